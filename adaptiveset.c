@@ -0,0 +1,911 @@
+/******************************************************************************
+ * NAME:	    adaptiveset.c
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    Source file containing the adaptive set engine. The
+ *		    members are held by an inner hashed or sorted set, or by a
+ *		    bitset of integers, and every primitive is passed on to
+ *		    whichever it is. The engine counts the operations on the
+ *		    set, and after each change, or when it is asked to
+ *		    settle, decides whether another representation would
+ *		    serve better. Reads never switch, since the set may be
+ *		    in the middle of iterations. A switch copies the members
+ *		    across in one pass, and is logged in the statistics.
+ *
+ * CREATED:	    10/17/2026
+ *
+ * LAST EDITED:	    10/17/2026
+ ***/
+
+/******************************************************************************
+ * INCLUDES
+ ***/
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "set.h"
+#include "setengine.h"
+#include "sortedset.h"
+#include "adaptiveset.h"
+
+/******************************************************************************
+ * MACRO DEFINITIONS
+ ***/
+
+#define WORD_BITS 64
+
+#define isfrozen(store, size)						\
+  ((store)->quiet >= CONFIG_ADAPTIVESET_QUIET + (unsigned long long)(size))
+#define isthawed(store, size)						\
+  ((store)->churn >= (CONFIG_ADAPTIVESET_QUIET				\
+		      + (unsigned long long)(size)) / 4)
+/* Whether a bitset of `bits' bits is small enough for `size' members, at
+ * `density' bits per member. Small bitsets are always good enough. */
+#define isdense(bits, size, density)					\
+  ((unsigned long long)(bits) <= (unsigned long long)(density)		\
+   * ((size) < CONFIG_ADAPTIVESET_DENSE ? CONFIG_ADAPTIVESET_DENSE : (size)))
+#define span_of(least, most)						\
+  ((unsigned long long)(most) - (unsigned long long)(least) + 1)
+
+/******************************************************************************
+ * TYPE DEFINITIONS
+ ***/
+
+/* The storage of an adaptive set. `inner' holds the members unless the set
+ * is a bitset, in which bit i of `words' is the integer base + i. `least'
+ * and `most' bound the integers in the set. `quiet' counts the reads since
+ * the last change, and `churn' the changes since the last switch. `scratch'
+ * holds the member returned by remove, and `current' the one returned by
+ * an iterator over a bitset. */
+typedef struct {
+
+  adaptiveset_repr repr;
+  int (*compare)(const void *, const void *);
+  size_t width;
+  int integer;
+
+  set * inner;
+  uint64_t * words;
+  size_t nwords;
+  long long base;
+  long long least;
+  long long most;
+
+  unsigned long long quiet;
+  unsigned long long churn;
+  adaptiveset_stats stats;
+
+  unsigned char * scratch;
+  unsigned char * current;
+
+} adaptivestore;
+
+/******************************************************************************
+ * LOCAL PROTOTYPES
+ ***/
+
+static adaptivestore * open_store(const set *,
+				  int (*)(const void *, const void *),
+				  size_t, int);
+static void close_store(adaptivestore *);
+static long long integer_of(const adaptivestore *, const void *);
+static void * record_of(const adaptivestore *, long long, unsigned char *);
+static int bit_of(const adaptivestore *, long long, unsigned long long *);
+static adaptiveset_repr represent(const adaptivestore *);
+static void note(adaptivestore *, adaptiveset_repr, long);
+static int convert(set *, adaptiveset_repr);
+static void * walk(const set *, set_iterator *);
+static int grow(adaptivestore *, long long);
+static int hashed_add(set *, size_t, const void *);
+static void adapt(set *);
+
+static int adaptive_ismember(const set *, const void *);
+static int adaptive_insert(set *, void *);
+static void * adaptive_remove(set *, const void *);
+static void * adaptive_begin(const set *, set_iterator *);
+static void * adaptive_advance(const set *, set_iterator *);
+static void adaptive_clear(set *);
+static int adaptive_like(set *, const set *);
+
+/******************************************************************************
+ * ENGINES
+ ***/
+
+const set_engine set_adaptive_engine = {
+  .name = "adaptive",
+  .ismember = adaptive_ismember,
+  .insert = adaptive_insert,
+  .remove = adaptive_remove,
+  .begin = adaptive_begin,
+  .advance = adaptive_advance,
+  .clear = adaptive_clear,
+  .like = adaptive_like,
+  .byvalue = 1
+};
+
+/******************************************************************************
+ * API FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:	    set_create_adaptive
+ *
+ * DESCRIPTION:	    Creates an empty adaptive set.
+ *
+ * ARGUMENTS:	    match, copy, destroy: as in set_create (set.h). They are
+ *			called on records of `width' bytes.
+ *		    hash: (unsigned long (*)(const void *)) -- as in
+ *			set_create_hashed.
+ *		    compare: (int (*)(const void *, const void *)) -- as in
+ *			set_create_sorted, or NULL if the set is never to be
+ *			sorted.
+ *		    width: (size_t) -- the size of a member, in bytes.
+ *		    integer: (int) -- nonzero if the members are signed
+ *			integers of `width' bytes, which may be kept in a
+ *			bitset. The width must then be 1, 2, 4 or 8.
+ *
+ * RETURN:	    (set *) -- pointer to the set, or NULL.
+ *
+ * NOTES:	    O(1). As with the other engines that keep records,
+ *		    set_insert stores a copy of the record and destroys the one
+ *		    it was given, and the data returned by set_remove and the
+ *		    iterators are only valid until the next call on the set.
+ *		    Reads update its counters, so an adaptive set must not be
+ *		    read from several threads at once.
+ ***/
+set * set_create_adaptive(int (*match)(const void *, const void *),
+			  unsigned long (*hash)(const void *),
+			  int (*compare)(const void *, const void *),
+			  void * (*copy)(const void *),
+			  void (*destroy)(void *),
+			  size_t width, int integer)
+{
+  if (match == NULL || hash == NULL || width == 0
+      || (integer && width != 1 && width != 2 && width != 4 && width != 8))
+    return NULL;
+
+  set * group = NULL;
+  if ((group = set_create_engine(&set_adaptive_engine, match, hash, copy,
+				 destroy)) == NULL)
+    return NULL;
+
+  if ((group->storage = open_store(group, compare, width, integer)) == NULL) {
+    free(group);
+    return NULL;
+  }
+
+  return group;
+}
+
+/******************************************************************************
+ * FUNCTION:	    set_adaptive_stats
+ *
+ * DESCRIPTION:	    Reports the representation of an adaptive set, the
+ *		    operations on it, and its last switches.
+ *
+ * ARGUMENTS:	    group: (const set *) -- the set to be operated on.
+ *		    stats: (adaptiveset_stats *) -- will contain the statistics.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    O(CONFIG_ADAPTIVESET_EVENTS)
+ ***/
+int set_adaptive_stats(const set * group, adaptiveset_stats * stats)
+{
+  if (group == NULL || stats == NULL || group->engine != &set_adaptive_engine)
+    return -1;
+
+  const adaptivestore * store = group->storage;
+  *stats = store->stats;
+  stats->repr = represent(store);
+
+  /* The events are kept in a ring, with the next one to be overwritten at
+   * switches % CONFIG_ADAPTIVESET_EVENTS. */
+  int oldest = store->stats.switches > CONFIG_ADAPTIVESET_EVENTS
+    ? (int)(store->stats.switches % CONFIG_ADAPTIVESET_EVENTS) : 0;
+  for (int i = 0; i < stats->nevents; i++)
+    stats->events[i] = store->stats.events[(oldest + i)
+					   % CONFIG_ADAPTIVESET_EVENTS];
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    set_adaptive_settle
+ *
+ * DESCRIPTION:	    Makes the switch that reads alone have earned: a hashed
+ *		    set that is frozen is sorted, so that the iterations after
+ *		    it walk its members in order through contiguous memory.
+ *
+ * ARGUMENTS:	    group: (set *) -- the set to be operated on.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise. A set that is not
+ *		    frozen is left as it is.
+ *
+ * NOTES:	    O(1), or O(n log n) when it switches. As with a change, it
+ *		    must not be called while the set is being iterated.
+ ***/
+int set_adaptive_settle(set * group)
+{
+  if (group == NULL || group->engine != &set_adaptive_engine)
+    return -1;
+
+  adaptivestore * store = group->storage;
+  if (store->repr == ADAPTIVESET_HASHED && store->compare != NULL
+      && group->size > CONFIG_SET_INLINE && isfrozen(store, group->size))
+    return convert(group, ADAPTIVESET_SORTED);
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    adaptiveset_name
+ *
+ * DESCRIPTION:	    Names a representation, for printing.
+ *
+ * ARGUMENTS:	    repr: (adaptiveset_repr) -- the representation.
+ *
+ * RETURN:	    const char * -- its name, or "unknown".
+ *
+ * NOTES:	    O(1)
+ ***/
+const char * adaptiveset_name(adaptiveset_repr repr)
+{
+  switch (repr) {
+  case ADAPTIVESET_INLINE: return "inline";
+  case ADAPTIVESET_HASHED: return "hashed";
+  case ADAPTIVESET_SORTED: return "sorted";
+  case ADAPTIVESET_BITSET: return "bitset";
+  }
+  return "unknown";
+}
+
+/******************************************************************************
+ * LOCAL FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:	    open_store
+ *
+ * DESCRIPTION:	    Creates the storage of an empty adaptive set, which starts
+ *		    out hashed.
+ *
+ * ARGUMENTS:	    group: (const set *) -- the set, for its functions.
+ *		    compare: (int (*)(const void *, const void *)) -- the
+ *			order, or NULL.
+ *		    width: (size_t) -- the size of a record.
+ *		    integer: (int) -- whether the records are integers.
+ *
+ * RETURN:	    adaptivestore * -- the storage, or NULL.
+ *
+ * NOTES:	    O(1)
+ ***/
+static adaptivestore * open_store(const set * group,
+				  int (*compare)(const void *, const void *),
+				  size_t width, int integer)
+{
+  adaptivestore * store = NULL;
+  if ((store = malloc(sizeof(adaptivestore) + 2 * width)) == NULL)
+    return NULL;
+
+  *store = (adaptivestore){
+    .repr = ADAPTIVESET_HASHED,
+    .compare = compare,
+    .width = width,
+    .integer = integer,
+    .inner = NULL,
+    .words = NULL,
+    .nwords = 0,
+    .quiet = 0,
+    .churn = 0,
+    .stats = {.repr = ADAPTIVESET_INLINE},
+    .scratch = (unsigned char *)(store + 1),
+    .current = (unsigned char *)(store + 1) + width
+  };
+
+  /* The inner set keeps pointers to records it owns, so it frees them. */
+  if ((store->inner = set_create_hashed(group->match, group->hash, NULL,
+					free)) == NULL) {
+    free(store);
+    return NULL;
+  }
+
+  return store;
+}
+
+/******************************************************************************
+ * FUNCTION:	    close_store
+ *
+ * DESCRIPTION:	    Frees the members of an adaptive set, and its storage.
+ *
+ * ARGUMENTS:	    store: (adaptivestore *) -- the storage.
+ *
+ * RETURN:	    void.
+ *
+ * NOTES:	    O(n)
+ ***/
+static void close_store(adaptivestore * store)
+{
+  if (store->inner != NULL)
+    set_destroy(&store->inner);
+  free(store->words);
+  free(store);
+}
+
+/******************************************************************************
+ * FUNCTION:	    integer_of
+ *
+ * DESCRIPTION:	    Reads a record as a signed integer.
+ *
+ * ARGUMENTS:	    store: (const adaptivestore *) -- storage of integers.
+ *		    data: (const void *) -- the record.
+ *
+ * RETURN:	    long long -- its value.
+ *
+ * NOTES:	    O(1)
+ ***/
+static long long integer_of(const adaptivestore * store, const void * data)
+{
+  int8_t one;
+  int16_t two;
+  int32_t four;
+  int64_t eight;
+  switch (store->width) {
+  case 1: memcpy(&one, data, 1); return one;
+  case 2: memcpy(&two, data, 2); return two;
+  case 4: memcpy(&four, data, 4); return four;
+  default: memcpy(&eight, data, 8); return eight;
+  }
+}
+
+/******************************************************************************
+ * FUNCTION:	    record_of
+ *
+ * DESCRIPTION:	    Writes a signed integer as a record.
+ *
+ * ARGUMENTS:	    store: (const adaptivestore *) -- storage of integers.
+ *		    value: (long long) -- the value.
+ *		    record: (unsigned char *) -- will contain the record.
+ *
+ * RETURN:	    void * -- the record.
+ *
+ * NOTES:	    O(1)
+ ***/
+static void * record_of(const adaptivestore * store, long long value,
+			unsigned char * record)
+{
+  int8_t one = (int8_t)value;
+  int16_t two = (int16_t)value;
+  int32_t four = (int32_t)value;
+  int64_t eight = value;
+  switch (store->width) {
+  case 1: memcpy(record, &one, 1); break;
+  case 2: memcpy(record, &two, 2); break;
+  case 4: memcpy(record, &four, 4); break;
+  default: memcpy(record, &eight, 8); break;
+  }
+  return record;
+}
+
+/******************************************************************************
+ * FUNCTION:	    bit_of
+ *
+ * DESCRIPTION:	    Finds the bit of an integer in a bitset.
+ *
+ * ARGUMENTS:	    store: (const adaptivestore *) -- storage that is a bitset.
+ *		    value: (long long) -- the integer.
+ *		    bit: (unsigned long long *) -- will contain the bit.
+ *
+ * RETURN:	    int -- 1 if the bitset covers the integer, 0 otherwise.
+ *
+ * NOTES:	    O(1)
+ ***/
+static int bit_of(const adaptivestore * store, long long value,
+		  unsigned long long * bit)
+{
+  if (value < store->base)
+    return 0;
+  *bit = span_of(store->base, value) - 1;
+  return *bit < store->nwords * WORD_BITS;
+}
+
+/******************************************************************************
+ * FUNCTION:	    represent
+ *
+ * DESCRIPTION:	    The representation of the set, as the statistics give it:
+ *		    a hashed set that has not outgrown its inline arrays is
+ *		    inline.
+ *
+ * ARGUMENTS:	    store: (const adaptivestore *) -- the storage.
+ *
+ * RETURN:	    adaptiveset_repr -- the representation.
+ *
+ * NOTES:	    O(1)
+ ***/
+static adaptiveset_repr represent(const adaptivestore * store)
+{
+  if (store->repr == ADAPTIVESET_HASHED && store->inner->storage == NULL)
+    return ADAPTIVESET_INLINE;
+  return store->repr;
+}
+
+/******************************************************************************
+ * FUNCTION:	    note
+ *
+ * DESCRIPTION:	    Logs a switch to the current representation.
+ *
+ * ARGUMENTS:	    store: (adaptivestore *) -- the storage.
+ *		    from: (adaptiveset_repr) -- the old representation.
+ *		    size: (long) -- the size of the set.
+ *
+ * RETURN:	    void.
+ *
+ * NOTES:	    O(1)
+ ***/
+static void note(adaptivestore * store, adaptiveset_repr from, long size)
+{
+  adaptiveset_stats * stats = &store->stats;
+  stats->events[stats->switches % CONFIG_ADAPTIVESET_EVENTS] =
+    (adaptiveset_switch){
+    .from = from,
+    .to = represent(store),
+    .size = size,
+    .operation = stats->lookups + stats->inserts + stats->removes
+    + stats->scans
+  };
+  stats->switches++;
+  if (stats->nevents < CONFIG_ADAPTIVESET_EVENTS)
+    stats->nevents++;
+}
+
+/******************************************************************************
+ * FUNCTION:	    convert
+ *
+ * DESCRIPTION:	    Switches the set to another representation, copying its
+ *		    members across, and finds the bounds of its integers.
+ *
+ * ARGUMENTS:	    group: (set *) -- the set to be operated on.
+ *		    repr: (adaptiveset_repr) -- ADAPTIVESET_HASHED,
+ *			ADAPTIVESET_SORTED or ADAPTIVESET_BITSET.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise. On failure the set
+ *		    is left as it was.
+ *
+ * NOTES:	    O(n), or O(n log n) to a sorted set. A bitset also takes a
+ *		    first pass, for the bounds.
+ ***/
+static int convert(set * group, adaptiveset_repr repr)
+{
+  adaptivestore * store = group->storage;
+  adaptiveset_repr from = represent(store);
+  set * inner = NULL;
+  uint64_t * words = NULL;
+  size_t nwords = 0;
+  long long base = 0, least = 0, most = 0;
+  set_iterator iterator;
+
+  if (repr == ADAPTIVESET_BITSET) {
+    int first = 1;
+    for (void * data = walk(group, &iterator); data != NULL;
+	 data = adaptive_advance(group, &iterator), first = 0) {
+      long long value = integer_of(store, data);
+      least = first || value < least ? value : least;
+      most = first || value > most ? value : most;
+    }
+    /* The base is a multiple of the word size, so the bitset can grow by
+     * whole words at either end. */
+    base = least - ((least % WORD_BITS) + WORD_BITS) % WORD_BITS;
+    nwords = (size_t)(span_of(base, most) / WORD_BITS + 1);
+    if ((words = calloc(nwords, sizeof(uint64_t))) == NULL)
+      return -1;
+  } else if (repr == ADAPTIVESET_SORTED) {
+    if ((inner = set_create_sorted(store->compare, NULL, NULL,
+				   store->width)) == NULL)
+      return -1;
+  } else {
+    if ((inner = set_create_hashed(group->match, group->hash, NULL,
+				   free)) == NULL)
+      return -1;
+  }
+
+  int first = 1;
+  for (void * data = walk(group, &iterator); data != NULL;
+       data = adaptive_advance(group, &iterator), first = 0) {
+    if (store->integer) {
+      long long value = integer_of(store, data);
+      least = first || value < least ? value : least;
+      most = first || value > most ? value : most;
+    }
+
+    if (repr == ADAPTIVESET_BITSET) {
+      unsigned long long bit = span_of(base, integer_of(store, data)) - 1;
+      words[bit / WORD_BITS] |= (uint64_t)1 << (bit % WORD_BITS);
+    } else if (repr == ADAPTIVESET_SORTED) {
+      if (set_insert(inner, data) < 0)
+	goto error_exception;
+    } else if (hashed_add(inner, store->width, data) < 0) {
+      goto error_exception;
+    }
+  }
+
+  if (store->inner != NULL)
+    set_destroy(&store->inner);
+  free(store->words);
+  store->inner = inner;
+  store->words = words;
+  store->nwords = nwords;
+  store->base = base;
+  store->least = least;
+  store->most = most;
+  store->repr = repr;
+  store->quiet = 0;
+  store->churn = 0;
+  note(store, from, group->size);
+  return 0;
+
+ error_exception: {
+    set_destroy(&inner);
+    return -1;
+  }
+}
+
+/******************************************************************************
+ * FUNCTION:	    walk
+ *
+ * DESCRIPTION:	    Starts an iteration over the members, without counting it
+ *		    as a scan or switching.
+ *
+ * ARGUMENTS:	    group: (const set *) -- the set to be operated on.
+ *		    iterator: (set_iterator *) -- will contain the position.
+ *
+ * RETURN:	    void * -- the first member, or NULL.
+ *
+ * NOTES:	    O(1), or O(words) for a bitset.
+ ***/
+static void * walk(const set * group, set_iterator * iterator)
+{
+  const adaptivestore * store = group->storage;
+  if (store->repr != ADAPTIVESET_BITSET)
+    return set_begin(store->inner, iterator);
+
+  iterator->node = NULL;
+  iterator->index = -1;
+  return adaptive_advance(group, iterator);
+}
+
+/******************************************************************************
+ * FUNCTION:	    grow
+ *
+ * DESCRIPTION:	    Widens a bitset by whole words to take in an integer.
+ *
+ * ARGUMENTS:	    store: (adaptivestore *) -- storage that is a bitset.
+ *		    value: (long long) -- the integer.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    O(words)
+ ***/
+static int grow(adaptivestore * store, long long value)
+{
+  long long base = store->base;
+  if (value < base)
+    base = value - ((value % WORD_BITS) + WORD_BITS) % WORD_BITS;
+  long long top = store->base + (long long)(store->nwords * WORD_BITS) - 1;
+  if (value > top)
+    top = value;
+
+  size_t nwords = (size_t)(span_of(base, top) / WORD_BITS)
+    + (span_of(base, top) % WORD_BITS != 0);
+  uint64_t * words = NULL;
+  if ((words = calloc(nwords, sizeof(uint64_t))) == NULL)
+    return -1;
+
+  memcpy(words + (store->base - base) / WORD_BITS, store->words,
+	 store->nwords * sizeof(uint64_t));
+  free(store->words);
+  store->words = words;
+  store->nwords = nwords;
+  store->base = base;
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    hashed_add
+ *
+ * DESCRIPTION:	    Inserts a copy of a record into the inner hashed set.
+ *
+ * ARGUMENTS:	    inner: (set *) -- an inner hashed set.
+ *		    width: (size_t) -- the size of a record.
+ *		    data: (const void *) -- the record.
+ *
+ * RETURN:	    int -- as set_insert.
+ *
+ * NOTES:	    O(1) amortized. The copy is made with the width, since the
+ *		    inner set frees its records.
+ ***/
+static int hashed_add(set * inner, size_t width, const void * data)
+{
+  void * record = NULL;
+  if ((record = malloc(width)) == NULL)
+    return -1;
+  memcpy(record, data, width);
+
+  int ret = set_insert(inner, record);
+  if (ret)
+    free(record);
+  return ret;
+}
+
+/******************************************************************************
+ * FUNCTION:	    adapt
+ *
+ * DESCRIPTION:	    Decides, after a change, whether the set should switch:
+ *		    to a bitset if its integers are dense, from a bitset if
+ *		    they are sparse, and from sorted to hashed if it has
+ *		    changed much since it was sorted.
+ *
+ * ARGUMENTS:	    group: (set *) -- the set to be operated on.
+ *
+ * RETURN:	    void.
+ *
+ * NOTES:	    O(1), or O(n) when it switches. A switch that fails leaves
+ *		    the set as it was, which is still correct.
+ ***/
+static void adapt(set * group)
+{
+  adaptivestore * store = group->storage;
+  if (store->repr == ADAPTIVESET_BITSET) {
+    if (!isdense(store->nwords * WORD_BITS, group->size,
+		 2 * CONFIG_ADAPTIVESET_DENSITY))
+      convert(group, ADAPTIVESET_HASHED);
+  } else if (store->integer && group->size >= CONFIG_ADAPTIVESET_DENSE
+	     && isdense(span_of(store->least, store->most), group->size,
+			CONFIG_ADAPTIVESET_DENSITY)) {
+    convert(group, ADAPTIVESET_BITSET);
+  } else if (store->repr == ADAPTIVESET_SORTED
+	     && isthawed(store, group->size)) {
+    convert(group, ADAPTIVESET_HASHED);
+  }
+}
+
+/******************************************************************************
+ * FUNCTION:	    adaptive_ismember
+ *
+ * DESCRIPTION:	    ismember primitive of the adaptive engine.
+ *
+ * ARGUMENTS:	    group: (const set *) -- the set to be operated on.
+ *		    data: (const void *) -- the record to check.
+ *
+ * RETURN:	    int -- 1 if the member is in the set, 0 if it is not.
+ *
+ * NOTES:	    That of the representation. A lookup never switches, since
+ *		    the set may be in the middle of an iteration.
+ ***/
+static int adaptive_ismember(const set * group, const void * data)
+{
+  adaptivestore * store = group->storage;
+  store->stats.lookups++;
+  store->quiet++;
+  if (store->repr != ADAPTIVESET_BITSET)
+    return set_ismember(store->inner, data);
+
+  unsigned long long bit = 0;
+  return bit_of(store, integer_of(store, data), &bit)
+    && (store->words[bit / WORD_BITS] >> (bit % WORD_BITS) & 1);
+}
+
+/******************************************************************************
+ * FUNCTION:	    adaptive_insert
+ *
+ * DESCRIPTION:	    insert primitive of the adaptive engine. A bitset that
+ *		    would grow too sparse for the integer is switched to
+ *		    hashed first.
+ *
+ * ARGUMENTS:	    group: (set *) -- the set to be operated on.
+ *		    data: (void *) -- the record to insert.
+ *
+ * RETURN:	    int -- 0 if the record was inserted, 1 if it is already a
+ *		    member, -1 otherwise.
+ *
+ * NOTES:	    That of the representation, and see adapt.
+ ***/
+static int adaptive_insert(set * group, void * data)
+{
+  adaptivestore * store = group->storage;
+  store->stats.inserts++;
+  long long value = store->integer ? integer_of(store, data) : 0;
+
+  unsigned long long bit = 0;
+  if (store->repr == ADAPTIVESET_BITSET && !bit_of(store, value, &bit)) {
+    long long base = value < store->base ? value : store->base;
+    long long top = store->base + (long long)(store->nwords * WORD_BITS) - 1;
+    top = value > top ? value : top;
+    if (!isdense(span_of(base, top), group->size + 1,
+		 2 * CONFIG_ADAPTIVESET_DENSITY)) {
+      if (convert(group, ADAPTIVESET_HASHED))
+	return -1;
+    } else if (grow(store, value) || !bit_of(store, value, &bit)) {
+      return -1;
+    }
+  }
+
+  int ret = 0;
+  if (store->repr == ADAPTIVESET_BITSET) {
+    uint64_t * word = &store->words[bit / WORD_BITS];
+    uint64_t mask = (uint64_t)1 << (bit % WORD_BITS);
+    ret = (*word & mask) != 0;
+    *word |= mask;
+  } else {
+    adaptiveset_repr before = represent(store);
+    ret = store->repr == ADAPTIVESET_SORTED
+      ? set_insert(store->inner, data)
+      : hashed_add(store->inner, store->width, data);
+    if (ret == 0 && before != represent(store))
+      note(store, before, group->size + 1);
+  }
+  if (ret != 0)
+    return ret;
+
+  if (store->integer) {
+    store->least = group->size == 0 || value < store->least
+      ? value : store->least;
+    store->most = group->size == 0 || value > store->most
+      ? value : store->most;
+  }
+  group->size++;
+  store->quiet = 0;
+  store->churn++;
+  adapt(group);
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    adaptive_remove
+ *
+ * DESCRIPTION:	    remove primitive of the adaptive engine.
+ *
+ * ARGUMENTS:	    group: (set *) -- the set to be operated on.
+ *		    data: (const void *) -- the record to remove.
+ *
+ * RETURN:	    void * -- a copy of the member, valid until the next call
+ *		    on the set, or NULL.
+ *
+ * NOTES:	    That of the representation, and see adapt. The bounds of
+ *		    the integers are not narrowed until the next switch.
+ ***/
+static void * adaptive_remove(set * group, const void * data)
+{
+  adaptivestore * store = group->storage;
+  store->stats.removes++;
+
+  if (store->repr == ADAPTIVESET_BITSET) {
+    unsigned long long bit = 0;
+    if (!bit_of(store, integer_of(store, data), &bit)
+	|| !(store->words[bit / WORD_BITS] >> (bit % WORD_BITS) & 1))
+      return NULL;
+    store->words[bit / WORD_BITS] &= ~((uint64_t)1 << (bit % WORD_BITS));
+    memcpy(store->scratch, data, store->width);
+  } else {
+    /* The engine is called directly, since set_remove would destroy the
+     * member before it is copied. */
+    void * old = NULL;
+    if ((old = store->inner->engine->remove(store->inner, data)) == NULL)
+      return NULL;
+    memcpy(store->scratch, old, store->width);
+    if (store->repr == ADAPTIVESET_HASHED)
+      free(old);
+  }
+
+  group->size--;
+  store->quiet = 0;
+  store->churn++;
+  adapt(group);
+  return store->scratch;
+}
+
+/******************************************************************************
+ * FUNCTION:	    adaptive_begin
+ *
+ * DESCRIPTION:	    begin primitive of the adaptive engine. A scan counts as a
+ *		    read of every member.
+ *
+ * ARGUMENTS:	    group: (const set *) -- the set to be operated on.
+ *		    iterator: (set_iterator *) -- will contain the position.
+ *
+ * RETURN:	    void * -- the first member, or NULL.
+ *
+ * NOTES:	    O(1), or O(words) for a bitset. It never switches, since
+ *		    other iterations may be in progress; see
+ *		    set_adaptive_settle.
+ ***/
+static void * adaptive_begin(const set * group, set_iterator * iterator)
+{
+  adaptivestore * store = group->storage;
+  store->stats.scans++;
+  store->quiet += (unsigned long long)group->size;
+  return walk(group, iterator);
+}
+
+/******************************************************************************
+ * FUNCTION:	    adaptive_advance
+ *
+ * DESCRIPTION:	    advance primitive of the adaptive engine. A bitset is
+ *		    walked a word at a time, in order.
+ *
+ * ARGUMENTS:	    group: (const set *) -- the set to be operated on.
+ *		    iterator: (set_iterator *) -- the position.
+ *
+ * RETURN:	    void * -- the next member, or NULL at the end.
+ *
+ * NOTES:	    O(1) amortized.
+ ***/
+static void * adaptive_advance(const set * group, set_iterator * iterator)
+{
+  adaptivestore * store = group->storage;
+  if (store->repr != ADAPTIVESET_BITSET)
+    return set_advance(store->inner, iterator);
+
+  unsigned long long bit = (unsigned long long)(iterator->index + 1);
+  size_t index = (size_t)(bit / WORD_BITS);
+  if (index >= store->nwords)
+    return NULL;
+  uint64_t word = store->words[index] >> (bit % WORD_BITS);
+  while (word == 0) {
+    if (++index >= store->nwords)
+      return NULL;
+    word = store->words[index];
+    bit = (unsigned long long)index * WORD_BITS;
+  }
+  for (; !(word & 1); word >>= 1)
+    bit++;
+
+  iterator->index = (long)bit;
+  return record_of(store, store->base + (long long)bit, store->current);
+}
+
+/******************************************************************************
+ * FUNCTION:	    adaptive_clear
+ *
+ * DESCRIPTION:	    clear primitive of the adaptive engine.
+ *
+ * ARGUMENTS:	    group: (set *) -- the set to be operated on.
+ *
+ * RETURN:	    void.
+ *
+ * NOTES:	    O(n). The records belong to the set, so destroy is not
+ *		    called on them.
+ ***/
+static void adaptive_clear(set * group)
+{
+  if (group->storage == NULL)
+    return;
+
+  close_store(group->storage);
+  group->storage = NULL;
+  group->size = 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    adaptive_like
+ *
+ * DESCRIPTION:	    like primitive of the adaptive engine. The new set starts
+ *		    out hashed, with the order and width of the model.
+ *
+ * ARGUMENTS:	    group: (set *) -- the empty set.
+ *		    model: (const set *) -- an adaptive set.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    O(1)
+ ***/
+static int adaptive_like(set * group, const set * model)
+{
+  const adaptivestore * store = model->storage;
+  if ((group->storage = open_store(group, store->compare, store->width,
+				   store->integer)) == NULL)
+    return -1;
+  return 0;
+}
+
+/*****************************************************************************/
@@ -0,0 +1,112 @@
+/******************************************************************************
+ * NAME:	    adaptiveset.h
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    The header file for the adaptive set engine, which picks
+ *		    the representation of a set by itself. An adaptive set is
+ *		    an ordinary set (set.h) of fixed-size records. It starts
+ *		    out hashed, with its first members inline; it may be
+ *		    sorted (sortedset.h) once it has gone a while without
+ *		    changing, and is hashed again once it changes much; and a
+ *		    set of integers that is dense enough becomes a bitset.
+ *		    The representation it is in, and the switches it has
+ *		    made, are available here.
+ *
+ * CREATED:	    10/17/2026
+ *
+ * LAST EDITED:	    10/17/2026
+ ***/
+
+#ifndef __ET_ADAPTIVESET_H__
+#define __ET_ADAPTIVESET_H__
+
+#include <stddef.h>
+
+#include "set.h"
+
+/******************************************************************************
+ * CONFIGURATION
+ ***/
+
+/* The number of switches remembered by the statistics. */
+#ifndef CONFIG_ADAPTIVESET_EVENTS
+#   define CONFIG_ADAPTIVESET_EVENTS 16
+#endif
+
+/* A set is frozen, and is sorted by set_adaptive_settle, when it has been
+ * read this many times, plus its size, without a change. A scan reads each
+ * member once. It is hashed again after a quarter as many changes. */
+#ifndef CONFIG_ADAPTIVESET_QUIET
+#   define CONFIG_ADAPTIVESET_QUIET 1024
+#endif
+
+/* A set of at least CONFIG_ADAPTIVESET_DENSE integers becomes a bitset when
+ * the bitset would take at most this many bits per member, and stops being
+ * one when it would take twice as many. */
+#ifndef CONFIG_ADAPTIVESET_DENSITY
+#   define CONFIG_ADAPTIVESET_DENSITY 8
+#endif
+
+#ifndef CONFIG_ADAPTIVESET_DENSE
+#   define CONFIG_ADAPTIVESET_DENSE 64
+#endif
+
+/******************************************************************************
+ * TYPE DEFINITIONS
+ ***/
+
+typedef enum {
+
+  ADAPTIVESET_INLINE,
+  ADAPTIVESET_HASHED,
+  ADAPTIVESET_SORTED,
+  ADAPTIVESET_BITSET
+
+} adaptiveset_repr;
+
+/* A switch from one representation to another, with the size of the set
+ * and the number of operations on it before the switch. */
+typedef struct {
+
+  adaptiveset_repr from;
+  adaptiveset_repr to;
+  long size;
+  unsigned long long operation;
+
+} adaptiveset_switch;
+
+/* The representation of a set, the operations on it since it was created,
+ * and its last switches, oldest first. */
+typedef struct {
+
+  adaptiveset_repr repr;
+
+  unsigned long long lookups;
+  unsigned long long inserts;
+  unsigned long long removes;
+  unsigned long long scans;
+
+  unsigned long switches;
+  int nevents;
+  adaptiveset_switch events[CONFIG_ADAPTIVESET_EVENTS];
+
+} adaptiveset_stats;
+
+/******************************************************************************
+ * API FUNCTION PROTOTYPES
+ ***/
+
+extern set * set_create_adaptive(int (*match)(const void *, const void *),
+				 unsigned long (*hash)(const void *),
+				 int (*compare)(const void *, const void *),
+				 void * (*copy)(const void *),
+				 void (*destroy)(void *),
+				 size_t width, int integer);
+extern int set_adaptive_stats(const set * set, adaptiveset_stats * stats);
+extern int set_adaptive_settle(set * set);
+extern const char * adaptiveset_name(adaptiveset_repr repr);
+
+#endif /* __ET_ADAPTIVESET_H__ */
+
+/*****************************************************************************/
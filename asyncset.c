@@ -0,0 +1,551 @@
+/******************************************************************************
+ * NAME:	    asyncset.c
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    Source file containing code for sets that are rebuilt in
+ *		    the background. A build runs on a thread of its own, which
+ *		    starts a worker for each part: every worker loads its part
+ *		    into a hashed set of its own, in parallel, and the builder
+ *		    then moves the members of the smaller sets into the
+ *		    largest, which becomes the new version. Moving a member
+ *		    does not copy it, and the largest set is never rehashed.
+ *		    Versions are reference counted under a mutex, which is held
+ *		    only to take or drop a reference, never while a set is
+ *		    read or built. This code follows the typedefs and
+ *		    prototypes in asyncset.h.
+ *
+ * CREATED:	    10/17/2026
+ *
+ * LAST EDITED:	    10/17/2026
+ ***/
+
+/******************************************************************************
+ * INCLUDES
+ ***/
+
+#include <stdlib.h>
+
+#include "asyncset.h"
+
+/******************************************************************************
+ * TYPE DEFINITIONS
+ ***/
+
+/* One part of a build, and the set it was loaded into. */
+typedef struct {
+
+  asyncset_job * job;
+  int part;
+  set * group;
+  int status;
+  pthread_t thread;
+  int started;
+
+} worker;
+
+/******************************************************************************
+ * LOCAL PROTOTYPES
+ ***/
+
+static asyncset_version * make_version(set *);
+static void unlink_version(asyncset *, asyncset_version *);
+static void drop_version(asyncset_version *);
+static asyncset_job * start(asyncset_job *);
+static void * build(void *);
+static void * load(void *);
+static int load_array(set *, int, int, void *);
+static set * merge(worker *, int);
+
+/******************************************************************************
+ * API FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:	    asyncset_create
+ *
+ * DESCRIPTION:	    Creates an asyncset, whose current version is an empty
+ *		    hashed set.
+ *
+ * ARGUMENTS:	    match: (int (*)(const void *, const void *)) -- returns 1
+ *			if two members are equal.
+ *		    hash: (unsigned long (*)(const void *)) -- hashes a member.
+ *		    copy: (void * (*)(const void *)) -- copies a member. Needed
+ *			by asyncset_build_array, and the set operations.
+ *		    destroy: (void (*)(void *)) -- frees a member, or NULL.
+ *
+ * RETURN:	    (asyncset *) -- the new asyncset, or NULL.
+ *
+ * NOTES:	    O(1)
+ ***/
+asyncset * asyncset_create(int (*match)(const void *, const void *),
+			   unsigned long (*hash)(const void *),
+			   void * (*copy)(const void *),
+			   void (*destroy)(void *))
+{
+  if (match == NULL || hash == NULL)
+    return NULL;
+  asyncset * handle = NULL;
+  if ((handle = malloc(sizeof(asyncset))) == NULL)
+    return NULL;
+
+  *handle = (asyncset){
+    .versions = NULL,
+    .match = match,
+    .hash = hash,
+    .copy = copy,
+    .destroy = destroy
+  };
+  if (pthread_mutex_init(&handle->lock, NULL)) {
+    free(handle);
+    return NULL;
+  }
+
+  set * group = set_create_hashed(match, hash, copy, destroy);
+  if (group == NULL || (handle->versions = make_version(group)) == NULL) {
+    set_destroy(&group);
+    asyncset_destroy(&handle);
+    return NULL;
+  }
+
+  return handle;
+}
+
+/******************************************************************************
+ * FUNCTION:	    asyncset_destroy
+ *
+ * DESCRIPTION:	    Destroys every version of the set, and the asyncset.
+ *
+ * ARGUMENTS:	    handle: (asyncset **) -- the asyncset to be operated on.
+ *
+ * RETURN:	    void.
+ *
+ * NOTES:	    O(n). No build may be running, and no reader may still
+ *		    hold a version.
+ ***/
+void asyncset_destroy(asyncset ** handle)
+{
+  if (handle == NULL || *handle == NULL)
+    return;
+
+  while ((*handle)->versions != NULL) {
+    asyncset_version * version = (*handle)->versions;
+    (*handle)->versions = version->next;
+    drop_version(version);
+  }
+
+  pthread_mutex_destroy(&(*handle)->lock);
+  free(*handle);
+  *handle = NULL;
+}
+
+/******************************************************************************
+ * FUNCTION:	    asyncset_acquire
+ *
+ * DESCRIPTION:	    Takes a reference to the current version of the set.
+ *
+ * ARGUMENTS:	    handle: (asyncset *) -- the asyncset to be operated on.
+ *
+ * RETURN:	    (const set *) -- the current version, which stays valid
+ *		    until it is released, even if a new version is swapped in.
+ *		    NULL if handle is NULL.
+ *
+ * NOTES:	    O(1). The version must not be modified; any number of
+ *		    threads may read it at once.
+ ***/
+const set * asyncset_acquire(asyncset * handle)
+{
+  if (handle == NULL)
+    return NULL;
+
+  pthread_mutex_lock(&handle->lock);
+  asyncset_version * version = handle->versions;
+  version->refs++;
+  pthread_mutex_unlock(&handle->lock);
+  return version->group;
+}
+
+/******************************************************************************
+ * FUNCTION:	    asyncset_release
+ *
+ * DESCRIPTION:	    Drops a reference taken by asyncset_acquire.
+ *
+ * ARGUMENTS:	    handle: (asyncset *) -- the asyncset to be operated on.
+ *		    group: (const set *) -- the version that was acquired.
+ *
+ * RETURN:	    void.
+ *
+ * NOTES:	    O(versions). The last reader of an old version destroys
+ *		    it.
+ ***/
+void asyncset_release(asyncset * handle, const set * group)
+{
+  if (handle == NULL || group == NULL)
+    return;
+
+  asyncset_version * version = NULL;
+  pthread_mutex_lock(&handle->lock);
+  for (version = handle->versions; version != NULL; version = version->next)
+    if (version->group == group)
+      break;
+  if (version != NULL && --version->refs == 0)
+    unlink_version(handle, version);
+  else
+    version = NULL;
+  pthread_mutex_unlock(&handle->lock);
+
+  drop_version(version);
+}
+
+/******************************************************************************
+ * FUNCTION:	    asyncset_swap
+ *
+ * DESCRIPTION:	    Makes a set the current version. Readers that hold the
+ *		    old version keep it until they release it.
+ *
+ * ARGUMENTS:	    handle: (asyncset *) -- the asyncset to be operated on.
+ *		    group: (set *) -- the new version, which the asyncset
+ *			takes over. It must not be modified afterwards.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    O(1). If there are no readers, the old version is
+ *		    destroyed here.
+ ***/
+int asyncset_swap(asyncset * handle, set * group)
+{
+  if (handle == NULL || group == NULL)
+    return -1;
+  asyncset_version * version = NULL, * old = NULL;
+  if ((version = make_version(group)) == NULL)
+    return -1;
+
+  pthread_mutex_lock(&handle->lock);
+  old = handle->versions;
+  version->next = old;
+  handle->versions = version;
+  if (--old->refs == 0)
+    unlink_version(handle, old);
+  else
+    old = NULL;
+  pthread_mutex_unlock(&handle->lock);
+
+  drop_version(old);
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    asyncset_build
+ *
+ * DESCRIPTION:	    Starts to build a new version of the set from a loader
+ *		    callback, in the background. When it is built, it is
+ *		    swapped in.
+ *
+ * ARGUMENTS:	    handle: (asyncset *) -- the asyncset to be operated on.
+ *		    loader: (asyncset_loader) -- loads the members.
+ *		    context: (void *) -- passed to the loader.
+ *		    threads: (int) -- the number of parts, each of which is
+ *			loaded on a thread of its own.
+ *		    done: (asyncset_done) -- called when the build finishes, or
+ *			NULL.
+ *		    done_context: (void *) -- passed to done.
+ *
+ * RETURN:	    (asyncset_job *) -- the build, which must be passed to
+ *		    asyncset_wait; or NULL if it could not be started.
+ *
+ * NOTES:	    O(1). The build itself is O(n) expected, of which the
+ *		    loading is divided among the threads.
+ ***/
+asyncset_job * asyncset_build(asyncset * handle, asyncset_loader loader,
+			      void * context, int threads,
+			      asyncset_done done, void * done_context)
+{
+  if (handle == NULL || loader == NULL || threads < 1
+      || threads > CONFIG_ASYNCSET_THREADS)
+    return NULL;
+  asyncset_job * job = NULL;
+  if ((job = malloc(sizeof(asyncset_job))) == NULL)
+    return NULL;
+
+  *job = (asyncset_job){
+    .handle = handle,
+    .threads = threads,
+    .loader = loader,
+    .context = context,
+    .members = NULL,
+    .count = 0,
+    .done = done,
+    .done_context = done_context,
+    .status = -1
+  };
+  return start(job);
+}
+
+/******************************************************************************
+ * FUNCTION:	    asyncset_build_array
+ *
+ * DESCRIPTION:	    Starts to build a new version of the set from an array of
+ *		    members, in the background, as asyncset_build does.
+ *
+ * ARGUMENTS:	    handle: (asyncset *) -- the asyncset to be operated on.
+ *		    members: (void * const *) -- the members, which are copied
+ *			by the copy function of the asyncset. The array must
+ *			stay valid until the build finishes.
+ *		    count: (size_t) -- the number of members.
+ *		    threads: (int) -- the number of threads, among which the
+ *			array is divided.
+ *		    done: (asyncset_done) -- called when the build finishes, or
+ *			NULL.
+ *		    done_context: (void *) -- passed to done.
+ *
+ * RETURN:	    (asyncset_job *) -- the build, which must be passed to
+ *		    asyncset_wait; or NULL if it could not be started.
+ *
+ * NOTES:	    O(1). The members may contain duplicates.
+ ***/
+asyncset_job * asyncset_build_array(asyncset * handle, void * const * members,
+				    size_t count, int threads,
+				    asyncset_done done, void * done_context)
+{
+  if (handle == NULL || handle->copy == NULL
+      || (members == NULL && count > 0) || threads < 1
+      || threads > CONFIG_ASYNCSET_THREADS)
+    return NULL;
+  asyncset_job * job = NULL;
+  if ((job = malloc(sizeof(asyncset_job))) == NULL)
+    return NULL;
+
+  *job = (asyncset_job){
+    .handle = handle,
+    .threads = threads,
+    .loader = load_array,
+    .context = job,
+    .members = members,
+    .count = count,
+    .done = done,
+    .done_context = done_context,
+    .status = -1
+  };
+  return start(job);
+}
+
+/******************************************************************************
+ * FUNCTION:	    asyncset_wait
+ *
+ * DESCRIPTION:	    Waits for a build to finish, and frees it.
+ *
+ * ARGUMENTS:	    job: (asyncset_job **) -- the build.
+ *
+ * RETURN:	    int -- 0 if the new version was swapped in, -1 otherwise.
+ *
+ * NOTES:	    Returns after the done callback, if there is one.
+ ***/
+int asyncset_wait(asyncset_job ** job)
+{
+  if (job == NULL || *job == NULL)
+    return -1;
+
+  pthread_join((*job)->builder, NULL);
+  int status = (*job)->status;
+  free(*job);
+  *job = NULL;
+  return status;
+}
+
+/******************************************************************************
+ * LOCAL FUNCTIONS
+ ***/
+
+static asyncset_version * make_version(set * group)
+{
+  asyncset_version * version = NULL;
+  if ((version = malloc(sizeof(asyncset_version))) == NULL)
+    return NULL;
+  *version = (asyncset_version){.group = group, .refs = 1, .next = NULL};
+  return version;
+}
+
+/* Removes a version from the list. Called with the lock held. */
+static void unlink_version(asyncset * handle, asyncset_version * version)
+{
+  asyncset_version ** link = &handle->versions;
+  while (*link != version)
+    link = &(*link)->next;
+  *link = version->next;
+}
+
+/* Destroys a version that is no longer in the list, outside the lock. */
+static void drop_version(asyncset_version * version)
+{
+  if (version == NULL)
+    return;
+  set_destroy(&version->group);
+  free(version);
+}
+
+/******************************************************************************
+ * FUNCTION:	    start
+ *
+ * DESCRIPTION:	    Starts the thread of a build.
+ *
+ * ARGUMENTS:	    job: (asyncset_job *) -- the build.
+ *
+ * RETURN:	    (asyncset_job *) -- the build, or NULL (and it is freed) if
+ *		    the thread could not be started.
+ *
+ * NOTES:	    none.
+ ***/
+static asyncset_job * start(asyncset_job * job)
+{
+  if (pthread_create(&job->builder, NULL, build, job)) {
+    free(job);
+    return NULL;
+  }
+  return job;
+}
+
+/******************************************************************************
+ * FUNCTION:	    build
+ *
+ * DESCRIPTION:	    The thread of a build. Loads the parts, the first on this
+ *		    thread and the rest on workers, merges them, and swaps the
+ *		    result in.
+ *
+ * ARGUMENTS:	    arg: (void *) -- the build.
+ *
+ * RETURN:	    void * -- NULL.
+ *
+ * NOTES:	    A part whose worker cannot be started is loaded on this
+ *		    thread instead.
+ ***/
+static void * build(void * arg)
+{
+  asyncset_job * job = arg;
+  asyncset * handle = job->handle;
+  worker workers[CONFIG_ASYNCSET_THREADS];
+
+  for (int i = 0; i < job->threads; i++)
+    workers[i] = (worker){
+      .job = job,
+      .part = i,
+      .group = NULL,
+      .status = -1,
+      .started = 0
+    };
+  for (int i = 1; i < job->threads; i++)
+    workers[i].started = !pthread_create(&workers[i].thread, NULL, load,
+					 &workers[i]);
+  load(&workers[0]);
+  for (int i = 1; i < job->threads; i++) {
+    if (workers[i].started)
+      pthread_join(workers[i].thread, NULL);
+    else
+      load(&workers[i]);
+  }
+
+  int status = 0;
+  for (int i = 0; i < job->threads; i++)
+    status |= workers[i].status;
+
+  set * group = NULL;
+  if (status == 0 && (group = merge(workers, job->threads)) != NULL
+      && asyncset_swap(handle, group) == 0)
+    job->status = 0;
+  else
+    set_destroy(&group);
+  for (int i = 0; i < job->threads; i++)
+    set_destroy(&workers[i].group);
+
+  if (job->done != NULL)
+    job->done(job, job->status, job->done_context);
+  return NULL;
+}
+
+/* The body of a worker: loads one part into a set of its own. */
+static void * load(void * arg)
+{
+  worker * part = arg;
+  asyncset * handle = part->job->handle;
+
+  part->group = set_create_hashed(handle->match, handle->hash, handle->copy,
+				  handle->destroy);
+  if (part->group != NULL)
+    part->status = part->job->loader(part->group, part->part,
+				     part->job->threads,
+				     part->job->context) ? -1 : 0;
+  return NULL;
+}
+
+/* The loader of asyncset_build_array: copies a slice of the array. */
+static int load_array(set * group, int part, int parts, void * context)
+{
+  const asyncset_job * job = context;
+  size_t first = job->count * part / parts;
+  size_t last = job->count * (part + 1) / parts;
+
+  for (size_t i = first; i < last; i++) {
+    void * data = NULL;
+    if ((data = group->copy(job->members[i])) == NULL)
+      return -1;
+    int ret = set_insert(group, data);
+    if (ret != 0 && group->destroy != NULL)
+      group->destroy(data);
+    if (ret < 0)
+      return -1;
+  }
+
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    merge
+ *
+ * DESCRIPTION:	    Moves the members of every part into the largest part.
+ *
+ * ARGUMENTS:	    workers: (worker *) -- the loaded parts.
+ *		    n: (int) -- the number of parts.
+ *
+ * RETURN:	    (set *) -- the largest part, which now holds every member
+ *		    and is taken out of its worker; or NULL on failure.
+ *
+ * NOTES:	    O(n - largest) expected. A member moves by its pointer, so
+ *		    the part it came from is destroyed without destroying its
+ *		    data; duplicates are destroyed as they are found, which is
+ *		    safe, since iteration over a hashed set does not look at
+ *		    the data of its members.
+ ***/
+static set * merge(worker * workers, int n)
+{
+  int largest = 0;
+  for (int i = 1; i < n; i++)
+    if (set_size(workers[i].group) > set_size(workers[largest].group))
+      largest = i;
+  set * group = workers[largest].group;
+  workers[largest].group = NULL;
+
+  int status = 0;
+  for (int i = 0; i < n; i++) {
+    set * part = workers[i].group;
+    if (part == NULL)
+      continue;
+
+    set_iterator iterator;
+    for (void * data = set_begin(part, &iterator); data != NULL;
+	 data = set_advance(part, &iterator)) {
+      int ret = status == 0 ? set_insert(group, data) : -1;
+      if (ret != 0) {
+	status |= ret < 0 ? -1 : 0;
+	if (group->destroy != NULL)
+	  group->destroy(data);
+      }
+    }
+    part->destroy = NULL;
+    set_destroy(&workers[i].group);
+  }
+
+  if (status != 0)
+    set_destroy(&group);
+  return group;
+}
+
+/*****************************************************************************/
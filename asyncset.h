@@ -0,0 +1,122 @@
+/******************************************************************************
+ * NAME:	    asyncset.h
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    The header file for sets that are rebuilt in the
+ *		    background. An asyncset holds the current version of a
+ *		    hashed set, which readers acquire and release. A new
+ *		    version is built on other threads, from an array of members
+ *		    or from a loader callback, while readers go on using the
+ *		    old one; when it is done it is swapped in, and the old
+ *		    version is destroyed once its last reader releases it. The
+ *		    caller can wait for a build, like a future, or be called
+ *		    back when it finishes.
+ *
+ * CREATED:	    10/17/2026
+ *
+ * LAST EDITED:	    10/17/2026
+ ***/
+
+#ifndef __ET_ASYNCSET_H__
+#define __ET_ASYNCSET_H__
+
+#include <pthread.h>
+#include <stddef.h>
+
+#include "set.h"
+
+/******************************************************************************
+ * CONFIGURATION
+ ***/
+
+/* The most threads a build uses. */
+#ifndef CONFIG_ASYNCSET_THREADS
+#   define CONFIG_ASYNCSET_THREADS 64
+#endif
+
+/******************************************************************************
+ * TYPE DEFINITIONS
+ ***/
+
+/* A published version of the set, and the number of references to it: one
+ * from each reader, and one from the asyncset while it is current. */
+typedef struct _asyncset_version_ {
+
+  set * group;
+  long refs;
+  struct _asyncset_version_ * next;
+
+} asyncset_version;
+
+typedef struct {
+
+  pthread_mutex_t lock;
+  /* The current version first, then old versions that are still read. */
+  asyncset_version * versions;
+
+  int (*match)(const void *, const void *);
+  unsigned long (*hash)(const void *);
+  void * (*copy)(const void *);
+  void (*destroy)(void *);
+
+} asyncset;
+
+/* Loads part `part' of `parts' of the new version into `group', which is a
+ * hashed set of its own, by set_insert. The parts of a build are loaded on
+ * different threads at the same time, and may overlap. A nonzero return
+ * fails the build. */
+typedef int (*asyncset_loader)(set * group, int part, int parts,
+			       void * context);
+
+struct _asyncset_job_;
+
+/* Called on the building thread when a build finishes, with 0 if the new
+ * version was swapped in, or -1 if the build failed. */
+typedef void (*asyncset_done)(struct _asyncset_job_ * job, int status,
+			      void * context);
+
+typedef struct _asyncset_job_ {
+
+  asyncset * handle;
+  int threads;
+
+  asyncset_loader loader;
+  void * context;
+  void * const * members;
+  size_t count;
+
+  asyncset_done done;
+  void * done_context;
+
+  pthread_t builder;
+  int status;
+
+} asyncset_job;
+
+/******************************************************************************
+ * API FUNCTION PROTOTYPES
+ ***/
+
+extern asyncset * asyncset_create(int (*match)(const void *, const void *),
+				  unsigned long (*hash)(const void *),
+				  void * (*copy)(const void *),
+				  void (*destroy)(void *));
+extern void asyncset_destroy(asyncset ** handle);
+extern const set * asyncset_acquire(asyncset * handle);
+extern void asyncset_release(asyncset * handle, const set * group);
+extern int asyncset_swap(asyncset * handle, set * group);
+extern asyncset_job * asyncset_build(asyncset * handle,
+				     asyncset_loader loader, void * context,
+				     int threads, asyncset_done done,
+				     void * done_context);
+extern asyncset_job * asyncset_build_array(asyncset * handle,
+					   void * const * members,
+					   size_t count, int threads,
+					   asyncset_done done,
+					   void * done_context);
+extern int asyncset_wait(asyncset_job ** job);
+
+#endif /* __ET_ASYNCSET_H__ */
+
+/*****************************************************************************/
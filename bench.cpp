@@ -0,0 +1,535 @@
+/******************************************************************************
+ * NAME:	    bench.cpp
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    Benchmarks of the set implementations. Compile this by
+ *		    'make bench', and run it without arguments. Each benchmark
+ *		    prints the time per operation; the C++ set of set.hpp is
+ *		    compared with a hashed C set of the same integers, which
+ *		    boxes every member and calls its functions through
+ *		    pointers, with the same C set on transparent huge pages
+ *		    (set_use_hugepages), and with one that grows incrementally
+ *		    (set_use_incremental). Insertions are also timed one by
+ *		    one, for the 99.9th percentile and the worst of them.
+ *		    A second benchmark churns the members of the hashed,
+ *		    compact and robin sets, inserting and removing at the
+ *		    same rate, and then times lookups in what is left.
+ *
+ * CREATED:	    10/17/2026
+ *
+ * LAST EDITED:	    10/17/2026
+ ***/
+
+/******************************************************************************
+ * INCLUDES
+ ***/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "set.hpp"
+
+extern "C" {
+#include "robinset.h"
+}
+
+/******************************************************************************
+ * MACRO DEFINITIONS
+ ***/
+
+#ifndef CONFIG_BENCH_SIZE
+#   define CONFIG_BENCH_SIZE 1000000
+#endif
+
+/* Each implementation is run this many times, and its best times are kept. */
+#ifndef CONFIG_BENCH_ROUNDS
+#   define CONFIG_BENCH_ROUNDS 3
+#endif
+
+/******************************************************************************
+ * TYPE DEFINITIONS
+ ***/
+
+typedef std::chrono::steady_clock bench_clock;
+
+/* The times of one implementation, in nanoseconds per operation, and the
+ * 99.9th percentile and the longest of the latencies of an insertion. */
+typedef struct {
+
+  double insert;
+  double hit;
+  double miss;
+  double unite;
+  double tail;
+  double worst;
+
+} timings;
+
+/* The times of one engine under churn, in nanoseconds per operation, and the
+ * mean probe of a robin set after it (0 for the other engines). */
+typedef struct {
+
+  double churn;
+  double hit;
+  double miss;
+  double probe;
+
+} churn_timings;
+
+/* The signature shared by set_create_hashed, set_create_compact and
+ * set_create_robin. */
+typedef set * (*set_creator)(int (*)(const void *, const void *),
+			     unsigned long (*)(const void *),
+			     void * (*)(const void *), void (*)(void *));
+
+/******************************************************************************
+ * LOCAL PROTOTYPES
+ ***/
+
+static int match_int(const void *, const void *);
+static unsigned long hash_int(const void *);
+static void * copy_int(const void *);
+static double since(bench_clock::time_point, long);
+static void percentiles(std::vector<double> &, timings *);
+static void keep_best(timings *, const timings *);
+static void keep_best(churn_timings *, const churn_timings *);
+template <typename T> static T isolated(T (*)(int), int);
+static timings run_c(int, set_pages, int);
+static timings bench_c(int);
+static timings bench_c_huge(int);
+static timings bench_c_incremental(int);
+static timings bench_cpp(int);
+static churn_timings run_churn(int, set_creator);
+static churn_timings churn_hashed(int);
+static churn_timings churn_compact(int);
+static churn_timings churn_robin(int);
+
+/******************************************************************************
+ * STATIC VARIABLES
+ ***/
+
+/* Keeps the compiler from discarding the lookups. */
+static volatile long sink = 0;
+
+/******************************************************************************
+ * MAIN
+ ***/
+
+int main()
+{
+  int n = CONFIG_BENCH_SIZE;
+  timings c = isolated(bench_c, n), huge = isolated(bench_c_huge, n);
+  timings incr = isolated(bench_c_incremental, n);
+  timings cpp = isolated(bench_cpp, n);
+  for (int round = 1; round < CONFIG_BENCH_ROUNDS; round++) {
+    timings next = isolated(bench_c, n);
+    keep_best(&c, &next);
+    next = isolated(bench_c_huge, n);
+    keep_best(&huge, &next);
+    next = isolated(bench_c_incremental, n);
+    keep_best(&incr, &next);
+    next = isolated(bench_cpp, n);
+    keep_best(&cpp, &next);
+  }
+
+  printf("%d integers, ns per operation\n"
+	 "\t\tset.h\thuge\tincr\tset.hpp\tspeedup\n"
+	 "insert\t\t%.1f\t%.1f\t%.1f\t%.1f\t%.1fx\n"
+	 "insert p99.9\t%.0f\t%.0f\t%.0f\t%.0f\t%.1fx\n"
+	 "insert max\t%.0f\t%.0f\t%.0f\t%.0f\t%.1fx\n"
+	 "ismember hit\t%.1f\t%.1f\t%.1f\t%.1f\t%.1fx\n"
+	 "ismember miss\t%.1f\t%.1f\t%.1f\t%.1f\t%.1fx\n"
+	 "union\t\t%.1f\t%.1f\t%.1f\t%.1f\t%.1fx\n", n,
+	 c.insert, huge.insert, incr.insert, cpp.insert, c.insert / cpp.insert,
+	 c.tail, huge.tail, incr.tail, cpp.tail, c.tail / cpp.tail,
+	 c.worst, huge.worst, incr.worst, cpp.worst, c.worst / cpp.worst,
+	 c.hit, huge.hit, incr.hit, cpp.hit, c.hit / cpp.hit,
+	 c.miss, huge.miss, incr.miss, cpp.miss, c.miss / cpp.miss,
+	 c.unite, huge.unite, incr.unite, cpp.unite, c.unite / cpp.unite);
+
+  churn_timings hashed = isolated(churn_hashed, n);
+  churn_timings compact = isolated(churn_compact, n);
+  churn_timings robin = isolated(churn_robin, n);
+  for (int round = 1; round < CONFIG_BENCH_ROUNDS; round++) {
+    churn_timings next = isolated(churn_hashed, n);
+    keep_best(&hashed, &next);
+    next = isolated(churn_compact, n);
+    keep_best(&compact, &next);
+    next = isolated(churn_robin, n);
+    keep_best(&robin, &next);
+  }
+
+  printf("\nchurn of %d integers, ns per operation\n"
+	 "\t\thashed\tcompact\trobin\n"
+	 "insert/remove\t%.1f\t%.1f\t%.1f\n"
+	 "ismember hit\t%.1f\t%.1f\t%.1f\n"
+	 "ismember miss\t%.1f\t%.1f\t%.1f\n"
+	 "mean probe\t\t\t%.2f\n", n,
+	 hashed.churn, compact.churn, robin.churn,
+	 hashed.hit, compact.hit, robin.hit,
+	 hashed.miss, compact.miss, robin.miss, robin.probe);
+  return 0;
+}
+
+/******************************************************************************
+ * LOCAL FUNCTIONS
+ ***/
+
+static int match_int(const void * one, const void * two)
+{
+  return *static_cast<const int *>(one) == *static_cast<const int *>(two);
+}
+
+static unsigned long hash_int(const void * data)
+{
+  return static_cast<unsigned long>(*static_cast<const int *>(data));
+}
+
+static void * copy_int(const void * data)
+{
+  int * copy = static_cast<int *>(malloc(sizeof(int)));
+  if (copy != NULL)
+    *copy = *static_cast<const int *>(data);
+  return copy;
+}
+
+/******************************************************************************
+ * FUNCTION:	    since
+ *
+ * DESCRIPTION:	    Measures the time per operation since a starting point.
+ *
+ * ARGUMENTS:	    start: (bench_clock::time_point) -- the starting point.
+ *		    operations: (long) -- the number of operations done.
+ *
+ * RETURN:	    double -- nanoseconds per operation.
+ *
+ * NOTES:	    none.
+ ***/
+static double since(bench_clock::time_point start, long operations)
+{
+  std::chrono::duration<double, std::nano> elapsed = bench_clock::now() - start;
+  return elapsed.count() / operations;
+}
+
+/******************************************************************************
+ * FUNCTION:	    percentiles
+ *
+ * DESCRIPTION:	    Finds the 99.9th percentile and the maximum of the
+ *		    latencies of single insertions.
+ *
+ * ARGUMENTS:	    samples: (std::vector<double> &) -- the latencies, in
+ *			nanoseconds. They are reordered.
+ *		    result: (timings *) -- receives them in `tail' and `worst'.
+ *
+ * RETURN:	    void.
+ *
+ * NOTES:	    O(n)
+ ***/
+static void percentiles(std::vector<double> & samples, timings * result)
+{
+  std::vector<double>::iterator tail = samples.begin()
+    + (long)(samples.size() * 999 / 1000);
+  std::nth_element(samples.begin(), tail, samples.end());
+  result->tail = *tail;
+  result->worst = *std::max_element(tail, samples.end());
+}
+
+/******************************************************************************
+ * FUNCTION:	    keep_best
+ *
+ * DESCRIPTION:	    Keeps the lower of each pair of times.
+ *
+ * ARGUMENTS:	    best: (timings *) -- the best times so far.
+ *		    next: (const timings *) -- the times of another round.
+ *
+ * RETURN:	    void.
+ *
+ * NOTES:	    none.
+ ***/
+static void keep_best(timings * best, const timings * next)
+{
+  best->insert = std::min(best->insert, next->insert);
+  best->hit = std::min(best->hit, next->hit);
+  best->miss = std::min(best->miss, next->miss);
+  best->unite = std::min(best->unite, next->unite);
+  best->tail = std::min(best->tail, next->tail);
+  best->worst = std::min(best->worst, next->worst);
+}
+
+static void keep_best(churn_timings * best, const churn_timings * next)
+{
+  best->churn = std::min(best->churn, next->churn);
+  best->hit = std::min(best->hit, next->hit);
+  best->miss = std::min(best->miss, next->miss);
+  best->probe = std::min(best->probe, next->probe);
+}
+
+/******************************************************************************
+ * FUNCTION:	    isolated
+ *
+ * DESCRIPTION:	    Runs a benchmark in a child process, so that it starts
+ *		    with a fresh heap. An implementation that runs after
+ *		    another has freed a million small blocks is otherwise
+ *		    slowed down several times by the allocator.
+ *
+ * ARGUMENTS:	    bench: (T (*)(int)) -- the benchmark.
+ *		    n: (int) -- its argument.
+ *
+ * RETURN:	    T -- the results. If the child cannot be started, the
+ *		    benchmark is run in this process.
+ *
+ * NOTES:	    The results come back through a pipe, so T must be a
+ *		    plain structure.
+ ***/
+template <typename T>
+static T isolated(T (*bench)(int), int n)
+{
+  int fds[2];
+  if (pipe(fds))
+    return bench(n);
+
+  pid_t child = fork();
+  if (child < 0) {
+    close(fds[0]);
+    close(fds[1]);
+    return bench(n);
+  }
+  if (child == 0) {
+    T result = bench(n);
+    ssize_t written = write(fds[1], &result, sizeof(T));
+    _exit(written == (ssize_t)sizeof(T) ? 0 : 1);
+  }
+
+  T result = T();
+  close(fds[1]);
+  if (read(fds[0], &result, sizeof(T)) != (ssize_t)sizeof(T))
+    result = bench(n);
+  close(fds[0]);
+  waitpid(child, NULL, 0);
+  return result;
+}
+
+/******************************************************************************
+ * FUNCTION:	    run_c
+ *
+ * DESCRIPTION:	    Times a hashed C set (set_create_hashed).
+ *
+ * ARGUMENTS:	    n: (int) -- the number of members.
+ *		    pages: (set_pages) -- the pages of its hash table.
+ *		    incremental: (int) -- whether it grows incrementally.
+ *
+ * RETURN:	    timings -- the results.
+ *
+ * NOTES:	    The members are scattered by multiplying with an odd
+ *		    constant, so that the order of insertion is not the order
+ *		    of the hashes. The latencies are taken in a pass of their
+ *		    own, so that reading the clock does not slow the others.
+ ***/
+static timings run_c(int n, set_pages pages, int incremental)
+{
+  timings result;
+  set * one = set_create_hashed(match_int, hash_int, copy_int, free);
+  set * two = set_create_hashed(match_int, hash_int, copy_int, free);
+  set * three = set_create_hashed(match_int, hash_int, copy_int, free);
+  set_use_hugepages(one, pages);
+  set_use_hugepages(two, pages);
+  set_use_hugepages(three, pages);
+  set_use_incremental(one, incremental);
+  set_use_incremental(two, incremental);
+  set_use_incremental(three, incremental);
+
+  bench_clock::time_point start = bench_clock::now();
+  for (int i = 0; i < n; i++) {
+    int key = (int)((unsigned)i * 2654435761u >> 1);
+    set_insert(one, copy_int(&key));
+  }
+  result.insert = since(start, n);
+
+  start = bench_clock::now();
+  for (int i = 0; i < n; i++) {
+    int key = (int)((unsigned)i * 2654435761u >> 1);
+    sink = sink + set_ismember(one, &key);
+  }
+  result.hit = since(start, n);
+
+  start = bench_clock::now();
+  for (int i = n; i < 2 * n; i++) {
+    int key = (int)((unsigned)i * 2654435761u >> 1);
+    sink = sink + set_ismember(one, &key);
+  }
+  result.miss = since(start, n);
+
+  for (int i = n / 2; i < n + n / 2; i++) {
+    int key = (int)((unsigned)i * 2654435761u >> 1);
+    set_insert(two, copy_int(&key));
+  }
+  /* set_union is a macro built on a compound literal, which is not C++. */
+  set * setu = NULL, * sets[] = {one, two, NULL};
+  start = bench_clock::now();
+  set_union_func(&setu, sets);
+  result.unite = since(start, set_size(one) + set_size(two));
+  sink = sink + set_size(setu);
+
+  std::vector<double> samples((size_t)n);
+  for (int i = 0; i < n; i++) {
+    int key = (int)((unsigned)i * 2654435761u >> 1);
+    int * copy = static_cast<int *>(copy_int(&key));
+    start = bench_clock::now();
+    set_insert(three, copy);
+    samples[(size_t)i] = since(start, 1);
+  }
+  percentiles(samples, &result);
+
+  set_destroy(&setu);
+  set_destroy(&one);
+  set_destroy(&two);
+  set_destroy(&three);
+  return result;
+}
+
+static timings bench_c(int n)
+{
+  return run_c(n, SET_PAGES_NORMAL, 0);
+}
+
+static timings bench_c_huge(int n)
+{
+  return run_c(n, SET_PAGES_TRANSPARENT, 0);
+}
+
+static timings bench_c_incremental(int n)
+{
+  return run_c(n, SET_PAGES_NORMAL, 1);
+}
+
+/******************************************************************************
+ * FUNCTION:	    bench_cpp
+ *
+ * DESCRIPTION:	    Times et::Set<int> with the same keys as bench_c.
+ *
+ * ARGUMENTS:	    n: (int) -- the number of members.
+ *
+ * RETURN:	    timings -- the results.
+ *
+ * NOTES:	    The union copies its first argument, as set_union does.
+ ***/
+static timings bench_cpp(int n)
+{
+  timings result;
+  et::Set<int> one, two, three;
+
+  bench_clock::time_point start = bench_clock::now();
+  for (int i = 0; i < n; i++)
+    one.insert((int)((unsigned)i * 2654435761u >> 1));
+  result.insert = since(start, n);
+
+  start = bench_clock::now();
+  for (int i = 0; i < n; i++)
+    sink = sink + one.contains((int)((unsigned)i * 2654435761u >> 1));
+  result.hit = since(start, n);
+
+  start = bench_clock::now();
+  for (int i = n; i < 2 * n; i++)
+    sink = sink + one.contains((int)((unsigned)i * 2654435761u >> 1));
+  result.miss = since(start, n);
+
+  for (int i = n / 2; i < n + n / 2; i++)
+    two.insert((int)((unsigned)i * 2654435761u >> 1));
+  start = bench_clock::now();
+  et::Set<int> setu = et::unite(one, two);
+  result.unite = since(start, (long)(one.size() + two.size()));
+  sink = sink + (long)setu.size();
+
+  std::vector<double> samples((size_t)n);
+  for (int i = 0; i < n; i++) {
+    int key = (int)((unsigned)i * 2654435761u >> 1);
+    start = bench_clock::now();
+    three.insert(key);
+    samples[(size_t)i] = since(start, 1);
+  }
+  percentiles(samples, &result);
+
+  return result;
+}
+
+/******************************************************************************
+ * FUNCTION:	    run_churn
+ *
+ * DESCRIPTION:	    Times a C set under churn. The set is filled, and then a
+ *		    window slides over the keys: each step inserts the next
+ *		    key and removes the oldest, so the size stays the same.
+ *		    Lookups of the keys in the window, and of those that have
+ *		    left it, are timed afterwards.
+ *
+ * ARGUMENTS:	    n: (int) -- the number of members.
+ *		    create: (set_creator) -- makes the set.
+ *
+ * RETURN:	    churn_timings -- the results.
+ *
+ * NOTES:	    The window slides over 2n keys, so every member is
+ *		    replaced twice. A set that leaves tombstones pays for
+ *		    them in the misses and in the rebuilds during the churn.
+ ***/
+static churn_timings run_churn(int n, set_creator create)
+{
+  churn_timings result = {0, 0, 0, 0};
+  set * group = create(match_int, hash_int, copy_int, free);
+  for (int i = 0; i < n; i++) {
+    int key = (int)((unsigned)i * 2654435761u >> 1);
+    set_insert(group, copy_int(&key));
+  }
+
+  bench_clock::time_point start = bench_clock::now();
+  for (int i = 0; i < 2 * n; i++) {
+    int key = (int)((unsigned)(i + n) * 2654435761u >> 1);
+    int old = (int)((unsigned)i * 2654435761u >> 1);
+    const void * pOld = &old;
+    set_insert(group, copy_int(&key));
+    set_remove(group, &pOld);
+  }
+  result.churn = since(start, 4L * n);
+
+  start = bench_clock::now();
+  for (int i = 2 * n; i < 3 * n; i++) {
+    int key = (int)((unsigned)i * 2654435761u >> 1);
+    sink = sink + set_ismember(group, &key);
+  }
+  result.hit = since(start, n);
+
+  start = bench_clock::now();
+  for (int i = 0; i < 2 * n; i++) {
+    int key = (int)((unsigned)i * 2654435761u >> 1);
+    sink = sink + set_ismember(group, &key);
+  }
+  result.miss = since(start, 2L * n);
+
+  robinset_stats stats;
+  if (set_robin_stats(group, &stats) == 0)
+    result.probe = stats.mean;
+
+  set_destroy(&group);
+  return result;
+}
+
+static churn_timings churn_hashed(int n)
+{
+  return run_churn(n, set_create_hashed);
+}
+
+static churn_timings churn_compact(int n)
+{
+  return run_churn(n, set_create_compact);
+}
+
+static churn_timings churn_robin(int n)
+{
+  return run_churn(n, set_create_robin);
+}
+
+/*****************************************************************************/
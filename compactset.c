@@ -0,0 +1,509 @@
+/******************************************************************************
+ * NAME:	    compactset.c
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    Source file containing the compact set engine, a hashed
+ *		    set that remembers the order of insertion. The members
+ *		    and their hashes are appended to a dense array of
+ *		    entries, and a separate index of small integers, probed
+ *		    linearly, maps a hash to its entry. The index holds
+ *		    1, 2, 4 or 8 byte slots, the fewest that can number the
+ *		    entries, so most of it fits in the cache. A removed member
+ *		    leaves a hole in the entries, and its slot is marked;
+ *		    both are dropped when the arrays are rebuilt.
+ *
+ * CREATED:	    10/17/2026
+ *
+ * LAST EDITED:	    10/17/2026
+ ***/
+
+/******************************************************************************
+ * INCLUDES
+ ***/
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "set.h"
+#include "setengine.h"
+
+/******************************************************************************
+ * MACRO DEFINITIONS
+ ***/
+
+/* The fewest slots in an index. */
+#define COMPACTSET_MIN_SLOTS 8
+
+/* Slot values: an entry is stored as its position plus SLOT_FIRST. */
+#define SLOT_EMPTY 0
+#define SLOT_DUMMY 1
+#define SLOT_FIRST 2
+
+/* An index of `slots' slots numbers at most two thirds as many entries. */
+#define capacity_of(slots) ((slots) / 3 * 2)
+
+/******************************************************************************
+ * TYPE DEFINITIONS
+ ***/
+
+typedef struct {
+
+  unsigned long hash;
+  void * data;
+
+} compactentry;
+
+/* The storage of a compact set. The first `used' entries are in order of
+ * insertion, and those with NULL data are holes. `dummies' is the number of
+ * marked slots in the index, which outlive the holes given back from the
+ * end of the entries. */
+typedef struct {
+
+  compactentry * entries;
+  long used;
+  long capacity;
+
+  void * index;
+  unsigned long mask;
+  long dummies;
+  int width;
+
+} compactstore;
+
+/******************************************************************************
+ * LOCAL PROTOTYPES
+ ***/
+
+static unsigned long mix(unsigned long);
+static unsigned long long get_slot(const compactstore *, unsigned long);
+static void set_slot(compactstore *, unsigned long, unsigned long long);
+static long find(const set *, const void *, unsigned long);
+static unsigned long free_slot(const compactstore *, unsigned long);
+static int rebuild(set *, long);
+static int gather(set *, int, set * [], int);
+
+static int compact_ismember(const set *, const void *);
+static int compact_insert(set *, void *);
+static void * compact_remove(set *, const void *);
+static void * compact_begin(const set *, set_iterator *);
+static void * compact_advance(const set *, set_iterator *);
+static void compact_clear(set *);
+static int compact_combine(set *, int, set * []);
+
+/******************************************************************************
+ * ENGINES
+ ***/
+
+const set_engine set_compact_engine = {
+  .name = "compact",
+  .ismember = compact_ismember,
+  .insert = compact_insert,
+  .remove = compact_remove,
+  .begin = compact_begin,
+  .advance = compact_advance,
+  .clear = compact_clear,
+  .combine = compact_combine
+};
+
+/******************************************************************************
+ * LOCAL FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:	    mix
+ *
+ * DESCRIPTION:	    Scrambles the bits of a user hash, so that functions like
+ *		    the identity on small integers still spread evenly over a
+ *		    power-of-two index.
+ *
+ * ARGUMENTS:	    hash: (unsigned long) -- the user hash.
+ *
+ * RETURN:	    unsigned long -- the mixed hash.
+ *
+ * NOTES:	    This is the finalizer of MurmurHash3, as in hashtable.c.
+ ***/
+static unsigned long mix(unsigned long hash)
+{
+  unsigned long long h = hash;
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return (unsigned long)h;
+}
+
+/* Reads slot i of the index. */
+static unsigned long long get_slot(const compactstore * store,
+				   unsigned long i)
+{
+  switch (store->width) {
+  case 1: return ((const uint8_t *)store->index)[i];
+  case 2: return ((const uint16_t *)store->index)[i];
+  case 4: return ((const uint32_t *)store->index)[i];
+  default: return ((const uint64_t *)store->index)[i];
+  }
+}
+
+/* Writes slot i of the index. */
+static void set_slot(compactstore * store, unsigned long i,
+		     unsigned long long value)
+{
+  switch (store->width) {
+  case 1: ((uint8_t *)store->index)[i] = (uint8_t)value; break;
+  case 2: ((uint16_t *)store->index)[i] = (uint16_t)value; break;
+  case 4: ((uint32_t *)store->index)[i] = (uint32_t)value; break;
+  default: ((uint64_t *)store->index)[i] = (uint64_t)value; break;
+  }
+}
+
+/******************************************************************************
+ * FUNCTION:	    find
+ *
+ * DESCRIPTION:	    Finds the slot of the index that holds a member.
+ *
+ * ARGUMENTS:	    group: (const set *) -- a set with storage.
+ *		    data: (const void *) -- the data to look for.
+ *		    hash: (unsigned long) -- the hash of `data'.
+ *
+ * RETURN:	    long -- the slot, or -1 if `data' is not a member.
+ *
+ * NOTES:	    O(1) expected. Marked slots are probed past, and match is
+ *		    only called on entries with the same hash.
+ ***/
+static long find(const set * group, const void * data, unsigned long hash)
+{
+  const compactstore * store = group->storage;
+  for (unsigned long i = mix(hash) & store->mask;;
+       i = (i + 1) & store->mask) {
+    unsigned long long slot = get_slot(store, i);
+    if (slot == SLOT_EMPTY)
+      return -1;
+    if (slot == SLOT_DUMMY)
+      continue;
+
+    const compactentry * entry = &store->entries[slot - SLOT_FIRST];
+    if (entry->hash == hash && set_matches(group, entry->data, data))
+      return (long)i;
+  }
+}
+
+/* Returns the first empty or marked slot on the probe sequence of a hash. */
+static unsigned long free_slot(const compactstore * store, unsigned long hash)
+{
+  unsigned long i = mix(hash) & store->mask;
+  while (get_slot(store, i) >= SLOT_FIRST)
+    i = (i + 1) & store->mask;
+  return i;
+}
+
+/******************************************************************************
+ * FUNCTION:	    rebuild
+ *
+ * DESCRIPTION:	    Moves the members of a set, in order, into new arrays of
+ *		    entries and index with room for `room' entries, dropping
+ *		    the holes and the marked slots.
+ *
+ * ARGUMENTS:	    group: (set *) -- the set to be operated on.
+ *		    room: (long) -- the entries to make room for, at least the
+ *			size of the set.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise. On failure the set is
+ *		    left unchanged.
+ *
+ * NOTES:	    O(n)
+ ***/
+static int rebuild(set * group, long room)
+{
+  unsigned long slots = COMPACTSET_MIN_SLOTS;
+  while ((long)capacity_of(slots) < room)
+    slots <<= 1;
+
+  compactstore * old = group->storage, * store = NULL;
+  if ((store = malloc(sizeof(compactstore))) == NULL)
+    return -1;
+
+  int width = 8;
+  if (capacity_of(slots) + SLOT_FIRST <= UINT8_MAX)
+    width = 1;
+  else if (capacity_of(slots) + SLOT_FIRST <= UINT16_MAX)
+    width = 2;
+  else if (capacity_of(slots) + SLOT_FIRST <= UINT32_MAX)
+    width = 4;
+
+  *store = (compactstore){
+    .entries = malloc(capacity_of(slots) * sizeof(compactentry)),
+    .used = 0,
+    .capacity = (long)capacity_of(slots),
+    .index = calloc(slots, width),
+    .mask = slots - 1,
+    .dummies = 0,
+    .width = width
+  };
+  if (store->entries == NULL || store->index == NULL) {
+    free(store->entries);
+    free(store->index);
+    free(store);
+    return -1;
+  }
+
+  for (long i = 0; old != NULL && i < old->used; i++) {
+    if (old->entries[i].data == NULL)
+      continue;
+    store->entries[store->used] = old->entries[i];
+    set_slot(store, free_slot(store, old->entries[i].hash),
+	     store->used + SLOT_FIRST);
+    store->used++;
+  }
+
+  if (old != NULL) {
+    free(old->entries);
+    free(old->index);
+    free(old);
+  }
+  group->storage = store;
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    gather
+ *
+ * DESCRIPTION:	    combine of a compact set. Each candidate is looked up in
+ *		    the other sets, and inserted if it is found in enough of
+ *		    them.
+ *
+ * ARGUMENTS:	    setk: (set *) -- the empty result.
+ *		    k: (int) -- the threshold.
+ *		    sets: (set * []) -- the sets.
+ *		    n: (int) -- the number of sets.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    O(Nn) lookups. A candidate from set i that is in an earlier
+ *		    set has been counted already. The candidates are visited
+ *		    set by set, in the order of each, so the result keeps the
+ *		    order in which its members first appear.
+ ***/
+static int gather(set * setk, int k, set * sets[], int n)
+{
+  for (int i = 0; i <= n - k; i++) {
+    set_iterator iterator;
+    for (void * data = set_begin(sets[i], &iterator); data != NULL;
+	 data = set_advance(sets[i], &iterator)) {
+      int count = 1, seen = 0;
+      for (int j = 0; j < n && !seen; j++) {
+	if (j != i && set_ismember(sets[j], data)) {
+	  seen = j < i;
+	  count++;
+	}
+      }
+      if (seen || count < k)
+	continue;
+
+      void * copy = NULL;
+      if ((copy = setk->copy(data)) == NULL)
+	return -1;
+      if (compact_insert(setk, copy)) {
+	if (setk->destroy != NULL)
+	  setk->destroy(copy);
+	return -1;
+      }
+    }
+  }
+
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    compact_ismember
+ *
+ * DESCRIPTION:	    ismember primitive of the compact engine.
+ *
+ * ARGUMENTS:	    group: (const set *) -- the set to be operated on.
+ *		    data: (const void *) -- data to check.
+ *
+ * RETURN:	    int -- 1 if the member is in the set, 0 if it is not.
+ *
+ * NOTES:	    O(1) expected.
+ ***/
+static int compact_ismember(const set * group, const void * data)
+{
+  if (group->storage == NULL)
+    return 0;
+  return find(group, data, set_hashof(group, data)) >= 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    compact_insert
+ *
+ * DESCRIPTION:	    insert primitive of the compact engine. The member is
+ *		    appended to the entries.
+ *
+ * ARGUMENTS:	    group: (set *) -- the set to be operated on.
+ *		    data: (void *) -- data to insert.
+ *
+ * RETURN:	    int -- 0 if successful, 1 if the data is already contained
+ *		    in the set, -1 otherwise.
+ *
+ * NOTES:	    O(1) amortized. When the entries are used up, or the
+ *		    members and marked slots fill the index to its load
+ *		    limit, the set is rebuilt with room for twice its members.
+ ***/
+static int compact_insert(set * group, void * data)
+{
+  unsigned long hash = set_hashof(group, data);
+  if (group->storage != NULL && find(group, data, hash) >= 0)
+    return 1;
+
+  compactstore * store = group->storage;
+  if ((store == NULL || store->used == store->capacity
+       || (long)group->size + store->dummies >= store->capacity)
+      && rebuild(group, 2 * (long)group->size + 1))
+    return -1;
+
+  store = group->storage;
+  store->entries[store->used] = (compactentry){.hash = hash, .data = data};
+  unsigned long i = free_slot(store, hash);
+  if (get_slot(store, i) == SLOT_DUMMY)
+    store->dummies--;
+  set_slot(store, i, store->used + SLOT_FIRST);
+  store->used++;
+  group->size++;
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    compact_remove
+ *
+ * DESCRIPTION:	    remove primitive of the compact engine. The entry becomes
+ *		    a hole, and its slot is marked, so the order of the other
+ *		    members is kept.
+ *
+ * ARGUMENTS:	    group: (set *) -- the set to be operated on.
+ *		    data: (const void *) -- data to remove.
+ *
+ * RETURN:	    void * -- the data of the removed member, or NULL.
+ *
+ * NOTES:	    O(1) amortized. Holes at the end of the entries are given
+ *		    back at once, and a set that has shrunk to an eighth of
+ *		    its entries is rebuilt smaller.
+ ***/
+static void * compact_remove(set * group, const void * data)
+{
+  long i = -1;
+  if (group->storage == NULL
+      || (i = find(group, data, set_hashof(group, data))) < 0)
+    return NULL;
+
+  compactstore * store = group->storage;
+  compactentry * entry = &store->entries[get_slot(store, i) - SLOT_FIRST];
+  void * old = entry->data;
+  entry->data = NULL;
+  set_slot(store, i, SLOT_DUMMY);
+  store->dummies++;
+  group->size--;
+
+  while (store->used > 0 && store->entries[store->used - 1].data == NULL)
+    store->used--;
+  if (store->capacity > capacity_of(COMPACTSET_MIN_SLOTS)
+      && group->size < store->capacity / 8)
+    rebuild(group, 2 * (long)group->size);
+  return old;
+}
+
+/******************************************************************************
+ * FUNCTION:	    compact_begin
+ *
+ * DESCRIPTION:	    begin primitive of the compact engine.
+ *
+ * ARGUMENTS:	    group: (const set *) -- the set to be operated on.
+ *		    iterator: (set_iterator *) -- will contain the position.
+ *
+ * RETURN:	    void * -- the data of the first member, or NULL.
+ *
+ * NOTES:	    O(1) amortized.
+ ***/
+static void * compact_begin(const set * group, set_iterator * iterator)
+{
+  iterator->node = NULL;
+  iterator->index = -1;
+  return compact_advance(group, iterator);
+}
+
+/******************************************************************************
+ * FUNCTION:	    compact_advance
+ *
+ * DESCRIPTION:	    advance primitive of the compact engine. The entries are
+ *		    read in order, skipping the holes, so members come in the
+ *		    order they were inserted.
+ *
+ * ARGUMENTS:	    group: (const set *) -- the set to be operated on.
+ *		    iterator: (set_iterator *) -- the current position.
+ *
+ * RETURN:	    void * -- the data of the next member, or NULL.
+ *
+ * NOTES:	    O(1) amortized.
+ ***/
+static void * compact_advance(const set * group, set_iterator * iterator)
+{
+  const compactstore * store = group->storage;
+  if (store == NULL)
+    return NULL;
+
+  while (++iterator->index < store->used)
+    if (store->entries[iterator->index].data != NULL)
+      return store->entries[iterator->index].data;
+  return NULL;
+}
+
+/******************************************************************************
+ * FUNCTION:	    compact_clear
+ *
+ * DESCRIPTION:	    clear primitive of the compact engine.
+ *
+ * ARGUMENTS:	    group: (set *) -- the set to be operated on.
+ *
+ * RETURN:	    void.
+ *
+ * NOTES:	    O(n)
+ ***/
+static void compact_clear(set * group)
+{
+  compactstore * store = group->storage;
+  if (store != NULL) {
+    for (long i = 0; i < store->used && group->destroy != NULL; i++)
+      if (store->entries[i].data != NULL)
+	group->destroy(store->entries[i].data);
+    free(store->entries);
+    free(store->index);
+    free(store);
+    group->storage = NULL;
+  }
+
+  group->size = 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    compact_combine
+ *
+ * DESCRIPTION:	    combine primitive of the compact engine, which keeps the
+ *		    order of the members in the result.
+ *
+ * ARGUMENTS:	    setk: (set *) -- the empty result, like sets[0].
+ *		    k: (int) -- the threshold.
+ *		    sets: (set * []) -- NULL terminated array of sets.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    See gather.
+ ***/
+static int compact_combine(set * setk, int k, set * sets[])
+{
+  int n = 0;
+  while (sets[n] != NULL)
+    n++;
+  return gather(setk, k, sets, n);
+}
+
+/*****************************************************************************/
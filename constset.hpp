@@ -0,0 +1,281 @@
+/******************************************************************************
+ * NAME:	    constset.hpp
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    Header-only compile-time sets, for small static tables
+ *		    such as keywords or opcodes. et::ConstSet<T, N> is built
+ *		    from a list of keys by a constexpr constructor, so a table
+ *		    declared constexpr is laid out by the compiler: there is no
+ *		    initialization at startup and nothing on the heap, and a
+ *		    lookup of a constant key is folded to a constant. The
+ *		    table is a perfect hash, built by hash-and-displace as in
+ *		    frozenset.c: every key has its own slot, so a lookup is one
+ *		    hash and one comparison. index_of gives the position of a
+ *		    key in the list, to map keywords to tokens.
+ *
+ * CREATED:	    10/17/2026
+ *
+ * LAST EDITED:	    10/17/2026
+ ***/
+
+#ifndef __ET_CONSTSET_HPP__
+#define __ET_CONSTSET_HPP__
+
+/******************************************************************************
+ * INCLUDES
+ ***/
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+namespace et {
+
+/******************************************************************************
+ * CONFIGURATION
+ ***/
+
+/* A bucket for which no pilot below CONFIG_CONSTSET_MAX_PILOT is found makes
+ * the build restart with a new seed; after CONFIG_CONSTSET_SEEDS seeds it
+ * fails, which is a compile error for a constexpr set. */
+#ifndef CONFIG_CONSTSET_MAX_PILOT
+#   define CONFIG_CONSTSET_MAX_PILOT (1u << 16)
+#endif
+
+#ifndef CONFIG_CONSTSET_SEEDS
+#   define CONFIG_CONSTSET_SEEDS 16
+#endif
+
+/******************************************************************************
+ * TYPE DEFINITIONS
+ ***/
+
+/* std::hash is not constexpr, so ConstSet hashes with these by default. Keys
+ * of other types need a Hash of their own, with a constexpr operator(). */
+template <class T, class Enable = void>
+struct const_hash;
+
+template <class T>
+struct const_hash<T, std::enable_if_t<std::is_integral_v<T>
+				      || std::is_enum_v<T>>> {
+  constexpr std::uint64_t operator()(T key) const
+  {
+    return static_cast<std::uint64_t>(key);
+  }
+};
+
+/* FNV-1a. */
+template <>
+struct const_hash<std::string_view> {
+  constexpr std::uint64_t operator()(std::string_view key) const
+  {
+    std::uint64_t h = 14695981039346656037ULL;
+    for (char c : key)
+      h = (h ^ static_cast<unsigned char>(c)) * 1099511628211ULL;
+    return h;
+  }
+};
+
+/* The keys are hashed with a seed, into `buckets' buckets of about two keys,
+ * and the pilot of a bucket sends each of its keys to a free slot among
+ * `capacity'. Slots that hold no key are marked in `used'. */
+template <class T, std::size_t N, class Hash = const_hash<T>,
+	  class Eq = std::equal_to<T>>
+class ConstSet {
+
+public:
+
+  static constexpr std::size_t capacity = N + N / 4 + 1;
+  static constexpr std::size_t buckets = N / 2 + 1;
+
+  constexpr explicit ConstSet(const T (&keys)[N], const Hash & hash = Hash(),
+			      const Eq & eq = Eq())
+    : hash(hash), eq(eq)
+  {
+    build(keys);
+  }
+
+  constexpr explicit ConstSet(const std::array<T, N> & keys,
+			      const Hash & hash = Hash(), const Eq & eq = Eq())
+    : hash(hash), eq(eq)
+  {
+    build(keys);
+  }
+
+  constexpr std::size_t size() const { return N; }
+  constexpr bool empty() const { return N == 0; }
+
+  constexpr bool contains(const T & key) const { return index_of(key) >= 0; }
+
+  /****************************************************************************
+   * FUNCTION:	    index_of
+   *
+   * DESCRIPTION:   Finds the position of a key in the list the set was built
+   *		    from.
+   *
+   * ARGUMENTS:	    key: (const T &) -- the key.
+   *
+   * RETURN:	    long -- the position, or -1 if the key is not a member.
+   *
+   * NOTES:	    O(1): one hash, and one comparison.
+   ***/
+  constexpr long index_of(const T & key) const
+  {
+    std::uint64_t h = hash_of(key);
+    std::size_t slot = position(h, pilots[bucket(h)]);
+    return used[slot] && eq(slots[slot], key) ? static_cast<long>(order[slot])
+      : -1;
+  }
+
+private:
+
+  static constexpr std::uint64_t mix(std::uint64_t h)
+  {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+  }
+
+  constexpr std::uint64_t hash_of(const T & key) const
+  {
+    return mix(static_cast<std::uint64_t>(hash(key)) ^ seed);
+  }
+
+  /* Both map 32 bits of the hash onto [0, n) with a multiply. */
+  static constexpr std::size_t bucket(std::uint64_t h)
+  {
+    return static_cast<std::size_t>((h >> 32) * buckets >> 32);
+  }
+
+  static constexpr std::size_t position(std::uint64_t h, std::uint32_t pilot)
+  {
+    return static_cast<std::size_t>(((h ^ mix(pilot)) & 0xffffffffULL)
+				    * capacity >> 32);
+  }
+
+  template <class Keys>
+  constexpr void build(const Keys & keys)
+  {
+    for (std::uint64_t attempt = 1; attempt <= CONFIG_CONSTSET_SEEDS;
+	 attempt++) {
+      seed = mix(attempt * 0x9e3779b97f4a7c15ULL);
+      if (place(keys))
+	return;
+    }
+    throw std::logic_error("et::ConstSet: no perfect hash was found");
+  }
+
+  /****************************************************************************
+   * FUNCTION:	    place
+   *
+   * DESCRIPTION:   Tries to find a pilot for every bucket with the current
+   *		    seed, largest buckets first.
+   *
+   * ARGUMENTS:	    keys: (const Keys &) -- the N keys.
+   *
+   * RETURN:	    bool -- true if every key was given a slot.
+   *
+   * NOTES:	    O(N) expected. Throws if two keys are equal, or distinct
+   *		    keys have the same hash, since no seed can tell them apart.
+   ***/
+  template <class Keys>
+  constexpr bool place(const Keys & keys)
+  {
+    std::array<std::uint64_t, N> hashes{};
+    std::array<std::size_t, buckets + 1> start{};
+    std::array<std::size_t, N> sorted{};
+    std::size_t largest = 0;
+    for (std::size_t i = 0; i < N; i++) {
+      hashes[i] = hash_of(keys[i]);
+      start[bucket(hashes[i]) + 1]++;
+    }
+    for (std::size_t b = 0; b < buckets; b++) {
+      largest = start[b + 1] > largest ? start[b + 1] : largest;
+      start[b + 1] += start[b];
+    }
+    std::array<std::size_t, buckets + 1> fill = start;
+    for (std::size_t i = 0; i < N; i++)
+      sorted[fill[bucket(hashes[i])]++] = i;
+
+    for (std::size_t i = 0; i < capacity; i++)
+      used[i] = false;
+
+    for (std::size_t size = largest; size > 0; size--) {
+      for (std::size_t b = 0; b < buckets; b++) {
+	if (start[b + 1] - start[b] != size)
+	  continue;
+
+	for (std::size_t x = start[b]; x < start[b + 1]; x++)
+	  for (std::size_t y = start[b]; y < x; y++)
+	    if (hashes[sorted[x]] == hashes[sorted[y]])
+	      throw std::logic_error(eq(keys[sorted[x]], keys[sorted[y]])
+				     ? "et::ConstSet: duplicate key"
+				     : "et::ConstSet: keys with equal hashes");
+
+	std::uint32_t pilot = 0;
+	for (; pilot < CONFIG_CONSTSET_MAX_PILOT; pilot++) {
+	  bool fits = true;
+	  for (std::size_t x = start[b]; x < start[b + 1] && fits; x++) {
+	    std::size_t slot = position(hashes[sorted[x]], pilot);
+	    fits = !used[slot];
+	    for (std::size_t y = start[b]; y < x && fits; y++)
+	      fits = position(hashes[sorted[y]], pilot) != slot;
+	  }
+	  if (fits)
+	    break;
+	}
+	if (pilot == CONFIG_CONSTSET_MAX_PILOT)
+	  return false;
+
+	pilots[b] = pilot;
+	for (std::size_t x = start[b]; x < start[b + 1]; x++) {
+	  std::size_t slot = position(hashes[sorted[x]], pilot);
+	  used[slot] = true;
+	  slots[slot] = keys[sorted[x]];
+	  order[slot] = sorted[x];
+	}
+      }
+    }
+
+    return true;
+  }
+
+  Hash hash;
+  Eq eq;
+  std::uint64_t seed = 0;
+  std::array<std::uint32_t, buckets> pilots{};
+  std::array<T, capacity> slots{};
+  std::array<bool, capacity> used{};
+  std::array<std::size_t, capacity> order{};
+
+};
+
+/******************************************************************************
+ * API FUNCTIONS
+ ***/
+
+/* Builds a set from a braced list, whose length is deduced:
+ *	constexpr auto keywords = et::make_const_set<std::string_view>({
+ *	  "if", "else", "while"
+ *	});
+ */
+template <class T, class Hash = const_hash<T>, class Eq = std::equal_to<T>,
+	  std::size_t N>
+constexpr ConstSet<T, N, Hash, Eq> make_const_set(const T (&keys)[N])
+{
+  return ConstSet<T, N, Hash, Eq>(keys);
+}
+
+} /* namespace et */
+
+#endif /* __ET_CONSTSET_HPP__ */
+
+/*****************************************************************************/
@@ -0,0 +1,370 @@
+/******************************************************************************
+ * NAME:	    cuckoofilter.c
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    Source file containing code for implementing a cuckoo
+ *		    filter, after Fan et al., "Cuckoo Filter: Practically
+ *		    Better Than Bloom". Each hash is reduced to a fingerprint
+ *		    that may live in either of two buckets, the second found
+ *		    from the first and the fingerprint alone, so fingerprints
+ *		    can be moved between their buckets to make room without
+ *		    knowing the hash they came from. With four slots a bucket
+ *		    the filter fills to about 95%, and the false positive rate
+ *		    is about 8 / 65536. This code follows the typedefs and
+ *		    prototypes in cuckoofilter.h.
+ *
+ * CREATED:	    10/17/2026
+ *
+ * LAST EDITED:	    10/17/2026
+ ***/
+
+/******************************************************************************
+ * INCLUDES
+ ***/
+
+#include <stdlib.h>
+
+#include "cuckoofilter.h"
+
+/******************************************************************************
+ * MACRO DEFINITIONS
+ ***/
+
+/* The number of fingerprints moved to make room for a new one before it is
+ * put in the stash. */
+#define CUCKOOFILTER_MAX_KICKS 500
+
+#define bucket_of(filter, i)				\
+  (&(filter)->slots[(i) * CONFIG_CUCKOOFILTER_SLOTS])
+#define alternate(filter, i, fp) (((i) ^ mix(fp)) & ((filter)->buckets - 1))
+
+/******************************************************************************
+ * LOCAL PROTOTYPES
+ ***/
+
+static unsigned long mix(unsigned long long);
+static void split(const cuckoofilter *, unsigned long, unsigned long *,
+		  unsigned short *);
+static int put(cuckoofilter *, unsigned long, unsigned short);
+static int take(cuckoofilter *, unsigned long, unsigned short);
+static int place(cuckoofilter *, unsigned long, unsigned short);
+
+/******************************************************************************
+ * API FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:	    cuckoofilter_create
+ *
+ * DESCRIPTION:	    Creates an empty filter.
+ *
+ * ARGUMENTS:	    capacity: (unsigned long) -- the number of hashes the
+ *			filter should be able to hold.
+ *
+ * RETURN:	    (cuckoofilter *) -- pointer to the new filter, or NULL.
+ *
+ * NOTES:	    O(capacity). The number of buckets is a power of two, so
+ *		    the filter may hold up to twice as many hashes as asked.
+ ***/
+cuckoofilter * cuckoofilter_create(unsigned long capacity)
+{
+  unsigned long buckets = 2;
+  while (buckets * CONFIG_CUCKOOFILTER_SLOTS * 19 < capacity * 20)
+    buckets <<= 1;
+
+  cuckoofilter * filter = NULL;
+  if ((filter = malloc(sizeof(cuckoofilter))) == NULL)
+    return NULL;
+
+  *filter = (cuckoofilter){
+    .count = 0,
+    .buckets = buckets,
+    .slots = NULL,
+    .stashed = 0,
+    .stash_bucket = 0,
+    .stash = 0,
+    .random = 0x2545f4914f6cdd1dUL
+  };
+
+  if ((filter->slots = calloc(buckets * CONFIG_CUCKOOFILTER_SLOTS,
+			      sizeof(unsigned short))) == NULL) {
+    free(filter);
+    return NULL;
+  }
+
+  return filter;
+}
+
+/******************************************************************************
+ * FUNCTION:	    cuckoofilter_destroy
+ *
+ * DESCRIPTION:	    Frees the filter.
+ *
+ * ARGUMENTS:	    filter: (cuckoofilter **) -- the filter to be operated on.
+ *
+ * RETURN:	    void.
+ *
+ * NOTES:	    O(1)
+ ***/
+void cuckoofilter_destroy(cuckoofilter ** filter)
+{
+  if (filter == NULL || *filter == NULL)
+    return;
+
+  free((*filter)->slots);
+  free(*filter);
+  *filter = NULL;
+}
+
+/******************************************************************************
+ * FUNCTION:	    cuckoofilter_insert
+ *
+ * DESCRIPTION:	    Adds a hash to the filter.
+ *
+ * ARGUMENTS:	    filter: (cuckoofilter *) -- the filter to be operated on.
+ *		    hash: (unsigned long) -- the hash to add.
+ *
+ * RETURN:	    int -- 0 if successful, -1 if the filter is full.
+ *
+ * NOTES:	    O(1) amortized. A filter is a multiset: adding a hash twice
+ *		    stores two fingerprints, and both must be removed. When
+ *		    the filter is full, a bigger one must be built.
+ ***/
+int cuckoofilter_insert(cuckoofilter * filter, unsigned long hash)
+{
+  if (filter == NULL || filter->stashed)
+    return -1;
+
+  unsigned long i = 0;
+  unsigned short fp = 0;
+  split(filter, hash, &i, &fp);
+  place(filter, i, fp);
+  filter->count++;
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    cuckoofilter_remove
+ *
+ * DESCRIPTION:	    Removes a hash from the filter.
+ *
+ * ARGUMENTS:	    filter: (cuckoofilter *) -- the filter to be operated on.
+ *		    hash: (unsigned long) -- the hash to remove. It must have
+ *			been added; removing any other hash may remove the
+ *			fingerprint of a different one.
+ *
+ * RETURN:	    int -- 0 if successful, -1 if the hash is not found.
+ *
+ * NOTES:	    O(1). Freeing a slot makes room for the stash, if any.
+ ***/
+int cuckoofilter_remove(cuckoofilter * filter, unsigned long hash)
+{
+  if (filter == NULL)
+    return -1;
+
+  unsigned long i = 0;
+  unsigned short fp = 0;
+  split(filter, hash, &i, &fp);
+  unsigned long j = alternate(filter, i, fp);
+
+  if (filter->stashed && filter->stash == fp
+      && (filter->stash_bucket == i || filter->stash_bucket == j)) {
+    filter->stashed = 0;
+  } else if (take(filter, i, fp) && take(filter, j, fp)) {
+    return -1;
+  } else if (filter->stashed) {
+    filter->stashed = 0;
+    place(filter, filter->stash_bucket, filter->stash);
+  }
+
+  filter->count--;
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    cuckoofilter_contains
+ *
+ * DESCRIPTION:	    Determines if a hash may have been added to the filter.
+ *
+ * ARGUMENTS:	    filter: (const cuckoofilter *) -- the filter to check.
+ *		    hash: (unsigned long) -- the hash to look for.
+ *
+ * RETURN:	    int -- 0 if the hash is definitely not in the filter, 1 if
+ *		    it probably is.
+ *
+ * NOTES:	    O(1). Reads two buckets, without branching on their
+ *		    contents.
+ ***/
+int cuckoofilter_contains(const cuckoofilter * filter, unsigned long hash)
+{
+  if (filter == NULL)
+    return 0;
+
+  unsigned long i = 0;
+  unsigned short fp = 0;
+  split(filter, hash, &i, &fp);
+  unsigned long j = alternate(filter, i, fp);
+
+  const unsigned short * one = bucket_of(filter, i);
+  const unsigned short * two = bucket_of(filter, j);
+  int found = 0;
+  for (int k = 0; k < CONFIG_CUCKOOFILTER_SLOTS; k++)
+    found |= (one[k] == fp) | (two[k] == fp);
+
+  return found || (filter->stashed && filter->stash == fp
+		   && (filter->stash_bucket == i || filter->stash_bucket == j));
+}
+
+/******************************************************************************
+ * LOCAL FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:	    mix
+ *
+ * DESCRIPTION:	    Scrambles the bits of a 64-bit value.
+ *
+ * ARGUMENTS:	    h: (unsigned long long) -- the value.
+ *
+ * RETURN:	    unsigned long -- the mixed value.
+ *
+ * NOTES:	    This is the finalizer of MurmurHash3.
+ ***/
+static unsigned long mix(unsigned long long h)
+{
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return (unsigned long)h;
+}
+
+/******************************************************************************
+ * FUNCTION:	    split
+ *
+ * DESCRIPTION:	    Derives the first bucket and the fingerprint of a hash.
+ *
+ * ARGUMENTS:	    filter: (const cuckoofilter *) -- the filter.
+ *		    hash: (unsigned long) -- the user hash.
+ *		    i: (unsigned long *) -- will contain the bucket.
+ *		    fp: (unsigned short *) -- will contain the fingerprint,
+ *			which is never 0.
+ *
+ * RETURN:	    void.
+ *
+ * NOTES:	    The hash is mixed first, so weak hashes like the identity
+ *		    on integers still spread over the buckets.
+ ***/
+static void split(const cuckoofilter * filter, unsigned long hash,
+		  unsigned long * i, unsigned short * fp)
+{
+  unsigned long long h = mix(hash);
+  *i = (unsigned long)h & (filter->buckets - 1);
+  *fp = (unsigned short)(h >> 48);
+  if (*fp == 0)
+    *fp = 1;
+}
+
+/******************************************************************************
+ * FUNCTION:	    put
+ *
+ * DESCRIPTION:	    Stores a fingerprint in a free slot of a bucket.
+ *
+ * ARGUMENTS:	    filter: (cuckoofilter *) -- the filter.
+ *		    i: (unsigned long) -- the bucket.
+ *		    fp: (unsigned short) -- the fingerprint.
+ *
+ * RETURN:	    int -- 0 if successful, -1 if the bucket is full.
+ *
+ * NOTES:	    O(1)
+ ***/
+static int put(cuckoofilter * filter, unsigned long i, unsigned short fp)
+{
+  unsigned short * slots = bucket_of(filter, i);
+  for (int k = 0; k < CONFIG_CUCKOOFILTER_SLOTS; k++) {
+    if (slots[k] == 0) {
+      slots[k] = fp;
+      return 0;
+    }
+  }
+
+  return -1;
+}
+
+/******************************************************************************
+ * FUNCTION:	    take
+ *
+ * DESCRIPTION:	    Clears one slot of a bucket holding a fingerprint.
+ *
+ * ARGUMENTS:	    filter: (cuckoofilter *) -- the filter.
+ *		    i: (unsigned long) -- the bucket.
+ *		    fp: (unsigned short) -- the fingerprint.
+ *
+ * RETURN:	    int -- 0 if successful, -1 if the bucket does not hold it.
+ *
+ * NOTES:	    O(1)
+ ***/
+static int take(cuckoofilter * filter, unsigned long i, unsigned short fp)
+{
+  unsigned short * slots = bucket_of(filter, i);
+  for (int k = 0; k < CONFIG_CUCKOOFILTER_SLOTS; k++) {
+    if (slots[k] == fp) {
+      slots[k] = 0;
+      return 0;
+    }
+  }
+
+  return -1;
+}
+
+/******************************************************************************
+ * FUNCTION:	    place
+ *
+ * DESCRIPTION:	    Stores a fingerprint in either of its buckets, moving
+ *		    other fingerprints to their alternate buckets to make room
+ *		    if both are full.
+ *
+ * ARGUMENTS:	    filter: (cuckoofilter *) -- the filter, with an empty
+ *			stash.
+ *		    i: (unsigned long) -- one of the buckets of `fp'.
+ *		    fp: (unsigned short) -- the fingerprint.
+ *
+ * RETURN:	    int -- 0 if the fingerprint was stored, 1 if the last one
+ *		    to be moved ended up in the stash.
+ *
+ * NOTES:	    O(CUCKOOFILTER_MAX_KICKS). The victims are chosen with a
+ *		    xorshift generator, so that the moves cannot cycle.
+ ***/
+static int place(cuckoofilter * filter, unsigned long i, unsigned short fp)
+{
+  if (put(filter, i, fp) == 0)
+    return 0;
+  i = alternate(filter, i, fp);
+  if (put(filter, i, fp) == 0)
+    return 0;
+
+  for (int kick = 0; kick < CUCKOOFILTER_MAX_KICKS; kick++) {
+    filter->random ^= filter->random << 13;
+    filter->random ^= filter->random >> 7;
+    filter->random ^= filter->random << 17;
+
+    unsigned short * victim = bucket_of(filter, i)
+      + filter->random % CONFIG_CUCKOOFILTER_SLOTS;
+    unsigned short evicted = *victim;
+    *victim = fp;
+    fp = evicted;
+
+    i = alternate(filter, i, fp);
+    if (put(filter, i, fp) == 0)
+      return 0;
+  }
+
+  filter->stashed = 1;
+  filter->stash_bucket = i;
+  filter->stash = fp;
+  return 1;
+}
+
+/*****************************************************************************/
@@ -0,0 +1,71 @@
+/******************************************************************************
+ * NAME:	    cuckoofilter.h
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    The header file for the implementation of a cuckoo filter,
+ *		    an approximate set of hashes. It answers "definitely not a
+ *		    member" or "probably a member", and unlike a Bloom filter
+ *		    it supports removal. A filter can be used on its own, or
+ *		    attached to a hashed set with set_attach_filter (set.h),
+ *		    which keeps it in sync with the members and consults it
+ *		    before every exact lookup.
+ *
+ * CREATED:	    10/17/2026
+ *
+ * LAST EDITED:	    10/17/2026
+ ***/
+
+#ifndef __ET_CUCKOOFILTER_H__
+#define __ET_CUCKOOFILTER_H__
+
+/******************************************************************************
+ * CONFIGURATION
+ ***/
+
+/* The number of fingerprints in a bucket. */
+#ifndef CONFIG_CUCKOOFILTER_SLOTS
+#   define CONFIG_CUCKOOFILTER_SLOTS 4
+#endif
+
+/******************************************************************************
+ * TYPE DEFINITIONS
+ ***/
+
+/* Every hash is stored as a 16-bit fingerprint in one of two buckets; 0 marks
+ * an empty slot. A fingerprint that could not be placed is kept in the stash,
+ * and while the stash is full the filter accepts no more insertions. */
+typedef struct _cuckoofilter_ {
+
+  unsigned long count;
+  unsigned long buckets;
+  unsigned short * slots;
+
+  int stashed;
+  unsigned long stash_bucket;
+  unsigned short stash;
+
+  unsigned long random;
+
+} cuckoofilter;
+
+/******************************************************************************
+ * MACRO DEFINITIONS
+ ***/
+
+#define cuckoofilter_count(filter) ((filter)->count)
+
+/******************************************************************************
+ * API FUNCTION PROTOTYPES
+ ***/
+
+extern cuckoofilter * cuckoofilter_create(unsigned long capacity);
+extern void cuckoofilter_destroy(cuckoofilter ** filter);
+extern int cuckoofilter_insert(cuckoofilter * filter, unsigned long hash);
+extern int cuckoofilter_remove(cuckoofilter * filter, unsigned long hash);
+extern int cuckoofilter_contains(const cuckoofilter * filter,
+				 unsigned long hash);
+
+#endif /* __ET_CUCKOOFILTER_H__ */
+
+/*****************************************************************************/
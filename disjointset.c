@@ -0,0 +1,466 @@
+/******************************************************************************
+ * NAME:	    disjointset.c
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    Source file containing code for implementing a disjoint-
+ *		    set forest. The elements are kept in one array of nodes,
+ *		    in the order they were added, and a hash table maps each
+ *		    element to its node. Each class is a tree of parent links
+ *		    within the array, and also a ring of next links, so that a
+ *		    class can be listed without searching the forest. This
+ *		    code follows the typedefs and prototypes in disjointset.h.
+ *
+ * CREATED:	    10/17/2026
+ *
+ * LAST EDITED:	    10/17/2026
+ ***/
+
+/******************************************************************************
+ * INCLUDES
+ ***/
+
+#include <stdlib.h>
+
+#include "disjointset.h"
+
+/******************************************************************************
+ * CONFIGURATION
+ ***/
+
+/* The number of nodes the forest has room for when it is created. */
+#ifndef CONFIG_DISJOINTSET_MIN
+#   define CONFIG_DISJOINTSET_MIN 16
+#endif
+
+/******************************************************************************
+ * LOCAL PROTOTYPES
+ ***/
+
+static long index_of(const disjointset *, const void *);
+static long root_of(disjointset *, long);
+static set * make_class(const disjointset *, long, unsigned char *);
+
+/******************************************************************************
+ * API FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:	    disjointset_create
+ *
+ * DESCRIPTION:	    Creates an empty forest with the parameters given.
+ *
+ * ARGUMENTS:	    match: (int (*)(const void *, const void *)) -- as in
+ *			set_create.
+ *		    hash: (unsigned long (*)(const void *)) -- a pointer to a
+ *			user-defined function returning the hash of a key.
+ *			Keys that match must have the same hash.
+ *		    copy: (void * (*)(const void *)) -- as in set_create. May
+ *			be NULL, but then the classes cannot be exported.
+ *		    destroy: (void (*)(void *)) -- a pointer to a user-defined
+ *			function that frees data held in the forest.
+ *
+ * RETURN:	    (disjointset *) -- pointer to the new forest, or NULL.
+ *
+ * NOTES:	    O(1)
+ ***/
+disjointset * disjointset_create(int (*match)(const void *, const void *),
+				 unsigned long (*hash)(const void *),
+				 void * (*copy)(const void *),
+				 void (*destroy)(void *))
+{
+  if (match == NULL || hash == NULL)
+    return NULL;
+  disjointset * forest = NULL;
+  if ((forest = malloc(sizeof(disjointset))) == NULL)
+    return NULL;
+
+  *forest = (disjointset){
+    .size = 0,
+    .classes = 0,
+    .capacity = CONFIG_DISJOINTSET_MIN,
+    .match = match,
+    .hash = hash,
+    .copy = copy,
+    .destroy = destroy,
+    .nodes = NULL
+  };
+
+  if ((forest->nodes = malloc(forest->capacity * sizeof(disjointset_node)))
+      == NULL)
+    goto error_exception;
+  if (hashtable_init(&forest->table, 0, hash, match))
+    goto error_exception;
+
+  return forest;
+
+ error_exception: {
+    free(forest->nodes);
+    free(forest);
+    return NULL;
+  }
+}
+
+/******************************************************************************
+ * FUNCTION:	    disjointset_destroy
+ *
+ * DESCRIPTION:	    Removes all data from the forest and frees it. If destroy
+ *		    is NULL, does not attempt to free the data in the forest.
+ *
+ * ARGUMENTS:	    forest: (disjointset **) -- the forest to be operated on.
+ *
+ * RETURN:	    void.
+ *
+ * NOTES:	    O(n)
+ ***/
+void disjointset_destroy(disjointset ** forest)
+{
+  if (forest == NULL || *forest == NULL)
+    return;
+
+  hashtable_fini(&(*forest)->table, (*forest)->destroy);
+  free((*forest)->nodes);
+  free(*forest);
+  *forest = NULL;
+}
+
+/******************************************************************************
+ * FUNCTION:	    disjointset_add
+ *
+ * DESCRIPTION:	    Adds `data' to the forest, in a class of its own.
+ *
+ * ARGUMENTS:	    forest: (disjointset *) -- the forest to be operated on.
+ *		    data: (void *) -- data to add.
+ *
+ * RETURN:	    int -- 0 if `data' was not an element and is now held by
+ *		    the forest, 1 if it was already an element (in which case
+ *		    its class is unchanged, and the caller still owns `data'),
+ *		    -1 otherwise.
+ *
+ * NOTES:	    O(1) amortized.
+ ***/
+int disjointset_add(disjointset * forest, void * data)
+{
+  if (forest == NULL || data == NULL)
+    return -1;
+
+  /* Make room first, so that a failure leaves the table as it was. */
+  if (forest->size == forest->capacity) {
+    disjointset_node * nodes = NULL;
+    if ((nodes = realloc(forest->nodes, 2 * forest->capacity
+			 * sizeof(disjointset_node))) == NULL)
+      return -1;
+    forest->nodes = nodes;
+    forest->capacity *= 2;
+  }
+
+  int inserted = 0;
+  bucket * entry = NULL;
+  if ((entry = hashtable_insert(&forest->table, data, &inserted)) == NULL)
+    return -1;
+  if (!inserted)
+    return 1;
+
+  long i = forest->size++;
+  entry->count = i;
+  forest->nodes[i] = (disjointset_node){
+    .data = data,
+    .parent = i,
+    .next = i,
+    .size = 1,
+    .rank = 0
+  };
+  forest->classes++;
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    disjointset_find
+ *
+ * DESCRIPTION:	    Finds the representative of the class of `data'. Two
+ *		    elements are in the same class exactly when they have the
+ *		    same representative, until the next call to
+ *		    disjointset_union.
+ *
+ * ARGUMENTS:	    forest: (disjointset *) -- the forest to be operated on.
+ *		    data: (const void *) -- an element.
+ *
+ * RETURN:	    const void * -- the representative, which is an element of
+ *		    the forest, or NULL if `data' is not an element.
+ *
+ * NOTES:	    O(a(n)) amortized, where a is the inverse of Ackermann's
+ *		    function. The path to the root is compressed.
+ ***/
+const void * disjointset_find(disjointset * forest, const void * data)
+{
+  long i = -1;
+  if (forest == NULL || data == NULL || (i = index_of(forest, data)) < 0)
+    return NULL;
+
+  return forest->nodes[root_of(forest, i)].data;
+}
+
+/******************************************************************************
+ * FUNCTION:	    disjointset_union
+ *
+ * DESCRIPTION:	    Merges the classes of `one' and `two'.
+ *
+ * ARGUMENTS:	    forest: (disjointset *) -- the forest to be operated on.
+ *		    one: (const void *) -- an element.
+ *		    two: (const void *) -- another element.
+ *
+ * RETURN:	    int -- 0 if the classes were merged, 1 if they were the
+ *		    same class already, -1 if either is not an element.
+ *
+ * NOTES:	    O(a(n)) amortized. The root of lower rank is put under the
+ *		    other, and the rings of the classes are spliced together.
+ ***/
+int disjointset_union(disjointset * forest, const void * one,
+		      const void * two)
+{
+  long i = -1, j = -1;
+  if (forest == NULL || one == NULL || two == NULL
+      || (i = index_of(forest, one)) < 0 || (j = index_of(forest, two)) < 0)
+    return -1;
+
+  i = root_of(forest, i);
+  j = root_of(forest, j);
+  if (i == j)
+    return 1;
+
+  disjointset_node * nodes = forest->nodes;
+  if (nodes[i].rank < nodes[j].rank) {
+    long k = i;
+    i = j;
+    j = k;
+  }
+  nodes[j].parent = i;
+  nodes[i].size += nodes[j].size;
+  if (nodes[i].rank == nodes[j].rank)
+    nodes[i].rank++;
+
+  long next = nodes[i].next;
+  nodes[i].next = nodes[j].next;
+  nodes[j].next = next;
+  forest->classes--;
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    disjointset_same
+ *
+ * DESCRIPTION:	    Determines whether `one' and `two' are in the same class.
+ *
+ * ARGUMENTS:	    forest: (disjointset *) -- the forest to be operated on.
+ *		    one: (const void *) -- an element.
+ *		    two: (const void *) -- another element.
+ *
+ * RETURN:	    int -- 1 if they are, 0 if they are not, or if either is
+ *		    not an element.
+ *
+ * NOTES:	    O(a(n)) amortized.
+ ***/
+int disjointset_same(disjointset * forest, const void * one,
+		     const void * two)
+{
+  long i = -1, j = -1;
+  if (forest == NULL || one == NULL || two == NULL
+      || (i = index_of(forest, one)) < 0 || (j = index_of(forest, two)) < 0)
+    return 0;
+
+  return root_of(forest, i) == root_of(forest, j);
+}
+
+/******************************************************************************
+ * FUNCTION:	    disjointset_count
+ *
+ * DESCRIPTION:	    Returns the number of elements in the class of `data'.
+ *
+ * ARGUMENTS:	    forest: (disjointset *) -- the forest to be operated on.
+ *		    data: (const void *) -- an element.
+ *
+ * RETURN:	    long -- the size of the class, which is 0 for non-members.
+ *
+ * NOTES:	    O(a(n)) amortized.
+ ***/
+long disjointset_count(disjointset * forest, const void * data)
+{
+  long i = -1;
+  if (forest == NULL || data == NULL || (i = index_of(forest, data)) < 0)
+    return 0;
+
+  return forest->nodes[root_of(forest, i)].size;
+}
+
+/******************************************************************************
+ * FUNCTION:	    disjointset_class
+ *
+ * DESCRIPTION:	    Creates a hashed set (set.h) of copies of the elements in
+ *		    the class of `data'.
+ *
+ * ARGUMENTS:	    forest: (disjointset *) -- the forest to be operated on.
+ *		    data: (const void *) -- an element.
+ *
+ * RETURN:	    set * -- the class, made with the match, hash, copy and
+ *		    destroy functions of the forest, or NULL if `data' is not
+ *		    an element, or the forest has no copy function.
+ *
+ * NOTES:	    O(m) for a class of m elements, which are found along the
+ *		    ring of the class.
+ ***/
+set * disjointset_class(disjointset * forest, const void * data)
+{
+  long i = -1;
+  if (forest == NULL || data == NULL || forest->copy == NULL
+      || (i = index_of(forest, data)) < 0)
+    return NULL;
+
+  return make_class(forest, i, NULL);
+}
+
+/******************************************************************************
+ * FUNCTION:	    disjointset_export
+ *
+ * DESCRIPTION:	    Exports the partition: creates a hashed set (set.h) of
+ *		    copies of the elements of each class.
+ *
+ * ARGUMENTS:	    forest: (const disjointset *) -- the forest to be operated
+ *			on.
+ *		    classes: (set ***) -- will contain a pointer to an array
+ *			of the sets, in the order the first element of each
+ *			class was added. The caller destroys the sets and
+ *			frees the array.
+ *
+ * RETURN:	    long -- the number of sets, which is the number of classes,
+ *		    or -1 if an error has occurred, or the forest has no copy
+ *		    function. *classes is NULL for an empty forest.
+ *
+ * NOTES:	    O(n), in one pass over the nodes, each class being listed
+ *		    along its ring when its first element is met. The forest
+ *		    is not changed.
+ ***/
+long disjointset_export(const disjointset * forest, set *** classes)
+{
+  if (forest == NULL || classes == NULL || forest->copy == NULL)
+    return -1;
+
+  *classes = NULL;
+  if (forest->size == 0)
+    return 0;
+
+  set ** groups = NULL;
+  unsigned char * seen = NULL;
+  long made = 0;
+  groups = malloc(forest->classes * sizeof(set *));
+  seen = calloc(forest->size, sizeof(unsigned char));
+  if (groups == NULL || seen == NULL)
+    goto error_exception;
+
+  for (long i = 0; i < forest->size; i++) {
+    if (seen[i])
+      continue;
+    if ((groups[made] = make_class(forest, i, seen)) == NULL)
+      goto error_exception;
+    made++;
+  }
+
+  free(seen);
+  *classes = groups;
+  return made;
+
+ error_exception: {
+    for (long i = 0; i < made; i++)
+      set_destroy(&groups[i]);
+    free(groups);
+    free(seen);
+    return -1;
+  }
+}
+
+/******************************************************************************
+ * LOCAL FUNCTIONS
+ ***/
+
+/* Returns the index of the node of `data', or -1 if it is not an element. */
+static long index_of(const disjointset * forest, const void * data)
+{
+  bucket * entry = hashtable_lookup(&forest->table, data);
+  return entry == NULL ? -1 : entry->count;
+}
+
+/******************************************************************************
+ * FUNCTION:	    root_of
+ *
+ * DESCRIPTION:	    Finds the root of the tree of a node, and points every
+ *		    node on the way at it.
+ *
+ * ARGUMENTS:	    forest: (disjointset *) -- the forest.
+ *		    i: (long) -- the index of the node.
+ *
+ * RETURN:	    long -- the index of the root.
+ *
+ * NOTES:	    O(a(n)) amortized. Two passes up the path: one to find the
+ *		    root, one to compress the path.
+ ***/
+static long root_of(disjointset * forest, long i)
+{
+  disjointset_node * nodes = forest->nodes;
+  long root = i;
+  while (nodes[root].parent != root)
+    root = nodes[root].parent;
+
+  while (nodes[i].parent != root) {
+    long parent = nodes[i].parent;
+    nodes[i].parent = root;
+    i = parent;
+  }
+  return root;
+}
+
+/******************************************************************************
+ * FUNCTION:	    make_class
+ *
+ * DESCRIPTION:	    Creates a hashed set of copies of the elements on the
+ *		    ring of a node.
+ *
+ * ARGUMENTS:	    forest: (const disjointset *) -- the forest.
+ *		    first: (long) -- the index of the node.
+ *		    seen: (unsigned char *) -- if not NULL, marked at the index
+ *			of each node on the ring.
+ *
+ * RETURN:	    set * -- the set, or NULL.
+ *
+ * NOTES:	    O(m) for a ring of m nodes.
+ ***/
+static set * make_class(const disjointset * forest, long first,
+			unsigned char * seen)
+{
+  set * group = NULL;
+  if ((group = set_create_hashed(forest->match, forest->hash, forest->copy,
+				 forest->destroy)) == NULL)
+    return NULL;
+
+  long i = first;
+  do {
+    void * data = NULL;
+    if ((data = forest->copy(forest->nodes[i].data)) == NULL)
+      goto error_exception;
+    if (set_insert(group, data)) {
+      if (forest->destroy != NULL)
+	forest->destroy(data);
+      goto error_exception;
+    }
+    if (seen != NULL)
+      seen[i] = 1;
+    i = forest->nodes[i].next;
+  } while (i != first);
+
+  return group;
+
+ error_exception: {
+    set_destroy(&group);
+    return NULL;
+  }
+}
+
+/*****************************************************************************/
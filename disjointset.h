@@ -0,0 +1,90 @@
+/******************************************************************************
+ * NAME:	    disjointset.h
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    The header file for the implementation of a disjoint-set
+ *		    forest (union-find), which keeps a partition of its
+ *		    elements into classes. Elements are found by the same
+ *		    user-defined match and hash functions as a hashed set
+ *		    (set.h); classes are merged with disjointset_union, by
+ *		    rank, and the representative of a class is found with
+ *		    path compression, both in nearly constant time. The
+ *		    partition can be exported as sets.
+ *
+ * CREATED:	    10/17/2026
+ *
+ * LAST EDITED:	    10/17/2026
+ ***/
+
+#ifndef __ET_DISJOINTSET_H__
+#define __ET_DISJOINTSET_H__
+
+#include "hashtable.h"
+#include "set.h"
+
+/******************************************************************************
+ * TYPE DEFINITIONS
+ ***/
+
+/* An element of the forest. `parent' is the index of its parent, or its own
+ * index at a root, and the members of each class are linked in a ring by
+ * `next'. `size' and `rank' are only kept up to date at a root. */
+typedef struct {
+
+  void * data;
+  long parent;
+  long next;
+  long size;
+  int rank;
+
+} disjointset_node;
+
+typedef struct {
+
+  long size;
+  long classes;
+  long capacity;
+
+  int (*match)(const void *, const void *);
+  unsigned long (*hash)(const void *);
+  void * (*copy)(const void *);
+  void (*destroy)(void *);
+
+  /* The entry of each element holds its index in `nodes' in its count. */
+  hashtable table;
+  disjointset_node * nodes;
+
+} disjointset;
+
+/******************************************************************************
+ * MACRO DEFINITIONS
+ ***/
+
+/* The number of elements, and the number of classes they are in. */
+#define disjointset_size(forest) ((forest)->size)
+#define disjointset_classes(forest) ((forest)->classes)
+
+/******************************************************************************
+ * API FUNCTION PROTOTYPES
+ ***/
+
+extern disjointset * disjointset_create(int (*match)(const void *,
+						     const void *),
+					unsigned long (*hash)(const void *),
+					void * (*copy)(const void *),
+					void (*destroy)(void *));
+extern void disjointset_destroy(disjointset ** forest);
+extern int disjointset_add(disjointset * forest, void * data);
+extern const void * disjointset_find(disjointset * forest, const void * data);
+extern int disjointset_union(disjointset * forest, const void * one,
+			     const void * two);
+extern int disjointset_same(disjointset * forest, const void * one,
+			    const void * two);
+extern long disjointset_count(disjointset * forest, const void * data);
+extern set * disjointset_class(disjointset * forest, const void * data);
+extern long disjointset_export(const disjointset * forest, set *** classes);
+
+#endif /* __ET_DISJOINTSET_H__ */
+
+/*****************************************************************************/
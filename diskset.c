@@ -0,0 +1,1128 @@
+/******************************************************************************
+ * NAME:	    diskset.c
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    Source file containing the disk set engine. The file is a
+ *		    sequence of pages: the first holds a header, the others
+ *		    are the nodes of a B+ tree whose keys are the hashes of
+ *		    the members. Leaves hold the hash and the bytes of each
+ *		    member, sorted by hash, and are chained from left to right
+ *		    for iteration. Since hashes may repeat, a leaf remembers
+ *		    the separator it was split at, so that a search knows
+ *		    whether equal hashes may go on in the next leaf. Removal
+ *		    does not merge leaves; the room is reused by later inserts.
+ *		    Pages are only ever read through a buffer pool with a
+ *		    fixed number of frames, which evicts with the CLOCK
+ *		    algorithm and writes back changed pages when they are
+ *		    evicted or the set is synced. This code follows the
+ *		    typedefs and prototypes in diskset.h.
+ *
+ * CREATED:	    10/17/2026
+ *
+ * LAST EDITED:	    10/17/2026
+ ***/
+
+/******************************************************************************
+ * INCLUDES
+ ***/
+
+/* For pread, pwrite, fsync and fileno. */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "set.h"
+#include "setengine.h"
+#include "diskset.h"
+
+/******************************************************************************
+ * MACRO DEFINITIONS
+ ***/
+
+#define DISKSET_MAGIC "SETDISK1"
+/* The buffer pool never has fewer frames than this, so that an insert, which
+ * holds at most four pages at once, always finds a free one. */
+#define DISKSET_MIN_FRAMES 8
+/* The most levels of inner nodes. */
+#define DISKSET_DEPTH 32
+#define DISKSET_NONE ((uint64_t)-1)
+
+/* Every node starts with a nodehead. Leaves then hold entries of a 64-bit
+ * hash followed by the record, padded to keep the next entry aligned; inner
+ * nodes hold their children, then keys. */
+#define NODE_HEAD 32
+#define INNER_KEYS ((CONFIG_DISKSET_PAGE - NODE_HEAD - 8) / 16)
+
+#define node_of(page) ((nodehead *)(page))
+#define children_of(page) ((uint64_t *)((page) + NODE_HEAD))
+#define keys_of(page) (children_of(page) + INNER_KEYS + 1)
+#define entry_of(store, page, i)				\
+  ((page) + NODE_HEAD + (size_t)(i) * (store)->stride)
+#define offset_of(page) ((off_t)(page) * CONFIG_DISKSET_PAGE)
+
+/******************************************************************************
+ * TYPE DEFINITIONS
+ ***/
+
+/* The first page of the file. */
+typedef struct {
+
+  char magic[8];
+  uint64_t pagesize;
+  uint64_t width;
+  uint64_t root;
+  uint64_t first;
+  uint64_t pages;
+  uint64_t size;
+
+} filehead;
+
+/* The start of every node. `high' is the separator a leaf was last split at:
+ * if `bounded', every hash in later leaves is at least `high'. */
+typedef struct {
+
+  uint32_t leaf;
+  uint32_t count;
+  uint64_t next;
+  uint64_t high;
+  uint32_t bounded;
+  uint32_t unused;
+
+} nodehead;
+
+typedef struct {
+
+  uint64_t page;
+  int pins;
+  int dirty;
+  int referenced;
+
+} frame;
+
+/* The storage of a disk set. `index' maps page numbers to frames, by open
+ * addressing; `scratch' holds the member returned by the last call to
+ * begin, advance or remove. */
+typedef struct {
+
+  FILE * file;
+  int fd;
+  int durable;
+  size_t width;
+  size_t stride;
+  size_t fanout;
+  filehead head;
+
+  frame * frames;
+  char * slab;
+  unsigned long nframes;
+  unsigned long hand;
+  long * index;
+  unsigned long mask;
+
+  char * scratch;
+  diskset_stats stats;
+
+} diskstore;
+
+/******************************************************************************
+ * LOCAL PROTOTYPES
+ ***/
+
+static diskstore * open_store(const char *, size_t, size_t);
+static void close_store(diskstore *);
+static int flush(diskstore *);
+static unsigned long slot_of(const diskstore *, uint64_t);
+static long lookup(const diskstore *, uint64_t);
+static void unindex(diskstore *, unsigned long);
+static int write_frame(diskstore *, unsigned long);
+static char * fetch(diskstore *, uint64_t, int);
+static void release(diskstore *, char *, int);
+static uint64_t allocate(diskstore *);
+static unsigned long leaf_bound(const diskstore *, const char *,
+				unsigned long, int);
+static uint64_t descend(diskstore *, unsigned long, uint64_t [], int [],
+			int *);
+static int find(const set *, const void *, unsigned long, char **, long *);
+static int split_leaf(diskstore *, char **, uint64_t *, unsigned long,
+		      uint64_t [], int [], int);
+static int promote(diskstore *, uint64_t [], int [], int, uint64_t,
+		   uint64_t);
+
+static int disk_ismember(const set *, const void *);
+static int disk_insert(set *, void *);
+static void * disk_remove(set *, const void *);
+static void * disk_begin(const set *, set_iterator *);
+static void * disk_advance(const set *, set_iterator *);
+static void disk_clear(set *);
+static int disk_like(set *, const set *);
+
+/******************************************************************************
+ * ENGINES
+ ***/
+
+const set_engine set_disk_engine = {
+  .name = "disk",
+  .ismember = disk_ismember,
+  .insert = disk_insert,
+  .remove = disk_remove,
+  .begin = disk_begin,
+  .advance = disk_advance,
+  .clear = disk_clear,
+  .like = disk_like,
+  .byvalue = 1
+};
+
+/******************************************************************************
+ * API FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:	    set_create_disk
+ *
+ * DESCRIPTION:	    Opens a disk set, creating the file if it does not exist.
+ *
+ * ARGUMENTS:	    match, copy, destroy: as in set_create (set.h). They are
+ *			called on records of `width' bytes.
+ *		    hash: (unsigned long (*)(const void *)) -- as in
+ *			set_create_hashed.
+ *		    width: (size_t) -- the size of a member, in bytes.
+ *		    path: (const char *) -- the file, or NULL for a temporary
+ *			file that is deleted when the set is destroyed.
+ *		    cache: (size_t) -- the size of the buffer pool, in bytes.
+ *
+ * RETURN:	    (set *) -- pointer to the set, or NULL if an argument is
+ *		    bad, or the file exists but holds records of another width.
+ *
+ * NOTES:	    O(1). set_insert stores a copy of the record and destroys
+ *		    the one it was given, the data returned by the iterators
+ *		    are only valid until the next call on the set, and
+ *		    set_destroy syncs and closes the file, leaving the members
+ *		    in it. The sets made by the set operations are disk sets
+ *		    in temporary files, with a buffer pool of the same size.
+ ***/
+set * set_create_disk(int (*match)(const void *, const void *),
+		      unsigned long (*hash)(const void *),
+		      void * (*copy)(const void *),
+		      void (*destroy)(void *),
+		      size_t width, const char * path, size_t cache)
+{
+  if (match == NULL || hash == NULL)
+    return NULL;
+
+  set * group = NULL;
+  if ((group = set_create_engine(&set_disk_engine, match, hash, copy,
+				 destroy)) == NULL)
+    return NULL;
+
+  diskstore * store = NULL;
+  if ((store = open_store(path, width, cache)) == NULL) {
+    free(group);
+    return NULL;
+  }
+
+  group->storage = store;
+  group->size = (int)store->head.size;
+  return group;
+}
+
+/******************************************************************************
+ * FUNCTION:	    set_disk_sync
+ *
+ * DESCRIPTION:	    Writes every changed page of a disk set to its file, and
+ *		    waits for the file to reach the disk.
+ *
+ * ARGUMENTS:	    group: (set *) -- the set to be operated on.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    O(frames). The pages stay in the buffer pool.
+ ***/
+int set_disk_sync(set * group)
+{
+  if (group == NULL || group->engine != &set_disk_engine)
+    return -1;
+
+  diskstore * store = group->storage;
+  if (flush(store) || fsync(store->fd))
+    return -1;
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    set_disk_stats
+ *
+ * DESCRIPTION:	    Reads the statistics of the buffer pool of a disk set.
+ *
+ * ARGUMENTS:	    group: (const set *) -- the set.
+ *		    stats: (diskset_stats *) -- will contain the statistics.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    O(1). The hit ratio is given by diskset_hitratio.
+ ***/
+int set_disk_stats(const set * group, diskset_stats * stats)
+{
+  if (group == NULL || stats == NULL || group->engine != &set_disk_engine)
+    return -1;
+
+  const diskstore * store = group->storage;
+  *stats = store->stats;
+  stats->pages = store->head.pages;
+  stats->frames = store->nframes;
+  return 0;
+}
+
+/******************************************************************************
+ * LOCAL FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:	    open_store
+ *
+ * DESCRIPTION:	    Opens the file of a disk set and sets up its buffer pool.
+ *		    An empty file is given a header and an empty root leaf.
+ *
+ * ARGUMENTS:	    path: (const char *) -- the file, or NULL.
+ *		    width: (size_t) -- the size of a member.
+ *		    cache: (size_t) -- the size of the buffer pool.
+ *
+ * RETURN:	    (diskstore *) -- the storage, or NULL.
+ *
+ * NOTES:	    O(frames)
+ ***/
+static diskstore * open_store(const char * path, size_t width, size_t cache)
+{
+  size_t stride = 8 + (width + 7) / 8 * 8;
+  if (width == 0 || (CONFIG_DISKSET_PAGE - NODE_HEAD) / stride < 4)
+    return NULL;
+
+  diskstore * store = NULL;
+  if ((store = calloc(1, sizeof(diskstore))) == NULL)
+    return NULL;
+
+  store->fd = -1;
+  store->durable = path != NULL;
+  store->width = width;
+  store->stride = stride;
+  store->fanout = (CONFIG_DISKSET_PAGE - NODE_HEAD) / stride;
+  store->nframes = cache / CONFIG_DISKSET_PAGE;
+  if (store->nframes < DISKSET_MIN_FRAMES)
+    store->nframes = DISKSET_MIN_FRAMES;
+  store->mask = 1;
+  while (store->mask < 2 * store->nframes)
+    store->mask <<= 1;
+  store->mask--;
+
+  if ((store->frames = malloc(store->nframes * sizeof(frame))) == NULL
+      || (store->slab = malloc(store->nframes * CONFIG_DISKSET_PAGE)) == NULL
+      || (store->index = malloc((store->mask + 1) * sizeof(long))) == NULL
+      || (store->scratch = malloc(width)) == NULL)
+    goto error_exception;
+  for (unsigned long i = 0; i < store->nframes; i++)
+    store->frames[i] = (frame){.page = DISKSET_NONE, .pins = 0, .dirty = 0,
+			       .referenced = 0};
+  for (unsigned long i = 0; i <= store->mask; i++)
+    store->index[i] = -1;
+
+  if (path != NULL)
+    store->fd = open(path, O_RDWR | O_CREAT, 0644);
+  else if ((store->file = tmpfile()) != NULL)
+    store->fd = fileno(store->file);
+  if (store->fd < 0)
+    goto error_exception;
+
+  char page[CONFIG_DISKSET_PAGE];
+  ssize_t got = pread(store->fd, page, CONFIG_DISKSET_PAGE, 0);
+  if (got == CONFIG_DISKSET_PAGE) {
+    memcpy(&store->head, page, sizeof(filehead));
+    if (memcmp(store->head.magic, DISKSET_MAGIC, 8)
+	|| store->head.pagesize != CONFIG_DISKSET_PAGE
+	|| store->head.width != width)
+      goto error_exception;
+  } else if (got == 0) {
+    memcpy(store->head.magic, DISKSET_MAGIC, 8);
+    store->head.pagesize = CONFIG_DISKSET_PAGE;
+    store->head.width = width;
+    store->head.root = store->head.first = 1;
+    store->head.pages = 1;
+    store->head.size = 0;
+
+    char * root = NULL;
+    if ((root = fetch(store, allocate(store), 1)) == NULL)
+      goto error_exception;
+    node_of(root)->leaf = 1;
+    release(store, root, 1);
+    if (flush(store))
+      goto error_exception;
+  } else {
+    goto error_exception;
+  }
+
+  return store;
+
+ error_exception: {
+    close_store(store);
+    return NULL;
+  }
+}
+
+/******************************************************************************
+ * FUNCTION:	    close_store
+ *
+ * DESCRIPTION:	    Closes the file of a disk set and frees the storage,
+ *		    without writing anything.
+ *
+ * ARGUMENTS:	    store: (diskstore *) -- the storage.
+ *
+ * RETURN:	    void.
+ *
+ * NOTES:	    O(1)
+ ***/
+static void close_store(diskstore * store)
+{
+  if (store->file != NULL)
+    fclose(store->file);
+  else if (store->fd >= 0)
+    close(store->fd);
+
+  free(store->frames);
+  free(store->slab);
+  free(store->index);
+  free(store->scratch);
+  free(store);
+}
+
+/******************************************************************************
+ * FUNCTION:	    flush
+ *
+ * DESCRIPTION:	    Writes every changed page, and then the header.
+ *
+ * ARGUMENTS:	    store: (diskstore *) -- the storage.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    O(frames). The header is written last, so that it never
+ *		    refers to a page that is not in the file.
+ ***/
+static int flush(diskstore * store)
+{
+  for (unsigned long i = 0; i < store->nframes; i++)
+    if (store->frames[i].page != DISKSET_NONE && store->frames[i].dirty
+	&& write_frame(store, i))
+      return -1;
+
+  char page[CONFIG_DISKSET_PAGE] = {0};
+  memcpy(page, &store->head, sizeof(filehead));
+  if (pwrite(store->fd, page, CONFIG_DISKSET_PAGE, 0) != CONFIG_DISKSET_PAGE)
+    return -1;
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    slot_of
+ *
+ * DESCRIPTION:	    Finds the home slot of a page in the index of the pool.
+ *
+ * ARGUMENTS:	    store: (const diskstore *) -- the storage.
+ *		    page: (uint64_t) -- the page number.
+ *
+ * RETURN:	    unsigned long -- the slot.
+ *
+ * NOTES:	    O(1). Fibonacci hashing, since page numbers are dense.
+ ***/
+static unsigned long slot_of(const diskstore * store, uint64_t page)
+{
+  return (unsigned long)((page * 0x9e3779b97f4a7c15ULL) >> 32) & store->mask;
+}
+
+/******************************************************************************
+ * FUNCTION:	    lookup
+ *
+ * DESCRIPTION:	    Finds the slot of the index that refers to the frame
+ *		    holding a page.
+ *
+ * ARGUMENTS:	    store: (const diskstore *) -- the storage.
+ *		    page: (uint64_t) -- the page number.
+ *
+ * RETURN:	    long -- the slot, or -1 if the page is not in the pool.
+ *
+ * NOTES:	    O(1) expected. The index is at most half full.
+ ***/
+static long lookup(const diskstore * store, uint64_t page)
+{
+  for (unsigned long i = slot_of(store, page); store->index[i] >= 0;
+       i = (i + 1) & store->mask)
+    if (store->frames[store->index[i]].page == page)
+      return (long)i;
+
+  return -1;
+}
+
+/******************************************************************************
+ * FUNCTION:	    unindex
+ *
+ * DESCRIPTION:	    Empties a slot of the index, shifting later slots of the
+ *		    same cluster back so that no lookup is cut short.
+ *
+ * ARGUMENTS:	    store: (diskstore *) -- the storage.
+ *		    i: (unsigned long) -- the slot.
+ *
+ * RETURN:	    void.
+ *
+ * NOTES:	    O(1) expected.
+ ***/
+static void unindex(diskstore * store, unsigned long i)
+{
+  for (unsigned long j = (i + 1) & store->mask; store->index[j] >= 0;
+       j = (j + 1) & store->mask) {
+    unsigned long home = slot_of(store, store->frames[store->index[j]].page);
+    if (((j - home) & store->mask) >= ((j - i) & store->mask)) {
+      store->index[i] = store->index[j];
+      i = j;
+    }
+  }
+
+  store->index[i] = -1;
+}
+
+/******************************************************************************
+ * FUNCTION:	    write_frame
+ *
+ * DESCRIPTION:	    Writes the page held by a frame to the file.
+ *
+ * ARGUMENTS:	    store: (diskstore *) -- the storage.
+ *		    i: (unsigned long) -- the frame.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    O(1)
+ ***/
+static int write_frame(diskstore * store, unsigned long i)
+{
+  if (pwrite(store->fd, store->slab + i * CONFIG_DISKSET_PAGE,
+	     CONFIG_DISKSET_PAGE, offset_of(store->frames[i].page))
+      != CONFIG_DISKSET_PAGE)
+    return -1;
+
+  store->frames[i].dirty = 0;
+  store->stats.writes++;
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    fetch
+ *
+ * DESCRIPTION:	    Pins a page in the buffer pool, reading it if it is not
+ *		    there. The victim frame is found by the CLOCK algorithm:
+ *		    the hand passes over pinned frames, and gives frames that
+ *		    were used since it last passed a second chance.
+ *
+ * ARGUMENTS:	    store: (diskstore *) -- the storage.
+ *		    page: (uint64_t) -- the page number.
+ *		    fresh: (int) -- nonzero for a newly allocated page, which
+ *			is zeroed instead of read.
+ *
+ * RETURN:	    char * -- the contents of the page, or NULL.
+ *
+ * NOTES:	    O(frames) worst case. Every fetch must be matched by a
+ *		    release.
+ ***/
+static char * fetch(diskstore * store, uint64_t page, int fresh)
+{
+  long slot = lookup(store, page);
+  if (slot >= 0) {
+    frame * hit = &store->frames[store->index[slot]];
+    hit->pins++;
+    hit->referenced = 1;
+    store->stats.hits++;
+    return store->slab + (hit - store->frames) * CONFIG_DISKSET_PAGE;
+  }
+
+  unsigned long victim = store->nframes;
+  for (unsigned long turn = 0; turn < 2 * store->nframes; turn++) {
+    frame * candidate = &store->frames[store->hand];
+    unsigned long current = store->hand;
+    store->hand = (store->hand + 1) % store->nframes;
+    if (candidate->pins == 0 && !candidate->referenced) {
+      victim = current;
+      break;
+    }
+    candidate->referenced = 0;
+  }
+  if (victim == store->nframes)
+    return NULL;
+
+  frame * evicted = &store->frames[victim];
+  if (evicted->page != DISKSET_NONE) {
+    if (evicted->dirty && write_frame(store, victim))
+      return NULL;
+    unindex(store, (unsigned long)lookup(store, evicted->page));
+    evicted->page = DISKSET_NONE;
+    store->stats.evictions++;
+  }
+
+  char * data = store->slab + victim * CONFIG_DISKSET_PAGE;
+  if (fresh) {
+    memset(data, 0, CONFIG_DISKSET_PAGE);
+  } else {
+    if (pread(store->fd, data, CONFIG_DISKSET_PAGE, offset_of(page))
+	!= CONFIG_DISKSET_PAGE)
+      return NULL;
+    store->stats.misses++;
+  }
+
+  *evicted = (frame){.page = page, .pins = 1, .dirty = fresh,
+		     .referenced = 1};
+  unsigned long i = slot_of(store, page);
+  while (store->index[i] >= 0)
+    i = (i + 1) & store->mask;
+  store->index[i] = (long)victim;
+  return data;
+}
+
+/******************************************************************************
+ * FUNCTION:	    release
+ *
+ * DESCRIPTION:	    Unpins a page returned by fetch.
+ *
+ * ARGUMENTS:	    store: (diskstore *) -- the storage.
+ *		    data: (char *) -- the contents of the page.
+ *		    dirty: (int) -- nonzero if the page was changed.
+ *
+ * RETURN:	    void.
+ *
+ * NOTES:	    O(1)
+ ***/
+static void release(diskstore * store, char * data, int dirty)
+{
+  frame * held = &store->frames[(data - store->slab) / CONFIG_DISKSET_PAGE];
+  held->pins--;
+  held->dirty |= dirty;
+}
+
+/******************************************************************************
+ * FUNCTION:	    allocate
+ *
+ * DESCRIPTION:	    Appends a page to the file.
+ *
+ * ARGUMENTS:	    store: (diskstore *) -- the storage.
+ *
+ * RETURN:	    uint64_t -- the number of the new page.
+ *
+ * NOTES:	    O(1). The page must be fetched as fresh.
+ ***/
+static uint64_t allocate(diskstore * store)
+{
+  return store->head.pages++;
+}
+
+/******************************************************************************
+ * FUNCTION:	    leaf_bound
+ *
+ * DESCRIPTION:	    Binary search of the hashes of a leaf.
+ *
+ * ARGUMENTS:	    store: (const diskstore *) -- the storage.
+ *		    leaf: (const char *) -- the leaf.
+ *		    hash: (unsigned long) -- the hash.
+ *		    upper: (int) -- nonzero to find the first entry with a
+ *			greater hash, zero for the first with a hash at least
+ *			as great.
+ *
+ * RETURN:	    unsigned long -- the position.
+ *
+ * NOTES:	    O(log fanout)
+ ***/
+static unsigned long leaf_bound(const diskstore * store, const char * leaf,
+				unsigned long hash, int upper)
+{
+  unsigned long lo = 0, hi = node_of(leaf)->count;
+  while (lo < hi) {
+    unsigned long mid = lo + (hi - lo) / 2;
+    uint64_t key = 0;
+    memcpy(&key, entry_of(store, leaf, mid), sizeof(uint64_t));
+    if (key < hash || (upper && key == hash))
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+
+  return lo;
+}
+
+/******************************************************************************
+ * FUNCTION:	    descend
+ *
+ * DESCRIPTION:	    Walks from the root to the leftmost leaf that may hold a
+ *		    hash, recording the path.
+ *
+ * ARGUMENTS:	    store: (diskstore *) -- the storage.
+ *		    hash: (unsigned long) -- the hash.
+ *		    path: (uint64_t []) -- will contain the inner nodes passed.
+ *		    slots: (int []) -- will contain the child taken at each.
+ *		    depth: (int *) -- will contain the length of the path.
+ *
+ * RETURN:	    uint64_t -- the page of the leaf, or 0 on error.
+ *
+ * NOTES:	    O(log n). At each node the child taken is the one after
+ *		    the keys less than the hash, since keys equal to it may
+ *		    have entries on both sides.
+ ***/
+static uint64_t descend(diskstore * store, unsigned long hash,
+			uint64_t path[], int slots[], int * depth)
+{
+  uint64_t page = store->head.root;
+  *depth = 0;
+  for (;;) {
+    char * node = NULL;
+    if ((node = fetch(store, page, 0)) == NULL)
+      return 0;
+    if (node_of(node)->leaf) {
+      release(store, node, 0);
+      return page;
+    }
+
+    unsigned long lo = 0, hi = node_of(node)->count;
+    const uint64_t * keys = keys_of(node);
+    while (lo < hi) {
+      unsigned long mid = lo + (hi - lo) / 2;
+      if (keys[mid] < hash)
+	lo = mid + 1;
+      else
+	hi = mid;
+    }
+
+    if (*depth == DISKSET_DEPTH) {
+      release(store, node, 0);
+      return 0;
+    }
+    path[*depth] = page;
+    slots[(*depth)++] = (int)lo;
+    page = children_of(node)[lo];
+    release(store, node, 0);
+  }
+}
+
+/******************************************************************************
+ * FUNCTION:	    find
+ *
+ * DESCRIPTION:	    Searches a disk set for a member.
+ *
+ * ARGUMENTS:	    group: (const set *) -- the set.
+ *		    data: (const void *) -- the data to look for.
+ *		    hash: (unsigned long) -- the hash of `data'.
+ *		    leaf: (char **) -- will contain the leaf holding the
+ *			member, which is left pinned.
+ *		    position: (long *) -- will contain its position there.
+ *
+ * RETURN:	    int -- 1 if found, 0 if not, -1 on error.
+ *
+ * NOTES:	    O(log n) expected. The search moves on to the next leaf
+ *		    only while the hash could continue there.
+ ***/
+static int find(const set * group, const void * data, unsigned long hash,
+		char ** leaf, long * position)
+{
+  diskstore * store = group->storage;
+  uint64_t path[DISKSET_DEPTH];
+  int slots[DISKSET_DEPTH], depth = 0;
+  uint64_t page = 0;
+  if ((page = descend(store, hash, path, slots, &depth)) == 0)
+    return -1;
+
+  for (;;) {
+    char * node = NULL;
+    if ((node = fetch(store, page, 0)) == NULL)
+      return -1;
+
+    const nodehead * head = node_of(node);
+    unsigned long i = leaf_bound(store, node, hash, 0);
+    for (; i < head->count; i++) {
+      const char * entry = entry_of(store, node, i);
+      uint64_t key = 0;
+      memcpy(&key, entry, sizeof(uint64_t));
+      if (key != hash)
+	break;
+      if (group->match(entry + 8, data) == 1) {
+	*leaf = node;
+	*position = (long)i;
+	return 1;
+      }
+    }
+
+    int more = i == head->count && head->bounded && head->high == hash
+      && head->next != 0;
+    page = head->next;
+    release(store, node, 0);
+    if (!more)
+      return 0;
+  }
+}
+
+/******************************************************************************
+ * FUNCTION:	    split_leaf
+ *
+ * DESCRIPTION:	    Splits a full leaf in two, and keeps the half that a hash
+ *		    belongs in.
+ *
+ * ARGUMENTS:	    store: (diskstore *) -- the storage.
+ *		    leaf: (char **) -- the pinned leaf; will contain the half
+ *			to insert into, which is left pinned.
+ *		    page: (uint64_t *) -- the page of the leaf; will contain
+ *			that of the half.
+ *		    hash: (unsigned long) -- the hash to be inserted.
+ *		    path, slots, depth: the path to the leaf, from descend.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    O(log n). The upper half moves to a new page, and its first
+ *		    hash becomes the separator in the parent.
+ ***/
+static int split_leaf(diskstore * store, char ** leaf, uint64_t * page,
+		      unsigned long hash, uint64_t path[], int slots[],
+		      int depth)
+{
+  uint64_t right = allocate(store);
+  char * other = NULL;
+  if ((other = fetch(store, right, 1)) == NULL)
+    return -1;
+
+  nodehead * left = node_of(*leaf);
+  unsigned long half = left->count / 2;
+  memcpy(entry_of(store, other, 0), entry_of(store, *leaf, half),
+	 (left->count - half) * store->stride);
+  *node_of(other) = (nodehead){.leaf = 1, .count = left->count - half,
+			       .next = left->next, .high = left->high,
+			       .bounded = left->bounded};
+
+  uint64_t separator = 0;
+  memcpy(&separator, entry_of(store, other, 0), sizeof(uint64_t));
+  left->count = half;
+  left->next = right;
+  left->high = separator;
+  left->bounded = 1;
+
+  if (hash > separator) {
+    release(store, *leaf, 1);
+    *leaf = other;
+    *page = right;
+  } else {
+    release(store, other, 1);
+  }
+
+  return promote(store, path, slots, depth, separator, right);
+}
+
+/******************************************************************************
+ * FUNCTION:	    promote
+ *
+ * DESCRIPTION:	    Inserts a separator and the node to its right into the
+ *		    parent of a node that was split, splitting the parent in
+ *		    turn if it is full, up to a new root.
+ *
+ * ARGUMENTS:	    store: (diskstore *) -- the storage.
+ *		    path, slots, depth: the path to the node, from descend.
+ *		    key: (uint64_t) -- the separator.
+ *		    child: (uint64_t) -- the page of the new node.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    O(log n)
+ ***/
+static int promote(diskstore * store, uint64_t path[], int slots[], int depth,
+		   uint64_t key, uint64_t child)
+{
+  for (int level = depth - 1; level >= 0; level--) {
+    char * node = NULL;
+    if ((node = fetch(store, path[level], 0)) == NULL)
+      return -1;
+
+    nodehead * head = node_of(node);
+    uint64_t * keys = keys_of(node), * children = children_of(node);
+    unsigned long at = (unsigned long)slots[level], count = head->count;
+    if (count < INNER_KEYS) {
+      memmove(keys + at + 1, keys + at, (count - at) * sizeof(uint64_t));
+      memmove(children + at + 2, children + at + 1,
+	      (count - at) * sizeof(uint64_t));
+      keys[at] = key;
+      children[at + 1] = child;
+      head->count++;
+      release(store, node, 1);
+      return 0;
+    }
+
+    uint64_t allkeys[INNER_KEYS + 1], allchildren[INNER_KEYS + 2];
+    memcpy(allkeys, keys, at * sizeof(uint64_t));
+    allkeys[at] = key;
+    memcpy(allkeys + at + 1, keys + at, (count - at) * sizeof(uint64_t));
+    memcpy(allchildren, children, (at + 1) * sizeof(uint64_t));
+    allchildren[at + 1] = child;
+    memcpy(allchildren + at + 2, children + at + 1,
+	   (count - at) * sizeof(uint64_t));
+
+    uint64_t right = allocate(store);
+    char * other = NULL;
+    if ((other = fetch(store, right, 1)) == NULL) {
+      release(store, node, 0);
+      return -1;
+    }
+
+    unsigned long total = count + 1, middle = total / 2;
+    head->count = middle;
+    memcpy(keys, allkeys, middle * sizeof(uint64_t));
+    memcpy(children, allchildren, (middle + 1) * sizeof(uint64_t));
+    node_of(other)->count = total - middle - 1;
+    memcpy(keys_of(other), allkeys + middle + 1,
+	   (total - middle - 1) * sizeof(uint64_t));
+    memcpy(children_of(other), allchildren + middle + 1,
+	   (total - middle) * sizeof(uint64_t));
+
+    release(store, node, 1);
+    release(store, other, 1);
+    key = allkeys[middle];
+    child = right;
+  }
+
+  uint64_t root = allocate(store);
+  char * node = NULL;
+  if ((node = fetch(store, root, 1)) == NULL)
+    return -1;
+  node_of(node)->count = 1;
+  keys_of(node)[0] = key;
+  children_of(node)[0] = store->head.root;
+  children_of(node)[1] = child;
+  store->head.root = root;
+  release(store, node, 1);
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    disk_ismember
+ *
+ * DESCRIPTION:	    ismember primitive of the disk engine.
+ *
+ * ARGUMENTS:	    group: (const set *) -- the set to be operated on.
+ *		    data: (const void *) -- data to check.
+ *
+ * RETURN:	    int -- 1 if the member is in the set, 0 if it is not, or
+ *		    if the file could not be read.
+ *
+ * NOTES:	    O(log n) page requests.
+ ***/
+static int disk_ismember(const set * group, const void * data)
+{
+  char * leaf = NULL;
+  long position = 0;
+  if (find(group, data, group->hash(data), &leaf, &position) != 1)
+    return 0;
+
+  release(group->storage, leaf, 0);
+  return 1;
+}
+
+/******************************************************************************
+ * FUNCTION:	    disk_insert
+ *
+ * DESCRIPTION:	    insert primitive of the disk engine. The record is stored
+ *		    after the entries of equal hash in its leaf.
+ *
+ * ARGUMENTS:	    group: (set *) -- the set to be operated on.
+ *		    data: (void *) -- data to insert.
+ *
+ * RETURN:	    int -- 0 if successful, 1 if the data is already contained
+ *		    in the set, -1 otherwise.
+ *
+ * NOTES:	    O(log n) page requests.
+ ***/
+static int disk_insert(set * group, void * data)
+{
+  diskstore * store = group->storage;
+  unsigned long hash = group->hash(data);
+
+  char * leaf = NULL;
+  long position = 0;
+  int found = find(group, data, hash, &leaf, &position);
+  if (found == 1)
+    release(store, leaf, 0);
+  if (found)
+    return found;
+
+  uint64_t path[DISKSET_DEPTH], page = 0;
+  int slots[DISKSET_DEPTH], depth = 0;
+  if ((page = descend(store, hash, path, slots, &depth)) == 0
+      || (leaf = fetch(store, page, 0)) == NULL)
+    return -1;
+  if (node_of(leaf)->count == store->fanout
+      && split_leaf(store, &leaf, &page, hash, path, slots, depth)) {
+    release(store, leaf, 1);
+    return -1;
+  }
+
+  nodehead * head = node_of(leaf);
+  unsigned long at = leaf_bound(store, leaf, hash, 1);
+  memmove(entry_of(store, leaf, at + 1), entry_of(store, leaf, at),
+	  (head->count - at) * store->stride);
+  uint64_t key = hash;
+  memcpy(entry_of(store, leaf, at), &key, sizeof(uint64_t));
+  memcpy(entry_of(store, leaf, at) + 8, data, store->width);
+  head->count++;
+  release(store, leaf, 1);
+
+  store->head.size++;
+  group->size++;
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    disk_remove
+ *
+ * DESCRIPTION:	    remove primitive of the disk engine.
+ *
+ * ARGUMENTS:	    group: (set *) -- the set to be operated on.
+ *		    data: (const void *) -- data to remove.
+ *
+ * RETURN:	    void * -- a copy of the removed record, valid until the
+ *		    next call on the set, or NULL if there was no match.
+ *
+ * NOTES:	    O(log n) page requests. Leaves are not merged.
+ ***/
+static void * disk_remove(set * group, const void * data)
+{
+  diskstore * store = group->storage;
+  char * leaf = NULL;
+  long position = 0;
+  if (find(group, data, group->hash(data), &leaf, &position) != 1)
+    return NULL;
+
+  nodehead * head = node_of(leaf);
+  memcpy(store->scratch, entry_of(store, leaf, position) + 8, store->width);
+  memmove(entry_of(store, leaf, position), entry_of(store, leaf, position + 1),
+	  (head->count - position - 1) * store->stride);
+  head->count--;
+  release(store, leaf, 1);
+
+  store->head.size--;
+  group->size--;
+  return store->scratch;
+}
+
+/******************************************************************************
+ * FUNCTION:	    disk_begin
+ *
+ * DESCRIPTION:	    begin primitive of the disk engine.
+ *
+ * ARGUMENTS:	    group: (const set *) -- the set to be operated on.
+ *		    iterator: (set_iterator *) -- will contain the position.
+ *
+ * RETURN:	    void * -- a copy of the first member, or NULL.
+ *
+ * NOTES:	    O(1) page requests. The iterator holds the page of the
+ *		    current leaf, and the position in it.
+ ***/
+static void * disk_begin(const set * group, set_iterator * iterator)
+{
+  const diskstore * store = group->storage;
+  iterator->node = (void *)(uintptr_t)store->head.first;
+  iterator->index = -1;
+  return disk_advance(group, iterator);
+}
+
+/******************************************************************************
+ * FUNCTION:	    disk_advance
+ *
+ * DESCRIPTION:	    advance primitive of the disk engine. The leaves are
+ *		    visited from left to right, so members come in order of
+ *		    their hashes.
+ *
+ * ARGUMENTS:	    group: (const set *) -- the set to be operated on.
+ *		    iterator: (set_iterator *) -- the position.
+ *
+ * RETURN:	    void * -- a copy of the next member, valid until the next
+ *		    call on the set, or NULL at the end.
+ *
+ * NOTES:	    O(1) amortized page requests.
+ ***/
+static void * disk_advance(const set * group, set_iterator * iterator)
+{
+  diskstore * store = group->storage;
+  uint64_t page = (uint64_t)(uintptr_t)iterator->node;
+  iterator->index++;
+  while (page != 0) {
+    char * leaf = NULL;
+    if ((leaf = fetch(store, page, 0)) == NULL)
+      break;
+
+    const nodehead * head = node_of(leaf);
+    if ((unsigned long)iterator->index < head->count) {
+      memcpy(store->scratch, entry_of(store, leaf, iterator->index) + 8,
+	     store->width);
+      release(store, leaf, 0);
+      iterator->node = (void *)(uintptr_t)page;
+      return store->scratch;
+    }
+
+    page = head->next;
+    iterator->index = 0;
+    release(store, leaf, 0);
+  }
+
+  iterator->node = NULL;
+  return NULL;
+}
+
+/******************************************************************************
+ * FUNCTION:	    disk_clear
+ *
+ * DESCRIPTION:	    clear primitive of the disk engine. The set is synced and
+ *		    its file closed; the members stay in the file, unless it
+ *		    is temporary.
+ *
+ * ARGUMENTS:	    group: (set *) -- the set to be operated on.
+ *
+ * RETURN:	    void.
+ *
+ * NOTES:	    O(frames)
+ ***/
+static void disk_clear(set * group)
+{
+  diskstore * store = group->storage;
+  if (store == NULL)
+    return;
+
+  if (store->durable && flush(store) == 0)
+    fsync(store->fd);
+  close_store(store);
+  group->storage = NULL;
+  group->size = 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    disk_like
+ *
+ * DESCRIPTION:	    like primitive of the disk engine. Gives the set a
+ *		    temporary file, with records and a buffer pool of the same
+ *		    size as the model.
+ *
+ * ARGUMENTS:	    group: (set *) -- the empty set.
+ *		    model: (const set *) -- a disk set.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    O(frames)
+ ***/
+static int disk_like(set * group, const set * model)
+{
+  const diskstore * store = model->storage;
+  if ((group->storage = open_store(NULL, store->width,
+				   store->nframes * CONFIG_DISKSET_PAGE))
+      == NULL)
+    return -1;
+  return 0;
+}
+
+/*****************************************************************************/
@@ -0,0 +1,78 @@
+/******************************************************************************
+ * NAME:	    diskset.h
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    The header file for the disk set engine, which keeps the
+ *		    members of a set in a file, for long-lived sets that are
+ *		    bigger than memory. A disk set is an ordinary set (set.h):
+ *		    set_insert, set_ismember, set_remove, the iterators and
+ *		    the set operations all work on it unchanged. Its members
+ *		    are fixed-size records, kept in a B+ tree of pages keyed
+ *		    by their hashes, and pages are read through a buffer pool
+ *		    of bounded size, whose statistics are available here.
+ *
+ * CREATED:	    10/17/2026
+ *
+ * LAST EDITED:	    10/17/2026
+ ***/
+
+#ifndef __ET_DISKSET_H__
+#define __ET_DISKSET_H__
+
+#include <stddef.h>
+
+#include "set.h"
+
+/******************************************************************************
+ * CONFIGURATION
+ ***/
+
+/* The size of a page of the file, and of a frame of the buffer pool. */
+#ifndef CONFIG_DISKSET_PAGE
+#   define CONFIG_DISKSET_PAGE 4096
+#endif
+
+/******************************************************************************
+ * TYPE DEFINITIONS
+ ***/
+
+/* Counters of the buffer pool since the set was opened. A hit is a request
+ * for a page that was already in a frame, a miss one that had to be read,
+ * and an eviction a page that was dropped to make room (and written first
+ * if it had changed). */
+typedef struct {
+
+  unsigned long long hits;
+  unsigned long long misses;
+  unsigned long long evictions;
+  unsigned long long writes;
+
+  unsigned long long pages;
+  unsigned long frames;
+
+} diskset_stats;
+
+/******************************************************************************
+ * MACRO DEFINITIONS
+ ***/
+
+#define diskset_hitratio(stats)						\
+  ((stats)->hits + (stats)->misses == 0 ? 1.0				\
+   : (double)(stats)->hits / (double)((stats)->hits + (stats)->misses))
+
+/******************************************************************************
+ * API FUNCTION PROTOTYPES
+ ***/
+
+extern set * set_create_disk(int (*match)(const void *, const void *),
+			     unsigned long (*hash)(const void *),
+			     void * (*copy)(const void *),
+			     void (*destroy)(void *),
+			     size_t width, const char * path, size_t cache);
+extern int set_disk_sync(set * set);
+extern int set_disk_stats(const set * set, diskset_stats * stats);
+
+#endif /* __ET_DISKSET_H__ */
+
+/*****************************************************************************/
@@ -0,0 +1,699 @@
+/******************************************************************************
+ * NAME:	    extset.c
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    Source file containing code for implementing an external-
+ *		    memory set. Every run is sorted and free of duplicates,
+ *		    but a record may appear in more than one run of a set. The
+ *		    set operations read all of the runs of all of the sets at
+ *		    once, through a heap ordered by their next records, and
+ *		    decide for each distinct record from which sets it came.
+ *		    Runs are only ever read and written sequentially, through
+ *		    large stdio buffers. This code follows the typedefs and
+ *		    prototypes in extset.h.
+ *
+ * CREATED:	    10/17/2026
+ *
+ * LAST EDITED:	    10/17/2026
+ ***/
+
+/******************************************************************************
+ * INCLUDES
+ ***/
+
+/* For mkstemp, fdopen and unlink. */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "extset.h"
+
+/******************************************************************************
+ * TYPE DEFINITIONS
+ ***/
+
+/* Which distinct records a merge passes on to its sink. */
+typedef enum {
+
+  MERGE_UNION,
+  MERGE_INTERSECTION,
+  MERGE_DIFFERENCE
+
+} merge_mode;
+
+/* A run being read by a merge, and the set it belongs to. */
+typedef struct {
+
+  FILE * file;
+  int set;
+
+} cursor;
+
+/******************************************************************************
+ * LOCAL PROTOTYPES
+ ***/
+
+static int open_run(const extset *, extrun *);
+static void close_run(extrun *);
+static int spill(extset *);
+static int crowded(const extset *, int);
+static int compact(extset *, int);
+static int append(const void *, size_t, void *);
+static int stop(const void *, size_t, void *);
+static int merge(extset * [], int, merge_mode, extset_sink, void *);
+static void sift_down(int *, int, int, const char *, size_t,
+		      int (*)(const void *, const void *));
+
+/******************************************************************************
+ * API FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:	    extset_create
+ *
+ * DESCRIPTION:	    Creates an empty external-memory set.
+ *
+ * ARGUMENTS:	    width: (size_t) -- the size of every record, in bytes.
+ *		    compare: (int (*)(const void *, const void *)) -- a three-
+ *			way comparison of two records, as for qsort.
+ *		    memory: (size_t) -- the size of the buffer that collects
+ *			records before they are spilled, in bytes.
+ *		    directory: (const char *) -- where to put the runs, or
+ *			NULL for the default directory of tmpfile().
+ *
+ * RETURN:	    (extset *) -- pointer to the new set, or NULL.
+ *
+ * NOTES:	    O(1). The memory used by a set is bounded by `memory' plus
+ *		    CONFIG_EXTSET_FANIN buffers of CONFIG_EXTSET_IOBUF bytes.
+ ***/
+extset * extset_create(size_t width,
+		       int (*compare)(const void *, const void *),
+		       size_t memory, const char * directory)
+{
+  if (width == 0 || compare == NULL)
+    return NULL;
+  extset * group = NULL;
+  if ((group = malloc(sizeof(extset))) == NULL)
+    return NULL;
+
+  *group = (extset){
+    .width = width,
+    .compare = compare,
+    .directory = NULL,
+    .buffer = NULL,
+    .capacity = memory / width > 0 ? memory / width : 1,
+    .buffered = 0,
+    .nruns = 0
+  };
+
+  if ((group->buffer = malloc(group->capacity * width)) == NULL)
+    goto error_exception;
+  if (directory != NULL) {
+    if ((group->directory = malloc(strlen(directory) + 1)) == NULL)
+      goto error_exception;
+    strcpy(group->directory, directory);
+  }
+
+  return group;
+
+ error_exception: {
+    extset_destroy(&group);
+    return NULL;
+  }
+}
+
+/******************************************************************************
+ * FUNCTION:	    extset_destroy
+ *
+ * DESCRIPTION:	    Frees the set and deletes its runs.
+ *
+ * ARGUMENTS:	    group: (extset **) -- the set to be operated on.
+ *
+ * RETURN:	    void.
+ *
+ * NOTES:	    O(runs)
+ ***/
+void extset_destroy(extset ** group)
+{
+  if (group == NULL || *group == NULL)
+    return;
+
+  for (int i = 0; i < (*group)->nruns; i++)
+    close_run(&(*group)->runs[i]);
+  free((*group)->buffer);
+  free((*group)->directory);
+  free(*group);
+  *group = NULL;
+}
+
+/******************************************************************************
+ * FUNCTION:	    extset_insert
+ *
+ * DESCRIPTION:	    Adds a record to the set.
+ *
+ * ARGUMENTS:	    group: (extset *) -- the set to be operated on.
+ *		    record: (const void *) -- the record, which is copied.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    O(1) amortized, plus the cost of sorting each full buffer.
+ *		    Duplicates are only removed when runs are written and
+ *		    merged, so inserting a member again is not reported.
+ ***/
+int extset_insert(extset * group, const void * record)
+{
+  if (group == NULL || record == NULL)
+    return -1;
+
+  memcpy(group->buffer + group->buffered * group->width, record, group->width);
+  if (++group->buffered == group->capacity)
+    return spill(group);
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    extset_flush
+ *
+ * DESCRIPTION:	    Sorts the records in the buffer and spills them to a run.
+ *
+ * ARGUMENTS:	    group: (extset *) -- the set to be operated on.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    O(b log b) for b buffered records. The set operations call
+ *		    this on every set they are given.
+ ***/
+int extset_flush(extset * group)
+{
+  if (group == NULL)
+    return -1;
+
+  return group->buffered > 0 ? spill(group) : 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    extset_union_func
+ *
+ * DESCRIPTION:	    Streams the union of the sets to a sink, in order.
+ *
+ * ARGUMENTS:	    sink: (extset_sink) -- receives every record of the union.
+ *		    context: (void *) -- passed to the sink.
+ *		    sets: (extset * []) -- NULL terminated array of sets, with
+ *			the same width and comparison.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise, or the nonzero value
+ *		    returned by the sink.
+ *
+ * NOTES:	    O(N log R) for N records in R runs in total, in one
+ *		    sequential pass over the runs. Should always be called by
+ *		    wrapper macro.
+ ***/
+int extset_union_func(extset_sink sink, void * context, extset * sets[])
+{
+  if (sink == NULL || sets[0] == NULL)
+    return -1;
+  int n = 0;
+  while (sets[n] != NULL)
+    n++;
+
+  return merge(sets, n, MERGE_UNION, sink, context);
+}
+
+/******************************************************************************
+ * FUNCTION:	    extset_intersection_func
+ *
+ * DESCRIPTION:	    Streams the intersection of the sets to a sink, in order.
+ *
+ * ARGUMENTS:	    sink: (extset_sink) -- receives every record of the
+ *			intersection.
+ *		    context: (void *) -- passed to the sink.
+ *		    sets: (extset * []) -- NULL terminated array of sets, with
+ *			the same width and comparison.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise, or the nonzero value
+ *		    returned by the sink.
+ *
+ * NOTES:	    O(N log R), as for extset_union_func. Should always be
+ *		    called by wrapper macro.
+ ***/
+int extset_intersection_func(extset_sink sink, void * context,
+			     extset * sets[])
+{
+  if (sink == NULL || sets[0] == NULL)
+    return -1;
+  int n = 0;
+  while (sets[n] != NULL)
+    n++;
+
+  return merge(sets, n, MERGE_INTERSECTION, sink, context);
+}
+
+/******************************************************************************
+ * FUNCTION:	    extset_difference
+ *
+ * DESCRIPTION:	    Streams the records of set1 that are not in set2 to a sink,
+ *		    in order.
+ *
+ * ARGUMENTS:	    sink: (extset_sink) -- receives every record of the
+ *			difference.
+ *		    context: (void *) -- passed to the sink.
+ *		    set1: (extset *) -- the minuend.
+ *		    set2: (extset *) -- the subtrahend.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise, or the nonzero value
+ *		    returned by the sink.
+ *
+ * NOTES:	    O(N log R), as for extset_union_func.
+ ***/
+int extset_difference(extset_sink sink, void * context, extset * set1,
+		      extset * set2)
+{
+  if (sink == NULL || set1 == NULL || set2 == NULL)
+    return -1;
+
+  return merge((extset * []){set1, set2}, 2, MERGE_DIFFERENCE, sink,
+	       context);
+}
+
+/******************************************************************************
+ * FUNCTION:	    extset_issubset
+ *
+ * DESCRIPTION:	    Determines if set1 is a subset of set2.
+ *
+ * ARGUMENTS:	    set1: (extset *) -- the set in question.
+ *		    set2: (extset *) -- the reference set.
+ *
+ * RETURN:	    int -- 1 if the set is a subset, 0 if it is not, -1 if an
+ *		    error has occurred.
+ *
+ * NOTES:	    O(N log R). The merge stops at the first record of set1
+ *		    that is missing from set2.
+ ***/
+int extset_issubset(extset * set1, extset * set2)
+{
+  switch (extset_difference(stop, NULL, set1, set2)) {
+  case 0:
+    return 1;
+  case 1:
+    return 0;
+  default:
+    return -1;
+  }
+}
+
+/******************************************************************************
+ * FUNCTION:	    extset_tofile
+ *
+ * DESCRIPTION:	    A sink that writes the records it receives to a file.
+ *
+ * ARGUMENTS:	    record: (const void *) -- the record.
+ *		    width: (size_t) -- the size of the record.
+ *		    file: (void *) -- the (FILE *) to write to.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    For a fast sequential write, give the file a large buffer
+ *		    with setvbuf.
+ ***/
+int extset_tofile(const void * record, size_t width, void * file)
+{
+  return fwrite(record, width, 1, file) == 1 ? 0 : -1;
+}
+
+/******************************************************************************
+ * LOCAL FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:	    open_run
+ *
+ * DESCRIPTION:	    Creates an empty run, in an anonymous temporary file.
+ *
+ * ARGUMENTS:	    group: (const extset *) -- the set the run is for.
+ *		    run: (extrun *) -- will contain the new run.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    The file is unlinked as soon as it is created, so it
+ *		    disappears when it is closed, even after a crash.
+ ***/
+static int open_run(const extset * group, extrun * run)
+{
+  *run = (extrun){.file = NULL, .iobuf = NULL, .count = 0, .level = 0};
+  if (group->directory == NULL) {
+    run->file = tmpfile();
+  } else {
+    char * path = NULL;
+    if ((path = malloc(strlen(group->directory) + 16)) == NULL)
+      return -1;
+    sprintf(path, "%s/extsetXXXXXX", group->directory);
+
+    int fd = mkstemp(path);
+    if (fd >= 0) {
+      unlink(path);
+      if ((run->file = fdopen(fd, "w+b")) == NULL)
+	close(fd);
+    }
+    free(path);
+  }
+
+  if (run->file == NULL || (run->iobuf = malloc(CONFIG_EXTSET_IOBUF)) == NULL
+      || setvbuf(run->file, run->iobuf, _IOFBF, CONFIG_EXTSET_IOBUF)) {
+    close_run(run);
+    return -1;
+  }
+
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    close_run
+ *
+ * DESCRIPTION:	    Closes (and so deletes) a run.
+ *
+ * ARGUMENTS:	    run: (extrun *) -- the run.
+ *
+ * RETURN:	    void.
+ *
+ * NOTES:	    The buffer is freed after the file, which may still flush
+ *		    into it.
+ ***/
+static void close_run(extrun * run)
+{
+  if (run->file != NULL)
+    fclose(run->file);
+  free(run->iobuf);
+  *run = (extrun){.file = NULL, .iobuf = NULL, .count = 0, .level = 0};
+}
+
+/******************************************************************************
+ * FUNCTION:	    spill
+ *
+ * DESCRIPTION:	    Sorts the buffer, and writes its distinct records to a new
+ *		    run of level 0. Then, while a level has CONFIG_EXTSET_TIER
+ *		    runs, merges them into one run of the next level. If the
+ *		    set already has CONFIG_EXTSET_FANIN runs, the runs of the
+ *		    lowest level that has more than one are merged first.
+ *
+ * ARGUMENTS:	    group: (extset *) -- the set to be operated on.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    O(b log b) for b buffered records, plus the merges. The
+ *		    buffer is emptied only if the run is written.
+ ***/
+static int spill(extset * group)
+{
+  if (group->nruns == CONFIG_EXTSET_FANIN && compact(group, crowded(group, 2)))
+    return -1;
+
+  qsort(group->buffer, group->buffered, group->width, group->compare);
+  extrun * run = &group->runs[group->nruns];
+  if (open_run(group, run))
+    return -1;
+
+  const char * previous = NULL;
+  for (size_t i = 0; i < group->buffered; i++) {
+    const char * record = group->buffer + i * group->width;
+    if (previous != NULL && group->compare(previous, record) == 0)
+      continue;
+    if (append(record, group->width, run)) {
+      close_run(run);
+      return -1;
+    }
+    previous = record;
+  }
+
+  group->nruns++;
+  group->buffered = 0;
+
+  /* The run is written, so a failed merge only leaves more runs. */
+  for (int level = crowded(group, CONFIG_EXTSET_TIER); level >= 0
+	 && !compact(group, level); level = crowded(group, CONFIG_EXTSET_TIER))
+    ;
+  return 0;
+}
+
+/* The lowest level with at least `count' runs, or -1 if there is none. */
+static int crowded(const extset * group, int count)
+{
+  int top = 0;
+  for (int i = 0; i < group->nruns; i++)
+    top = group->runs[i].level > top ? group->runs[i].level : top;
+
+  for (int level = 0; level <= top; level++) {
+    int runs = 0;
+    for (int i = 0; i < group->nruns; i++)
+      runs += group->runs[i].level == level;
+    if (runs >= count)
+      return level;
+  }
+  return -1;
+}
+
+/******************************************************************************
+ * FUNCTION:	    compact
+ *
+ * DESCRIPTION:	    Merges the runs of a set up to a level into one run of
+ *		    the next level.
+ *
+ * ARGUMENTS:	    group: (extset *) -- the set to be operated on.
+ *		    level: (int) -- the highest level to merge, which should
+ *			have at least two runs. If it is -1, every run is
+ *			merged.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise. On failure the old
+ *		    runs are kept.
+ *
+ * NOTES:	    O(n log r) for n records in the r runs merged. Only runs
+ *		    of about the same size are merged, so a record is not
+ *		    rewritten with every spill, only when its run moves up a
+ *		    level. A run of level l holds at least 2^l spills, and
+ *		    usually CONFIG_EXTSET_TIER^l, so over s spills every
+ *		    record is rewritten about log_T(s) times, and never more
+ *		    than log2(s) + 1 times, for a tier of T.
+ ***/
+static int compact(extset * group, int level)
+{
+  if (level < 0) {
+    for (int i = 0; i < group->nruns; i++)
+      level = group->runs[i].level > level ? group->runs[i].level : level;
+  }
+
+  /* The merge reads the runs through a view of the set that has only them,
+   * and not the buffer, which is not part of any run. */
+  extset part = *group;
+  part.buffered = 0;
+  part.nruns = 0;
+  for (int i = 0; i < group->nruns; i++)
+    if (group->runs[i].level <= level)
+      part.runs[part.nruns++] = group->runs[i];
+
+  extrun run;
+  if (open_run(group, &run))
+    return -1;
+  if (merge((extset * []){&part}, 1, MERGE_UNION, append, &run)) {
+    close_run(&run);
+    return -1;
+  }
+
+  int kept = 0;
+  for (int i = 0; i < group->nruns; i++) {
+    if (group->runs[i].level <= level)
+      close_run(&group->runs[i]);
+    else
+      group->runs[kept++] = group->runs[i];
+  }
+  run.level = level + 1;
+  group->runs[kept] = run;
+  group->nruns = kept + 1;
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    append
+ *
+ * DESCRIPTION:	    A sink that appends records to a run.
+ *
+ * ARGUMENTS:	    record: (const void *) -- the record.
+ *		    width: (size_t) -- the size of the record.
+ *		    run: (void *) -- the (extrun *) to append to.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    none.
+ ***/
+static int append(const void * record, size_t width, void * run)
+{
+  if (fwrite(record, width, 1, ((extrun *)run)->file) != 1)
+    return -1;
+  ((extrun *)run)->count++;
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    stop
+ *
+ * DESCRIPTION:	    A sink that stops the merge at the first record.
+ *
+ * ARGUMENTS:	    record, width, context: ignored.
+ *
+ * RETURN:	    int -- 1.
+ *
+ * NOTES:	    none.
+ ***/
+static int stop(const void * record, size_t width, void * context)
+{
+  return 1;
+}
+
+/******************************************************************************
+ * FUNCTION:	    merge
+ *
+ * DESCRIPTION:	    Merges the runs of the sets, and passes each distinct
+ *		    record that belongs in the result to the sink.
+ *
+ * ARGUMENTS:	    sets: (extset * []) -- the sets.
+ *		    n: (int) -- the number of sets.
+ *		    mode: (merge_mode) -- which records belong in the result.
+ *		    sink: (extset_sink) -- receives the result.
+ *		    context: (void *) -- passed to the sink.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise, or the nonzero value
+ *		    returned by the sink.
+ *
+ * NOTES:	    O(N log R). Holds one record per run in memory. A set that
+ *		    is given more than once is read once, since its runs
+ *		    have one file each; its later places take their
+ *		    membership from the first.
+ ***/
+static int merge(extset * sets[], int n, merge_mode mode, extset_sink sink,
+		 void * context)
+{
+  size_t width = sets[0]->width;
+  int (*compare)(const void *, const void *) = sets[0]->compare;
+  int * first = NULL;
+  if ((first = malloc(n * sizeof(int))) == NULL)
+    return -1;
+
+  int runs = 0;
+  for (int i = 0; i < n; i++) {
+    if (sets[i]->width != width || sets[i]->compare != compare
+	|| extset_flush(sets[i])) {
+      free(first);
+      return -1;
+    }
+    for (first[i] = 0; sets[first[i]] != sets[i]; first[i]++)
+      continue;
+    if (first[i] == i)
+      runs += sets[i]->nruns;
+  }
+
+  cursor * cursors = malloc((runs + 1) * sizeof(cursor));
+  int * heap = malloc((runs + 1) * sizeof(int));
+  char * records = malloc((runs + 1) * width);
+  char * current = malloc(width);
+  char * member = malloc(n);
+  int ret = -1;
+  if (cursors == NULL || heap == NULL || records == NULL || current == NULL
+      || member == NULL)
+    goto finish;
+
+  /* Start reading every run from the beginning. */
+  int size = 0;
+  for (int i = 0, r = 0; i < n; i++) {
+    for (int j = 0; first[i] == i && j < sets[i]->nruns; j++, r++) {
+      cursors[r] = (cursor){.file = sets[i]->runs[j].file, .set = i};
+      rewind(cursors[r].file);
+      if (fread(records + r * width, width, 1, cursors[r].file) == 1)
+	heap[size++] = r;
+      else if (ferror(cursors[r].file))
+	goto finish;
+    }
+  }
+  for (int i = size / 2 - 1; i >= 0; i--)
+    sift_down(heap, size, i, records, width, compare);
+
+  ret = 0;
+  while (size > 0 && ret == 0) {
+    memcpy(current, records + heap[0] * width, width);
+    memset(member, 0, n);
+
+    /* Take every copy of the smallest record off of the heap. */
+    while (size > 0 && compare(records + heap[0] * width, current) == 0) {
+      cursor * top = &cursors[heap[0]];
+      member[top->set] = 1;
+      if (fread(records + heap[0] * width, width, 1, top->file) != 1) {
+	if (ferror(top->file)) {
+	  ret = -1;
+	  break;
+	}
+	heap[0] = heap[--size];
+      }
+      sift_down(heap, size, 0, records, width, compare);
+    }
+
+    int all = 1;
+    for (int i = 0; i < n; i++)
+      all = all && member[first[i]];
+    if (ret == 0
+	&& ((mode == MERGE_UNION)
+	    || (mode == MERGE_INTERSECTION && all)
+	    || (mode == MERGE_DIFFERENCE && member[0] && !member[first[1]])))
+      ret = sink(current, width, context);
+  }
+
+ finish:
+  free(first);
+  free(cursors);
+  free(heap);
+  free(records);
+  free(current);
+  free(member);
+  return ret;
+}
+
+/******************************************************************************
+ * FUNCTION:	    sift_down
+ *
+ * DESCRIPTION:	    Restores the order of a min-heap of runs, keyed by their
+ *		    next records, below position i.
+ *
+ * ARGUMENTS:	    heap: (int *) -- the runs in the heap.
+ *		    size: (int) -- the number of runs in the heap.
+ *		    i: (int) -- the position that may be out of order.
+ *		    records: (const char *) -- the next record of every run.
+ *		    width: (size_t) -- the size of a record.
+ *		    compare: (int (*)(const void *, const void *)) -- the
+ *			comparison of records.
+ *
+ * RETURN:	    void.
+ *
+ * NOTES:	    O(log size)
+ ***/
+static void sift_down(int * heap, int size, int i, const char * records,
+		      size_t width, int (*compare)(const void *, const void *))
+{
+  for (;;) {
+    int smallest = i, left = 2 * i + 1, right = 2 * i + 2;
+    if (left < size && compare(records + heap[left] * width,
+			       records + heap[smallest] * width) < 0)
+      smallest = left;
+    if (right < size && compare(records + heap[right] * width,
+				records + heap[smallest] * width) < 0)
+      smallest = right;
+    if (smallest == i)
+      return;
+
+    int swap = heap[i];
+    heap[i] = heap[smallest];
+    heap[smallest] = swap;
+    i = smallest;
+  }
+}
+
+/*****************************************************************************/
@@ -0,0 +1,118 @@
+/******************************************************************************
+ * NAME:	    extset.h
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    The header file for the implementation of an external-
+ *		    memory set, for sets too large to hold in memory. Members
+ *		    are fixed-size records (such as 64-bit IDs), ordered by a
+ *		    comparison function like the one given to qsort. They are
+ *		    collected in a buffer of bounded size, which is sorted and
+ *		    spilled to disk as a run whenever it fills, and the set
+ *		    operations are computed by merging the runs of all of the
+ *		    sets in one streaming pass. The results are passed to a
+ *		    callback in order, which may write them to a file.
+ *
+ * CREATED:	    10/17/2026
+ *
+ * LAST EDITED:	    10/17/2026
+ ***/
+
+#ifndef __ET_EXTSET_H__
+#define __ET_EXTSET_H__
+
+#include <stdio.h>
+#include <stddef.h>
+
+/******************************************************************************
+ * CONFIGURATION
+ ***/
+
+/* The most runs a set keeps. When a spill would make more, the runs of the
+ * lowest level that has more than one are first merged. */
+#ifndef CONFIG_EXTSET_FANIN
+#   define CONFIG_EXTSET_FANIN 32
+#endif
+
+/* The runs of one level that are merged into one run of the next. At least
+ * 2, and less than CONFIG_EXTSET_FANIN. */
+#ifndef CONFIG_EXTSET_TIER
+#   define CONFIG_EXTSET_TIER 8
+#endif
+
+/* The size of the stdio buffer of each run, in bytes. */
+#ifndef CONFIG_EXTSET_IOBUF
+#   define CONFIG_EXTSET_IOBUF (256 * 1024)
+#endif
+
+/******************************************************************************
+ * TYPE DEFINITIONS
+ ***/
+
+/* A sorted run of distinct records in a temporary file. A spill makes a run
+ * of level 0, and merging runs of level l makes one of level l + 1. */
+typedef struct {
+
+  FILE * file;
+  char * iobuf;
+  long long count;
+  int level;
+
+} extrun;
+
+typedef struct {
+
+  size_t width;
+  int (*compare)(const void *, const void *);
+  char * directory;
+
+  char * buffer;
+  size_t capacity;
+  size_t buffered;
+
+  extrun runs[CONFIG_EXTSET_FANIN];
+  int nruns;
+
+} extset;
+
+/* Receives the records of a result in order. A nonzero return stops the
+ * operation, which then returns the same value. */
+typedef int (*extset_sink)(const void * record, size_t width, void * context);
+
+/******************************************************************************
+ * MACRO DEFINITIONS
+ ***/
+
+/* Wrapper macros for the variadic operations. As with set.h, these should
+ * ALWAYS be called instead of the corresponding _func functions.
+ */
+#define extset_union(Sink, Context, ...)				\
+  (extset_union_func(Sink, Context, (extset * []){__VA_ARGS__, NULL}))
+
+#define extset_intersection(Sink, Context, ...)				\
+  (extset_intersection_func(Sink, Context,				\
+			    (extset * []){__VA_ARGS__, NULL}))
+
+/******************************************************************************
+ * API FUNCTION PROTOTYPES
+ ***/
+
+extern extset * extset_create(size_t width,
+			      int (*compare)(const void *, const void *),
+			      size_t memory, const char * directory);
+extern void extset_destroy(extset ** set);
+extern int extset_insert(extset * set, const void * record);
+extern int extset_flush(extset * set);
+extern int extset_difference(extset_sink sink, void * context,
+			     extset * source1, extset * source2);
+extern int extset_issubset(extset * subset, extset * masterset);
+extern int extset_tofile(const void * record, size_t width, void * file);
+
+/* These functions: */
+extern int extset_union_func(extset_sink, void *, extset * []);
+extern int extset_intersection_func(extset_sink, void *, extset * []);
+/* Should NEVER be called directly. Use the wrapper macros defined above. */
+
+#endif /* __ET_EXTSET_H__ */
+
+/*****************************************************************************/
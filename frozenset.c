@@ -0,0 +1,416 @@
+/******************************************************************************
+ * NAME:	    frozenset.c
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    Source file containing code for implementing a frozen set.
+ *		    The minimal perfect hash is built by hash and displace, in
+ *		    the style of CHD and PTHash: the keys are split into small
+ *		    buckets by their hash, and the buckets, largest first, are
+ *		    each given a pilot, the smallest number that sends all of
+ *		    their keys to free positions. The positions range over
+ *		    slightly more slots than there are keys, which keeps the
+ *		    search for pilots short, and the few keys that land past
+ *		    the end are remapped to the holes that are left. This code
+ *		    follows the typedefs and prototypes in frozenset.h.
+ *
+ * CREATED:	    10/17/2026
+ *
+ * LAST EDITED:	    10/17/2026
+ ***/
+
+/******************************************************************************
+ * INCLUDES
+ ***/
+
+#include <stdlib.h>
+
+#include "frozenset.h"
+#include "setengine.h"
+
+/******************************************************************************
+ * MACRO DEFINITIONS
+ ***/
+
+/* The average number of keys in a bucket. */
+#define FROZENSET_BUCKET_SIZE 2
+/* A bucket for which no pilot below this is found makes the build restart
+ * with a new seed, and after FROZENSET_SEEDS seeds the build fails. */
+#define FROZENSET_MAX_PILOT (1u << 20)
+#define FROZENSET_SEEDS 8
+
+/* Both map a 32-bit value onto [0, n) with a multiply instead of a modulo. */
+#define bucket_of(frozen, h)						\
+  ((unsigned long)(((h) >> 32) * (unsigned long long)(frozen)->buckets >> 32))
+#define position_of(frozen, h, pilot)					\
+  ((unsigned long)((((h) ^ mix(pilot)) & 0xffffffffULL)			\
+		   * (unsigned long long)(frozen)->capacity >> 32))
+
+#define bit_test(bits, i) ((bits)[(i) / 64] >> ((i) % 64) & 1)
+#define bit_set(bits, i) ((bits)[(i) / 64] |= 1ULL << ((i) % 64))
+
+/******************************************************************************
+ * LOCAL PROTOTYPES
+ ***/
+
+static unsigned long long mix(unsigned long long);
+static unsigned long long key_hash(const frozenset *, const void *);
+static int place(frozenset *, unsigned long, const unsigned long long *,
+		 unsigned long *);
+
+/******************************************************************************
+ * API FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:	    frozenset_build
+ *
+ * DESCRIPTION:	    Builds a frozen set holding copies of the members of
+ *		    `source'.
+ *
+ * ARGUMENTS:	    source: (const set *) -- a hashed or interned set, with a
+ *			copy function. It is not modified.
+ *
+ * RETURN:	    (frozenset *) -- the new frozen set, or NULL if an error has
+ *		    occurred, including when two members have the same hash.
+ *
+ * NOTES:	    O(n) expected. Besides the copies of the keys, the frozen
+ *		    set takes about one pointer and one pilot per key, and
+ *		    the build needs about five words per key of scratch
+ *		    space.
+ ***/
+frozenset * frozenset_build(const set * source)
+{
+  if (source == NULL || source->copy == NULL
+      || (source->hash == NULL && !set_isinterned(source)))
+    return NULL;
+  frozenset * frozen = NULL;
+  if ((frozen = malloc(sizeof(frozenset))) == NULL)
+    return NULL;
+
+  unsigned long n = set_size(source);
+  *frozen = (frozenset){
+    .size = 0,
+    .match = source->match,
+    .hash = source->hash,
+    .destroy = source->destroy,
+    .seed = 0,
+    .capacity = n + n / 32 + 1,
+    .buckets = n / FROZENSET_BUCKET_SIZE + 1,
+    .pilots = NULL,
+    .remap = NULL,
+    .keys = NULL
+  };
+
+  unsigned long long * hashes = NULL;
+  void ** data = NULL;
+  unsigned long * positions = NULL;
+  unsigned long copied = 0;
+  frozen->pilots = malloc(frozen->buckets * sizeof(unsigned int));
+  frozen->remap = malloc((frozen->capacity - n) * sizeof(unsigned long));
+  frozen->keys = calloc(n + 1, sizeof(void *));
+  hashes = malloc((n + 1) * sizeof(unsigned long long));
+  data = malloc((n + 1) * sizeof(void *));
+  positions = malloc((n + 1) * sizeof(unsigned long));
+  if (frozen->pilots == NULL || frozen->remap == NULL || frozen->keys == NULL
+      || hashes == NULL || data == NULL || positions == NULL)
+    goto error_exception;
+
+  /* The members are copied as they are visited, since an engine that keeps
+   * records by value only holds each one until the next call. */
+  unsigned long i = 0;
+  set_iterator iterator;
+  for (void * member = set_begin(source, &iterator);
+       member != NULL && copied < n;
+       member = set_advance(source, &iterator)) {
+    if ((data[copied] = source->copy(member)) == NULL)
+      goto error_exception;
+    copied++;
+  }
+  if (copied != n)
+    goto error_exception;
+
+  int placed = -1;
+  for (int seed = 0; seed < FROZENSET_SEEDS && placed; seed++) {
+    frozen->seed = seed;
+    for (i = 0; i < n; i++)
+      hashes[i] = key_hash(frozen, data[i]);
+    if ((placed = place(frozen, n, hashes, positions)) == -1)
+      goto error_exception;
+  }
+  if (placed)
+    goto error_exception;
+
+  /* Move the copies into the positions found for them. */
+  for (i = 0; i < n; i++) {
+    unsigned long position = positions[i] < n ? positions[i]
+      : frozen->remap[positions[i] - n];
+    frozen->keys[position] = data[i];
+  }
+  frozen->size = n;
+
+  free(hashes);
+  free(data);
+  free(positions);
+  return frozen;
+
+ error_exception: {
+    for (i = 0; i < copied && source->destroy != NULL; i++)
+      source->destroy(data[i]);
+    free(hashes);
+    free(data);
+    free(positions);
+    frozenset_destroy(&frozen);
+    return NULL;
+  }
+}
+
+/******************************************************************************
+ * FUNCTION:	    frozenset_destroy
+ *
+ * DESCRIPTION:	    Frees the frozen set, destroying its keys with the destroy
+ *		    function of the set it was built from.
+ *
+ * ARGUMENTS:	    frozen: (frozenset **) -- the set to be operated on.
+ *
+ * RETURN:	    void.
+ *
+ * NOTES:	    O(n)
+ ***/
+void frozenset_destroy(frozenset ** frozen)
+{
+  if (frozen == NULL || *frozen == NULL)
+    return;
+
+  if ((*frozen)->keys != NULL && (*frozen)->destroy != NULL)
+    for (int i = 0; i < (*frozen)->size; i++)
+      if ((*frozen)->keys[i] != NULL)
+	(*frozen)->destroy((*frozen)->keys[i]);
+
+  free((*frozen)->pilots);
+  free((*frozen)->remap);
+  free((*frozen)->keys);
+  free(*frozen);
+  *frozen = NULL;
+}
+
+/******************************************************************************
+ * FUNCTION:	    frozenset_ismember
+ *
+ * DESCRIPTION:	    Determines if `data' is a member of the frozen set.
+ *
+ * ARGUMENTS:	    frozen: (const frozenset *) -- the set to be operated on.
+ *		    data: (const void *) -- data to check.
+ *
+ * RETURN:	    int -- 1 if the member is in the set, 0 if it is not.
+ *
+ * NOTES:	    O(1). One hash and one comparison: the only key that can
+ *		    match `data' is the one at the position the hash gives.
+ ***/
+int frozenset_ismember(const frozenset * frozen, const void * data)
+{
+  if (frozen == NULL || data == NULL || frozenset_isempty(frozen))
+    return 0;
+
+  unsigned long long h = key_hash(frozen, data);
+  unsigned long position = position_of(frozen, h,
+				       frozen->pilots[bucket_of(frozen, h)]);
+  if (position >= (unsigned long)frozen->size)
+    position = frozen->remap[position - frozen->size];
+
+  return set_matches(frozen, frozen->keys[position], data);
+}
+
+/******************************************************************************
+ * FUNCTION:	    frozenset_traverse
+ *
+ * DESCRIPTION:	    Calls func() on each member of the frozen set.
+ *
+ * ARGUMENTS:	    frozen: (frozenset *) -- the set to be operated on.
+ *		    func: (void (*)(void *)) -- the function to be called on
+ *			each member.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    O(n). The order is unspecified.
+ ***/
+int frozenset_traverse(frozenset * frozen, void (*func)(void *))
+{
+  if (frozen == NULL || frozenset_isempty(frozen) || func == NULL)
+    return -1;
+
+  for (int i = 0; i < frozen->size; i++)
+    func(frozen->keys[i]);
+
+  return 0;
+}
+
+/******************************************************************************
+ * LOCAL FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:	    mix
+ *
+ * DESCRIPTION:	    Scrambles the bits of a 64-bit value.
+ *
+ * ARGUMENTS:	    h: (unsigned long long) -- the value.
+ *
+ * RETURN:	    unsigned long long -- the mixed value.
+ *
+ * NOTES:	    This is the finalizer of MurmurHash3.
+ ***/
+static unsigned long long mix(unsigned long long h)
+{
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
+
+/******************************************************************************
+ * FUNCTION:	    key_hash
+ *
+ * DESCRIPTION:	    Computes the hash that places a key, from the user hash
+ *		    (or address, for interned sets) and the seed.
+ *
+ * ARGUMENTS:	    frozen: (const frozenset *) -- the frozen set.
+ *		    data: (const void *) -- the key.
+ *
+ * RETURN:	    unsigned long long -- the hash.
+ *
+ * NOTES:	    O(1)
+ ***/
+static unsigned long long key_hash(const frozenset * frozen,
+				   const void * data)
+{
+  return mix(set_hashof(frozen, data) + frozen->seed * 0x9e3779b97f4a7c15ULL);
+}
+
+/******************************************************************************
+ * FUNCTION:	    place
+ *
+ * DESCRIPTION:	    Finds a pilot for every bucket, and the position of every
+ *		    key, for the current seed.
+ *
+ * ARGUMENTS:	    frozen: (frozenset *) -- the set being built. Its pilots
+ *			and remap arrays are filled in.
+ *		    n: (unsigned long) -- the number of keys.
+ *		    hashes: (const unsigned long long *) -- the hash of each
+ *			key.
+ *		    positions: (unsigned long *) -- will contain the position
+ *			of each key, in [0, capacity).
+ *
+ * RETURN:	    int -- 0 if successful, -2 if some bucket has no pilot for
+ *		    this seed, -1 on any other error.
+ *
+ * NOTES:	    O(n) expected. The keys are grouped by bucket, and the
+ *		    buckets by size, with counting sorts.
+ ***/
+static int place(frozenset * frozen, unsigned long n,
+		 const unsigned long long * hashes, unsigned long * positions)
+{
+  unsigned long r = frozen->buckets, m = frozen->capacity;
+  unsigned long * start = calloc(r + 1, sizeof(unsigned long));
+  unsigned long * members = malloc((n + 1) * sizeof(unsigned long));
+  unsigned long long * grouped = malloc((n + 1) * sizeof(unsigned long long));
+  unsigned long * order = malloc(r * sizeof(unsigned long));
+  unsigned long long * taken = calloc(m / 64 + 1, sizeof(unsigned long long));
+  unsigned long * sizes = NULL, * tried = NULL;
+  int ret = -1;
+  if (start == NULL || members == NULL || grouped == NULL || order == NULL
+      || taken == NULL)
+    goto finish;
+
+  /* Group the keys by bucket, with their hashes next to each other so that
+   * trying a pilot reads memory in order. start[b] is first the size of
+   * bucket b - 1, then the end of bucket b, and finally its start. */
+  for (unsigned long i = 0; i < n; i++)
+    start[bucket_of(frozen, hashes[i]) + 1]++;
+  unsigned long largest = 0;
+  for (unsigned long b = 1; b <= r; b++) {
+    if (start[b] > largest)
+      largest = start[b];
+    start[b] += start[b - 1];
+  }
+  for (unsigned long i = 0; i < n; i++) {
+    unsigned long j = start[bucket_of(frozen, hashes[i])]++;
+    members[j] = i;
+    grouped[j] = hashes[i];
+  }
+  for (unsigned long b = r; b > 0; b--)
+    start[b] = start[b - 1];
+  start[0] = 0;
+
+  /* Order the buckets from largest to smallest. */
+  if ((sizes = calloc(largest + 2, sizeof(unsigned long))) == NULL
+      || (tried = malloc((largest + 1) * sizeof(unsigned long))) == NULL)
+    goto finish;
+  for (unsigned long b = 0; b < r; b++)
+    sizes[largest - (start[b + 1] - start[b]) + 1]++;
+  for (unsigned long k = 1; k <= largest + 1; k++)
+    sizes[k] += sizes[k - 1];
+  for (unsigned long b = 0; b < r; b++)
+    order[sizes[largest - (start[b + 1] - start[b])]++] = b;
+
+  ret = 0;
+  for (unsigned long o = 0; o < r && ret == 0; o++) {
+    unsigned long b = order[o], first = start[b];
+    unsigned long size = start[b + 1] - first;
+    unsigned int pilot = 0;
+    for (; pilot < FROZENSET_MAX_PILOT; pilot++) {
+      unsigned long j = 0;
+      for (; j < size; j++) {
+	unsigned long position = position_of(frozen, grouped[first + j],
+					     pilot);
+	if (bit_test(taken, position))
+	  break;
+	unsigned long k = 0;
+	while (k < j && tried[k] != position)
+	  k++;
+	if (k < j)
+	  break;
+	tried[j] = position;
+      }
+
+      if (j == size)
+	break;
+    }
+
+    if (pilot == FROZENSET_MAX_PILOT) {
+      ret = -2;
+      break;
+    }
+
+    frozen->pilots[b] = pilot;
+    for (unsigned long j = 0; j < size; j++) {
+      bit_set(taken, tried[j]);
+      positions[members[first + j]] = tried[j];
+    }
+  }
+
+  /* Send the positions past the end to the holes below it. */
+  unsigned long hole = 0;
+  for (unsigned long p = n; p < m && ret == 0; p++) {
+    frozen->remap[p - n] = 0;
+    if (!bit_test(taken, p))
+      continue;
+    while (bit_test(taken, hole))
+      hole++;
+    frozen->remap[p - n] = hole++;
+  }
+
+ finish:
+  free(start);
+  free(members);
+  free(grouped);
+  free(order);
+  free(taken);
+  free(sizes);
+  free(tried);
+  return ret;
+}
+
+/*****************************************************************************/
@@ -0,0 +1,67 @@
+/******************************************************************************
+ * NAME:	    frozenset.h
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    The header file for the implementation of a frozen set, an
+ *		    immutable copy of a hashed set (set.h) built around a
+ *		    minimal perfect hash function. Every member has its own
+ *		    slot in a key array with no empty slots, so membership is
+ *		    decided by one hash and one comparison, without probing.
+ *		    It is meant for sets that are built once and then only
+ *		    queried, such as allow lists loaded at startup.
+ *
+ * CREATED:	    10/17/2026
+ *
+ * LAST EDITED:	    10/17/2026
+ ***/
+
+#ifndef __ET_FROZENSET_H__
+#define __ET_FROZENSET_H__
+
+#include "set.h"
+
+/******************************************************************************
+ * TYPE DEFINITIONS
+ ***/
+
+/* The hash of a key, which depends on the seed, selects one of `buckets'
+ * buckets, and the pilot of that bucket selects one of `capacity' positions.
+ * Positions at or past `size' are redirected into the key array by `remap'.
+ */
+typedef struct {
+
+  int size;
+
+  int (*match)(const void *, const void *);
+  unsigned long (*hash)(const void *);
+  void (*destroy)(void *);
+
+  unsigned long seed;
+  unsigned long capacity;
+  unsigned long buckets;
+  unsigned int * pilots;
+  unsigned long * remap;
+  void ** keys;
+
+} frozenset;
+
+/******************************************************************************
+ * MACRO DEFINITIONS
+ ***/
+
+#define frozenset_size(set) ((set)->size)
+#define frozenset_isempty(set) (frozenset_size(set) == 0 ? 1 : 0)
+
+/******************************************************************************
+ * API FUNCTION PROTOTYPES
+ ***/
+
+extern frozenset * frozenset_build(const set * source);
+extern void frozenset_destroy(frozenset ** set);
+extern int frozenset_ismember(const frozenset * set, const void * data);
+extern int frozenset_traverse(frozenset * set, void (*func)(void *));
+
+#endif /* __ET_FROZENSET_H__ */
+
+/*****************************************************************************/
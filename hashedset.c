@@ -0,0 +1,295 @@
+/******************************************************************************
+ * NAME:	    hashedset.c
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    Source file containing the hashed set engine. A hashed set
+ *		    starts out small: its first CONFIG_SET_INLINE members and
+ *		    their hashes live in arrays inside the set object, and are
+ *		    found by a linear scan of the hashes, so small sets never
+ *		    allocate. Once the set outgrows the arrays, its members
+ *		    are moved to a hash table (hashtable.h), which the set
+ *		    keeps for the rest of its life.
+ *
+ * CREATED:	    10/17/2026
+ *
+ * LAST EDITED:	    10/17/2026
+ ***/
+
+/******************************************************************************
+ * INCLUDES
+ ***/
+
+#include <stdlib.h>
+
+#include "set.h"
+#include "setengine.h"
+#include "hashtable.h"
+
+/******************************************************************************
+ * LOCAL PROTOTYPES
+ ***/
+
+static int find_inline(const set *, const void *, unsigned long);
+static int upgrade(set *);
+
+static int hashed_ismember(const set *, const void *);
+static int hashed_insert(set *, void *);
+static void * hashed_remove(set *, const void *);
+static void * hashed_begin(const set *, set_iterator *);
+static void * hashed_advance(const set *, set_iterator *);
+static void hashed_clear(set *);
+
+/******************************************************************************
+ * ENGINES
+ ***/
+
+const set_engine set_hashed_engine = {
+  .name = "hashed",
+  .ismember = hashed_ismember,
+  .insert = hashed_insert,
+  .remove = hashed_remove,
+  .begin = hashed_begin,
+  .advance = hashed_advance,
+  .clear = hashed_clear
+};
+
+/******************************************************************************
+ * LOCAL FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:	    find_inline
+ *
+ * DESCRIPTION:	    Searches the inline members of a small set.
+ *
+ * ARGUMENTS:	    group: (const set *) -- a set without a hash table.
+ *		    data: (const void *) -- the data to look for.
+ *		    hash: (unsigned long) -- the hash of `data'.
+ *
+ * RETURN:	    int -- the position of the matching member, or -1.
+ *
+ * NOTES:	    O(CONFIG_SET_INLINE). The hashes are compared in a loop of
+ *		    fixed length without branches, which the compiler can
+ *		    vectorize, and match is only called where they are equal.
+ ***/
+static int find_inline(const set * group, const void * data,
+		       unsigned long hash)
+{
+  unsigned long long candidates = 0;
+  for (int i = 0; i < CONFIG_SET_INLINE; i++)
+    candidates |= (unsigned long long)(group->hashes[i] == hash) << i;
+  if (group->size < 64)
+    candidates &= (1ULL << group->size) - 1;
+
+  for (int i = 0; candidates != 0; i++, candidates >>= 1)
+    if ((candidates & 1) && set_matches(group, group->inlined[i], data))
+      return i;
+
+  return -1;
+}
+
+/******************************************************************************
+ * FUNCTION:	    upgrade
+ *
+ * DESCRIPTION:	    Moves the inline members of a full small set into a new
+ *		    hash table.
+ *
+ * ARGUMENTS:	    group: (set *) -- a set without a hash table.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise. On failure the set is
+ *		    left unchanged.
+ *
+ * NOTES:	    O(CONFIG_SET_INLINE)
+ ***/
+static int upgrade(set * group)
+{
+  hashtable * table = NULL;
+  if ((table = malloc(sizeof(hashtable))) == NULL)
+    return -1;
+  if (hashtable_init(table, 4 * CONFIG_SET_INLINE, group->hash,
+		     group->match)
+      || hashtable_setpages(table, (hashtable_pages)group->pages)
+      || hashtable_setincremental(table, group->incremental)) {
+    hashtable_fini(table, NULL);
+    free(table);
+    return -1;
+  }
+
+  for (int i = 0; i < group->size; i++) {
+    if (hashtable_insert(table, group->inlined[i], NULL) == NULL) {
+      hashtable_fini(table, NULL);
+      free(table);
+      return -1;
+    }
+  }
+
+  group->storage = table;
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    hashed_ismember
+ *
+ * DESCRIPTION:	    ismember primitive of the hashed engine.
+ *
+ * ARGUMENTS:	    group: (const set *) -- the set to be operated on.
+ *		    data: (const void *) -- data to check.
+ *
+ * RETURN:	    int -- 1 if the member is in the set, 0 if it is not.
+ *
+ * NOTES:	    O(1) expected.
+ ***/
+static int hashed_ismember(const set * group, const void * data)
+{
+  if (group->storage != NULL)
+    return hashtable_lookup(group->storage, data) != NULL;
+  return find_inline(group, data, set_hashof(group, data)) >= 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    hashed_insert
+ *
+ * DESCRIPTION:	    insert primitive of the hashed engine. Upgrades the set to
+ *		    a hash table when the inline arrays are full.
+ *
+ * ARGUMENTS:	    group: (set *) -- the set to be operated on.
+ *		    data: (void *) -- data to insert.
+ *
+ * RETURN:	    int -- 0 if successful, 1 if the data is already contained
+ *		    in the set, -1 otherwise.
+ *
+ * NOTES:	    O(1) amortized.
+ ***/
+static int hashed_insert(set * group, void * data)
+{
+  if (group->storage == NULL) {
+    unsigned long hash = set_hashof(group, data);
+    if (find_inline(group, data, hash) >= 0)
+      return 1;
+
+    if (group->size < CONFIG_SET_INLINE) {
+      group->hashes[group->size] = hash;
+      group->inlined[group->size] = data;
+      group->size++;
+      return 0;
+    }
+
+    if (upgrade(group))
+      return -1;
+  }
+
+  int inserted = 0;
+  if (hashtable_insert(group->storage, data, &inserted) == NULL)
+    return -1;
+  if (!inserted)
+    return 1;
+
+  group->size++;
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    hashed_remove
+ *
+ * DESCRIPTION:	    remove primitive of the hashed engine. In a small set, the
+ *		    last inline member is moved into the hole.
+ *
+ * ARGUMENTS:	    group: (set *) -- the set to be operated on.
+ *		    data: (const void *) -- data to remove.
+ *
+ * RETURN:	    void * -- the data of the removed member, or NULL.
+ *
+ * NOTES:	    O(1) expected.
+ ***/
+static void * hashed_remove(set * group, const void * data)
+{
+  void * old = NULL;
+  if (group->storage != NULL) {
+    if ((old = hashtable_remove(group->storage, data)) != NULL)
+      group->size--;
+    return old;
+  }
+
+  int i = find_inline(group, data, set_hashof(group, data));
+  if (i < 0)
+    return NULL;
+
+  old = group->inlined[i];
+  group->size--;
+  group->inlined[i] = group->inlined[group->size];
+  group->hashes[i] = group->hashes[group->size];
+  return old;
+}
+
+/******************************************************************************
+ * FUNCTION:	    hashed_begin
+ *
+ * DESCRIPTION:	    begin primitive of the hashed engine.
+ *
+ * ARGUMENTS:	    group: (const set *) -- the set to be operated on.
+ *		    iterator: (set_iterator *) -- will contain the position.
+ *
+ * RETURN:	    void * -- the data of the first member, or NULL.
+ *
+ * NOTES:	    O(1) amortized.
+ ***/
+static void * hashed_begin(const set * group, set_iterator * iterator)
+{
+  iterator->node = NULL;
+  iterator->index = -1;
+  return hashed_advance(group, iterator);
+}
+
+/******************************************************************************
+ * FUNCTION:	    hashed_advance
+ *
+ * DESCRIPTION:	    advance primitive of the hashed engine.
+ *
+ * ARGUMENTS:	    group: (const set *) -- the set to be operated on.
+ *		    iterator: (set_iterator *) -- the current position.
+ *
+ * RETURN:	    void * -- the data of the next member, or NULL.
+ *
+ * NOTES:	    O(1) amortized.
+ ***/
+static void * hashed_advance(const set * group, set_iterator * iterator)
+{
+  if (group->storage == NULL) {
+    if (++iterator->index < group->size)
+      return group->inlined[iterator->index];
+    return NULL;
+  }
+
+  bucket * entry = hashtable_next(group->storage, iterator->node);
+  iterator->node = entry;
+  return entry == NULL ? NULL : entry->data;
+}
+
+/******************************************************************************
+ * FUNCTION:	    hashed_clear
+ *
+ * DESCRIPTION:	    clear primitive of the hashed engine. The set becomes small
+ *		    again.
+ *
+ * ARGUMENTS:	    group: (set *) -- the set to be operated on.
+ *
+ * RETURN:	    void.
+ *
+ * NOTES:	    O(n)
+ ***/
+static void hashed_clear(set * group)
+{
+  if (group->storage != NULL) {
+    hashtable_fini(group->storage, group->destroy);
+    free(group->storage);
+    group->storage = NULL;
+  } else if (group->destroy != NULL) {
+    for (int i = 0; i < group->size; i++)
+      group->destroy(group->inlined[i]);
+  }
+
+  group->size = 0;
+}
+
+/*****************************************************************************/
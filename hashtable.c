@@ -0,0 +1,765 @@
+/******************************************************************************
+ * NAME:	    hashtable.c
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    Source file containing the open-addressed hash table used
+ *		    by the hashed containers in this library. Collisions are
+ *		    resolved by linear probing, and removed entries are marked
+ *		    with a tombstone so that probe sequences stay intact. The
+ *		    table is rebuilt (and the tombstones dropped) when live
+ *		    entries and tombstones together exceed 3/4 of the slots.
+ *		    A table made without hash and match functions compares
+ *		    its data by address, which is how canonical pointers from
+ *		    intern.h are stored. A large array of buckets can be put
+ *		    on huge pages, so that random probes miss the TLB less.
+ *		    A table can also be rebuilt incrementally: the new array
+ *		    is allocated at once, and each insertion then moves the
+ *		    next CONFIG_HASHTABLE_MIGRATE slots of the old one into
+ *		    it, while lookups search both.
+ *
+ * CREATED:	    10/17/2026
+ *
+ * LAST EDITED:	    10/17/2026
+ ***/
+
+/******************************************************************************
+ * INCLUDES
+ ***/
+
+/* For MAP_ANONYMOUS, MAP_HUGETLB and madvise. */
+#define _DEFAULT_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "hashtable.h"
+
+/******************************************************************************
+ * MACRO DEFINITIONS
+ ***/
+
+#define HASHTABLE_MIN_CAPACITY 8
+
+/* The size of a huge page, if the system does not say. */
+#define HASHTABLE_HUGE_DEFAULT (2UL * 1024 * 1024)
+
+#define bucket_isempty(b) ((b)->data == NULL)
+#define bucket_istombstone(b) ((b)->data == (void *)&tombstone)
+#define bucket_islive(b) (!bucket_isempty(b) && !bucket_istombstone(b))
+
+#define hash_of(table, data)					\
+  ((table)->hash == NULL ? (unsigned long)(uintptr_t)(data)	\
+   : (table)->hash(data))
+#define matches(table, one, two)					\
+  ((table)->match == NULL ? (one) == (two) : (table)->match(one, two) == 1)
+
+/******************************************************************************
+ * STATIC VARIABLES
+ ***/
+
+/* The address of this variable marks a removed entry. */
+static char tombstone;
+
+/******************************************************************************
+ * LOCAL PROTOTYPES
+ ***/
+
+static unsigned long mix(unsigned long);
+static bucket * probe(const hashtable *, bucket *, unsigned long,
+		      unsigned long, const void *);
+static int place(bucket *, unsigned long, const bucket *);
+static int resize(hashtable *, unsigned long);
+static int begin_resize(hashtable *, unsigned long);
+static void migrate(hashtable *, unsigned long);
+static bucket * alloc_buckets(hashtable_pages, unsigned long, size_t *,
+			      unsigned long *);
+static void free_buckets(bucket *, size_t);
+static unsigned long read_size(const char *, const char *);
+
+/******************************************************************************
+ * API FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:	    hashtable_init
+ *
+ * DESCRIPTION:	    Initializes an empty table with room for at least
+ *		    `capacity' slots.
+ *
+ * ARGUMENTS:	    table: (hashtable *) -- the table to initialize.
+ *		    capacity: (unsigned long) -- the initial number of slots.
+ *			This is rounded up to a power of two.
+ *		    hash: (unsigned long (*)(const void *)) -- user-defined
+ *			function returning the hash of a datum. Data that are
+ *			equal under `match' must hash to the same value.
+ *		    match: (int (*)(const void *, const void *)) -- user-
+ *			defined function returning 1 for equal data and 0
+ *			otherwise.
+ *			If both hash and match are NULL, data are only equal
+ *			to themselves, and their address is the hash.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    O(capacity)
+ ***/
+int hashtable_init(hashtable * table, unsigned long capacity,
+		   unsigned long (*hash)(const void *),
+		   int (*match)(const void *, const void *))
+{
+  if (table == NULL || (hash == NULL) != (match == NULL))
+    return -1;
+
+  unsigned long slots = HASHTABLE_MIN_CAPACITY;
+  while (slots < capacity)
+    slots <<= 1;
+
+  *table = (hashtable){
+    .size = 0,
+    .used = 0,
+    .capacity = slots,
+    .hash = hash,
+    .match = match,
+    .buckets = NULL,
+    .pages = HASHTABLE_PAGES_NORMAL,
+    .mapped = 0,
+    .pagesize = 0,
+    .incremental = 0,
+    .old = NULL,
+    .oldcapacity = 0,
+    .moved = 0,
+    .oldmapped = 0
+  };
+
+  if ((table->buckets = calloc(slots, sizeof(bucket))) == NULL)
+    return -1;
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    hashtable_fini
+ *
+ * DESCRIPTION:	    Releases the memory held by the table. If destroy is not
+ *		    NULL, it is called on the data in every live entry.
+ *
+ * ARGUMENTS:	    table: (hashtable *) -- the table to finalize.
+ *		    destroy: (void (*)(void *)) -- frees the user data, or NULL.
+ *
+ * RETURN:	    void.
+ *
+ * NOTES:	    O(capacity)
+ ***/
+void hashtable_fini(hashtable * table, void (*destroy)(void *))
+{
+  if (table == NULL || table->buckets == NULL)
+    return;
+
+  if (destroy != NULL) {
+    for (unsigned long i = 0; i < table->capacity; i++)
+      if (bucket_islive(&table->buckets[i]))
+	destroy(table->buckets[i].data);
+    for (unsigned long i = table->moved; table->old != NULL
+	   && i < table->oldcapacity; i++)
+      if (bucket_islive(&table->old[i]))
+	destroy(table->old[i].data);
+  }
+
+  free_buckets(table->buckets, table->mapped);
+  if (table->old != NULL)
+    free_buckets(table->old, table->oldmapped);
+  table->buckets = table->old = NULL;
+  table->size = table->used = table->capacity = 0;
+  table->oldcapacity = table->moved = 0;
+  table->mapped = table->oldmapped = 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    hashtable_lookup
+ *
+ * DESCRIPTION:	    Finds the entry whose data matches `data'.
+ *
+ * ARGUMENTS:	    table: (const hashtable *) -- the table to search.
+ *		    data: (const void *) -- the datum to look for.
+ *
+ * RETURN:	    bucket * -- the matching entry, or NULL if there is none.
+ *
+ * NOTES:	    O(1) expected. The full hash is compared before `match' is
+ *		    called, so most collisions never reach the user function.
+ *		    During an incremental resize, the old array is searched
+ *		    after the new one.
+ ***/
+bucket * hashtable_lookup(const hashtable * table, const void * data)
+{
+  if (table == NULL || data == NULL || table->size == 0)
+    return NULL;
+
+  unsigned long hash = mix(hash_of(table, data));
+  bucket * found = probe(table, table->buckets, table->capacity, hash, data);
+  if (found == NULL && table->old != NULL)
+    found = probe(table, table->old, table->oldcapacity, hash, data);
+  return found;
+}
+
+/******************************************************************************
+ * FUNCTION:	    hashtable_insert
+ *
+ * DESCRIPTION:	    Inserts `data' into the table if no matching entry exists.
+ *
+ * ARGUMENTS:	    table: (hashtable *) -- the table to operate on.
+ *		    data: (void *) -- the datum to insert. The table keeps the
+ *			pointer only if a new entry is created.
+ *		    inserted: (int *) -- if not NULL, set to 1 when a new entry
+ *			is created and 0 when a matching entry already exists.
+ *
+ * RETURN:	    bucket * -- the new or existing entry, or NULL if an error
+ *		    has occurred. New entries have a count of 0.
+ *
+ * NOTES:	    O(1) amortized. If the table is incremental (see
+ *		    hashtable_setincremental), O(CONFIG_HASHTABLE_MIGRATE)
+ *		    expected in the worst case instead: a resize only
+ *		    allocates the new array, and each insertion moves a few
+ *		    slots of the old one.
+ ***/
+bucket * hashtable_insert(hashtable * table, void * data, int * inserted)
+{
+  if (table == NULL || data == NULL)
+    return NULL;
+
+  if (table->old != NULL)
+    migrate(table, CONFIG_HASHTABLE_MIGRATE);
+
+  if ((table->used + 1) * 4 > table->capacity * 3) {
+    /* Double if live entries are filling the table, otherwise a rebuild at
+     * the same size is enough to clear out the tombstones. */
+    unsigned long capacity = (table->size + 1) * 2 > table->capacity
+      ? table->capacity * 2 : table->capacity;
+    if (table->incremental ? begin_resize(table, capacity)
+	: resize(table, capacity))
+      return NULL;
+  }
+
+  unsigned long hash = mix(hash_of(table, data));
+  bucket * found = NULL;
+  if (table->old != NULL && (found = probe(table, table->old,
+					   table->oldcapacity, hash, data))
+      != NULL) {
+    if (inserted != NULL)
+      *inserted = 0;
+    return found;
+  }
+
+  unsigned long mask = table->capacity - 1;
+  bucket * slot = NULL;
+  for (unsigned long i = hash & mask;; i = (i + 1) & mask) {
+    bucket * current = &table->buckets[i];
+    if (bucket_isempty(current)) {
+      if (slot == NULL) {
+	slot = current;
+	table->used++;
+      }
+      break;
+    }
+
+    if (bucket_istombstone(current)) {
+      if (slot == NULL)
+	slot = current;
+    } else if (current->hash == hash
+	       && matches(table, current->data, data)) {
+      if (inserted != NULL)
+	*inserted = 0;
+      return current;
+    }
+  }
+
+  *slot = (bucket){.hash = hash, .data = data, .count = 0};
+  table->size++;
+  if (inserted != NULL)
+    *inserted = 1;
+  return slot;
+}
+
+/******************************************************************************
+ * FUNCTION:	    hashtable_remove
+ *
+ * DESCRIPTION:	    Removes the entry matching `data' from the table.
+ *
+ * ARGUMENTS:	    table: (hashtable *) -- the table to operate on.
+ *		    data: (const void *) -- the datum to remove.
+ *
+ * RETURN:	    void * -- the data held by the removed entry, which the
+ *		    caller is now responsible for, or NULL if there was no
+ *		    matching entry.
+ *
+ * NOTES:	    O(1) expected.
+ ***/
+void * hashtable_remove(hashtable * table, const void * data)
+{
+  bucket * old = NULL;
+  if ((old = hashtable_lookup(table, data)) == NULL)
+    return NULL;
+
+  void * removed = old->data;
+  old->data = (void *)&tombstone;
+  table->size--;
+  return removed;
+}
+
+/******************************************************************************
+ * FUNCTION:	    hashtable_next
+ *
+ * DESCRIPTION:	    Iterates over the live entries of the table.
+ *
+ * ARGUMENTS:	    table: (const hashtable *) -- the table to iterate over.
+ *		    prev: (const bucket *) -- the entry returned by the previous
+ *			call, or NULL to start at the beginning.
+ *
+ * RETURN:	    bucket * -- the next live entry, or NULL at the end.
+ *
+ * NOTES:	    O(1) amortized. The order is unspecified, and the table
+ *		    must not be modified during iteration, except to remove
+ *		    the entry most recently returned. During an incremental
+ *		    resize, the entries left in the old array come first.
+ ***/
+bucket * hashtable_next(const hashtable * table, const bucket * prev)
+{
+  if (table == NULL || table->buckets == NULL)
+    return NULL;
+
+  bucket * array = table->old != NULL ? table->old : table->buckets;
+  unsigned long i = 0;
+  if (prev != NULL) {
+    uintptr_t at = (uintptr_t)prev;
+    if (table->old == NULL || at < (uintptr_t)table->old
+	|| at >= (uintptr_t)(table->old + table->oldcapacity))
+      array = table->buckets;
+    i = (prev - array) + 1;
+  }
+
+  for (;;) {
+    unsigned long capacity = array == table->old ? table->oldcapacity
+      : table->capacity;
+    for (; i < capacity; i++)
+      if (bucket_islive(&array[i]))
+	return &array[i];
+    if (array == table->buckets)
+      return NULL;
+    array = table->buckets;
+    i = 0;
+  }
+}
+
+/******************************************************************************
+ * FUNCTION:	    hashtable_setpages
+ *
+ * DESCRIPTION:	    Chooses the pages that back the array of buckets, from now
+ *		    on and for the current array.
+ *
+ * ARGUMENTS:	    table: (hashtable *) -- the table to operate on.
+ *		    pages: (hashtable_pages) -- the kind of pages.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise. Falling back to
+ *		    smaller pages is not an error.
+ *
+ * NOTES:	    O(capacity), if the array is moved. Arrays smaller than
+ *		    CONFIG_HASHTABLE_HUGE_MIN stay where they are.
+ ***/
+int hashtable_setpages(hashtable * table, hashtable_pages pages)
+{
+  if (table == NULL || pages < HASHTABLE_PAGES_NORMAL
+      || pages > HASHTABLE_PAGES_EXPLICIT)
+    return -1;
+
+  table->pages = pages;
+  if (table->buckets == NULL
+      || (table->mapped == 0
+	  && table->capacity * sizeof(bucket) < CONFIG_HASHTABLE_HUGE_MIN))
+    return 0;
+  return resize(table, table->capacity);
+}
+
+/******************************************************************************
+ * FUNCTION:	    hashtable_pagesize
+ *
+ * DESCRIPTION:	    Finds the size of the pages that back the array of
+ *		    buckets.
+ *
+ * ARGUMENTS:	    table: (const hashtable *) -- the table.
+ *
+ * RETURN:	    unsigned long -- the page size in bytes.
+ *
+ * NOTES:	    For transparent huge pages, reads /proc/self/smaps to see
+ *		    whether the kernel has granted any to the mapping. The
+ *		    answer can change as the kernel collapses or splits them.
+ ***/
+unsigned long hashtable_pagesize(const hashtable * table)
+{
+  unsigned long base = (unsigned long)sysconf(_SC_PAGESIZE);
+  if (table == NULL || table->buckets == NULL || table->mapped == 0)
+    return base;
+  if (table->pagesize != 0)
+    return table->pagesize;
+
+  FILE * smaps = fopen("/proc/self/smaps", "r");
+  if (smaps == NULL)
+    return base;
+
+  char line[256];
+  int inside = 0;
+  unsigned long start = 0, end = 0, huge = 0;
+  uintptr_t address = (uintptr_t)table->buckets;
+  while (fgets(line, sizeof(line), smaps) != NULL) {
+    if (sscanf(line, "%lx-%lx", &start, &end) == 2) {
+      if (inside)
+	break;
+      inside = address >= start && address < end;
+    } else if (inside && sscanf(line, "AnonHugePages: %lu kB", &huge) == 1) {
+      break;
+    }
+  }
+  fclose(smaps);
+
+  if (huge == 0)
+    return base;
+  unsigned long size = read_size("/sys/kernel/mm/transparent_hugepage/"
+				 "hpage_pmd_size", NULL);
+  return size != 0 ? size : HASHTABLE_HUGE_DEFAULT;
+}
+
+/******************************************************************************
+ * FUNCTION:	    hashtable_setincremental
+ *
+ * DESCRIPTION:	    Chooses whether the table is resized all at once, or
+ *		    incrementally. An incremental table allocates its new
+ *		    array when it must grow, and moves the entries of the old
+ *		    one CONFIG_HASHTABLE_MIGRATE slots at a time, on each
+ *		    insertion that follows, which bounds the time of every
+ *		    insertion instead of the average.
+ *
+ * ARGUMENTS:	    table: (hashtable *) -- the table to operate on.
+ *		    incremental: (int) -- nonzero to resize incrementally.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    Turning it off finishes a resize that is under way, in
+ *		    O(capacity).
+ ***/
+int hashtable_setincremental(hashtable * table, int incremental)
+{
+  if (table == NULL)
+    return -1;
+
+  table->incremental = incremental != 0;
+  if (!table->incremental && table->old != NULL)
+    migrate(table, table->oldcapacity - table->moved);
+  return 0;
+}
+
+/******************************************************************************
+ * LOCAL FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:	    mix
+ *
+ * DESCRIPTION:	    Scrambles the bits of a user hash, so that functions like
+ *		    the identity on small integers still spread evenly over a
+ *		    power-of-two table.
+ *
+ * ARGUMENTS:	    hash: (unsigned long) -- the user hash.
+ *
+ * RETURN:	    unsigned long -- the mixed hash.
+ *
+ * NOTES:	    This is the finalizer of MurmurHash3.
+ ***/
+static unsigned long mix(unsigned long hash)
+{
+  unsigned long long h = hash;
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return (unsigned long)h;
+}
+
+/******************************************************************************
+ * FUNCTION:	    probe
+ *
+ * DESCRIPTION:	    Finds the entry whose data matches `data' in one array of
+ *		    buckets.
+ *
+ * ARGUMENTS:	    table: (const hashtable *) -- the table, for its match.
+ *		    buckets: (bucket *) -- the array to search.
+ *		    capacity: (unsigned long) -- the slots of the array.
+ *		    hash: (unsigned long) -- the mixed hash of `data'.
+ *		    data: (const void *) -- the datum to look for.
+ *
+ * RETURN:	    bucket * -- the matching entry, or NULL if there is none.
+ *
+ * NOTES:	    O(1) expected.
+ ***/
+static bucket * probe(const hashtable * table, bucket * buckets,
+		      unsigned long capacity, unsigned long hash,
+		      const void * data)
+{
+  unsigned long mask = capacity - 1;
+  for (unsigned long i = hash & mask;; i = (i + 1) & mask) {
+    bucket * current = &buckets[i];
+    if (bucket_isempty(current))
+      return NULL;
+    if (!bucket_istombstone(current) && current->hash == hash
+	&& matches(table, current->data, data))
+      return current;
+  }
+}
+
+/* Copies an entry into the first free slot on its probe sequence. Returns 1
+ * if the slot was empty, and 0 if it was a tombstone. */
+static int place(bucket * buckets, unsigned long capacity,
+		 const bucket * entry)
+{
+  unsigned long mask = capacity - 1, j = entry->hash & mask;
+  while (bucket_islive(&buckets[j]))
+    j = (j + 1) & mask;
+
+  int empty = bucket_isempty(&buckets[j]);
+  buckets[j] = *entry;
+  return empty;
+}
+
+/******************************************************************************
+ * FUNCTION:	    resize
+ *
+ * DESCRIPTION:	    Moves every live entry into a new array of `capacity'
+ *		    slots, dropping all tombstones. The entries still in the
+ *		    old array of an incremental resize are moved too.
+ *
+ * ARGUMENTS:	    table: (hashtable *) -- the table to resize.
+ *		    capacity: (unsigned long) -- the new number of slots. Must
+ *			be a power of two larger than the number of entries.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise. On failure the table
+ *		    is left unchanged.
+ *
+ * NOTES:	    O(capacity)
+ ***/
+static int resize(hashtable * table, unsigned long capacity)
+{
+  bucket * buckets = NULL;
+  size_t mapped = 0;
+  unsigned long pagesize = 0;
+  if ((buckets = alloc_buckets(table->pages, capacity, &mapped, &pagesize))
+      == NULL)
+    return -1;
+
+  for (unsigned long i = 0; i < table->capacity; i++)
+    if (bucket_islive(&table->buckets[i]))
+      place(buckets, capacity, &table->buckets[i]);
+  for (unsigned long i = table->moved; table->old != NULL
+	 && i < table->oldcapacity; i++)
+    if (bucket_islive(&table->old[i]))
+      place(buckets, capacity, &table->old[i]);
+
+  free_buckets(table->buckets, table->mapped);
+  if (table->old != NULL)
+    free_buckets(table->old, table->oldmapped);
+  table->buckets = buckets;
+  table->capacity = capacity;
+  table->used = table->size;
+  table->mapped = mapped;
+  table->pagesize = pagesize;
+  table->old = NULL;
+  table->oldcapacity = table->moved = 0;
+  table->oldmapped = 0;
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    begin_resize
+ *
+ * DESCRIPTION:	    Starts an incremental resize: the array of buckets
+ *		    becomes the old array, and an empty one of `capacity'
+ *		    slots takes its place.
+ *
+ * ARGUMENTS:	    table: (hashtable *) -- the table to resize.
+ *		    capacity: (unsigned long) -- as in resize.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise. On failure the table
+ *		    is left unchanged.
+ *
+ * NOTES:	    O(1), less the cost of the allocation, which is lazy for a
+ *		    large array. If a resize is already under way, the table
+ *		    is resized at once.
+ ***/
+static int begin_resize(hashtable * table, unsigned long capacity)
+{
+  if (table->old != NULL)
+    return resize(table, capacity);
+
+  bucket * buckets = NULL;
+  size_t mapped = 0;
+  unsigned long pagesize = 0;
+  if ((buckets = alloc_buckets(table->pages, capacity, &mapped, &pagesize))
+      == NULL)
+    return -1;
+
+  table->old = table->buckets;
+  table->oldcapacity = table->capacity;
+  table->oldmapped = table->mapped;
+  table->moved = 0;
+  table->buckets = buckets;
+  table->capacity = capacity;
+  table->used = 0;
+  table->mapped = mapped;
+  table->pagesize = pagesize;
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    migrate
+ *
+ * DESCRIPTION:	    Moves the live entries in the next `count' slots of the
+ *		    old array into the new one, and frees the old array once
+ *		    it has all been moved.
+ *
+ * ARGUMENTS:	    table: (hashtable *) -- a table being resized.
+ *		    count: (unsigned long) -- the slots to move.
+ *
+ * RETURN:	    void.
+ *
+ * NOTES:	    O(count) expected. A moved entry leaves a tombstone, so
+ *		    that the probe sequences of the entries after it in the
+ *		    old array stay intact. Each insertion moves at least 8
+ *		    slots, and a resize leaves the new array no more than
+ *		    half full, so the move is done before it fills.
+ ***/
+static void migrate(hashtable * table, unsigned long count)
+{
+  unsigned long end = table->oldcapacity - table->moved > count
+    ? table->moved + count : table->oldcapacity;
+  for (; table->moved < end; table->moved++) {
+    bucket * current = &table->old[table->moved];
+    if (!bucket_islive(current))
+      continue;
+    table->used += place(table->buckets, table->capacity, current);
+    current->data = (void *)&tombstone;
+  }
+
+  if (table->moved == table->oldcapacity) {
+    free_buckets(table->old, table->oldmapped);
+    table->old = NULL;
+    table->oldcapacity = table->moved = 0;
+    table->oldmapped = 0;
+  }
+}
+
+/******************************************************************************
+ * FUNCTION:	    alloc_buckets
+ *
+ * DESCRIPTION:	    Allocates a zeroed array of buckets, on the pages asked
+ *		    for if it is large enough, and if the system allows.
+ *
+ * ARGUMENTS:	    pages: (hashtable_pages) -- the kind of pages.
+ *		    capacity: (unsigned long) -- the number of buckets.
+ *		    mapped: (size_t *) -- set to the length of the mapping, or
+ *			0 if the array came from calloc.
+ *		    pagesize: (unsigned long *) -- set to the page size, if the
+ *			mapping fixes it, or 0.
+ *
+ * RETURN:	    bucket * -- the array, or NULL.
+ *
+ * NOTES:	    Explicit huge pages fall back to transparent ones, which
+ *		    fall back to calloc. A mapping for transparent huge pages
+ *		    is aligned to a huge page, since the kernel can only use
+ *		    huge pages for the aligned parts of it.
+ ***/
+static bucket * alloc_buckets(hashtable_pages pages, unsigned long capacity,
+			      size_t * mapped, unsigned long * pagesize)
+{
+  size_t bytes = capacity * sizeof(bucket);
+  *mapped = 0;
+  *pagesize = 0;
+  if (pages == HASHTABLE_PAGES_NORMAL || bytes < CONFIG_HASHTABLE_HUGE_MIN)
+    return calloc(capacity, sizeof(bucket));
+
+#ifdef MAP_HUGETLB
+  if (pages == HASHTABLE_PAGES_EXPLICIT) {
+    unsigned long huge = read_size("/proc/meminfo", "Hugepagesize:");
+    huge = huge != 0 ? huge * 1024 : HASHTABLE_HUGE_DEFAULT;
+    size_t length = (bytes + huge - 1) / huge * huge;
+    void * memory = mmap(NULL, length, PROT_READ | PROT_WRITE,
+			 MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (memory != MAP_FAILED) {
+      *mapped = length;
+      *pagesize = huge;
+      return memory;
+    }
+  }
+#endif /* MAP_HUGETLB */
+
+#ifdef MADV_HUGEPAGE
+  size_t huge = HASHTABLE_HUGE_DEFAULT;
+  size_t length = (bytes + huge - 1) / huge * huge;
+  char * memory = mmap(NULL, length + huge, PROT_READ | PROT_WRITE,
+		       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (memory != MAP_FAILED) {
+    char * aligned = (char *)(((uintptr_t)memory + huge - 1)
+			      & ~(uintptr_t)(huge - 1));
+    if (aligned > memory)
+      munmap(memory, aligned - memory);
+    if (memory + huge > aligned)
+      munmap(aligned + length, memory + huge - aligned);
+    madvise(aligned, length, MADV_HUGEPAGE);
+    *mapped = length;
+    return (bucket *)aligned;
+  }
+#endif /* MADV_HUGEPAGE */
+
+  return calloc(capacity, sizeof(bucket));
+}
+
+/* Frees an array from alloc_buckets. */
+static void free_buckets(bucket * buckets, size_t mapped)
+{
+  if (mapped != 0)
+    munmap(buckets, mapped);
+  else
+    free(buckets);
+}
+
+/******************************************************************************
+ * FUNCTION:	    read_size
+ *
+ * DESCRIPTION:	    Reads a number from a file of the kernel, either alone or
+ *		    on the line that starts with a key.
+ *
+ * ARGUMENTS:	    path: (const char *) -- the file.
+ *		    key: (const char *) -- the start of the line, such as
+ *			"Hugepagesize:", or NULL if the file is only a number.
+ *
+ * RETURN:	    unsigned long -- the number, or 0 if it cannot be read.
+ *
+ * NOTES:	    none.
+ ***/
+static unsigned long read_size(const char * path, const char * key)
+{
+  FILE * file = fopen(path, "r");
+  if (file == NULL)
+    return 0;
+
+  char line[256];
+  unsigned long size = 0;
+  size_t length = key == NULL ? 0 : strlen(key);
+  while (size == 0 && fgets(line, sizeof(line), file) != NULL)
+    if (key == NULL || strncmp(line, key, length) == 0)
+      if (sscanf(line + length, "%lu", &size) != 1)
+	size = 0;
+  fclose(file);
+  return size;
+}
+
+/*****************************************************************************/
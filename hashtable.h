@@ -0,0 +1,119 @@
+/******************************************************************************
+ * NAME:	    hashtable.h
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    The header file for the open-addressed hash table that
+ *		    backs the hashed containers in this library. The table
+ *		    stores pointers to user data, looked up by a user-defined
+ *		    hash and match function, and an integer payload per entry.
+ *		    A table can grow incrementally, moving a few entries to
+ *		    its new array on each insertion, so that no single
+ *		    insertion pays for copying the whole table.
+ *
+ * CREATED:	    10/17/2026
+ *
+ * LAST EDITED:	    10/17/2026
+ ***/
+
+#ifndef __ET_HASHTABLE_H__
+#define __ET_HASHTABLE_H__
+
+#include <stddef.h>
+
+/******************************************************************************
+ * CONFIGURATION
+ ***/
+
+/* Arrays of buckets smaller than this many bytes are never put on huge
+ * pages, since they would not fill one. */
+#ifndef CONFIG_HASHTABLE_HUGE_MIN
+#   define CONFIG_HASHTABLE_HUGE_MIN (2UL * 1024 * 1024)
+#endif
+
+/* The slots of the old array that an insertion moves while a table grows
+ * incrementally. At least 8, so that the move is done before the new array
+ * fills. */
+#ifndef CONFIG_HASHTABLE_MIGRATE
+#   define CONFIG_HASHTABLE_MIGRATE 16
+#endif
+
+/******************************************************************************
+ * TYPE DEFINITIONS
+ ***/
+
+typedef struct {
+
+  unsigned long hash;
+  void * data;
+  long count;
+
+} bucket;
+
+/* The pages that back the array of buckets. Explicit huge pages come from
+ * the reserved pool (MAP_HUGETLB); transparent ones are asked of the kernel
+ * with madvise(MADV_HUGEPAGE), and granted when it can. Each falls back to
+ * the next. */
+typedef enum {
+
+  HASHTABLE_PAGES_NORMAL,
+  HASHTABLE_PAGES_TRANSPARENT,
+  HASHTABLE_PAGES_EXPLICIT
+
+} hashtable_pages;
+
+typedef struct {
+
+  unsigned long size;
+  unsigned long used;
+  unsigned long capacity;
+
+  unsigned long (*hash)(const void *);
+  int (*match)(const void *, const void *);
+
+  bucket * buckets;
+
+  /* The pages asked for, and what the buckets got: the length of their
+   * mapping (0 if they came from calloc), and its page size if it is known
+   * from the mapping itself (0 if it is up to the kernel). */
+  hashtable_pages pages;
+  size_t mapped;
+  unsigned long pagesize;
+
+  /* While an incremental resize is under way, the array being moved out
+   * of: its slots before `moved' are empty or tombstones, and the entries
+   * after it are counted in `size' but not in `used'. */
+  int incremental;
+  bucket * old;
+  unsigned long oldcapacity;
+  unsigned long moved;
+  size_t oldmapped;
+
+} hashtable;
+
+/******************************************************************************
+ * MACRO DEFINITIONS
+ ***/
+
+#define hashtable_size(table) ((table)->size)
+
+/******************************************************************************
+ * API FUNCTION PROTOTYPES
+ ***/
+
+extern int hashtable_init(hashtable * table, unsigned long capacity,
+			  unsigned long (*hash)(const void *),
+			  int (*match)(const void *, const void *));
+extern void hashtable_fini(hashtable * table, void (*destroy)(void *));
+extern bucket * hashtable_lookup(const hashtable * table, const void * data);
+extern bucket * hashtable_insert(hashtable * table, void * data,
+				 int * inserted);
+extern void * hashtable_remove(hashtable * table, const void * data);
+extern bucket * hashtable_next(const hashtable * table, const bucket * prev);
+extern int hashtable_setpages(hashtable * table, hashtable_pages pages);
+extern unsigned long hashtable_pagesize(const hashtable * table);
+extern int hashtable_setincremental(hashtable * table, int incremental);
+
+#endif /* __ET_HASHTABLE_H__ */
+
+/*****************************************************************************/
@@ -0,0 +1,311 @@
+/******************************************************************************
+ * NAME:	    intern.c
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    Source file containing code for implementing an interning
+ *		    pool. The canonical copies are held in a hash table
+ *		    (hashtable.h), whose per-entry counts are used as
+ *		    reference counts: a copy is destroyed when the last
+ *		    reference to it is released. This code follows the
+ *		    typedefs and prototypes in intern.h.
+ *
+ * CREATED:	    10/17/2026
+ *
+ * LAST EDITED:	    10/17/2026
+ ***/
+
+/******************************************************************************
+ * INCLUDES
+ ***/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "intern.h"
+#include "stringset.h"
+
+/******************************************************************************
+ * STATIC VARIABLES
+ ***/
+
+/* The global string pool, created by the first call to intern_string and
+ * destroyed when its last string is released. */
+static internpool * strings = NULL;
+
+/******************************************************************************
+ * LOCAL PROTOTYPES
+ ***/
+
+static int match_string(const void *, const void *);
+static unsigned long hash_string(const void *);
+static void * copy_string(const void *);
+
+/******************************************************************************
+ * API FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:	    intern_create
+ *
+ * DESCRIPTION:	    Creates an empty interning pool with the parameters given.
+ *
+ * ARGUMENTS:	    match: (int (*)(const void *, const void *)) -- as in
+ *			set_create.
+ *		    hash: (unsigned long (*)(const void *)) -- as in
+ *			set_create_hashed.
+ *		    copy: (void * (*)(const void *)) -- makes the canonical
+ *			copy of a value the first time it is interned.
+ *		    destroy: (void (*)(void *)) -- frees a canonical copy. May
+ *			be NULL.
+ *
+ * RETURN:	    (internpool *) -- pointer to the new pool, or NULL.
+ *
+ * NOTES:	    O(1)
+ ***/
+internpool * intern_create(int (*match)(const void *, const void *),
+			   unsigned long (*hash)(const void *),
+			   void * (*copy)(const void *),
+			   void (*destroy)(void *))
+{
+  if (match == NULL || hash == NULL || copy == NULL)
+    return NULL;
+  internpool * pool = NULL;
+  if ((pool = malloc(sizeof(internpool))) == NULL)
+    return NULL;
+
+  *pool = (internpool){
+    .match = match,
+    .hash = hash,
+    .copy = copy,
+    .destroy = destroy
+  };
+
+  if (hashtable_init(&pool->table, 0, hash, match)) {
+    free(pool);
+    return NULL;
+  }
+
+  return pool;
+}
+
+/******************************************************************************
+ * FUNCTION:	    intern_destroy
+ *
+ * DESCRIPTION:	    Frees the pool and every canonical copy in it, whether or
+ *		    not it has been released.
+ *
+ * ARGUMENTS:	    pool: (internpool **) -- the pool to be operated on.
+ *
+ * RETURN:	    void.
+ *
+ * NOTES:	    O(n). Every handle from the pool becomes invalid.
+ ***/
+void intern_destroy(internpool ** pool)
+{
+  if (pool == NULL || *pool == NULL)
+    return;
+
+  hashtable_fini(&(*pool)->table, (*pool)->destroy);
+  free(*pool);
+  *pool = NULL;
+}
+
+/******************************************************************************
+ * FUNCTION:	    intern
+ *
+ * DESCRIPTION:	    Returns the canonical copy of `data', making it if the pool
+ *		    has none, and adds a reference to it.
+ *
+ * ARGUMENTS:	    pool: (internpool *) -- the pool to be operated on.
+ *		    data: (const void *) -- the value to intern. The caller
+ *			keeps ownership of it.
+ *
+ * RETURN:	    const void * -- the handle, or NULL if an error has
+ *		    occurred.
+ *
+ * NOTES:	    O(1) amortized. Each call should be paired with a call to
+ *		    intern_release.
+ ***/
+const void * intern(internpool * pool, const void * data)
+{
+  if (pool == NULL || data == NULL)
+    return NULL;
+
+  bucket * entry = NULL;
+  if ((entry = hashtable_lookup(&pool->table, data)) == NULL) {
+    void * canonical = NULL;
+    if ((canonical = pool->copy(data)) == NULL)
+      return NULL;
+    if ((entry = hashtable_insert(&pool->table, canonical, NULL)) == NULL) {
+      if (pool->destroy != NULL)
+	pool->destroy(canonical);
+      return NULL;
+    }
+  }
+
+  entry->count++;
+  return entry->data;
+}
+
+/******************************************************************************
+ * FUNCTION:	    intern_find
+ *
+ * DESCRIPTION:	    Returns the canonical copy of `data', if the pool has one.
+ *
+ * ARGUMENTS:	    pool: (const internpool *) -- the pool to be operated on.
+ *		    data: (const void *) -- the value to look for.
+ *
+ * RETURN:	    const void * -- the handle, or NULL if `data' has not been
+ *		    interned.
+ *
+ * NOTES:	    O(1) expected. No reference is added, so this is the way
+ *		    to turn a value into a key for set_ismember on a set of
+ *		    handles.
+ ***/
+const void * intern_find(const internpool * pool, const void * data)
+{
+  if (pool == NULL || data == NULL)
+    return NULL;
+
+  bucket * entry = hashtable_lookup(&pool->table, data);
+  return entry == NULL ? NULL : entry->data;
+}
+
+/******************************************************************************
+ * FUNCTION:	    intern_release
+ *
+ * DESCRIPTION:	    Drops a reference to a handle, destroying the canonical
+ *		    copy if it was the last one.
+ *
+ * ARGUMENTS:	    pool: (internpool *) -- the pool to be operated on.
+ *		    handle: (const void *) -- a handle returned by intern.
+ *
+ * RETURN:	    int -- 0 if successful, -1 if the handle is not in the
+ *		    pool.
+ *
+ * NOTES:	    O(1) expected.
+ ***/
+int intern_release(internpool * pool, const void * handle)
+{
+  if (pool == NULL || handle == NULL)
+    return -1;
+
+  bucket * entry = NULL;
+  if ((entry = hashtable_lookup(&pool->table, handle)) == NULL
+      || entry->data != handle)
+    return -1;
+
+  if (--entry->count == 0) {
+    void * canonical = hashtable_remove(&pool->table, handle);
+    if (pool->destroy != NULL)
+      pool->destroy(canonical);
+  }
+
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    intern_string
+ *
+ * DESCRIPTION:	    Interns a string in the global string pool.
+ *
+ * ARGUMENTS:	    string: (const char *) -- the string to intern.
+ *
+ * RETURN:	    const char * -- the canonical copy, or NULL if an error has
+ *		    occurred.
+ *
+ * NOTES:	    O(length) expected. The global pool is not safe to use
+ *		    from more than one thread at a time.
+ ***/
+const char * intern_string(const char * string)
+{
+  if (strings == NULL
+      && (strings = intern_create(match_string, hash_string, copy_string,
+				  free)) == NULL)
+    return NULL;
+
+  return intern(strings, string);
+}
+
+/******************************************************************************
+ * FUNCTION:	    intern_string_release
+ *
+ * DESCRIPTION:	    Drops a reference to a string in the global string pool.
+ *
+ * ARGUMENTS:	    handle: (const char *) -- a handle returned by
+ *			intern_string.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    O(length) expected. When the last string is released, the
+ *		    pool itself is freed.
+ ***/
+int intern_string_release(const char * handle)
+{
+  if (intern_release(strings, handle))
+    return -1;
+
+  if (intern_size(strings) == 0)
+    intern_destroy(&strings);
+  return 0;
+}
+
+/******************************************************************************
+ * LOCAL FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:	    match_string
+ *
+ * DESCRIPTION:	    The match function of the global string pool.
+ *
+ * ARGUMENTS:	    one: (const void *) -- the first string.
+ *		    two: (const void *) -- the second string.
+ *
+ * RETURN:	    int -- 1 if the strings are equal, 0 otherwise.
+ *
+ * NOTES:	    none.
+ ***/
+static int match_string(const void * one, const void * two)
+{
+  return strcmp(one, two) == 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    hash_string
+ *
+ * DESCRIPTION:	    The hash function of the global string pool.
+ *
+ * ARGUMENTS:	    string: (const void *) -- the string to hash.
+ *
+ * RETURN:	    unsigned long -- the hash, from stringset_hash.
+ *
+ * NOTES:	    none.
+ ***/
+static unsigned long hash_string(const void * string)
+{
+  return stringset_hash(string, strlen(string));
+}
+
+/******************************************************************************
+ * FUNCTION:	    copy_string
+ *
+ * DESCRIPTION:	    The copy function of the global string pool.
+ *
+ * ARGUMENTS:	    string: (const void *) -- the string to copy.
+ *
+ * RETURN:	    void * -- the copy, or NULL.
+ *
+ * NOTES:	    none.
+ ***/
+static void * copy_string(const void * string)
+{
+  size_t size = strlen(string) + 1;
+  char * copy = NULL;
+  if ((copy = malloc(size)) != NULL)
+    memcpy(copy, string, size);
+  return copy;
+}
+
+/*****************************************************************************/
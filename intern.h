@@ -0,0 +1,66 @@
+/******************************************************************************
+ * NAME:	    intern.h
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    The header file for the implementation of an interning
+ *		    pool. A pool keeps one canonical copy of every distinct
+ *		    value given to it, and hands out pointers to that copy, so
+ *		    equal values interned in the same pool have equal handles.
+ *		    Sets made with set_create_interned (set.h) compare and
+ *		    hash these handles by address, without calling any user
+ *		    function. A global pool of strings is provided as well.
+ *
+ * CREATED:	    10/17/2026
+ *
+ * LAST EDITED:	    10/17/2026
+ ***/
+
+#ifndef __ET_INTERN_H__
+#define __ET_INTERN_H__
+
+#include "hashtable.h"
+
+/******************************************************************************
+ * TYPE DEFINITIONS
+ ***/
+
+/* The count of each entry in the table is the number of references to it. */
+typedef struct {
+
+  int (*match)(const void *, const void *);
+  unsigned long (*hash)(const void *);
+  void * (*copy)(const void *);
+  void (*destroy)(void *);
+
+  hashtable table;
+
+} internpool;
+
+/******************************************************************************
+ * MACRO DEFINITIONS
+ ***/
+
+/* The number of distinct values in the pool. */
+#define intern_size(pool) ((int)hashtable_size(&(pool)->table))
+
+/******************************************************************************
+ * API FUNCTION PROTOTYPES
+ ***/
+
+extern internpool * intern_create(int (*match)(const void *, const void *),
+				  unsigned long (*hash)(const void *),
+				  void * (*copy)(const void *),
+				  void (*destroy)(void *));
+extern void intern_destroy(internpool ** pool);
+extern const void * intern(internpool * pool, const void * data);
+extern const void * intern_find(const internpool * pool, const void * data);
+extern int intern_release(internpool * pool, const void * handle);
+
+/* The global string pool. */
+extern const char * intern_string(const char * string);
+extern int intern_string_release(const char * handle);
+
+#endif /* __ET_INTERN_H__ */
+
+/*****************************************************************************/
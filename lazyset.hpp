@@ -0,0 +1,286 @@
+/******************************************************************************
+ * NAME:	    lazyset.hpp
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    Lazy set operations, written as C++20 coroutines. The
+ *		    functions in et::lazy return an et::generator, which
+ *		    computes the members of a union, intersection or difference
+ *		    one at a time as they are pulled, without building the
+ *		    result set, so a consumer that stops early (for instance
+ *		    with et::lazy::take) never pays for the rest. They work on
+ *		    both C sets (set.h) and et::Set (set.hpp). gcc 12 does not
+ *		    have std::generator, so a small one is defined here.
+ *
+ * CREATED:	    10/17/2026
+ *
+ * LAST EDITED:	    10/17/2026
+ ***/
+
+#ifndef __ET_LAZYSET_HPP__
+#define __ET_LAZYSET_HPP__
+
+#if __cplusplus < 202002L
+#   error "lazyset.hpp needs C++20 coroutines"
+#endif
+
+/******************************************************************************
+ * INCLUDES
+ ***/
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+#include "set.hpp"
+
+namespace et {
+
+/******************************************************************************
+ * TYPE DEFINITIONS
+ ***/
+
+/* A coroutine that yields values of type T, and a single-pass range over
+ * them. The coroutine does not start until begin() is called, and runs only
+ * as far as the next co_yield each time the iterator is advanced. A yielded
+ * value is referred to, not copied: it must stay alive until the coroutine
+ * is resumed, which locals and the temporaries of the co_yield expression
+ * do. Exceptions thrown by the coroutine are rethrown by begin() or ++. */
+template <class T>
+class generator {
+
+public:
+
+  class promise_type {
+
+  public:
+
+    generator get_return_object()
+    {
+      return generator(handle::from_promise(*this));
+    }
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    std::suspend_always final_suspend() noexcept { return {}; }
+
+    std::suspend_always yield_value(const T & value) noexcept
+    {
+      current = std::addressof(value);
+      return {};
+    }
+
+    void return_void() noexcept {}
+    void unhandled_exception() { error = std::current_exception(); }
+
+    /* co_await is not used by these coroutines. */
+    template <class U>
+    std::suspend_never await_transform(U &&) = delete;
+
+  private:
+
+    friend class generator;
+    const T * current = nullptr;
+    std::exception_ptr error;
+
+  };
+
+  using handle = std::coroutine_handle<promise_type>;
+
+  class iterator {
+
+  public:
+
+    using iterator_category = std::input_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = T;
+    using reference = const T &;
+    using pointer = const T *;
+
+    iterator() = default;
+
+    reference operator*() const { return *coroutine.promise().current; }
+    pointer operator->() const { return coroutine.promise().current; }
+
+    iterator & operator++()
+    {
+      resume(coroutine);
+      return *this;
+    }
+
+    void operator++(int) { ++*this; }
+
+    bool operator==(std::default_sentinel_t) const
+    {
+      return !coroutine || coroutine.done();
+    }
+
+  private:
+
+    friend class generator;
+    explicit iterator(handle coroutine) : coroutine(coroutine) {}
+    handle coroutine = nullptr;
+
+  };
+
+  generator(generator && other) noexcept
+    : coroutine(std::exchange(other.coroutine, nullptr)) {}
+
+  generator & operator=(generator && other) noexcept
+  {
+    if (this != &other) {
+      if (coroutine)
+	coroutine.destroy();
+      coroutine = std::exchange(other.coroutine, nullptr);
+    }
+    return *this;
+  }
+
+  generator(const generator &) = delete;
+  generator & operator=(const generator &) = delete;
+
+  ~generator()
+  {
+    if (coroutine)
+      coroutine.destroy();
+  }
+
+  /* May be called once. */
+  iterator begin()
+  {
+    resume(coroutine);
+    return iterator(coroutine);
+  }
+
+  std::default_sentinel_t end() const { return std::default_sentinel; }
+
+private:
+
+  explicit generator(handle coroutine) : coroutine(coroutine) {}
+
+  static void resume(handle coroutine)
+  {
+    if (!coroutine || coroutine.done())
+      return;
+    coroutine.resume();
+    if (coroutine.promise().error)
+      std::rethrow_exception(std::exchange(coroutine.promise().error,
+					   nullptr));
+  }
+
+  handle coroutine = nullptr;
+
+};
+
+/******************************************************************************
+ * API FUNCTIONS
+ ***/
+
+namespace lazy {
+
+/* The members of a C set. The pointers are those of set_begin and
+ * set_advance, so they are only good until the generator is advanced for a
+ * set whose engine keeps its members by value. None of the sets passed to
+ * these functions may change while their generator is in use. */
+inline generator<const void *> members(const set * group)
+{
+  set_iterator iterator;
+  for (const void * data = set_begin(group, &iterator); data != nullptr;
+       data = set_advance(group, &iterator))
+    co_yield data;
+}
+
+/* Every member of `one', then the members of `two' that are not in `one'. */
+inline generator<const void *> unite(const set * one, const set * two)
+{
+  for (const void * data : members(one))
+    co_yield data;
+  for (const void * data : members(two))
+    if (!set_ismember(one, data))
+      co_yield data;
+}
+
+/* Walks the smaller set, and looks each member up in the larger. */
+inline generator<const void *> intersection(const set * one, const set * two)
+{
+  if (set_size(two) < set_size(one))
+    std::swap(one, two);
+  for (const void * data : members(one))
+    if (set_ismember(two, data))
+      co_yield data;
+}
+
+inline generator<const void *> difference(const set * one, const set * two)
+{
+  for (const void * data : members(one))
+    if (!set_ismember(two, data))
+      co_yield data;
+}
+
+/* The same, for et::Set. The members are yielded by reference, so none are
+ * copied. */
+template <class T, class H, class E, class A>
+generator<T> unite(const Set<T, H, E, A> & one, const Set<T, H, E, A> & two)
+{
+  for (const T & value : one)
+    co_yield value;
+  for (const T & value : two)
+    if (!one.contains(value))
+      co_yield value;
+}
+
+template <class T, class H, class E, class A>
+generator<T> intersection(const Set<T, H, E, A> & one,
+			  const Set<T, H, E, A> & two)
+{
+  const Set<T, H, E, A> & small = two.size() < one.size() ? two : one;
+  const Set<T, H, E, A> & large = two.size() < one.size() ? one : two;
+  for (const T & value : small)
+    if (large.contains(value))
+      co_yield value;
+}
+
+template <class T, class H, class E, class A>
+generator<T> difference(const Set<T, H, E, A> & one,
+			const Set<T, H, E, A> & two)
+{
+  for (const T & value : one)
+    if (!two.contains(value))
+      co_yield value;
+}
+
+/****************************************************************************
+ * FUNCTION:	    take
+ *
+ * DESCRIPTION:	    Yields at most the first `n' values of another generator.
+ *
+ * ARGUMENTS:	    source: (generator<T>) -- the generator, which this one
+ *			takes over.
+ *		    n: (std::size_t) -- the number of values.
+ *
+ * RETURN:	    generator<T> -- the values.
+ *
+ * NOTES:	    `source' is not advanced past its n-th value, so the work
+ *		    of the rest of an operation is never done.
+ ***/
+template <class T>
+generator<T> take(generator<T> source, std::size_t n)
+{
+  if (n == 0)
+    co_return;
+  for (const T & value : source) {
+    co_yield value;
+    if (--n == 0)
+      co_return;
+  }
+}
+
+} /* namespace lazy */
+
+} /* namespace et */
+
+#endif /* __ET_LAZYSET_HPP__ */
+
+/*****************************************************************************/
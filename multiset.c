@@ -0,0 +1,551 @@
+/******************************************************************************
+ * NAME:	    multiset.c
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    Source file containing code for implementing a multiset.
+ *		    Every distinct element is held once in a hash table, and
+ *		    its multiplicity is kept in the count of its entry, so
+ *		    incrementing and decrementing an element is O(1). This
+ *		    code follows the typedefs and prototypes in multiset.h.
+ *
+ * CREATED:	    10/17/2026
+ *
+ * LAST EDITED:	    10/17/2026
+ ***/
+
+/******************************************************************************
+ * INCLUDES
+ ***/
+
+#include <stdlib.h>
+
+#include "multiset.h"
+
+/******************************************************************************
+ * LOCAL PROTOTYPES
+ ***/
+
+static long max(long, long);
+static long sum(long, long);
+static int combine(multiset **, multiset * [], long (*)(long, long));
+static int put(multiset *, const void *, long, long (*)(long, long));
+
+/******************************************************************************
+ * API FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:	    multiset_create
+ *
+ * DESCRIPTION:	    Creates an empty multiset with the parameters given.
+ *
+ * ARGUMENTS:	    match: (int (*)(const void *, const void *)) -- a pointer
+ *			to a user-defined function that compares two keys
+ *			and determines if they are equal. Should return 1
+ *			for equality and 0 otherwise.
+ *		    hash: (unsigned long (*)(const void *)) -- a pointer to a
+ *			user-defined function returning the hash of a key.
+ *			Keys that match must have the same hash.
+ *		    copy: (void * (*)(const void *)) -- as in set_create. May
+ *			be NULL, but then the multiset operations which create
+ *			a new multiset will exit with an error code.
+ *		    destroy: (void (*)(void *)) -- a pointer to a user-defined
+ *			function that frees data held in the multiset.
+ *
+ * RETURN:	    (multiset *) -- pointer to the new multiset, or NULL.
+ *
+ * NOTES:	    O(1)
+ ***/
+multiset * multiset_create(int (*match)(const void *, const void *),
+			   unsigned long (*hash)(const void *),
+			   void * (*copy)(const void *),
+			   void (*destroy)(void *))
+{
+  if (match == NULL || hash == NULL)
+    return NULL;
+  multiset * bag = NULL;
+  if ((bag = malloc(sizeof(multiset))) == NULL)
+    return NULL;
+
+  *bag = (multiset){
+    .total = 0,
+    .match = match,
+    .hash = hash,
+    .copy = copy,
+    .destroy = destroy
+  };
+
+  if (hashtable_init(&bag->table, 0, hash, match)) {
+    free(bag);
+    return NULL;
+  }
+
+  return bag;
+}
+
+/******************************************************************************
+ * FUNCTION:	    multiset_destroy
+ *
+ * DESCRIPTION:	    Removes all data from the multiset and frees it. If destroy
+ *		    is NULL, does not attempt to free the data in the multiset.
+ *
+ * ARGUMENTS:	    bag: (multiset **) -- the multiset to be operated on.
+ *
+ * RETURN:	    void.
+ *
+ * NOTES:	    O(n)
+ ***/
+void multiset_destroy(multiset ** bag)
+{
+  if (bag == NULL || *bag == NULL)
+    return;
+
+  hashtable_fini(&(*bag)->table, (*bag)->destroy);
+  free(*bag);
+  *bag = NULL;
+}
+
+/******************************************************************************
+ * FUNCTION:	    multiset_count
+ *
+ * DESCRIPTION:	    Returns the number of times `data' occurs in the multiset.
+ *
+ * ARGUMENTS:	    bag: (const multiset *) -- the multiset to be operated on.
+ *		    data: (const void *) -- data to check.
+ *
+ * RETURN:	    long -- the count of `data', which is 0 for non-members.
+ *
+ * NOTES:	    O(1)
+ ***/
+long multiset_count(const multiset * bag, const void * data)
+{
+  if (bag == NULL)
+    return 0;
+
+  bucket * entry = hashtable_lookup(&bag->table, data);
+  return entry == NULL ? 0 : entry->count;
+}
+
+/******************************************************************************
+ * FUNCTION:	    multiset_insert
+ *
+ * DESCRIPTION:	    Adds `n' occurrences of `data' to the multiset.
+ *
+ * ARGUMENTS:	    bag: (multiset *) -- the multiset to be operated on.
+ *		    data: (void *) -- data to insert.
+ *		    n: (long) -- the number of occurrences to add. Must be at
+ *			least 1.
+ *
+ * RETURN:	    int -- 0 if `data' was not a member and is now held by the
+ *		    multiset, 1 if it was already a member (in which case only
+ *		    the count changes, and the caller still owns `data'), -1
+ *		    otherwise.
+ *
+ * NOTES:	    O(1) amortized.
+ ***/
+int multiset_insert(multiset * bag, void * data, long n)
+{
+  if (bag == NULL || data == NULL || n < 1)
+    return -1;
+
+  int inserted = 0;
+  bucket * entry = NULL;
+  if ((entry = hashtable_insert(&bag->table, data, &inserted)) == NULL)
+    return -1;
+
+  entry->count += n;
+  bag->total += n;
+  return inserted ? 0 : 1;
+}
+
+/******************************************************************************
+ * FUNCTION:	    multiset_remove
+ *
+ * DESCRIPTION:	    Removes `n' occurrences of `data' from the multiset. When
+ *		    the count of an element reaches zero, it is removed and
+ *		    its data is destroyed.
+ *
+ * ARGUMENTS:	    bag: (multiset *) -- the multiset to be operated on.
+ *		    data: (const void *) -- data to remove.
+ *		    n: (long) -- the number of occurrences to remove. Must be
+ *			at least 1. Removing more occurrences than there are
+ *			removes the element.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    O(1)
+ ***/
+int multiset_remove(multiset * bag, const void * data, long n)
+{
+  if (bag == NULL || data == NULL || n < 1)
+    return -1;
+
+  bucket * entry = NULL;
+  if ((entry = hashtable_lookup(&bag->table, data)) == NULL)
+    return -1;
+
+  if (entry->count > n) {
+    entry->count -= n;
+    bag->total -= n;
+    return 0;
+  }
+
+  bag->total -= entry->count;
+  void * old = hashtable_remove(&bag->table, data);
+  if (bag->destroy != NULL)
+    bag->destroy(old);
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    multiset_traverse
+ *
+ * DESCRIPTION:	    Calls func() on each distinct element of the multiset,
+ *		    along with its count.
+ *
+ * ARGUMENTS:	    bag: (multiset *) -- the multiset to be operated on.
+ *		    func: (void (*)(void *, long)) -- the function to be called
+ *			on each element.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    O(n). The order is unspecified.
+ ***/
+int multiset_traverse(multiset * bag, void (*func)(void *, long))
+{
+  if (bag == NULL || multiset_isempty(bag) || func == NULL)
+    return -1;
+
+  for (bucket * entry = hashtable_next(&bag->table, NULL); entry != NULL;
+       entry = hashtable_next(&bag->table, entry))
+    func(entry->data, entry->count);
+
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    multiset_union_func
+ *
+ * DESCRIPTION:	    Places the union of the multisets in bagu. The count of
+ *		    each element is the largest of its counts in the inputs.
+ *
+ * ARGUMENTS:	    bagu: (multiset **) -- will contain a pointer to the union
+ *			at the end of the call.
+ *		    bags: (multiset * []) -- NULL terminated array of
+ *			multisets to operate on.
+ *
+ * RETURN:	    int -- 0 if computation was successful, -1 otherwise.
+ *
+ * NOTES:	    O(N), where N is the number of distinct elements in all
+ *		    of the inputs. Should always be called by wrapper macro.
+ ***/
+int multiset_union_func(multiset ** bagu, multiset * bags[])
+{
+  return combine(bagu, bags, max);
+}
+
+/******************************************************************************
+ * FUNCTION:	    multiset_sum_func
+ *
+ * DESCRIPTION:	    Places the sum of the multisets in bags. The count of each
+ *		    element is the sum of its counts in the inputs.
+ *
+ * ARGUMENTS:	    bags: (multiset **) -- will contain a pointer to the sum at
+ *			the end of the call.
+ *		    sources: (multiset * []) -- NULL terminated array of
+ *			multisets to operate on.
+ *
+ * RETURN:	    int -- 0 if computation was successful, -1 otherwise.
+ *
+ * NOTES:	    O(N). Should always be called by wrapper macro.
+ ***/
+int multiset_sum_func(multiset ** bags, multiset * sources[])
+{
+  return combine(bags, sources, sum);
+}
+
+/******************************************************************************
+ * FUNCTION:	    multiset_intersection_func
+ *
+ * DESCRIPTION:	    Places the intersection of the multisets in bagi. The count
+ *		    of each element is the smallest of its counts in the
+ *		    inputs.
+ *
+ * ARGUMENTS:	    bagi: (multiset **) -- will contain a pointer to the
+ *			intersection at the end of the call.
+ *		    bags: (multiset * []) -- NULL terminated array of
+ *			multisets to operate on.
+ *
+ * RETURN:	    int -- 0 if computation was successful, -1 otherwise.
+ *
+ * NOTES:	    O(nm), where n is the number of distinct elements in the
+ *		    first multiset and m is the number of multisets. Should
+ *		    always be called by wrapper macro.
+ ***/
+int multiset_intersection_func(multiset ** bagi, multiset * bags[])
+{
+  if (bagi == NULL || bags[0] == NULL)
+    return -1;
+  for (int i = 1; bags[i] != NULL; i++)
+    if (bags[i]->copy == NULL)
+      return -1;
+  if (combine(bagi, (multiset * []){bags[0], NULL}, max))
+    return -1;
+
+  for (int i = 1; bags[i] != NULL; i++) {
+    for (bucket * entry = hashtable_next(&(*bagi)->table, NULL);
+	 entry != NULL; entry = hashtable_next(&(*bagi)->table, entry)) {
+      long count = multiset_count(bags[i], entry->data);
+      if (count >= entry->count)
+	continue;
+
+      (*bagi)->total -= entry->count - count;
+      entry->count = count;
+      if (count == 0) {
+	void * old = hashtable_remove(&(*bagi)->table, entry->data);
+	if ((*bagi)->destroy != NULL)
+	  (*bagi)->destroy(old);
+      }
+    }
+  }
+
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    multiset_difference
+ *
+ * DESCRIPTION:	    Places the difference of the multisets in bagd. The count
+ *		    of each element is its count in bag1 less its count in
+ *		    bag2. Elements whose count falls to zero or below are left
+ *		    out.
+ *
+ * ARGUMENTS:	    bagd: (multiset **) -- will contain a pointer to the
+ *			difference at the end of the call.
+ *		    bag1: (const multiset *) -- the minuend.
+ *		    bag2: (const multiset *) -- the subtrahend.
+ *
+ * RETURN:	    int -- 0 if computation was successful, -1 otherwise.
+ *
+ * NOTES:	    O(n), where n is the number of distinct elements in bag1.
+ ***/
+int multiset_difference(multiset ** bagd, const multiset * bag1,
+			const multiset * bag2)
+{
+  if (bagd == NULL || bag1 == NULL || bag2 == NULL || bag1->copy == NULL)
+    return -1;
+  if ((*bagd = multiset_create(bag1->match, bag1->hash,
+			       bag1->copy, bag1->destroy)) == NULL)
+    return -1;
+
+  for (bucket * entry = hashtable_next(&bag1->table, NULL); entry != NULL;
+       entry = hashtable_next(&bag1->table, entry)) {
+    long count = entry->count - multiset_count(bag2, entry->data);
+    if (count > 0 && put(*bagd, entry->data, count, sum))
+      goto error_exception;
+  }
+
+  return 0;
+
+ error_exception: {
+    multiset_destroy(bagd);
+    return -1;
+  }
+}
+
+/******************************************************************************
+ * FUNCTION:	    multiset_topk
+ *
+ * DESCRIPTION:	    Finds the k elements with the largest counts.
+ *
+ * ARGUMENTS:	    bag: (const multiset *) -- the multiset to be operated on.
+ *		    k: (int) -- the number of elements to find.
+ *		    data: (void * []) -- at least k elements long. Will contain
+ *			pointers to the elements (owned by the multiset), in
+ *			order of decreasing count.
+ *		    counts: (long []) -- at least k elements long, or NULL.
+ *			Will contain the count of each element in `data'.
+ *
+ * RETURN:	    int -- the number of elements found, which is less than k
+ *		    if the multiset is smaller than k, or -1 on error.
+ *
+ * NOTES:	    O(n log k). Keeps a min-heap of the k best entries seen.
+ ***/
+int multiset_topk(const multiset * bag, int k, void * data[], long counts[])
+{
+  if (bag == NULL || k < 0 || data == NULL)
+    return -1;
+
+  bucket ** heap = NULL;
+  if (k > 0 && (heap = malloc(k * sizeof(bucket *))) == NULL)
+    return -1;
+
+  int size = 0;
+  for (bucket * entry = hashtable_next(&bag->table, NULL);
+       entry != NULL && k > 0; entry = hashtable_next(&bag->table, entry)) {
+    int i;
+    if (size < k) {
+      /* Sift up */
+      for (i = size++; i > 0 && heap[(i - 1) / 2]->count > entry->count;
+	   i = (i - 1) / 2)
+	heap[i] = heap[(i - 1) / 2];
+    } else if (entry->count > heap[0]->count) {
+      /* Replace the root and sift down */
+      for (i = 0; 2 * i + 1 < size;) {
+	int child = 2 * i + 1;
+	if (child + 1 < size && heap[child + 1]->count < heap[child]->count)
+	  child++;
+	if (heap[child]->count >= entry->count)
+	  break;
+	heap[i] = heap[child];
+	i = child;
+      }
+    } else {
+      continue;
+    }
+    heap[i] = entry;
+  }
+
+  /* Popping the min-heap yields the entries in increasing order, so fill the
+   * output from the back. */
+  for (int n = size; n > 0; n--) {
+    bucket * top = heap[0], * last = heap[n - 1];
+    int i = 0;
+    while (2 * i + 1 < n - 1) {
+      int child = 2 * i + 1;
+      if (child + 1 < n - 1 && heap[child + 1]->count < heap[child]->count)
+	child++;
+      if (heap[child]->count >= last->count)
+	break;
+      heap[i] = heap[child];
+      i = child;
+    }
+    heap[i] = last;
+
+    data[n - 1] = top->data;
+    if (counts != NULL)
+      counts[n - 1] = top->count;
+  }
+
+  free(heap);
+  return size;
+}
+
+/******************************************************************************
+ * LOCAL FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:	    max
+ *
+ * DESCRIPTION:	    Combines two counts for the union.
+ *
+ * ARGUMENTS:	    a, b: (long) -- the counts.
+ *
+ * RETURN:	    long -- the larger of the two.
+ *
+ * NOTES:	    none.
+ ***/
+static long max(long a, long b)
+{
+  return a > b ? a : b;
+}
+
+/******************************************************************************
+ * FUNCTION:	    sum
+ *
+ * DESCRIPTION:	    Combines two counts for the sum.
+ *
+ * ARGUMENTS:	    a, b: (long) -- the counts.
+ *
+ * RETURN:	    long -- the sum of the two.
+ *
+ * NOTES:	    none.
+ ***/
+static long sum(long a, long b)
+{
+  return a + b;
+}
+
+/******************************************************************************
+ * FUNCTION:	    combine
+ *
+ * DESCRIPTION:	    Creates a new multiset in `dest' and merges every element
+ *		    of every multiset in `bags' into it.
+ *
+ * ARGUMENTS:	    dest: (multiset **) -- will contain the result.
+ *		    bags: (multiset * []) -- NULL terminated array of
+ *			multisets to operate on.
+ *		    rule: (long (*)(long, long)) -- combines the count in
+ *			`dest' with the count in the source.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    O(N)
+ ***/
+static int combine(multiset ** dest, multiset * bags[],
+		   long (*rule)(long, long))
+{
+  if (dest == NULL || bags[0] == NULL)
+    return -1;
+  for (int i = 0; bags[i] != NULL; i++)
+    if (bags[i]->copy == NULL)
+      return -1;
+  if ((*dest = multiset_create(bags[0]->match, bags[0]->hash,
+			       bags[0]->copy, bags[0]->destroy)) == NULL)
+    return -1;
+
+  for (int i = 0; bags[i] != NULL; i++) {
+    for (bucket * entry = hashtable_next(&bags[i]->table, NULL);
+	 entry != NULL; entry = hashtable_next(&bags[i]->table, entry))
+      if (put(*dest, entry->data, entry->count, rule))
+	goto error_exception;
+  }
+
+  return 0;
+
+ error_exception: {
+    multiset_destroy(dest);
+    return -1;
+  }
+}
+
+/******************************************************************************
+ * FUNCTION:	    put
+ *
+ * DESCRIPTION:	    Merges one element and its count into `dest'. The element
+ *		    is copied only if it is not yet a member.
+ *
+ * ARGUMENTS:	    dest: (multiset *) -- the multiset to merge into.
+ *		    data: (const void *) -- the element.
+ *		    count: (long) -- the count of the element in its source.
+ *		    rule: (long (*)(long, long)) -- combines the count in
+ *			`dest' with `count'.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    O(1) amortized.
+ ***/
+static int put(multiset * dest, const void * data, long count,
+	       long (*rule)(long, long))
+{
+  bucket * entry = NULL;
+  if ((entry = hashtable_lookup(&dest->table, data)) == NULL) {
+    void * new = NULL;
+    if ((new = dest->copy(data)) == NULL)
+      return -1;
+    if ((entry = hashtable_insert(&dest->table, new, NULL)) == NULL) {
+      if (dest->destroy != NULL)
+	dest->destroy(new);
+      return -1;
+    }
+  }
+
+  long updated = rule(entry->count, count);
+  dest->total += updated - entry->count;
+  entry->count = updated;
+  return 0;
+}
+
+/*****************************************************************************/
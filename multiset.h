@@ -0,0 +1,87 @@
+/******************************************************************************
+ * NAME:	    multiset.h
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    The header file for the implementation of a multiset (or
+ *		    bag), a set in which every element carries a count of the
+ *		    number of times it occurs. It uses the same user-defined
+ *		    match, copy and destroy functions as the set in set.h, and
+ *		    additionally a hash function for the underlying hash table.
+ *
+ * CREATED:	    10/17/2026
+ *
+ * LAST EDITED:	    10/17/2026
+ ***/
+
+#ifndef __ET_MULTISET_H__
+#define __ET_MULTISET_H__
+
+#include "hashtable.h"
+
+/******************************************************************************
+ * TYPE DEFINITIONS
+ ***/
+
+typedef struct {
+
+  long total;
+
+  int (*match)(const void *, const void *);
+  unsigned long (*hash)(const void *);
+  void * (*copy)(const void *);
+  void (*destroy)(void *);
+
+  hashtable table;
+
+} multiset;
+
+/******************************************************************************
+ * MACRO DEFINITIONS
+ ***/
+
+/* The number of distinct elements, and the sum of all of their counts. */
+#define multiset_size(bag) ((int)hashtable_size(&(bag)->table))
+#define multiset_total(bag) ((bag)->total)
+#define multiset_isempty(bag) (multiset_size(bag) == 0 ? 1 : 0)
+
+/* Wrapper macros for the variadic multiset operations. As with set.h, these
+ * should ALWAYS be called instead of the corresponding _func functions.
+ */
+#define multiset_union(Bagu, ...)					\
+  (multiset_union_func(Bagu, (multiset * []){__VA_ARGS__, NULL}))
+
+#define multiset_sum(Bags, ...)						\
+  (multiset_sum_func(Bags, (multiset * []){__VA_ARGS__, NULL}))
+
+#define multiset_intersection(Bagi, ...)				\
+  (multiset_intersection_func(Bagi, (multiset * []){__VA_ARGS__, NULL}))
+
+/******************************************************************************
+ * API FUNCTION PROTOTYPES
+ ***/
+
+extern multiset * multiset_create(int (*match)(const void *, const void *),
+				  unsigned long (*hash)(const void *),
+				  void * (*copy)(const void *),
+				  void (*destroy)(void *));
+extern void multiset_destroy(multiset ** bag);
+extern long multiset_count(const multiset * bag, const void * data);
+extern int multiset_insert(multiset * bag, void * data, long n);
+extern int multiset_remove(multiset * bag, const void * data, long n);
+extern int multiset_traverse(multiset * bag, void (*func)(void *, long));
+extern int multiset_difference(multiset ** dest,
+			       const multiset * source1,
+			       const multiset * source2);
+extern int multiset_topk(const multiset * bag, int k,
+			 void * data[], long counts[]);
+
+/* These functions: */
+extern int multiset_union_func(multiset **, multiset * []);
+extern int multiset_sum_func(multiset **, multiset * []);
+extern int multiset_intersection_func(multiset **, multiset * []);
+/* Should NEVER be called directly. Use the wrapper macros defined above. */
+
+#endif /* __ET_MULTISET_H__ */
+
+/*****************************************************************************/
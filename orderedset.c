@@ -0,0 +1,1239 @@
+/******************************************************************************
+ * NAME:	    orderedset.c
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    Source file containing code for implementing an ordered
+ *		    set. The elements are stored in a B+-tree: they live in
+ *		    sorted arrays in the leaves, which are linked in order for
+ *		    iteration, and every internal node records how many
+ *		    elements are under each of its children, which makes rank
+ *		    and select O(log n). Set operations are computed by
+ *		    merging the sorted leaves, and the result is built bottom
+ *		    up. This code follows the typedefs and prototypes in
+ *		    orderedset.h.
+ *
+ * CREATED:	    10/17/2026
+ *
+ * LAST EDITED:	    10/17/2026
+ ***/
+
+/******************************************************************************
+ * INCLUDES
+ ***/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "orderedset.h"
+
+/******************************************************************************
+ * MACRO DEFINITIONS
+ ***/
+
+#define ORDER CONFIG_ORDEREDSET_ORDER
+#define MINIMUM (ORDER / 2)
+/* With at least two children per node, no tree can be deeper than this. */
+#define MAXDEPTH 64
+
+/******************************************************************************
+ * TYPE DEFINITIONS
+ ***/
+
+/* A position in the sorted sequence of elements. */
+typedef struct {
+
+  orderednode * leaf;
+  int index;
+
+} cursor;
+
+/******************************************************************************
+ * LOCAL PROTOTYPES
+ ***/
+
+static orderednode * newnode(int);
+static void freenode(orderednode *, void (*)(void *));
+static void moveentries(orderednode *, int, const orderednode *, int, int);
+static long subtreesize(const orderednode *);
+static int search(const orderedset *, const orderednode *, const void *);
+static int route(const orderedset *, const orderednode *, const void *);
+static orderednode * locate(const orderedset *, const void *, int *, long *);
+static int split(orderedset *, orderednode *, int);
+static int removekey(orderedset *, orderednode *, const void *, void **);
+static void rebalance(orderedset *, orderednode *, int);
+static int build(orderedset *, void **, long);
+static int collect(orderedset **, const orderedset *, void **, long);
+static int merge(orderedset **, orderedset * [], int);
+static void cursor_next(cursor *);
+
+/******************************************************************************
+ * API FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:	    orderedset_create
+ *
+ * DESCRIPTION:	    Creates an empty ordered set with the parameters given.
+ *
+ * ARGUMENTS:	    compare: (int (*)(const void *, const void *)) -- a
+ *			pointer to a user-defined function that orders two
+ *			keys. Should return a negative number, zero, or a
+ *			positive number if the first key is less than, equal
+ *			to, or greater than the second, as for qsort(3).
+ *		    copy: (void * (*)(const void *)) -- as in set_create.
+ *		    destroy: (void (*)(void *)) -- as in set_create.
+ *
+ * RETURN:	    (orderedset *) -- pointer to the new set, or NULL.
+ *
+ * NOTES:	    O(1)
+ ***/
+orderedset * orderedset_create(int (*compare)(const void *, const void *),
+			       void * (*copy)(const void *),
+			       void (*destroy)(void *))
+{
+  if (compare == NULL)
+    return NULL;
+  orderedset * group = NULL;
+  if ((group = malloc(sizeof(orderedset))) == NULL)
+    return NULL;
+
+  *group = (orderedset){
+    .size = 0,
+    .compare = compare,
+    .copy = copy,
+    .destroy = destroy,
+    .root = NULL,
+    .first = NULL,
+    .last = NULL
+  };
+
+  return group;
+}
+
+/******************************************************************************
+ * FUNCTION:	    orderedset_destroy
+ *
+ * DESCRIPTION:	    Removes all data from the set and frees it. If destroy is
+ *		    NULL, does not attempt to free the data in the set.
+ *
+ * ARGUMENTS:	    group: (orderedset **) -- the set to be operated on.
+ *
+ * RETURN:	    void.
+ *
+ * NOTES:	    O(n)
+ ***/
+void orderedset_destroy(orderedset ** group)
+{
+  if (group == NULL || *group == NULL)
+    return;
+
+  if ((*group)->root != NULL)
+    freenode((*group)->root, (*group)->destroy);
+  free(*group);
+  *group = NULL;
+}
+
+/******************************************************************************
+ * FUNCTION:	    orderedset_ismember
+ *
+ * DESCRIPTION:	    Determines if the key provided in 'data' is a member of
+ *		    the set.
+ *
+ * ARGUMENTS:	    group: (const orderedset *) -- the set to be operated on.
+ *		    data: (const void *) -- data to check.
+ *
+ * RETURN:	    int -- 1 if the member is in the set, 0 otherwise.
+ *
+ * NOTES:	    O(log n)
+ ***/
+int orderedset_ismember(const orderedset * group, const void * data)
+{
+  if (group == NULL || data == NULL || orderedset_isempty(group))
+    return 0;
+
+  int index = 0;
+  orderednode * leaf = locate(group, data, &index, NULL);
+  return index < leaf->n && group->compare(leaf->keys[index], data) == 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    orderedset_insert
+ *
+ * DESCRIPTION:	    Inserts the 'data' into the set if it does not already
+ *		    exist in the set.
+ *
+ * ARGUMENTS:	    group: (orderedset *) -- the set to be operated on.
+ *		    data: (void *) -- data to insert.
+ *
+ * RETURN:	    int -- 0 if successful, 1 if the data is already contained
+ *		    in the set, -1 otherwise.
+ *
+ * NOTES:	    O(log n). Full nodes are split on the way down, so the
+ *		    parent of a node being split always has room.
+ ***/
+int orderedset_insert(orderedset * group, void * data)
+{
+  if (group == NULL || data == NULL)
+    return -1;
+
+  if (orderedset_ismember(group, data))
+    return 1;
+
+  if (group->root == NULL) {
+    if ((group->root = newnode(1)) == NULL)
+      return -1;
+    group->first = group->last = group->root;
+  }
+
+  if (group->root->n == ORDER) {
+    orderednode * root = NULL;
+    if ((root = newnode(0)) == NULL)
+      return -1;
+    root->n = 1;
+    root->keys[0] = group->root->keys[0];
+    root->branch->counts[0] = group->size;
+    root->branch->children[0] = group->root;
+    group->root = root;
+    if (split(group, root, 0))
+      return -1;
+  }
+
+  /* The counts on the path are only updated once the element is in a leaf,
+   * so that a failed split leaves the tree consistent. */
+  orderednode * path[MAXDEPTH];
+  int indices[MAXDEPTH], depth = 0;
+  orderednode * node = group->root;
+  while (!node->leaf) {
+    int i = route(group, node, data);
+    if (node->branch->children[i]->n == ORDER) {
+      if (split(group, node, i))
+	return -1;
+      if (group->compare(node->keys[i + 1], data) <= 0)
+	i++;
+    }
+
+    path[depth] = node;
+    indices[depth++] = i;
+    node = node->branch->children[i];
+  }
+
+  int index = search(group, node, data);
+  moveentries(node, index + 1, node, index, node->n - index);
+  node->keys[index] = data;
+  node->n++;
+
+  while (depth-- > 0) {
+    int i = indices[depth];
+    path[depth]->branch->counts[i]++;
+    path[depth]->keys[i] = path[depth]->branch->children[i]->keys[0];
+  }
+
+  group->size++;
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    orderedset_remove
+ *
+ * DESCRIPTION:	    Removes the member matching 'data' from the set, and frees
+ *		    it with the destroy function.
+ *
+ * ARGUMENTS:	    group: (orderedset *) -- the set to be operated on.
+ *		    data: (const void *) -- data to remove.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    O(log n)
+ ***/
+int orderedset_remove(orderedset * group, const void * data)
+{
+  if (group == NULL || data == NULL || group->root == NULL)
+    return -1;
+
+  void * old = NULL;
+  if (removekey(group, group->root, data, &old))
+    return -1;
+
+  orderednode * root = group->root;
+  if (!root->leaf && root->n == 1) {
+    group->root = root->branch->children[0];
+    free(root);
+  } else if (root->leaf && root->n == 0) {
+    free(root);
+    group->root = group->first = group->last = NULL;
+  }
+
+  group->size--;
+  if (group->destroy != NULL)
+    group->destroy(old);
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    orderedset_traverse
+ *
+ * DESCRIPTION:	    Calls func() on each member of the set, in order.
+ *
+ * ARGUMENTS:	    group: (orderedset *) -- the set to be operated on.
+ *		    func: (void (*)(void *)) -- the function to be called on
+ *			each member of the set.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    O(n)
+ ***/
+int orderedset_traverse(orderedset * group, void (*func)(void *))
+{
+  if (group == NULL || orderedset_isempty(group) || func == NULL)
+    return -1;
+
+  for (orderednode * leaf = group->first; leaf != NULL; leaf = leaf->next)
+    for (int i = 0; i < leaf->n; i++)
+      func(leaf->keys[i]);
+
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    orderedset_range
+ *
+ * DESCRIPTION:	    Calls func() on each member of the set in the half-open
+ *		    interval [lo, hi), in order.
+ *
+ * ARGUMENTS:	    group: (orderedset *) -- the set to be operated on.
+ *		    lo: (const void *) -- the lower bound, or NULL for none.
+ *		    hi: (const void *) -- the upper bound, or NULL for none.
+ *		    func: (void (*)(void *)) -- the function to be called on
+ *			each member in the interval.
+ *
+ * RETURN:	    long -- the number of members visited, or -1 on error.
+ *
+ * NOTES:	    O(log n + m), where m is the number of members visited.
+ ***/
+long orderedset_range(orderedset * group, const void * lo, const void * hi,
+		      void (*func)(void *))
+{
+  if (group == NULL || func == NULL)
+    return -1;
+  if (orderedset_isempty(group))
+    return 0;
+
+  cursor position = {.leaf = group->first, .index = 0};
+  if (lo != NULL) {
+    position.leaf = locate(group, lo, &position.index, NULL);
+    if (position.index == position.leaf->n) {
+      position.leaf = position.leaf->next;
+      position.index = 0;
+    }
+  }
+
+  long visited = 0;
+  for (; position.leaf != NULL; cursor_next(&position)) {
+    void * data = position.leaf->keys[position.index];
+    if (hi != NULL && group->compare(data, hi) >= 0)
+      break;
+    func(data);
+    visited++;
+  }
+
+  return visited;
+}
+
+/******************************************************************************
+ * FUNCTION:	    orderedset_min
+ *
+ * DESCRIPTION:	    Returns the least member of the set.
+ *
+ * ARGUMENTS:	    group: (const orderedset *) -- the set to be operated on.
+ *
+ * RETURN:	    void * -- the least member, or NULL if the set is empty.
+ *
+ * NOTES:	    O(1)
+ ***/
+void * orderedset_min(const orderedset * group)
+{
+  if (group == NULL || orderedset_isempty(group))
+    return NULL;
+  return group->first->keys[0];
+}
+
+/******************************************************************************
+ * FUNCTION:	    orderedset_max
+ *
+ * DESCRIPTION:	    Returns the greatest member of the set.
+ *
+ * ARGUMENTS:	    group: (const orderedset *) -- the set to be operated on.
+ *
+ * RETURN:	    void * -- the greatest member, or NULL if the set is empty.
+ *
+ * NOTES:	    O(1)
+ ***/
+void * orderedset_max(const orderedset * group)
+{
+  if (group == NULL || orderedset_isempty(group))
+    return NULL;
+  return group->last->keys[group->last->n - 1];
+}
+
+/******************************************************************************
+ * FUNCTION:	    orderedset_floor
+ *
+ * DESCRIPTION:	    Finds the greatest member of the set that is less than or
+ *		    equal to `data'.
+ *
+ * ARGUMENTS:	    group: (const orderedset *) -- the set to be operated on.
+ *		    data: (const void *) -- the key to look for.
+ *
+ * RETURN:	    void * -- the member, or NULL if there is none.
+ *
+ * NOTES:	    O(log n)
+ ***/
+void * orderedset_floor(const orderedset * group, const void * data)
+{
+  if (group == NULL || data == NULL || orderedset_isempty(group))
+    return NULL;
+
+  int index = 0;
+  orderednode * leaf = locate(group, data, &index, NULL);
+  if (index < leaf->n && group->compare(leaf->keys[index], data) == 0)
+    return leaf->keys[index];
+  if (index > 0)
+    return leaf->keys[index - 1];
+  return leaf->prev == NULL ? NULL : leaf->prev->keys[leaf->prev->n - 1];
+}
+
+/******************************************************************************
+ * FUNCTION:	    orderedset_ceiling
+ *
+ * DESCRIPTION:	    Finds the least member of the set that is greater than or
+ *		    equal to `data'.
+ *
+ * ARGUMENTS:	    group: (const orderedset *) -- the set to be operated on.
+ *		    data: (const void *) -- the key to look for.
+ *
+ * RETURN:	    void * -- the member, or NULL if there is none.
+ *
+ * NOTES:	    O(log n)
+ ***/
+void * orderedset_ceiling(const orderedset * group, const void * data)
+{
+  if (group == NULL || data == NULL || orderedset_isempty(group))
+    return NULL;
+
+  int index = 0;
+  orderednode * leaf = locate(group, data, &index, NULL);
+  if (index < leaf->n)
+    return leaf->keys[index];
+  return leaf->next == NULL ? NULL : leaf->next->keys[0];
+}
+
+/******************************************************************************
+ * FUNCTION:	    orderedset_rank
+ *
+ * DESCRIPTION:	    Counts the members of the set that are less than `data'.
+ *		    If `data' is a member, this is its zero-based position in
+ *		    the sorted order.
+ *
+ * ARGUMENTS:	    group: (const orderedset *) -- the set to be operated on.
+ *		    data: (const void *) -- the key to look for.
+ *
+ * RETURN:	    long -- the rank of `data', or -1 on error.
+ *
+ * NOTES:	    O(log n)
+ ***/
+long orderedset_rank(const orderedset * group, const void * data)
+{
+  if (group == NULL || data == NULL)
+    return -1;
+  if (orderedset_isempty(group))
+    return 0;
+
+  int index = 0;
+  long rank = 0;
+  locate(group, data, &index, &rank);
+  return rank;
+}
+
+/******************************************************************************
+ * FUNCTION:	    orderedset_select
+ *
+ * DESCRIPTION:	    Finds the member of the set with the given rank.
+ *
+ * ARGUMENTS:	    group: (const orderedset *) -- the set to be operated on.
+ *		    rank: (long) -- zero-based position in the sorted order.
+ *
+ * RETURN:	    void * -- the member, or NULL if `rank' is out of range.
+ *
+ * NOTES:	    O(log n)
+ ***/
+void * orderedset_select(const orderedset * group, long rank)
+{
+  if (group == NULL || rank < 0 || rank >= orderedset_size(group))
+    return NULL;
+
+  orderednode * node = group->root;
+  while (!node->leaf) {
+    int i = 0;
+    while (rank >= node->branch->counts[i])
+      rank -= node->branch->counts[i++];
+    node = node->branch->children[i];
+  }
+
+  return node->keys[rank];
+}
+
+/******************************************************************************
+ * FUNCTION:	    orderedset_union_func
+ *
+ * DESCRIPTION:	    Performs the union set operation and places the result in
+ *		    setu. As with set_union_func, the members of the result
+ *		    are produced with the copy function.
+ *
+ * ARGUMENTS:	    setu: (orderedset **) -- will contain a pointer to the
+ *			union of all sets at the end of the call.
+ *		    sets: (orderedset * []) -- NULL terminated array of sets.
+ *
+ * RETURN:	    int -- 0 if computation was successful, -1 otherwise.
+ *
+ * NOTES:	    O(Nm), where N is the total number of members and m is the
+ *		    number of sets. Should always be called by wrapper macro.
+ ***/
+int orderedset_union_func(orderedset ** setu, orderedset * sets[])
+{
+  return merge(setu, sets, 1);
+}
+
+/******************************************************************************
+ * FUNCTION:	    orderedset_intersection_func
+ *
+ * DESCRIPTION:	    Performs the intersection set operation and places the
+ *		    result in seti.
+ *
+ * ARGUMENTS:	    seti: (orderedset **) -- will contain a pointer to the
+ *			intersection of all sets at the end of the call.
+ *		    sets: (orderedset * []) -- NULL terminated array of sets.
+ *
+ * RETURN:	    int -- 0 if computation was successful, -1 otherwise.
+ *
+ * NOTES:	    O(Nm). Should always be called by wrapper macro.
+ ***/
+int orderedset_intersection_func(orderedset ** seti, orderedset * sets[])
+{
+  if (sets[0] == NULL)
+    return -1;
+  int n = 0;
+  while (sets[n] != NULL)
+    n++;
+
+  return merge(seti, sets, n);
+}
+
+/******************************************************************************
+ * FUNCTION:	    orderedset_difference
+ *
+ * DESCRIPTION:	    Performs the set difference operation and places the
+ *		    result in setd.
+ *
+ * ARGUMENTS:	    setd: (orderedset **) -- will contain a pointer to the
+ *			difference at the end of the call.
+ *		    set1: (const orderedset *) -- the minuend.
+ *		    set2: (const orderedset *) -- the subtrahend.
+ *
+ * RETURN:	    int -- 0 if computation was successful, -1 otherwise.
+ *
+ * NOTES:	    O(n + m)
+ ***/
+int orderedset_difference(orderedset ** setd, const orderedset * set1,
+			  const orderedset * set2)
+{
+  if (setd == NULL || set1 == NULL || set2 == NULL || set1->copy == NULL)
+    return -1;
+
+  void ** data = NULL;
+  if (set1->size > 0
+      && (data = malloc(set1->size * sizeof(void *))) == NULL)
+    return -1;
+
+  long n = 0;
+  cursor one = {.leaf = set1->first}, two = {.leaf = set2->first};
+  for (; one.leaf != NULL; cursor_next(&one)) {
+    void * key = one.leaf->keys[one.index];
+    int order = 1;
+    while (two.leaf != NULL
+	   && (order = set1->compare(two.leaf->keys[two.index], key)) < 0)
+      cursor_next(&two);
+    if (two.leaf == NULL || order != 0)
+      data[n++] = key;
+  }
+
+  int ret = collect(setd, set1, data, n);
+  free(data);
+  return ret;
+}
+
+/******************************************************************************
+ * FUNCTION:	    orderedset_issubset
+ *
+ * DESCRIPTION:	    Determines if set1 is a subset of set2.
+ *
+ * ARGUMENTS:	    set1: (const orderedset *) -- the set in question.
+ *		    set2: (const orderedset *) -- the reference set.
+ *
+ * RETURN:	    int -- 1 if the set is a subset, 0 otherwise.
+ *
+ * NOTES:	    O(n + m)
+ ***/
+int orderedset_issubset(const orderedset * set1, const orderedset * set2)
+{
+  if (set1 == NULL || set2 == NULL || set1->size > set2->size)
+    return 0;
+
+  cursor one = {.leaf = set1->first}, two = {.leaf = set2->first};
+  for (; one.leaf != NULL; cursor_next(&one)) {
+    void * key = one.leaf->keys[one.index];
+    int order = 1;
+    while (two.leaf != NULL
+	   && (order = set1->compare(two.leaf->keys[two.index], key)) < 0)
+      cursor_next(&two);
+    if (two.leaf == NULL || order != 0)
+      return 0;
+  }
+
+  return 1;
+}
+
+/******************************************************************************
+ * FUNCTION:	    orderedset_isequal_func
+ *
+ * DESCRIPTION:	    Determines if the sets are all equal.
+ *
+ * ARGUMENTS:	    sets: (orderedset * []) -- the sets to check equality of.
+ *
+ * RETURN:	    int -- 1 if the sets are equal, 0 otherwise.
+ *
+ * NOTES:	    O(Nm). As with set_isequal, fewer than two sets are never
+ *		    equal. Should always be called by wrapper macro.
+ ***/
+int orderedset_isequal_func(orderedset * sets[])
+{
+  if (sets[0] == NULL || sets[1] == NULL)
+    return 0;
+  for (int i = 1; sets[i] != NULL; i++) {
+    if (sets[i]->size != sets[0]->size)
+      return 0;
+
+    cursor one = {.leaf = sets[0]->first}, two = {.leaf = sets[i]->first};
+    for (; one.leaf != NULL; cursor_next(&one), cursor_next(&two))
+      if (sets[0]->compare(one.leaf->keys[one.index],
+			   two.leaf->keys[two.index]) != 0)
+	return 0;
+  }
+
+  return 1;
+}
+
+/******************************************************************************
+ * FUNCTION:	    orderedset_copy
+ *
+ * DESCRIPTION:	    Produces a deep copy of the set `s'.
+ *
+ * ARGUMENTS:	    s: (const orderedset *) -- the set to create a copy of.
+ *
+ * RETURN:	    orderedset * -- a deep copy of the set `s', or NULL if an
+ *		    error has occurred.
+ *
+ * NOTES:	    O(n)
+ ***/
+orderedset * orderedset_copy(const orderedset * s)
+{
+  if (s == NULL || s->copy == NULL)
+    return NULL;
+
+  void ** data = NULL;
+  if (s->size > 0 && (data = malloc(s->size * sizeof(void *))) == NULL)
+    return NULL;
+
+  long n = 0;
+  for (orderednode * leaf = s->first; leaf != NULL; leaf = leaf->next)
+    for (int i = 0; i < leaf->n; i++)
+      data[n++] = leaf->keys[i];
+
+  orderedset * _new = NULL;
+  collect(&_new, s, data, n);
+  free(data);
+  return _new;
+}
+
+/******************************************************************************
+ * LOCAL FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:	    newnode
+ *
+ * DESCRIPTION:	    Allocates an empty node.
+ *
+ * ARGUMENTS:	    leaf: (int) -- 1 for a leaf, 0 for an internal node.
+ *
+ * RETURN:	    orderednode * -- the new node, or NULL.
+ *
+ * NOTES:	    Leaves are allocated without the branch.
+ ***/
+static orderednode * newnode(int leaf)
+{
+  orderednode * node = NULL;
+  size_t size = sizeof(orderednode) + (leaf ? 0 : sizeof(orderedbranch));
+  if ((node = calloc(1, size)) == NULL)
+    return NULL;
+
+  node->leaf = leaf;
+  return node;
+}
+
+/******************************************************************************
+ * FUNCTION:	    freenode
+ *
+ * DESCRIPTION:	    Frees a subtree, and the data in its leaves if destroy is
+ *		    not NULL.
+ *
+ * ARGUMENTS:	    node: (orderednode *) -- the root of the subtree.
+ *		    destroy: (void (*)(void *)) -- frees the data, or NULL.
+ *
+ * RETURN:	    void.
+ *
+ * NOTES:	    O(n)
+ ***/
+static void freenode(orderednode * node, void (*destroy)(void *))
+{
+  for (int i = 0; i < node->n; i++) {
+    if (!node->leaf)
+      freenode(node->branch->children[i], destroy);
+    else if (destroy != NULL)
+      destroy(node->keys[i]);
+  }
+
+  free(node);
+}
+
+/******************************************************************************
+ * FUNCTION:	    moveentries
+ *
+ * DESCRIPTION:	    Moves `n' entries (keys, and for internal nodes counts and
+ *		    children) from position `s' of `src' to position `d' of
+ *		    `dst'. The ranges may overlap.
+ *
+ * ARGUMENTS:	    dst: (orderednode *) -- the destination node.
+ *		    d: (int) -- the position in the destination.
+ *		    src: (const orderednode *) -- the source node, of the same
+ *			kind as `dst'.
+ *		    s: (int) -- the position in the source.
+ *		    n: (int) -- the number of entries to move.
+ *
+ * RETURN:	    void.
+ *
+ * NOTES:	    Neither node's count of entries is changed.
+ ***/
+static void moveentries(orderednode * dst, int d, const orderednode * src,
+			int s, int n)
+{
+  if (n <= 0)
+    return;
+
+  memmove(&dst->keys[d], &src->keys[s], n * sizeof(void *));
+  if (!src->leaf) {
+    memmove(&dst->branch->counts[d], &src->branch->counts[s],
+	    n * sizeof(long));
+    memmove(&dst->branch->children[d], &src->branch->children[s],
+	    n * sizeof(orderednode *));
+  }
+}
+
+/******************************************************************************
+ * FUNCTION:	    subtreesize
+ *
+ * DESCRIPTION:	    Counts the elements under a node.
+ *
+ * ARGUMENTS:	    node: (const orderednode *) -- the node.
+ *
+ * RETURN:	    long -- the number of elements.
+ *
+ * NOTES:	    O(ORDER)
+ ***/
+static long subtreesize(const orderednode * node)
+{
+  if (node->leaf)
+    return node->n;
+
+  long size = 0;
+  for (int i = 0; i < node->n; i++)
+    size += node->branch->counts[i];
+  return size;
+}
+
+/******************************************************************************
+ * FUNCTION:	    search
+ *
+ * DESCRIPTION:	    Binary search for the first key of the node that is not
+ *		    less than `data'.
+ *
+ * ARGUMENTS:	    group: (const orderedset *) -- provides the comparison.
+ *		    node: (const orderednode *) -- the node to search.
+ *		    data: (const void *) -- the key to look for.
+ *
+ * RETURN:	    int -- the position, which is node->n if every key is less
+ *		    than `data'.
+ *
+ * NOTES:	    O(log ORDER)
+ ***/
+static int search(const orderedset * group, const orderednode * node,
+		  const void * data)
+{
+  int lo = 0, hi = node->n;
+  while (lo < hi) {
+    int mid = lo + (hi - lo) / 2;
+    if (group->compare(node->keys[mid], data) < 0)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
+
+  return lo;
+}
+
+/******************************************************************************
+ * FUNCTION:	    route
+ *
+ * DESCRIPTION:	    Chooses the child of an internal node under which `data'
+ *		    belongs: the last child whose least key is not greater
+ *		    than `data', or the first child.
+ *
+ * ARGUMENTS:	    group: (const orderedset *) -- provides the comparison.
+ *		    node: (const orderednode *) -- an internal node.
+ *		    data: (const void *) -- the key to look for.
+ *
+ * RETURN:	    int -- the position of the child.
+ *
+ * NOTES:	    O(log ORDER)
+ ***/
+static int route(const orderedset * group, const orderednode * node,
+		 const void * data)
+{
+  int i = search(group, node, data);
+  if (i < node->n && group->compare(node->keys[i], data) == 0)
+    return i;
+  return i > 0 ? i - 1 : 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    locate
+ *
+ * DESCRIPTION:	    Finds the leaf under which `data' belongs, and the
+ *		    position of the first key in it that is not less than
+ *		    `data'.
+ *
+ * ARGUMENTS:	    group: (const orderedset *) -- a non-empty set.
+ *		    data: (const void *) -- the key to look for.
+ *		    index: (int *) -- will contain the position in the leaf.
+ *		    rank: (long *) -- if not NULL, will contain the number of
+ *			elements less than `data'.
+ *
+ * RETURN:	    orderednode * -- the leaf.
+ *
+ * NOTES:	    O(log n)
+ ***/
+static orderednode * locate(const orderedset * group, const void * data,
+			    int * index, long * rank)
+{
+  long before = 0;
+  orderednode * node = group->root;
+  while (!node->leaf) {
+    int i = route(group, node, data);
+    for (int j = 0; j < i; j++)
+      before += node->branch->counts[j];
+    node = node->branch->children[i];
+  }
+
+  *index = search(group, node, data);
+  if (rank != NULL)
+    *rank = before + *index;
+  return node;
+}
+
+/******************************************************************************
+ * FUNCTION:	    split
+ *
+ * DESCRIPTION:	    Splits the full child `i' of `parent' in two, and adds the
+ *		    new right half to `parent' after it.
+ *
+ * ARGUMENTS:	    group: (orderedset *) -- the set being operated on.
+ *		    parent: (orderednode *) -- a node that is not full.
+ *		    i: (int) -- the position of the child to split.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    O(ORDER)
+ ***/
+static int split(orderedset * group, orderednode * parent, int i)
+{
+  orderednode * child = parent->branch->children[i], * right = NULL;
+  if ((right = newnode(child->leaf)) == NULL)
+    return -1;
+
+  int half = child->n / 2;
+  moveentries(right, 0, child, child->n - half, half);
+  right->n = half;
+  child->n -= half;
+
+  if (child->leaf) {
+    right->prev = child;
+    right->next = child->next;
+    if (child->next != NULL)
+      child->next->prev = right;
+    else
+      group->last = right;
+    child->next = right;
+  }
+
+  long count = subtreesize(right);
+  moveentries(parent, i + 2, parent, i + 1, parent->n - i - 1);
+  parent->n++;
+  parent->keys[i + 1] = right->keys[0];
+  parent->branch->children[i + 1] = right;
+  parent->branch->counts[i + 1] = count;
+  parent->branch->counts[i] -= count;
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    removekey
+ *
+ * DESCRIPTION:	    Removes `data' from the subtree under `node', and restores
+ *		    the minimum occupancy of its children on the way back up.
+ *
+ * ARGUMENTS:	    group: (orderedset *) -- the set being operated on.
+ *		    node: (orderednode *) -- the root of the subtree.
+ *		    data: (const void *) -- the key to remove.
+ *		    old: (void **) -- will contain the removed element.
+ *
+ * RETURN:	    int -- 0 if successful, -1 if `data' is not a member.
+ *
+ * NOTES:	    O(log n). `node' itself may be left underfull; the caller
+ *		    fixes it.
+ ***/
+static int removekey(orderedset * group, orderednode * node,
+		     const void * data, void ** old)
+{
+  if (node->leaf) {
+    int index = search(group, node, data);
+    if (index == node->n || group->compare(node->keys[index], data) != 0)
+      return -1;
+
+    *old = node->keys[index];
+    moveentries(node, index, node, index + 1, node->n - index - 1);
+    node->n--;
+    return 0;
+  }
+
+  int i = route(group, node, data);
+  orderednode * child = node->branch->children[i];
+  if (removekey(group, child, data, old))
+    return -1;
+
+  node->branch->counts[i]--;
+  node->keys[i] = child->keys[0];
+  if (child->n < MINIMUM)
+    rebalance(group, node, i);
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    rebalance
+ *
+ * DESCRIPTION:	    Refills the underfull child `i' of `parent', by borrowing
+ *		    an entry from a sibling or merging with one.
+ *
+ * ARGUMENTS:	    group: (orderedset *) -- the set being operated on.
+ *		    parent: (orderednode *) -- an internal node with at least
+ *			two children.
+ *		    i: (int) -- the position of the underfull child.
+ *
+ * RETURN:	    void.
+ *
+ * NOTES:	    O(ORDER)
+ ***/
+static void rebalance(orderedset * group, orderednode * parent, int i)
+{
+  orderednode * child = parent->branch->children[i];
+  orderednode * left = i > 0 ? parent->branch->children[i - 1] : NULL;
+  orderednode * right = i + 1 < parent->n
+    ? parent->branch->children[i + 1] : NULL;
+
+  if (left != NULL && left->n > MINIMUM) {
+    long count = child->leaf ? 1 : left->branch->counts[left->n - 1];
+    moveentries(child, 1, child, 0, child->n);
+    moveentries(child, 0, left, left->n - 1, 1);
+    child->n++;
+    left->n--;
+    parent->branch->counts[i - 1] -= count;
+    parent->branch->counts[i] += count;
+    parent->keys[i] = child->keys[0];
+  } else if (right != NULL && right->n > MINIMUM) {
+    long count = child->leaf ? 1 : right->branch->counts[0];
+    moveentries(child, child->n, right, 0, 1);
+    moveentries(right, 0, right, 1, right->n - 1);
+    child->n++;
+    right->n--;
+    parent->branch->counts[i + 1] -= count;
+    parent->branch->counts[i] += count;
+    parent->keys[i + 1] = right->keys[0];
+  } else if (left != NULL || right != NULL) {
+    /* Neither sibling can spare an entry, so the two fit in one node. */
+    int j = left != NULL ? i - 1 : i;
+    orderednode * dst = parent->branch->children[j];
+    orderednode * src = parent->branch->children[j + 1];
+    moveentries(dst, dst->n, src, 0, src->n);
+    dst->n += src->n;
+    if (dst->leaf) {
+      dst->next = src->next;
+      if (src->next != NULL)
+	src->next->prev = dst;
+      else
+	group->last = dst;
+    }
+
+    parent->branch->counts[j] += parent->branch->counts[j + 1];
+    moveentries(parent, j + 1, parent, j + 2, parent->n - j - 2);
+    parent->n--;
+    free(src);
+  }
+}
+
+/******************************************************************************
+ * FUNCTION:	    build
+ *
+ * DESCRIPTION:	    Builds the tree of an empty set bottom up from sorted,
+ *		    distinct data.
+ *
+ * ARGUMENTS:	    group: (orderedset *) -- an empty set.
+ *		    data: (void **) -- the elements, in increasing order.
+ *		    n: (long) -- the number of elements.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise. On failure the set
+ *		    is left empty, and the data is not destroyed.
+ *
+ * NOTES:	    O(n). The entries are spread evenly over the nodes of each
+ *		    level, so every node is at least half full.
+ ***/
+static int build(orderedset * group, void ** data, long n)
+{
+  if (n <= 0)
+    return 0;
+
+  long width = (n + ORDER - 1) / ORDER;
+  orderednode ** level = NULL;
+  long * sizes = NULL;
+  if ((level = malloc(width * sizeof(orderednode *))) == NULL
+      || (sizes = malloc(width * sizeof(long))) == NULL) {
+    free(level);
+    return -1;
+  }
+
+  long start = 0;
+  for (long i = 0; i < width; i++) {
+    long count = n / width + (i < n % width);
+    if ((level[i] = newnode(1)) == NULL) {
+      while (i-- > 0)
+	free(level[i]);
+      goto error_exception;
+    }
+
+    memcpy(level[i]->keys, &data[start], count * sizeof(void *));
+    level[i]->n = count;
+    sizes[i] = count;
+    start += count;
+    if (i > 0) {
+      level[i]->prev = level[i - 1];
+      level[i - 1]->next = level[i];
+    }
+  }
+  group->first = level[0];
+  group->last = level[width - 1];
+
+  /* Parents are written over the front of the array; the children of a
+   * parent never come before it, so they are read before being replaced. */
+  while (width > 1) {
+    long parents = (width + ORDER - 1) / ORDER;
+    start = 0;
+    for (long p = 0; p < parents; p++) {
+      long count = width / parents + (p < width % parents);
+      orderednode * node = NULL;
+      if ((node = newnode(0)) == NULL) {
+	for (long i = 0; i < p; i++)
+	  freenode(level[i], NULL);
+	for (long i = start; i < width; i++)
+	  freenode(level[i], NULL);
+	goto error_exception;
+      }
+
+      long size = 0;
+      for (long j = 0; j < count; j++) {
+	node->keys[j] = level[start + j]->keys[0];
+	node->branch->children[j] = level[start + j];
+	node->branch->counts[j] = sizes[start + j];
+	size += sizes[start + j];
+      }
+      node->n = count;
+      start += count;
+      level[p] = node;
+      sizes[p] = size;
+    }
+    width = parents;
+  }
+
+  group->root = level[0];
+  group->size = n;
+  free(level);
+  free(sizes);
+  return 0;
+
+ error_exception: {
+    group->first = group->last = NULL;
+    free(level);
+    free(sizes);
+    return -1;
+  }
+}
+
+/******************************************************************************
+ * FUNCTION:	    collect
+ *
+ * DESCRIPTION:	    Creates a new set like `model' in `dest', holding copies
+ *		    of the given data.
+ *
+ * ARGUMENTS:	    dest: (orderedset **) -- will contain the new set.
+ *		    model: (const orderedset *) -- provides the functions of
+ *			the new set.
+ *		    data: (void **) -- the elements, in increasing order. The
+ *			array is overwritten with the copies.
+ *		    n: (long) -- the number of elements.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    O(n)
+ ***/
+static int collect(orderedset ** dest, const orderedset * model,
+		   void ** data, long n)
+{
+  if ((*dest = orderedset_create(model->compare, model->copy,
+				 model->destroy)) == NULL)
+    return -1;
+
+  long i = 0;
+  for (; i < n; i++)
+    if ((data[i] = model->copy(data[i])) == NULL)
+      goto error_exception;
+
+  if (build(*dest, data, n))
+    goto error_exception;
+  return 0;
+
+ error_exception: {
+    if (model->destroy != NULL)
+      while (i-- > 0)
+	model->destroy(data[i]);
+    orderedset_destroy(dest);
+    return -1;
+  }
+}
+
+/******************************************************************************
+ * FUNCTION:	    merge
+ *
+ * DESCRIPTION:	    Merges the sorted members of the sets, and places the
+ *		    elements that are members of at least k of them in dest.
+ *
+ * ARGUMENTS:	    dest: (orderedset **) -- will contain the result.
+ *		    sets: (orderedset * []) -- NULL terminated array of sets.
+ *		    k: (int) -- the number of sets an element must be in.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    O(Nm). The merge stops as soon as fewer than k of the sets
+ *		    have members left.
+ ***/
+static int merge(orderedset ** dest, orderedset * sets[], int k)
+{
+  if (dest == NULL || sets[0] == NULL)
+    return -1;
+  int m = 0;
+  long total = 0;
+  for (; sets[m] != NULL; m++) {
+    if (sets[m]->copy == NULL)
+      return -1;
+    total += sets[m]->size;
+  }
+
+  cursor * cursors = NULL;
+  void ** data = NULL;
+  if ((cursors = malloc(m * sizeof(cursor))) == NULL
+      || (total > 0 && (data = malloc(total * sizeof(void *))) == NULL)) {
+    free(cursors);
+    return -1;
+  }
+  for (int i = 0; i < m; i++)
+    cursors[i] = (cursor){.leaf = sets[i]->first, .index = 0};
+
+  long n = 0;
+  for (;;) {
+    void * least = NULL;
+    int active = 0;
+    for (int i = 0; i < m; i++) {
+      if (cursors[i].leaf == NULL)
+	continue;
+      void * key = cursors[i].leaf->keys[cursors[i].index];
+      if (least == NULL || sets[0]->compare(key, least) < 0)
+	least = key;
+      active++;
+    }
+    if (active < k)
+      break;
+
+    int count = 0;
+    for (int i = 0; i < m; i++) {
+      if (cursors[i].leaf != NULL && sets[0]->compare(
+	     cursors[i].leaf->keys[cursors[i].index], least) == 0) {
+	count++;
+	cursor_next(&cursors[i]);
+      }
+    }
+    if (count >= k)
+      data[n++] = least;
+  }
+
+  int ret = collect(dest, sets[0], data, n);
+  free(cursors);
+  free(data);
+  return ret;
+}
+
+/******************************************************************************
+ * FUNCTION:	    cursor_next
+ *
+ * DESCRIPTION:	    Advances a cursor to the next element in order.
+ *
+ * ARGUMENTS:	    position: (cursor *) -- a cursor at an element.
+ *
+ * RETURN:	    void. The leaf of the cursor is NULL past the last element.
+ *
+ * NOTES:	    O(1)
+ ***/
+static void cursor_next(cursor * position)
+{
+  if (++position->index == position->leaf->n) {
+    position->leaf = position->leaf->next;
+    position->index = 0;
+  }
+}
+
+/*****************************************************************************/
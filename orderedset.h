@@ -0,0 +1,125 @@
+/******************************************************************************
+ * NAME:	    orderedset.h
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    The header file for the implementation of an ordered set,
+ *		    a set whose elements are kept sorted by a user-defined
+ *		    three-way comparison function. Besides the operations in
+ *		    set.h, it supports range iteration, floor and ceiling,
+ *		    and finding the rank of an element or the element of a
+ *		    given rank.
+ *
+ * CREATED:	    10/17/2026
+ *
+ * LAST EDITED:	    10/17/2026
+ ***/
+
+#ifndef __ET_ORDEREDSET_H__
+#define __ET_ORDEREDSET_H__
+
+/******************************************************************************
+ * MACRO DEFINITIONS
+ ***/
+
+/* The maximum number of entries in a node of the tree. Nodes other than the
+ * root hold at least half this many. */
+#ifndef CONFIG_ORDEREDSET_ORDER
+#   define CONFIG_ORDEREDSET_ORDER 16
+#endif
+
+#define orderedset_size(set) ((set)->size)
+#define orderedset_isempty(set) (orderedset_size(set) == 0 ? 1 : 0)
+
+/* Wrapper macros for the variadic ordered set operations. As with set.h,
+ * these should ALWAYS be called instead of the corresponding _func functions.
+ */
+#define orderedset_union(Setu, ...)					\
+  (orderedset_union_func(Setu, (orderedset * []){__VA_ARGS__, NULL}))
+
+#define orderedset_intersection(Seti, ...)				\
+  (orderedset_intersection_func(Seti, (orderedset * []){__VA_ARGS__, NULL}))
+
+#define orderedset_isequal(...)						\
+  (orderedset_isequal_func((orderedset * []){__VA_ARGS__, NULL}))
+
+/******************************************************************************
+ * TYPE DEFINITIONS
+ ***/
+
+/* The part of an internal node that a leaf does not have: counts[i] is the
+ * number of elements under children[i]. */
+typedef struct {
+
+  long counts[CONFIG_ORDEREDSET_ORDER];
+  struct _orderednode_ * children[CONFIG_ORDEREDSET_ORDER];
+
+} orderedbranch;
+
+/* A node of the B+-tree. Leaves hold the elements, and are linked in order.
+ * In an internal node, keys[i] is the smallest element under children[i].
+ * An internal node is allocated with one orderedbranch, and a leaf with
+ * none. */
+typedef struct _orderednode_ {
+
+  int leaf;
+  int n;
+  struct _orderednode_ * prev;
+  struct _orderednode_ * next;
+  void * keys[CONFIG_ORDEREDSET_ORDER];
+
+  orderedbranch branch[];
+
+} orderednode;
+
+typedef struct {
+
+  long size;
+
+  int (*compare)(const void *, const void *);
+  void * (*copy)(const void *);
+  void (*destroy)(void *);
+
+  orderednode * root;
+  orderednode * first;
+  orderednode * last;
+
+} orderedset;
+
+/******************************************************************************
+ * API FUNCTION PROTOTYPES
+ ***/
+
+extern orderedset * orderedset_create(int (*compare)(const void *,
+						     const void *),
+				      void * (*copy)(const void *),
+				      void (*destroy)(void *));
+extern void orderedset_destroy(orderedset ** set);
+extern int orderedset_ismember(const orderedset * set, const void * data);
+extern int orderedset_insert(orderedset * set, void * data);
+extern int orderedset_remove(orderedset * set, const void * data);
+extern int orderedset_traverse(orderedset * set, void (*func)(void *));
+extern long orderedset_range(orderedset * set, const void * lo,
+			     const void * hi, void (*func)(void *));
+extern void * orderedset_min(const orderedset * set);
+extern void * orderedset_max(const orderedset * set);
+extern void * orderedset_floor(const orderedset * set, const void * data);
+extern void * orderedset_ceiling(const orderedset * set, const void * data);
+extern long orderedset_rank(const orderedset * set, const void * data);
+extern void * orderedset_select(const orderedset * set, long rank);
+extern int orderedset_difference(orderedset ** dest,
+				 const orderedset * source1,
+				 const orderedset * source2);
+extern int orderedset_issubset(const orderedset * subset,
+			       const orderedset * masterset);
+extern orderedset * orderedset_copy(const orderedset * set);
+
+/* These functions: */
+extern int orderedset_union_func(orderedset **, orderedset * []);
+extern int orderedset_intersection_func(orderedset **, orderedset * []);
+extern int orderedset_isequal_func(orderedset * []);
+/* Should NEVER be called directly. Use the wrapper macros defined above. */
+
+#endif /* __ET_ORDEREDSET_H__ */
+
+/*****************************************************************************/
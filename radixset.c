@@ -0,0 +1,1464 @@
+/******************************************************************************
+ * NAME:	    radixset.c
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    Source file containing the radix set engine, an adaptive
+ *		    radix tree. Each inner node branches on one byte of the
+ *		    key, and comes in four sizes, for 4, 16, 48 or 256
+ *		    children, so that a node is only as large as its fan-out
+ *		    needs: it is grown when it fills, and shrunk when it has
+ *		    emptied well below the next size down. A node with one
+ *		    child is merged into it, and the bytes they share kept as
+ *		    the prefix of the merged node. Each member is held in a
+ *		    leaf, with a copy of its key, so that a lookup never
+ *		    calls the key function on a member of the set. The
+ *		    iterators, and the walks of combine, go from a key to
+ *		    the least key above it, so they need no stack.
+ *
+ * CREATED:	    10/17/2026
+ *
+ * LAST EDITED:	    10/17/2026
+ ***/
+
+/******************************************************************************
+ * INCLUDES
+ ***/
+
+#include <limits.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "set.h"
+#include "setengine.h"
+#include "radixset.h"
+
+/******************************************************************************
+ * MACRO DEFINITIONS
+ ***/
+
+/* The number of sets a walk follows without allocating. */
+#define RADIXSET_LOCAL 16
+
+/* The sizes of inner node. */
+#define NODE4	0
+#define NODE16	1
+#define NODE48	2
+#define NODE256	3
+
+/* Children are nodes or leaves. Leaves are tagged in the low bit. */
+#define is_leaf(child) (((uintptr_t)(child) & 1) != 0)
+#define leaf_of(child) ((radixleaf *)((uintptr_t)(child) & ~(uintptr_t)1))
+#define tag_of(leaf) ((void *)((uintptr_t)(leaf) | 1))
+
+#define stored_of(node)						\
+  ((node)->prefixlen < CONFIG_RADIXSET_PREFIX				\
+   ? (node)->prefixlen : CONFIG_RADIXSET_PREFIX)
+
+/* The sorted edges and children of a node of 4 or 16. */
+#define keys_of(node)						\
+  ((node)->kind == NODE4 ? ((radixnode4 *)(node))->keys		\
+   : ((radixnode16 *)(node))->keys)
+#define children_of(node)					\
+  ((node)->kind == NODE4 ? ((radixnode4 *)(node))->children	\
+   : ((radixnode16 *)(node))->children)
+
+/******************************************************************************
+ * TYPE DEFINITIONS
+ ***/
+
+/* A member, and its key. */
+typedef struct {
+
+  void * data;
+  size_t length;
+  unsigned char key[];
+
+} radixleaf;
+
+/* The head of an inner node. Every key under the node continues with the
+ * prefixlen bytes of its prefix, the first of which are kept in `prefix'.
+ * The member with a key that ends here, if there is one, is `terminal'. A
+ * node always has at least two children, counting the terminal. */
+typedef struct {
+
+  unsigned char kind;
+  unsigned short count;
+  unsigned int prefixlen;
+  unsigned char prefix[CONFIG_RADIXSET_PREFIX];
+  radixleaf * terminal;
+
+} radixnode;
+
+typedef struct {
+
+  radixnode head;
+  unsigned char keys[4];
+  void * children[4];
+
+} radixnode4;
+
+typedef struct {
+
+  radixnode head;
+  unsigned char keys[16];
+  void * children[16];
+
+} radixnode16;
+
+/* index[edge] is one more than the slot of the child for edge, or 0. */
+typedef struct {
+
+  radixnode head;
+  unsigned char index[256];
+  void * children[48];
+
+} radixnode48;
+
+typedef struct {
+
+  radixnode head;
+  void * children[256];
+
+} radixnode256;
+
+/* The storage of a radix set. */
+typedef struct {
+
+  radixset_key key;
+  void * root;
+
+  long nodes[4];
+  long leaves;
+  unsigned long long bytes;
+
+} radixstore;
+
+/******************************************************************************
+ * LOCAL PROTOTYPES
+ ***/
+
+static radixstore * open_store(radixset_key);
+static void free_tree(void *, void (*)(void *));
+static radixnode * new_node(radixstore *, int);
+static void free_node(radixstore *, radixnode *);
+static radixleaf * new_leaf(radixstore *, void *);
+static void free_leaf(radixstore *, radixleaf *);
+static int compare_keys(const unsigned char *, size_t, const unsigned char *,
+			size_t);
+static void ** find_child(radixnode *, unsigned char);
+static void * next_child(const radixnode *, int, unsigned char *);
+static void put_child(radixnode *, unsigned char, void *);
+static int resize(radixstore *, void **, int);
+static int add_child(radixstore *, void **, unsigned char, void *);
+static void remove_child(radixstore *, void **, unsigned char);
+static void set_prefix(radixnode *, const unsigned char *, size_t);
+static void place(radixnode *, radixleaf *, size_t);
+static radixleaf * minimum(const void *);
+static size_t mismatch(const radixnode *, const unsigned char *, size_t,
+		       size_t);
+static radixleaf * search(const radixstore *, const unsigned char *, size_t);
+static radixleaf * at_least(const void *, const unsigned char *, size_t,
+			    size_t, int);
+static int insert_leaf(radixstore *, radixleaf *);
+static void collapse(radixstore *, void **);
+static radixleaf * remove_leaf(radixstore *, void **, const unsigned char *,
+			       size_t, size_t);
+static int add_copy(set *, const void *);
+static int walk(set *, int, set * [], int);
+static int gather(set *, int, set * [], int);
+
+static int radix_ismember(const set *, const void *);
+static int radix_insert(set *, void *);
+static void * radix_remove(set *, const void *);
+static void * radix_begin(const set *, set_iterator *);
+static void * radix_advance(const set *, set_iterator *);
+static void radix_clear(set *);
+static int radix_like(set *, const set *);
+static int radix_combine(set *, int, set * []);
+
+/******************************************************************************
+ * ENGINES
+ ***/
+
+const set_engine set_radix_engine = {
+  .name = "radix",
+  .ismember = radix_ismember,
+  .insert = radix_insert,
+  .remove = radix_remove,
+  .begin = radix_begin,
+  .advance = radix_advance,
+  .clear = radix_clear,
+  .like = radix_like,
+  .combine = radix_combine
+};
+
+/* The children a node of each size holds, the count at or below which it is
+ * shrunk, and its size in bytes. */
+static const int capacities[] = {4, 16, 48, 256};
+static const int shrinks[] = {0, 3, 12, 36};
+static const size_t sizes[] = {
+  sizeof(radixnode4), sizeof(radixnode16), sizeof(radixnode48),
+  sizeof(radixnode256)
+};
+
+/******************************************************************************
+ * API FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:	    set_create_radix
+ *
+ * DESCRIPTION:	    Creates an empty radix set.
+ *
+ * ARGUMENTS:	    match, copy, destroy: as in set_create (set.h).
+ *		    key: (radixset_key) -- gives the key of a member. See
+ *			radixset.h, and radixset_string_key and
+ *			radixset_int_key below.
+ *
+ * RETURN:	    (set *) -- pointer to the set, or NULL.
+ *
+ * NOTES:	    O(1). The set holds pointers to its members, as a list
+ *		    or hashed set does. The iterators return members in the
+ *		    order of their keys, compared byte by byte, with a key
+ *		    before every longer key that it begins.
+ ***/
+set * set_create_radix(int (*match)(const void *, const void *),
+		       radixset_key key, void * (*copy)(const void *),
+		       void (*destroy)(void *))
+{
+  if (match == NULL || key == NULL)
+    return NULL;
+
+  set * group = NULL;
+  if ((group = set_create_engine(&set_radix_engine, match, NULL, copy,
+				 destroy)) == NULL)
+    return NULL;
+
+  if ((group->storage = open_store(key)) == NULL) {
+    free(group);
+    return NULL;
+  }
+
+  return group;
+}
+
+/******************************************************************************
+ * FUNCTION:	    set_radix_prefix
+ *
+ * DESCRIPTION:	    Begins an iteration over the members of a radix set with
+ *		    keys that start with `prefix'. set_advance continues it,
+ *		    and returns NULL after the last of them.
+ *
+ * ARGUMENTS:	    group: (const set *) -- the set to be operated on.
+ *		    prefix: (const void *) -- the first bytes of the keys.
+ *		    length: (size_t) -- the length of the prefix. With 0,
+ *			every member is visited, as with set_begin.
+ *		    iterator: (set_iterator *) -- the position.
+ *
+ * RETURN:	    void * -- the first such member, or NULL if there is none.
+ *
+ * NOTES:	    O(k) for a prefix of k bytes, and then O(k) per member.
+ *		    The members come in the order of their keys.
+ ***/
+void * set_radix_prefix(const set * group, const void * prefix,
+			size_t length, set_iterator * iterator)
+{
+  if (group == NULL || iterator == NULL || (prefix == NULL && length > 0)
+      || group->engine != &set_radix_engine || length > LONG_MAX)
+    return NULL;
+
+  const radixstore * store = group->storage;
+  radixleaf * leaf = at_least(store->root, prefix, length, 0, 0);
+  if (leaf != NULL
+      && (leaf->length < length || memcmp(leaf->key, prefix, length) != 0))
+    leaf = NULL;
+
+  iterator->node = leaf;
+  iterator->index = (long)length;
+  return leaf == NULL ? NULL : leaf->data;
+}
+
+/******************************************************************************
+ * FUNCTION:	    set_radix_stats
+ *
+ * DESCRIPTION:	    Reports the shape of a radix set.
+ *
+ * ARGUMENTS:	    group: (const set *) -- the set to be operated on.
+ *		    stats: (radixset_stats *) -- will contain the statistics.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    O(1)
+ ***/
+int set_radix_stats(const set * group, radixset_stats * stats)
+{
+  if (group == NULL || stats == NULL || group->engine != &set_radix_engine)
+    return -1;
+
+  const radixstore * store = group->storage;
+  *stats = (radixset_stats){
+    .nodes4 = store->nodes[NODE4],
+    .nodes16 = store->nodes[NODE16],
+    .nodes48 = store->nodes[NODE48],
+    .nodes256 = store->nodes[NODE256],
+    .leaves = store->leaves,
+    .bytes = store->bytes
+  };
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    radixset_string_key
+ *
+ * DESCRIPTION:	    Key function for members that are C strings. The key is
+ *		    the string, without its terminating null byte.
+ *
+ * ARGUMENTS:	    data: (const void *) -- the (const char *) member.
+ *		    buffer: (unsigned char *) -- unused.
+ *		    length: (size_t *) -- will contain the length of the key.
+ *
+ * RETURN:	    const unsigned char * -- the key.
+ *
+ * NOTES:	    O(n) for a string of n bytes.
+ ***/
+const unsigned char * radixset_string_key(const void * data,
+					  unsigned char * buffer,
+					  size_t * length)
+{
+  *length = strlen(data);
+  return data;
+}
+
+/******************************************************************************
+ * FUNCTION:	    radixset_int_key
+ *
+ * DESCRIPTION:	    Key function for members that are ints. The key is the
+ *		    int, most significant byte first, with its sign bit
+ *		    flipped, so the keys are in the order of the ints.
+ *
+ * ARGUMENTS:	    data: (const void *) -- the (const int *) member.
+ *		    buffer: (unsigned char *) -- will contain the key.
+ *		    length: (size_t *) -- will contain sizeof(int).
+ *
+ * RETURN:	    const unsigned char * -- the key, in buffer.
+ *
+ * NOTES:	    O(1)
+ ***/
+const unsigned char * radixset_int_key(const void * data,
+				       unsigned char * buffer,
+				       size_t * length)
+{
+  unsigned int value = (unsigned int)*((const int *)data)
+    ^ (1u << (sizeof(int) * CHAR_BIT - 1));
+  for (size_t i = sizeof(int); i > 0; i--, value >>= CHAR_BIT)
+    buffer[i - 1] = (unsigned char)value;
+
+  *length = sizeof(int);
+  return buffer;
+}
+
+/******************************************************************************
+ * LOCAL FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:	    open_store
+ *
+ * DESCRIPTION:	    Creates the storage of an empty radix set.
+ *
+ * ARGUMENTS:	    key: (radixset_key) -- the key function.
+ *
+ * RETURN:	    radixstore * -- the storage, or NULL.
+ *
+ * NOTES:	    O(1)
+ ***/
+static radixstore * open_store(radixset_key key)
+{
+  radixstore * store = NULL;
+  if ((store = malloc(sizeof(radixstore))) == NULL)
+    return NULL;
+
+  *store = (radixstore){
+    .key = key,
+    .root = NULL,
+    .nodes = {0, 0, 0, 0},
+    .leaves = 0,
+    .bytes = 0
+  };
+  return store;
+}
+
+/******************************************************************************
+ * FUNCTION:	    free_tree
+ *
+ * DESCRIPTION:	    Frees a node or leaf, and everything under it.
+ *
+ * ARGUMENTS:	    child: (void *) -- the node or tagged leaf, or NULL.
+ *		    destroy: (void (*)(void *)) -- called on every member, if
+ *			not NULL.
+ *
+ * RETURN:	    void.
+ *
+ * NOTES:	    O(n). Recurses once per node on the path to a leaf, which
+ *		    is at most the length of its key.
+ ***/
+static void free_tree(void * child, void (*destroy)(void *))
+{
+  if (child == NULL)
+    return;
+
+  if (is_leaf(child)) {
+    radixleaf * leaf = leaf_of(child);
+    if (destroy != NULL)
+      destroy(leaf->data);
+    free(leaf);
+    return;
+  }
+
+  radixnode * node = child;
+  unsigned char edge = 0;
+  if (node->terminal != NULL)
+    free_tree(tag_of(node->terminal), destroy);
+  for (void * next = next_child(node, 0, &edge); next != NULL;
+       next = next_child(node, edge + 1, &edge))
+    free_tree(next, destroy);
+  free(node);
+}
+
+/******************************************************************************
+ * FUNCTION:	    new_node
+ *
+ * DESCRIPTION:	    Allocates an empty inner node.
+ *
+ * ARGUMENTS:	    store: (radixstore *) -- the storage.
+ *		    kind: (int) -- the size of the node.
+ *
+ * RETURN:	    radixnode * -- the node, or NULL.
+ *
+ * NOTES:	    O(1) for the size of the node.
+ ***/
+static radixnode * new_node(radixstore * store, int kind)
+{
+  radixnode * node = NULL;
+  if ((node = calloc(1, sizes[kind])) == NULL)
+    return NULL;
+
+  node->kind = (unsigned char)kind;
+  store->nodes[kind]++;
+  store->bytes += sizes[kind];
+  return node;
+}
+
+/* Frees an inner node, but none of its children. */
+static void free_node(radixstore * store, radixnode * node)
+{
+  store->nodes[node->kind]--;
+  store->bytes -= sizes[node->kind];
+  free(node);
+}
+
+/******************************************************************************
+ * FUNCTION:	    new_leaf
+ *
+ * DESCRIPTION:	    Allocates the leaf of a member, with a copy of its key.
+ *
+ * ARGUMENTS:	    store: (radixstore *) -- the storage.
+ *		    data: (void *) -- the member.
+ *
+ * RETURN:	    radixleaf * -- the leaf, or NULL.
+ *
+ * NOTES:	    O(k) for a key of k bytes.
+ ***/
+static radixleaf * new_leaf(radixstore * store, void * data)
+{
+  unsigned char buffer[CONFIG_RADIXSET_BUFFER];
+  size_t length = 0;
+  const unsigned char * key = store->key(data, buffer, &length);
+  if (length > UINT_MAX)
+    return NULL;
+
+  radixleaf * leaf = NULL;
+  if ((leaf = malloc(sizeof(radixleaf) + length)) == NULL)
+    return NULL;
+
+  leaf->data = data;
+  leaf->length = length;
+  memcpy(leaf->key, key, length);
+  store->leaves++;
+  store->bytes += sizeof(radixleaf) + length;
+  return leaf;
+}
+
+/* Frees a leaf, but not its member. */
+static void free_leaf(radixstore * store, radixleaf * leaf)
+{
+  store->leaves--;
+  store->bytes -= sizeof(radixleaf) + leaf->length;
+  free(leaf);
+}
+
+/******************************************************************************
+ * FUNCTION:	    compare_keys
+ *
+ * DESCRIPTION:	    Orders two keys, byte by byte. A key that begins another
+ *		    comes before it.
+ *
+ * ARGUMENTS:	    one, two: (const unsigned char *) -- the keys.
+ *		    onelen, twolen: (size_t) -- their lengths.
+ *
+ * RETURN:	    int -- less than, equal to or greater than zero, as one is
+ *		    less than, equal to or greater than two.
+ *
+ * NOTES:	    O(k)
+ ***/
+static int compare_keys(const unsigned char * one, size_t onelen,
+			const unsigned char * two, size_t twolen)
+{
+  size_t shorter = onelen < twolen ? onelen : twolen;
+  int order = shorter > 0 ? memcmp(one, two, shorter) : 0;
+  if (order != 0)
+    return order;
+  return (onelen > twolen) - (onelen < twolen);
+}
+
+/******************************************************************************
+ * FUNCTION:	    find_child
+ *
+ * DESCRIPTION:	    Finds the child of a node for an edge.
+ *
+ * ARGUMENTS:	    node: (radixnode *) -- the inner node.
+ *		    edge: (unsigned char) -- the next byte of the key.
+ *
+ * RETURN:	    void ** -- the slot that holds the child, or NULL.
+ *
+ * NOTES:	    O(1). Nodes of 4 and 16 are searched in order, and give up
+ *		    at the first greater edge.
+ ***/
+static void ** find_child(radixnode * node, unsigned char edge)
+{
+  switch (node->kind) {
+  case NODE4:
+  case NODE16: {
+    unsigned char * keys = keys_of(node);
+    for (int i = 0; i < node->count && keys[i] <= edge; i++)
+      if (keys[i] == edge)
+	return &children_of(node)[i];
+    return NULL;
+  }
+  case NODE48: {
+    radixnode48 * wide = (radixnode48 *)node;
+    return wide->index[edge] ? &wide->children[wide->index[edge] - 1] : NULL;
+  }
+  default: {
+    radixnode256 * full = (radixnode256 *)node;
+    return full->children[edge] != NULL ? &full->children[edge] : NULL;
+  }
+  }
+}
+
+/******************************************************************************
+ * FUNCTION:	    next_child
+ *
+ * DESCRIPTION:	    Finds the child of a node with the least edge at or above
+ *		    `from'.
+ *
+ * ARGUMENTS:	    node: (const radixnode *) -- the inner node.
+ *		    from: (int) -- the least edge, from 0 to 256.
+ *		    edge: (unsigned char *) -- will contain the edge.
+ *
+ * RETURN:	    void * -- the child, or NULL if there is none.
+ *
+ * NOTES:	    O(1). With from = edge + 1, visits the children in order.
+ ***/
+static void * next_child(const radixnode * node, int from,
+			 unsigned char * edge)
+{
+  switch (node->kind) {
+  case NODE4:
+  case NODE16: {
+    const unsigned char * keys = keys_of(node);
+    for (int i = 0; i < node->count; i++) {
+      if (keys[i] >= from) {
+	*edge = keys[i];
+	return children_of(node)[i];
+      }
+    }
+    return NULL;
+  }
+  case NODE48: {
+    const radixnode48 * wide = (const radixnode48 *)node;
+    for (int i = from; i < 256; i++) {
+      if (wide->index[i]) {
+	*edge = (unsigned char)i;
+	return wide->children[wide->index[i] - 1];
+      }
+    }
+    return NULL;
+  }
+  default: {
+    const radixnode256 * full = (const radixnode256 *)node;
+    for (int i = from; i < 256; i++) {
+      if (full->children[i] != NULL) {
+	*edge = (unsigned char)i;
+	return full->children[i];
+      }
+    }
+    return NULL;
+  }
+  }
+}
+
+/******************************************************************************
+ * FUNCTION:	    put_child
+ *
+ * DESCRIPTION:	    Adds a child to a node that has room for it.
+ *
+ * ARGUMENTS:	    node: (radixnode *) -- the inner node.
+ *		    edge: (unsigned char) -- an edge the node does not have.
+ *		    child: (void *) -- the node or tagged leaf.
+ *
+ * RETURN:	    void.
+ *
+ * NOTES:	    O(1). Nodes of 4 and 16 keep their edges sorted.
+ ***/
+static void put_child(radixnode * node, unsigned char edge, void * child)
+{
+  switch (node->kind) {
+  case NODE4:
+  case NODE16: {
+    unsigned char * keys = keys_of(node);
+    void ** children = children_of(node);
+    int i = node->count;
+    for (; i > 0 && keys[i - 1] > edge; i--) {
+      keys[i] = keys[i - 1];
+      children[i] = children[i - 1];
+    }
+    keys[i] = edge;
+    children[i] = child;
+    break;
+  }
+  case NODE48: {
+    radixnode48 * wide = (radixnode48 *)node;
+    int slot = 0;
+    while (wide->children[slot] != NULL)
+      slot++;
+    wide->children[slot] = child;
+    wide->index[edge] = (unsigned char)(slot + 1);
+    break;
+  }
+  default:
+    ((radixnode256 *)node)->children[edge] = child;
+    break;
+  }
+  node->count++;
+}
+
+/******************************************************************************
+ * FUNCTION:	    resize
+ *
+ * DESCRIPTION:	    Replaces a node with a node of another size, with the same
+ *		    prefix, terminal and children.
+ *
+ * ARGUMENTS:	    store: (radixstore *) -- the storage.
+ *		    ref: (void **) -- the slot that holds the node.
+ *		    kind: (int) -- the new size, which has room for the
+ *			children.
+ *
+ * RETURN:	    int -- 0 if successful, -1 if the set is out of memory, and
+ *		    the node is left as it is.
+ *
+ * NOTES:	    O(1) for the size of the node.
+ ***/
+static int resize(radixstore * store, void ** ref, int kind)
+{
+  radixnode * node = *ref, * other = NULL;
+  if ((other = new_node(store, kind)) == NULL)
+    return -1;
+
+  other->prefixlen = node->prefixlen;
+  memcpy(other->prefix, node->prefix, stored_of(node));
+  other->terminal = node->terminal;
+  unsigned char edge = 0;
+  for (void * child = next_child(node, 0, &edge); child != NULL;
+       child = next_child(node, edge + 1, &edge))
+    put_child(other, edge, child);
+
+  free_node(store, node);
+  *ref = other;
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    add_child
+ *
+ * DESCRIPTION:	    Adds a child to a node, growing the node if it is full.
+ *
+ * ARGUMENTS:	    store: (radixstore *) -- the storage.
+ *		    ref: (void **) -- the slot that holds the node.
+ *		    edge: (unsigned char) -- an edge the node does not have.
+ *		    child: (void *) -- the node or tagged leaf.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    O(1)
+ ***/
+static int add_child(radixstore * store, void ** ref, unsigned char edge,
+		     void * child)
+{
+  radixnode * node = *ref;
+  if (node->count == capacities[node->kind]
+      && resize(store, ref, node->kind + 1))
+    return -1;
+
+  put_child(*ref, edge, child);
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    remove_child
+ *
+ * DESCRIPTION:	    Removes a child from a node, shrinking the node if few
+ *		    enough children are left.
+ *
+ * ARGUMENTS:	    store: (radixstore *) -- the storage.
+ *		    ref: (void **) -- the slot that holds the node.
+ *		    edge: (unsigned char) -- an edge the node has.
+ *
+ * RETURN:	    void.
+ *
+ * NOTES:	    O(1). A node is shrunk well below the capacity of the next
+ *		    size down, so a member added and removed over and over
+ *		    does not resize it every time. If there is no memory for
+ *		    the smaller node, the node keeps its size.
+ ***/
+static void remove_child(radixstore * store, void ** ref, unsigned char edge)
+{
+  radixnode * node = *ref;
+  switch (node->kind) {
+  case NODE4:
+  case NODE16: {
+    unsigned char * keys = keys_of(node);
+    void ** children = children_of(node);
+    int i = 0;
+    while (keys[i] != edge)
+      i++;
+    memmove(keys + i, keys + i + 1, node->count - i - 1);
+    memmove(children + i, children + i + 1,
+	    (node->count - i - 1) * sizeof(void *));
+    break;
+  }
+  case NODE48: {
+    radixnode48 * wide = (radixnode48 *)node;
+    wide->children[wide->index[edge] - 1] = NULL;
+    wide->index[edge] = 0;
+    break;
+  }
+  default:
+    ((radixnode256 *)node)->children[edge] = NULL;
+    break;
+  }
+
+  node->count--;
+  if (node->kind > NODE4 && node->count <= shrinks[node->kind])
+    resize(store, ref, node->kind - 1);
+}
+
+/* Gives a node the prefix of `length' bytes at `bytes'. */
+static void set_prefix(radixnode * node, const unsigned char * bytes,
+		       size_t length)
+{
+  node->prefixlen = (unsigned int)length;
+  memcpy(node->prefix, bytes, stored_of(node));
+}
+
+/* Adds a leaf to a new node of 4, at the end of the node's path, `depth'
+ * bytes into the key. */
+static void place(radixnode * node, radixleaf * leaf, size_t depth)
+{
+  if (leaf->length == depth)
+    node->terminal = leaf;
+  else
+    put_child(node, leaf->key[depth], tag_of(leaf));
+}
+
+/******************************************************************************
+ * FUNCTION:	    minimum
+ *
+ * DESCRIPTION:	    Finds the leaf with the least key under a node.
+ *
+ * ARGUMENTS:	    child: (const void *) -- the node or tagged leaf, or NULL.
+ *
+ * RETURN:	    radixleaf * -- the leaf, or NULL.
+ *
+ * NOTES:	    O(k)
+ ***/
+static radixleaf * minimum(const void * child)
+{
+  unsigned char edge = 0;
+  while (child != NULL && !is_leaf(child)) {
+    const radixnode * node = child;
+    if (node->terminal != NULL)
+      return node->terminal;
+    child = next_child(node, 0, &edge);
+  }
+
+  return child == NULL ? NULL : leaf_of(child);
+}
+
+/******************************************************************************
+ * FUNCTION:	    mismatch
+ *
+ * DESCRIPTION:	    Compares the prefix of a node with a key.
+ *
+ * ARGUMENTS:	    node: (const radixnode *) -- the inner node.
+ *		    key: (const unsigned char *) -- the key.
+ *		    length: (size_t) -- its length.
+ *		    depth: (size_t) -- the bytes of the key above the node.
+ *
+ * RETURN:	    size_t -- the number of bytes of the prefix that the key
+ *		    matches.
+ *
+ * NOTES:	    O(p) for a prefix of p bytes. The bytes of a long prefix
+ *		    that the node does not keep are read from the least key
+ *		    under it.
+ ***/
+static size_t mismatch(const radixnode * node, const unsigned char * key,
+		       size_t length, size_t depth)
+{
+  size_t limit = length - depth < node->prefixlen
+    ? length - depth : node->prefixlen;
+  size_t i = 0;
+  for (; i < limit && i < CONFIG_RADIXSET_PREFIX; i++)
+    if (node->prefix[i] != key[depth + i])
+      return i;
+
+  if (i < limit) {
+    const radixleaf * least = minimum(node);
+    for (; i < limit; i++)
+      if (least->key[depth + i] != key[depth + i])
+	return i;
+  }
+  return i;
+}
+
+/******************************************************************************
+ * FUNCTION:	    search
+ *
+ * DESCRIPTION:	    Finds the leaf with a key.
+ *
+ * ARGUMENTS:	    store: (const radixstore *) -- the storage.
+ *		    key: (const unsigned char *) -- the key.
+ *		    length: (size_t) -- its length.
+ *
+ * RETURN:	    radixleaf * -- the leaf, or NULL.
+ *
+ * NOTES:	    O(k), one node per byte at most. Only the bytes of a prefix
+ *		    the node keeps are compared on the way down; the key of
+ *		    the leaf found at the bottom is compared in full.
+ ***/
+static radixleaf * search(const radixstore * store, const unsigned char * key,
+			  size_t length)
+{
+  const void * child = store->root;
+  size_t depth = 0;
+  while (child != NULL && !is_leaf(child)) {
+    const radixnode * node = child;
+    if (depth + node->prefixlen > length
+	|| memcmp(node->prefix, key + depth, stored_of(node)) != 0)
+      return NULL;
+
+    depth += node->prefixlen;
+    if (depth == length) {
+      child = node->terminal != NULL ? tag_of(node->terminal) : NULL;
+      break;
+    }
+
+    void ** slot = find_child((radixnode *)node, key[depth++]);
+    child = slot != NULL ? *slot : NULL;
+  }
+
+  if (child == NULL)
+    return NULL;
+  radixleaf * leaf = leaf_of(child);
+  return leaf->length == length && memcmp(leaf->key, key, length) == 0
+    ? leaf : NULL;
+}
+
+/******************************************************************************
+ * FUNCTION:	    at_least
+ *
+ * DESCRIPTION:	    Finds the leaf with the least key at or above a key, or
+ *		    strictly above it.
+ *
+ * ARGUMENTS:	    child: (const void *) -- the node or tagged leaf, or NULL.
+ *		    key: (const unsigned char *) -- the key.
+ *		    length: (size_t) -- its length.
+ *		    depth: (size_t) -- the bytes of the key above the node.
+ *		    strict: (int) -- 1 for keys above `key' only.
+ *
+ * RETURN:	    radixleaf * -- the leaf, or NULL if there is none.
+ *
+ * NOTES:	    O(k). Follows the key down, and takes the least key of the
+ *		    next child to the right at the level where the key runs
+ *		    out of keys at or above it.
+ ***/
+static radixleaf * at_least(const void * child, const unsigned char * key,
+			    size_t length, size_t depth, int strict)
+{
+  if (child == NULL)
+    return NULL;
+  if (is_leaf(child)) {
+    radixleaf * leaf = leaf_of(child);
+    int order = compare_keys(leaf->key, leaf->length, key, length);
+    return order > 0 || (order == 0 && !strict) ? leaf : NULL;
+  }
+
+  const radixnode * node = child;
+  const radixleaf * least = NULL;
+  for (size_t i = 0; i < node->prefixlen; i++) {
+    if (depth + i == length)
+      return minimum(node);
+    if (i >= CONFIG_RADIXSET_PREFIX && least == NULL)
+      least = minimum(node);
+    unsigned char byte = i < CONFIG_RADIXSET_PREFIX
+      ? node->prefix[i] : least->key[depth + i];
+    if (byte != key[depth + i])
+      return byte > key[depth + i] ? minimum(node) : NULL;
+  }
+
+  depth += node->prefixlen;
+  unsigned char edge = 0;
+  const void * next = NULL;
+  if (depth == length) {
+    if (node->terminal != NULL && !strict)
+      return node->terminal;
+    next = next_child(node, 0, &edge);
+  } else if ((next = next_child(node, key[depth], &edge)) != NULL
+	     && edge == key[depth]) {
+    radixleaf * found = at_least(next, key, length, depth + 1, strict);
+    if (found != NULL)
+      return found;
+    next = next_child(node, edge + 1, &edge);
+  }
+
+  return minimum(next);
+}
+
+/******************************************************************************
+ * FUNCTION:	    insert_leaf
+ *
+ * DESCRIPTION:	    Adds a leaf to the tree, unless its key is there already.
+ *
+ * ARGUMENTS:	    store: (radixstore *) -- the storage.
+ *		    leaf: (radixleaf *) -- the new leaf.
+ *
+ * RETURN:	    int -- 0 if successful, 1 if the key is in the tree, -1 if
+ *		    the set is out of memory.
+ *
+ * NOTES:	    O(k). A leaf met on the way down is split into a node of 4
+ *		    for the bytes it shares with the key, and a node whose
+ *		    prefix the key leaves is split the same way. Every node is
+ *		    allocated before the tree is changed, so a failure leaves
+ *		    the tree as it was.
+ ***/
+static int insert_leaf(radixstore * store, radixleaf * leaf)
+{
+  const unsigned char * key = leaf->key;
+  size_t length = leaf->length, depth = 0;
+  void ** ref = &store->root;
+  for (;;) {
+    if (*ref == NULL) {
+      *ref = tag_of(leaf);
+      return 0;
+    }
+
+    radixnode * parent = NULL;
+    if (is_leaf(*ref)) {
+      radixleaf * other = leaf_of(*ref);
+      if (other->length == length && memcmp(other->key, key, length) == 0)
+	return 1;
+
+      size_t common = 0, limit = (other->length < length
+				  ? other->length : length) - depth;
+      while (common < limit && other->key[depth + common] == key[depth + common])
+	common++;
+
+      if ((parent = new_node(store, NODE4)) == NULL)
+	return -1;
+      set_prefix(parent, key + depth, common);
+      place(parent, other, depth + common);
+      place(parent, leaf, depth + common);
+      *ref = parent;
+      return 0;
+    }
+
+    radixnode * node = *ref;
+    size_t matched = mismatch(node, key, length, depth);
+    if (matched < node->prefixlen) {
+      if ((parent = new_node(store, NODE4)) == NULL)
+	return -1;
+      set_prefix(parent, key + depth, matched);
+
+      /* The node keeps the rest of its prefix, after the byte that is now
+       * its edge in the parent. */
+      unsigned char edge = 0;
+      size_t rest = node->prefixlen - matched - 1;
+      if (node->prefixlen <= CONFIG_RADIXSET_PREFIX) {
+	edge = node->prefix[matched];
+	memmove(node->prefix, node->prefix + matched + 1, rest);
+      } else {
+	const radixleaf * least = minimum(node);
+	edge = least->key[depth + matched];
+	memcpy(node->prefix, least->key + depth + matched + 1,
+	       rest < CONFIG_RADIXSET_PREFIX ? rest : CONFIG_RADIXSET_PREFIX);
+      }
+      node->prefixlen = (unsigned int)rest;
+
+      put_child(parent, edge, node);
+      place(parent, leaf, depth + matched);
+      *ref = parent;
+      return 0;
+    }
+
+    depth += node->prefixlen;
+    if (depth == length) {
+      if (node->terminal != NULL)
+	return 1;
+      node->terminal = leaf;
+      return 0;
+    }
+
+    void ** slot = NULL;
+    if ((slot = find_child(node, key[depth])) == NULL)
+      return add_child(store, ref, key[depth], tag_of(leaf));
+    ref = slot;
+    depth++;
+  }
+}
+
+/******************************************************************************
+ * FUNCTION:	    collapse
+ *
+ * DESCRIPTION:	    Replaces a node that has one child left, counting the
+ *		    terminal, with that child.
+ *
+ * ARGUMENTS:	    store: (radixstore *) -- the storage.
+ *		    ref: (void **) -- the slot that holds the node.
+ *
+ * RETURN:	    void.
+ *
+ * NOTES:	    O(1). A leaf takes the place of the node as it is, since a
+ *		    leaf holds its whole key. An inner child is given the
+ *		    prefix of the node, then its edge, ahead of its own.
+ ***/
+static void collapse(radixstore * store, void ** ref)
+{
+  radixnode * node = *ref;
+  if (node->count + (node->terminal != NULL) != 1)
+    return;
+
+  unsigned char edge = 0;
+  void * child = node->terminal != NULL
+    ? tag_of(node->terminal) : next_child(node, 0, &edge);
+  if (!is_leaf(child)) {
+    radixnode * inner = child;
+    unsigned char bytes[CONFIG_RADIXSET_PREFIX];
+    size_t have = stored_of(node);
+    memcpy(bytes, node->prefix, have);
+    if (have < CONFIG_RADIXSET_PREFIX)
+      bytes[have++] = edge;
+    size_t more = CONFIG_RADIXSET_PREFIX - have;
+    if (more > stored_of(inner))
+      more = stored_of(inner);
+    memcpy(bytes + have, inner->prefix, more);
+    memcpy(inner->prefix, bytes, have + more);
+    inner->prefixlen += node->prefixlen + 1;
+  }
+
+  *ref = child;
+  free_node(store, node);
+}
+
+/******************************************************************************
+ * FUNCTION:	    remove_leaf
+ *
+ * DESCRIPTION:	    Removes the leaf with a key from the tree under a slot.
+ *
+ * ARGUMENTS:	    store: (radixstore *) -- the storage.
+ *		    ref: (void **) -- the slot.
+ *		    key: (const unsigned char *) -- the key.
+ *		    length: (size_t) -- its length.
+ *		    depth: (size_t) -- the bytes of the key above the slot.
+ *
+ * RETURN:	    radixleaf * -- the leaf, which is no longer in the tree, or
+ *		    NULL if the key is not in the tree.
+ *
+ * NOTES:	    O(k). Recurses once per node on the path. The node the
+ *		    leaf is taken from is shrunk, or collapsed, as needed.
+ ***/
+static radixleaf * remove_leaf(radixstore * store, void ** ref,
+			       const unsigned char * key, size_t length,
+			       size_t depth)
+{
+  radixleaf * leaf = NULL;
+  if (*ref == NULL)
+    return NULL;
+  if (is_leaf(*ref)) {
+    leaf = leaf_of(*ref);
+    if (leaf->length != length || memcmp(leaf->key, key, length) != 0)
+      return NULL;
+    *ref = NULL;
+    return leaf;
+  }
+
+  radixnode * node = *ref;
+  if (depth + node->prefixlen > length
+      || memcmp(node->prefix, key + depth, stored_of(node)) != 0)
+    return NULL;
+
+  depth += node->prefixlen;
+  if (depth == length) {
+    leaf = node->terminal;
+    if (leaf == NULL || leaf->length != length
+	|| memcmp(leaf->key, key, length) != 0)
+      return NULL;
+    node->terminal = NULL;
+  } else {
+    void ** slot = NULL;
+    if ((slot = find_child(node, key[depth])) == NULL)
+      return NULL;
+    if (!is_leaf(*slot))
+      return remove_leaf(store, slot, key, length, depth + 1);
+
+    leaf = leaf_of(*slot);
+    if (leaf->length != length || memcmp(leaf->key, key, length) != 0)
+      return NULL;
+    remove_child(store, ref, key[depth]);
+  }
+
+  collapse(store, ref);
+  return leaf;
+}
+
+/* Inserts a copy of `data' into the result of a walk. */
+static int add_copy(set * setk, const void * data)
+{
+  void * copy = NULL;
+  if ((copy = setk->copy(data)) == NULL)
+    return -1;
+
+  int ret = radix_insert(setk, copy);
+  if (ret != 0 && setk->destroy != NULL)
+    setk->destroy(copy);
+  return ret < 0 ? -1 : 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    walk
+ *
+ * DESCRIPTION:	    combine of radix sets with the same key function. Walks
+ *		    the trees together, in the order of their keys, and adds
+ *		    a copy of each member held by at least k of them.
+ *
+ * ARGUMENTS:	    setk: (set *) -- the empty result.
+ *		    k: (int) -- the threshold.
+ *		    sets: (set * []) -- the sets.
+ *		    n: (int) -- the number of sets.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    O(Nnk) for N members in total and keys of k bytes. For an
+ *		    intersection, a tree behind the others seeks straight to
+ *		    the greatest of their keys, skipping every subtree of
+ *		    keys the others do not have, so the cost follows the
+ *		    smaller set.
+ ***/
+static int walk(set * setk, int k, set * sets[], int n)
+{
+  const radixleaf * local[RADIXSET_LOCAL], ** heads = local;
+  if (n > RADIXSET_LOCAL
+      && (heads = malloc(n * sizeof(radixleaf *))) == NULL)
+    return -1;
+
+  for (int i = 0; i < n; i++)
+    heads[i] = minimum(((const radixstore *)sets[i]->storage)->root);
+
+  int ret = 0;
+  while (ret == 0) {
+    const radixleaf * least = NULL, * most = NULL;
+    int live = 0;
+    for (int i = 0; i < n; i++) {
+      if (heads[i] == NULL)
+	continue;
+      live++;
+      if (least == NULL || compare_keys(heads[i]->key, heads[i]->length,
+					least->key, least->length) < 0)
+	least = heads[i];
+      if (most == NULL || compare_keys(heads[i]->key, heads[i]->length,
+				       most->key, most->length) > 0)
+	most = heads[i];
+    }
+    if (live < k)
+      break;
+
+    if (k == n && compare_keys(least->key, least->length, most->key,
+			       most->length) != 0) {
+      for (int i = 0; i < n; i++)
+	if (heads[i] != most)
+	  heads[i] = at_least(((const radixstore *)sets[i]->storage)->root,
+			      most->key, most->length, 0, 0);
+      continue;
+    }
+
+    int count = 0;
+    for (int i = 0; i < n; i++)
+      count += heads[i] != NULL
+	&& compare_keys(heads[i]->key, heads[i]->length, least->key,
+			least->length) == 0;
+    if (count >= k)
+      ret = add_copy(setk, least->data);
+
+    /* Advancing a tree does not free its leaves, so `least' stays good. */
+    for (int i = 0; i < n; i++)
+      if (heads[i] != NULL
+	  && compare_keys(heads[i]->key, heads[i]->length, least->key,
+			  least->length) == 0)
+	heads[i] = at_least(((const radixstore *)sets[i]->storage)->root,
+			    least->key, least->length, 0, 1);
+  }
+
+  if (heads != local)
+    free(heads);
+  return ret;
+}
+
+/******************************************************************************
+ * FUNCTION:	    gather
+ *
+ * DESCRIPTION:	    combine of a radix set with sets of other engines, or
+ *		    other keys. Each candidate is looked up in the other
+ *		    sets, and added if it is found in enough of them.
+ *
+ * ARGUMENTS:	    setk: (set *) -- the empty result.
+ *		    k: (int) -- the threshold.
+ *		    sets: (set * []) -- the sets.
+ *		    n: (int) -- the number of sets.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    O(Nn) lookups. A candidate from set i that is in an earlier
+ *		    set has been counted already.
+ ***/
+static int gather(set * setk, int k, set * sets[], int n)
+{
+  for (int i = 0; i <= n - k; i++) {
+    set_iterator iterator;
+    for (void * data = set_begin(sets[i], &iterator); data != NULL;
+	 data = set_advance(sets[i], &iterator)) {
+      int count = 1, seen = 0;
+      for (int j = 0; j < n && !seen; j++) {
+	if (j != i && set_ismember(sets[j], data)) {
+	  seen = j < i;
+	  count++;
+	}
+      }
+      if (!seen && count >= k && add_copy(setk, data))
+	return -1;
+    }
+  }
+
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    radix_ismember
+ *
+ * DESCRIPTION:	    ismember primitive of the radix engine.
+ *
+ * ARGUMENTS:	    group: (const set *) -- the set to be operated on.
+ *		    data: (const void *) -- the data to check.
+ *
+ * RETURN:	    int -- 1 if the member is in the set, 0 if it is not.
+ *
+ * NOTES:	    O(k) for a key of k bytes.
+ ***/
+static int radix_ismember(const set * group, const void * data)
+{
+  const radixstore * store = group->storage;
+  unsigned char buffer[CONFIG_RADIXSET_BUFFER];
+  size_t length = 0;
+  const unsigned char * key = store->key(data, buffer, &length);
+  return search(store, key, length) != NULL;
+}
+
+/******************************************************************************
+ * FUNCTION:	    radix_insert
+ *
+ * DESCRIPTION:	    insert primitive of the radix engine.
+ *
+ * ARGUMENTS:	    group: (set *) -- the set to be operated on.
+ *		    data: (void *) -- the new member.
+ *
+ * RETURN:	    int -- 0 if successful, 1 if the member is already in the
+ *		    set, -1 otherwise.
+ *
+ * NOTES:	    O(k)
+ ***/
+static int radix_insert(set * group, void * data)
+{
+  radixstore * store = group->storage;
+  radixleaf * leaf = NULL;
+  if ((leaf = new_leaf(store, data)) == NULL)
+    return -1;
+
+  int ret = insert_leaf(store, leaf);
+  if (ret != 0)
+    free_leaf(store, leaf);
+  else
+    group->size++;
+  return ret;
+}
+
+/******************************************************************************
+ * FUNCTION:	    radix_remove
+ *
+ * DESCRIPTION:	    remove primitive of the radix engine.
+ *
+ * ARGUMENTS:	    group: (set *) -- the set to be operated on.
+ *		    data: (const void *) -- the member to remove.
+ *
+ * RETURN:	    void * -- the member removed, or NULL.
+ *
+ * NOTES:	    O(k)
+ ***/
+static void * radix_remove(set * group, const void * data)
+{
+  radixstore * store = group->storage;
+  unsigned char buffer[CONFIG_RADIXSET_BUFFER];
+  size_t length = 0;
+  const unsigned char * key = store->key(data, buffer, &length);
+
+  radixleaf * leaf = NULL;
+  if ((leaf = remove_leaf(store, &store->root, key, length, 0)) == NULL)
+    return NULL;
+
+  void * old = leaf->data;
+  free_leaf(store, leaf);
+  group->size--;
+  return old;
+}
+
+/******************************************************************************
+ * FUNCTION:	    radix_begin
+ *
+ * DESCRIPTION:	    begin primitive of the radix engine.
+ *
+ * ARGUMENTS:	    group: (const set *) -- the set to be operated on.
+ *		    iterator: (set_iterator *) -- will hold the position.
+ *
+ * RETURN:	    void * -- the member with the least key, or NULL.
+ *
+ * NOTES:	    O(k). The iterator holds the current leaf, and the length
+ *		    of the prefix it is limited to (set_radix_prefix).
+ ***/
+static void * radix_begin(const set * group, set_iterator * iterator)
+{
+  const radixstore * store = group->storage;
+  radixleaf * leaf = minimum(store->root);
+  iterator->node = leaf;
+  iterator->index = 0;
+  return leaf == NULL ? NULL : leaf->data;
+}
+
+/******************************************************************************
+ * FUNCTION:	    radix_advance
+ *
+ * DESCRIPTION:	    advance primitive of the radix engine.
+ *
+ * ARGUMENTS:	    group: (const set *) -- the set to be operated on.
+ *		    iterator: (set_iterator *) -- the position.
+ *
+ * RETURN:	    void * -- the member with the next key, or NULL at the end
+ *		    of the set, or of the prefix.
+ *
+ * NOTES:	    O(k). The next key is found from the root, so the
+ *		    iterator needs no stack.
+ ***/
+static void * radix_advance(const set * group, set_iterator * iterator)
+{
+  const radixstore * store = group->storage;
+  const radixleaf * last = iterator->node;
+  if (last == NULL)
+    return NULL;
+
+  size_t prefix = (size_t)iterator->index;
+  radixleaf * leaf = at_least(store->root, last->key, last->length, 0, 1);
+  if (leaf != NULL && prefix > 0
+      && (leaf->length < prefix || memcmp(leaf->key, last->key, prefix) != 0))
+    leaf = NULL;
+
+  iterator->node = leaf;
+  return leaf == NULL ? NULL : leaf->data;
+}
+
+/******************************************************************************
+ * FUNCTION:	    radix_clear
+ *
+ * DESCRIPTION:	    clear primitive of the radix engine.
+ *
+ * ARGUMENTS:	    group: (set *) -- the set to be operated on.
+ *
+ * RETURN:	    void.
+ *
+ * NOTES:	    O(n). destroy is called on every member.
+ ***/
+static void radix_clear(set * group)
+{
+  radixstore * store = group->storage;
+  if (store == NULL)
+    return;
+
+  free_tree(store->root, group->destroy);
+  free(store);
+  group->storage = NULL;
+  group->size = 0;
+}
+
+/* like primitive of the radix engine. Gives the set the model's key. */
+static int radix_like(set * group, const set * model)
+{
+  const radixstore * store = model->storage;
+  if ((group->storage = open_store(store->key)) == NULL)
+    return -1;
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    radix_combine
+ *
+ * DESCRIPTION:	    combine primitive of the radix engine. Radix sets with
+ *		    the same key function are walked together; otherwise the
+ *		    other sets are searched.
+ *
+ * ARGUMENTS:	    setk: (set *) -- the empty result, like sets[0].
+ *		    k: (int) -- the threshold.
+ *		    sets: (set * []) -- NULL terminated array of sets.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    See walk and gather.
+ ***/
+static int radix_combine(set * setk, int k, set * sets[])
+{
+  const radixstore * store = setk->storage;
+  int n = 0, radix = 1;
+  for (; sets[n] != NULL; n++)
+    radix &= sets[n]->engine == &set_radix_engine
+      && ((const radixstore *)sets[n]->storage)->key == store->key;
+
+  return radix ? walk(setk, k, sets, n) : gather(setk, k, sets, n);
+}
+
+/*****************************************************************************/
@@ -0,0 +1,91 @@
+/******************************************************************************
+ * NAME:	    radixset.h
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    The header file for the radix set engine, an adaptive
+ *		    radix tree over the bytes of a key. A radix set is an
+ *		    ordinary set (set.h) of members that each have a key, a
+ *		    string of bytes given by a key function: the text of a
+ *		    URL or path, the octets of an address, or an integer
+ *		    written with its most significant byte first. A lookup
+ *		    reads one node per byte of the key at most, runs of bytes
+ *		    shared by every key under a node are kept once, in the
+ *		    node, and members come out of the iterators in the order
+ *		    of their keys. The members with keys that start with a
+ *		    given prefix can be iterated on their own.
+ *
+ * CREATED:	    10/17/2026
+ *
+ * LAST EDITED:	    10/17/2026
+ ***/
+
+#ifndef __ET_RADIXSET_H__
+#define __ET_RADIXSET_H__
+
+#include <stddef.h>
+
+#include "set.h"
+
+/******************************************************************************
+ * CONFIGURATION
+ ***/
+
+/* The bytes of a compressed path kept in a node. Longer paths are checked
+ * against a key under the node. */
+#ifndef CONFIG_RADIXSET_PREFIX
+#   define CONFIG_RADIXSET_PREFIX 8
+#endif
+
+/* The size of the buffer given to a key function, for keys that are not
+ * stored in the member as they are. */
+#ifndef CONFIG_RADIXSET_BUFFER
+#   define CONFIG_RADIXSET_BUFFER 16
+#endif
+
+/******************************************************************************
+ * TYPE DEFINITIONS
+ ***/
+
+/* A key function. Returns the key of `data', and its length in *length:
+ * either a pointer into `data', or `buffer', with the key written into it.
+ * Members that match (set.h) must have equal keys, and members that do not
+ * must have different ones. */
+typedef const unsigned char * (*radixset_key)(const void * data,
+					      unsigned char * buffer,
+					      size_t * length);
+
+/* The shape of a radix set: the inner nodes of each size, the members, and
+ * the bytes of the nodes and of the leaves that hold the members. */
+typedef struct {
+
+  long nodes4;
+  long nodes16;
+  long nodes48;
+  long nodes256;
+  long leaves;
+  unsigned long long bytes;
+
+} radixset_stats;
+
+/******************************************************************************
+ * API FUNCTION PROTOTYPES
+ ***/
+
+extern set * set_create_radix(int (*match)(const void *, const void *),
+			      radixset_key key, void * (*copy)(const void *),
+			      void (*destroy)(void *));
+extern void * set_radix_prefix(const set * set, const void * prefix,
+			       size_t length, set_iterator * iterator);
+extern int set_radix_stats(const set * set, radixset_stats * stats);
+
+extern const unsigned char * radixset_string_key(const void * data,
+						 unsigned char * buffer,
+						 size_t * length);
+extern const unsigned char * radixset_int_key(const void * data,
+					      unsigned char * buffer,
+					      size_t * length);
+
+#endif /* __ET_RADIXSET_H__ */
+
+/*****************************************************************************/
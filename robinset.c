@@ -0,0 +1,455 @@
+/******************************************************************************
+ * NAME:	    robinset.c
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    Source file containing the Robin Hood set engine. Each
+ *		    slot of the table holds a member and its mixed hash, from
+ *		    which the distance of the member from its home slot is
+ *		    found. Along any run of the table, those distances grow by
+ *		    at most one from slot to slot, which is what lets a
+ *		    lookup stop early, and a removal close the gap by shifting
+ *		    the rest of the run back by one.
+ *
+ * CREATED:	    10/17/2026
+ *
+ * LAST EDITED:	    10/17/2026
+ ***/
+
+/******************************************************************************
+ * INCLUDES
+ ***/
+
+#include <stdlib.h>
+
+#include "robinset.h"
+#include "setengine.h"
+
+/******************************************************************************
+ * MACRO DEFINITIONS
+ ***/
+
+/* The fewest slots in a table. */
+#define ROBINSET_MIN_CAPACITY 16
+
+/* The distance of the member in slot i from its home slot. */
+#define distance(store, i)						\
+  (((i) - ((store)->slots[i].hash & (store)->mask)) & (store)->mask)
+
+/******************************************************************************
+ * TYPE DEFINITIONS
+ ***/
+
+/* A slot. It is empty if data is NULL. */
+typedef struct {
+
+  unsigned long hash;
+  void * data;
+
+} robinslot;
+
+typedef struct {
+
+  robinslot * slots;
+  unsigned long capacity;
+  unsigned long mask;
+
+} robinstore;
+
+/******************************************************************************
+ * LOCAL PROTOTYPES
+ ***/
+
+static unsigned long mix(unsigned long);
+static long find(const set *, const void *, unsigned long);
+static void place(robinstore *, robinslot);
+static int resize(set *, unsigned long);
+
+static int robin_ismember(const set *, const void *);
+static int robin_insert(set *, void *);
+static void * robin_remove(set *, const void *);
+static void * robin_begin(const set *, set_iterator *);
+static void * robin_advance(const set *, set_iterator *);
+static void robin_clear(set *);
+
+/******************************************************************************
+ * ENGINES
+ ***/
+
+const set_engine set_robin_engine = {
+  .name = "robin",
+  .ismember = robin_ismember,
+  .insert = robin_insert,
+  .remove = robin_remove,
+  .begin = robin_begin,
+  .advance = robin_advance,
+  .clear = robin_clear
+};
+
+/******************************************************************************
+ * API FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:	    set_create_robin
+ *
+ * DESCRIPTION:	    Initializes a robin set with the parameters given.
+ *
+ * ARGUMENTS:	    match: (int (*)(const void *, const void *)) -- as in
+ *			set_create.
+ *		    hash: (unsigned long (*)(const void *)) -- as in
+ *			set_create_hashed.
+ *		    copy: (void * (*copy)(const void *)) -- as in set_create.
+ *		    destroy: (void (*)(void *)) -- as in set_create.
+ *
+ * RETURN:	    (set *) -- pointer to the new set, or NULL.
+ *
+ * NOTES:	    O(1). The table is allocated by the first set_insert. The
+ *		    iteration order of a robin set is unspecified.
+ ***/
+set * set_create_robin(int (*match)(const void *, const void *),
+		       unsigned long (*hash)(const void *),
+		       void * (*copy)(const void *),
+		       void (*destroy)(void *))
+{
+  if (match == NULL || hash == NULL)
+    return NULL;
+  return set_create_engine(&set_robin_engine, match, hash, copy, destroy);
+}
+
+/******************************************************************************
+ * FUNCTION:	    set_robin_stats
+ *
+ * DESCRIPTION:	    Reports the shape of a robin set.
+ *
+ * ARGUMENTS:	    group: (const set *) -- the set to be operated on.
+ *		    stats: (robinset_stats *) -- will contain the statistics.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    O(capacity)
+ ***/
+int set_robin_stats(const set * group, robinset_stats * stats)
+{
+  if (group == NULL || stats == NULL || group->engine != &set_robin_engine)
+    return -1;
+
+  *stats = (robinset_stats){0, 0, 0, 0};
+  const robinstore * store = group->storage;
+  if (store == NULL)
+    return 0;
+
+  unsigned long long total = 0;
+  for (unsigned long i = 0; i < store->capacity; i++) {
+    if (store->slots[i].data == NULL)
+      continue;
+    unsigned long probe = distance(store, i) + 1;
+    total += probe;
+    if (probe > stats->longest)
+      stats->longest = probe;
+  }
+
+  stats->capacity = store->capacity;
+  stats->mean = group->size > 0 ? (double)total / group->size : 0;
+  stats->bytes = (unsigned long long)store->capacity * sizeof(robinslot);
+  return 0;
+}
+
+/******************************************************************************
+ * LOCAL FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:	    mix
+ *
+ * DESCRIPTION:	    Scrambles the bits of a user hash, so that functions like
+ *		    the identity on small integers still spread evenly over a
+ *		    power-of-two table.
+ *
+ * ARGUMENTS:	    hash: (unsigned long) -- the user hash.
+ *
+ * RETURN:	    unsigned long -- the mixed hash.
+ *
+ * NOTES:	    This is the finalizer of MurmurHash3, as in hashtable.c.
+ ***/
+static unsigned long mix(unsigned long hash)
+{
+  unsigned long long h = hash;
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return (unsigned long)h;
+}
+
+/******************************************************************************
+ * FUNCTION:	    find
+ *
+ * DESCRIPTION:	    Finds the slot that holds a member.
+ *
+ * ARGUMENTS:	    group: (const set *) -- a set with a table.
+ *		    data: (const void *) -- the data to look for.
+ *		    hash: (unsigned long) -- the mixed hash of `data'.
+ *
+ * RETURN:	    long -- the slot, or -1 if `data' is not a member.
+ *
+ * NOTES:	    O(1) expected. The probe stops at an empty slot, or at a
+ *		    member closer to its home than `data' would be, since
+ *		    `data' would have taken that member's slot.
+ ***/
+static long find(const set * group, const void * data, unsigned long hash)
+{
+  const robinstore * store = group->storage;
+  unsigned long i = hash & store->mask;
+  for (unsigned long d = 0;; i = (i + 1) & store->mask, d++) {
+    const robinslot * slot = &store->slots[i];
+    if (slot->data == NULL || distance(store, i) < d)
+      return -1;
+    if (slot->hash == hash && set_matches(group, slot->data, data))
+      return (long)i;
+  }
+}
+
+/******************************************************************************
+ * FUNCTION:	    place
+ *
+ * DESCRIPTION:	    Puts an entry that is not in the table into it. Walking
+ *		    from its home slot, the entry takes the slot of the first
+ *		    member closer to its own home, and that member is carried
+ *		    on in the same way, until an empty slot is found.
+ *
+ * ARGUMENTS:	    store: (robinstore *) -- a table with an empty slot.
+ *		    carry: (robinslot) -- the entry.
+ *
+ * RETURN:	    void.
+ *
+ * NOTES:	    O(1) expected.
+ ***/
+static void place(robinstore * store, robinslot carry)
+{
+  unsigned long i = carry.hash & store->mask;
+  for (unsigned long d = 0;; i = (i + 1) & store->mask, d++) {
+    robinslot * slot = &store->slots[i];
+    if (slot->data == NULL) {
+      *slot = carry;
+      return;
+    }
+
+    unsigned long theirs = distance(store, i);
+    if (theirs < d) {
+      robinslot swap = *slot;
+      *slot = carry;
+      carry = swap;
+      d = theirs;
+    }
+  }
+}
+
+/******************************************************************************
+ * FUNCTION:	    resize
+ *
+ * DESCRIPTION:	    Moves the members of a set into a new table of `capacity'
+ *		    slots.
+ *
+ * ARGUMENTS:	    group: (set *) -- the set to be operated on.
+ *		    capacity: (unsigned long) -- a power of two, with room for
+ *			the members under CONFIG_ROBINSET_LOAD.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise. On failure the set is
+ *		    left unchanged.
+ *
+ * NOTES:	    O(capacity)
+ ***/
+static int resize(set * group, unsigned long capacity)
+{
+  robinstore * old = group->storage, * store = NULL;
+  if ((store = malloc(sizeof(robinstore))) == NULL)
+    return -1;
+
+  *store = (robinstore){
+    .slots = calloc(capacity, sizeof(robinslot)),
+    .capacity = capacity,
+    .mask = capacity - 1
+  };
+  if (store->slots == NULL) {
+    free(store);
+    return -1;
+  }
+
+  if (old != NULL) {
+    for (unsigned long i = 0; i < old->capacity; i++)
+      if (old->slots[i].data != NULL)
+	place(store, old->slots[i]);
+    free(old->slots);
+    free(old);
+  }
+
+  group->storage = store;
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    robin_ismember
+ *
+ * DESCRIPTION:	    ismember primitive of the robin engine.
+ *
+ * ARGUMENTS:	    group: (const set *) -- the set to be operated on.
+ *		    data: (const void *) -- data to check.
+ *
+ * RETURN:	    int -- 1 if the member is in the set, 0 if it is not.
+ *
+ * NOTES:	    O(1) expected.
+ ***/
+static int robin_ismember(const set * group, const void * data)
+{
+  if (group->storage == NULL)
+    return 0;
+  return find(group, data, mix(set_hashof(group, data))) >= 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    robin_insert
+ *
+ * DESCRIPTION:	    insert primitive of the robin engine.
+ *
+ * ARGUMENTS:	    group: (set *) -- the set to be operated on.
+ *		    data: (void *) -- data to insert.
+ *
+ * RETURN:	    int -- 0 if successful, 1 if the data is already contained
+ *		    in the set, -1 otherwise.
+ *
+ * NOTES:	    O(1) amortized. The table doubles when it would be fuller
+ *		    than CONFIG_ROBINSET_LOAD eighths.
+ ***/
+static int robin_insert(set * group, void * data)
+{
+  unsigned long hash = mix(set_hashof(group, data));
+  if (group->storage != NULL && find(group, data, hash) >= 0)
+    return 1;
+
+  robinstore * store = group->storage;
+  if (store == NULL && resize(group, ROBINSET_MIN_CAPACITY))
+    return -1;
+  store = group->storage;
+  if ((unsigned long)(group->size + 1) * 8
+      > store->capacity * CONFIG_ROBINSET_LOAD
+      && resize(group, store->capacity * 2))
+    return -1;
+
+  place(group->storage, (robinslot){.hash = hash, .data = data});
+  group->size++;
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    robin_remove
+ *
+ * DESCRIPTION:	    remove primitive of the robin engine. The members after
+ *		    the removed one, up to the first that is in its home slot
+ *		    or the first empty slot, are shifted back by one slot.
+ *
+ * ARGUMENTS:	    group: (set *) -- the set to be operated on.
+ *		    data: (const void *) -- data to remove.
+ *
+ * RETURN:	    void * -- the data of the removed member, or NULL.
+ *
+ * NOTES:	    O(1) expected. No tombstone is left, so the table never
+ *		    needs to be rebuilt to clear them out. A table that has
+ *		    emptied to an eighth of its slots is halved.
+ ***/
+static void * robin_remove(set * group, const void * data)
+{
+  long found = -1;
+  if (group->storage == NULL
+      || (found = find(group, data, mix(set_hashof(group, data)))) < 0)
+    return NULL;
+
+  robinstore * store = group->storage;
+  unsigned long i = (unsigned long)found, j = (i + 1) & store->mask;
+  void * old = store->slots[i].data;
+  while (store->slots[j].data != NULL && distance(store, j) > 0) {
+    store->slots[i] = store->slots[j];
+    i = j;
+    j = (j + 1) & store->mask;
+  }
+  store->slots[i] = (robinslot){.hash = 0, .data = NULL};
+  group->size--;
+
+  if (store->capacity > ROBINSET_MIN_CAPACITY
+      && (unsigned long)group->size * 8 < store->capacity)
+    resize(group, store->capacity / 2);
+  return old;
+}
+
+/******************************************************************************
+ * FUNCTION:	    robin_begin
+ *
+ * DESCRIPTION:	    begin primitive of the robin engine.
+ *
+ * ARGUMENTS:	    group: (const set *) -- the set to be operated on.
+ *		    iterator: (set_iterator *) -- will contain the position.
+ *
+ * RETURN:	    void * -- the data of the first member, or NULL.
+ *
+ * NOTES:	    O(1) amortized.
+ ***/
+static void * robin_begin(const set * group, set_iterator * iterator)
+{
+  iterator->node = NULL;
+  iterator->index = -1;
+  return robin_advance(group, iterator);
+}
+
+/******************************************************************************
+ * FUNCTION:	    robin_advance
+ *
+ * DESCRIPTION:	    advance primitive of the robin engine.
+ *
+ * ARGUMENTS:	    group: (const set *) -- the set to be operated on.
+ *		    iterator: (set_iterator *) -- the current position.
+ *
+ * RETURN:	    void * -- the data of the next member, or NULL.
+ *
+ * NOTES:	    O(1) amortized.
+ ***/
+static void * robin_advance(const set * group, set_iterator * iterator)
+{
+  const robinstore * store = group->storage;
+  if (store == NULL)
+    return NULL;
+
+  while ((unsigned long)++iterator->index < store->capacity)
+    if (store->slots[iterator->index].data != NULL)
+      return store->slots[iterator->index].data;
+  return NULL;
+}
+
+/******************************************************************************
+ * FUNCTION:	    robin_clear
+ *
+ * DESCRIPTION:	    clear primitive of the robin engine.
+ *
+ * ARGUMENTS:	    group: (set *) -- the set to be operated on.
+ *
+ * RETURN:	    void.
+ *
+ * NOTES:	    O(capacity)
+ ***/
+static void robin_clear(set * group)
+{
+  robinstore * store = group->storage;
+  if (store != NULL) {
+    for (unsigned long i = 0; i < store->capacity && group->destroy != NULL;
+	 i++)
+      if (store->slots[i].data != NULL)
+	group->destroy(store->slots[i].data);
+    free(store->slots);
+    free(store);
+    group->storage = NULL;
+  }
+
+  group->size = 0;
+}
+
+/*****************************************************************************/
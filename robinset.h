@@ -0,0 +1,65 @@
+/******************************************************************************
+ * NAME:	    robinset.h
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    The header file for the Robin Hood set engine, a hashed
+ *		    set for workloads that remove about as often as they
+ *		    insert. A robin set is an ordinary set (set.h), kept in an
+ *		    open-addressed table with linear probing, where an
+ *		    insertion takes the slot of any member that is closer to
+ *		    its home slot than the new one would be. That keeps the
+ *		    probe lengths of all members nearly equal, and lets a
+ *		    lookup stop at the first member closer to home than the
+ *		    one it looks for. Removals shift the members after the
+ *		    removed one back, instead of leaving tombstones, so the
+ *		    table does not degrade under churn.
+ *
+ * CREATED:	    10/17/2026
+ *
+ * LAST EDITED:	    10/17/2026
+ ***/
+
+#ifndef __ET_ROBINSET_H__
+#define __ET_ROBINSET_H__
+
+#include "set.h"
+
+/******************************************************************************
+ * CONFIGURATION
+ ***/
+
+/* The most members a table holds, in eighths of its slots. */
+#ifndef CONFIG_ROBINSET_LOAD
+#   define CONFIG_ROBINSET_LOAD 7
+#endif
+
+/******************************************************************************
+ * TYPE DEFINITIONS
+ ***/
+
+/* The shape of a robin set: the slots of its table, the longest and the mean
+ * probe of its members (1 for a member in its home slot), and the bytes of
+ * the table. */
+typedef struct {
+
+  unsigned long capacity;
+  unsigned long longest;
+  double mean;
+  unsigned long long bytes;
+
+} robinset_stats;
+
+/******************************************************************************
+ * API FUNCTION PROTOTYPES
+ ***/
+
+extern set * set_create_robin(int (*match)(const void *, const void *),
+			      unsigned long (*hash)(const void *),
+			      void * (*copy)(const void *),
+			      void (*destroy)(void *));
+extern int set_robin_stats(const set * set, robinset_stats * stats);
+
+#endif /* __ET_ROBINSET_H__ */
+
+/*****************************************************************************/
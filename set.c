@@ -8,10 +8,13 @@
  *		    discrete mathematics. This code follows the typedefs and
  *		    prototypes contained in set.h. Also included is source code
  *		    for testing the structure. Compile this by 'make debug.'
+ *		    The members of a set are held by its engine (setengine.h).
+ *		    The linked list engine is defined here; the set operations
+ *		    are written in terms of the engine primitives.
  *
  * CREATED:	    05/09/2017
  *
- * LAST EDITED:	    02/12/2018
+ * LAST EDITED:	    10/17/2026
  ***/
 
 /******************************************************************************
@@ -24,6 +27,62 @@
 #include <stdarg.h>
 
 #include "set.h"
+#include "setengine.h"
+#include "hashtable.h"
+#include "cuckoofilter.h"
+
+/******************************************************************************
+ * MACRO DEFINITIONS
+ ***/
+
+/* Up to this many candidates, set_threshold_func counts on the stack. */
+#define TALLY_LOCAL (4 * CONFIG_SET_INLINE)
+
+/******************************************************************************
+ * TYPE DEFINITIONS
+ ***/
+
+/* Used by set_threshold_func to count the number of sets containing each
+ * candidate element. */
+typedef struct {
+
+  void * data;
+  unsigned long hash;
+  int count;
+
+} tally;
+
+/******************************************************************************
+ * LOCAL PROTOTYPES
+ ***/
+
+static set * set_like(const set *);
+static int add_copy(set *, const void *);
+static void * share(const void *);
+static int refilter(set *, unsigned long);
+static int count_linear(set *, int, set * [], long);
+static int count_hashed(set *, int, set * [], long);
+
+static int list_ismember(const set *, const void *);
+static int list_insert(set *, void *);
+static void * list_remove(set *, const void *);
+static void * list_begin(const set *, set_iterator *);
+static void * list_advance(const set *, set_iterator *);
+static void list_clear(set *);
+
+/******************************************************************************
+ * ENGINES
+ ***/
+
+const set_engine set_list_engine = {
+  .name = "list",
+  .ismember = list_ismember,
+  .insert = list_insert,
+  .remove = list_remove,
+  .begin = list_begin,
+  .advance = list_advance,
+  .clear = list_clear
+};
 
 /******************************************************************************
  * API FUNCTIONS
@@ -51,7 +110,8 @@
  *
  * RETURN:	    (set *) -- pointer to the new set, or NULL.
  *
- * NOTES:	    O(1)
+ * NOTES:	    O(1). The members are kept in a linked list, in the order
+ *		    they were inserted.
  ***/
 set * set_create(int (*match)(const void *, const void *),
 		 void * (*copy)(const void *),
@@ -59,6 +119,250 @@ set * set_create(int (*match)(const void *, const void *),
 {
   if (match == NULL)
     return NULL;
+  return set_create_engine(&set_list_engine, match, NULL, copy, destroy);
+}
+
+/******************************************************************************
+ * FUNCTION:	    set_create_hashed
+ *
+ * DESCRIPTION:	    Initializes a hashed set with the parameters given. The
+ *		    first CONFIG_SET_INLINE members are stored inside the set
+ *		    object, and when it grows past that they are moved to a
+ *		    hash table.
+ *
+ * ARGUMENTS:	    match: (int (*)(const void *, const void *)) -- as in
+ *			set_create.
+ *		    hash: (unsigned long (*)(const void *)) -- a pointer to a
+ *			user-defined function returning the hash of a key.
+ *			Keys that match must have the same hash.
+ *		    copy: (void * (*copy)(const void *)) -- as in set_create.
+ *		    destroy: (void (*)(void *)) -- as in set_create.
+ *
+ * RETURN:	    (set *) -- pointer to the new set, or NULL.
+ *
+ * NOTES:	    O(1). The iteration order of a hashed set is unspecified.
+ ***/
+set * set_create_hashed(int (*match)(const void *, const void *),
+			unsigned long (*hash)(const void *),
+			void * (*copy)(const void *),
+			void (*destroy)(void *))
+{
+  if (match == NULL || hash == NULL)
+    return NULL;
+  return set_create_engine(&set_hashed_engine, match, hash, copy, destroy);
+}
+
+/******************************************************************************
+ * FUNCTION:	    set_create_compact
+ *
+ * DESCRIPTION:	    Initializes a compact set with the parameters given. A
+ *		    compact set is a hashed set that keeps its members in a
+ *		    dense array, in the order they were inserted, with a
+ *		    separate small index to find them.
+ *
+ * ARGUMENTS:	    match: (int (*)(const void *, const void *)) -- as in
+ *			set_create.
+ *		    hash: (unsigned long (*)(const void *)) -- as in
+ *			set_create_hashed.
+ *		    copy: (void * (*copy)(const void *)) -- as in set_create.
+ *		    destroy: (void (*)(void *)) -- as in set_create.
+ *
+ * RETURN:	    (set *) -- pointer to the new set, or NULL.
+ *
+ * NOTES:	    O(1). Members are iterated, and traversed, in the order of
+ *		    insertion, like a list set, but set_ismember, set_insert
+ *		    and set_remove take O(1) expected time, like a hashed set.
+ ***/
+set * set_create_compact(int (*match)(const void *, const void *),
+			 unsigned long (*hash)(const void *),
+			 void * (*copy)(const void *),
+			 void (*destroy)(void *))
+{
+  if (match == NULL || hash == NULL)
+    return NULL;
+  return set_create_engine(&set_compact_engine, match, hash, copy, destroy);
+}
+
+/******************************************************************************
+ * FUNCTION:	    set_create_interned
+ *
+ * DESCRIPTION:	    Initializes a hashed set of interned handles, such as those
+ *		    returned by intern() and intern_string() (intern.h). Since
+ *		    equal values have the same handle, members are compared
+ *		    and hashed by address, and no user function is called.
+ *
+ * ARGUMENTS:	    none.
+ *
+ * RETURN:	    (set *) -- pointer to the new set, or NULL.
+ *
+ * NOTES:	    O(1). The set does not own its members: copies share the
+ *		    handle, and set_destroy leaves it alone, so the handles
+ *		    must outlive the set.
+ ***/
+set * set_create_interned(void)
+{
+  return set_create_engine(&set_hashed_engine, NULL, NULL, share, NULL);
+}
+
+/******************************************************************************
+ * FUNCTION:	    set_attach_filter
+ *
+ * DESCRIPTION:	    Puts a cuckoo filter (cuckoofilter.h) of the hashes of the
+ *		    members in front of a hashed or interned set. From then
+ *		    on set_insert and set_remove keep it up to date, and
+ *		    set_ismember consults it first, so that a lookup for a
+ *		    non-member rarely reaches the engine or calls match.
+ *
+ * ARGUMENTS:	    group: (set *) -- the set to be operated on.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    O(n). The filter grows with the set. Sets produced by the
+ *		    set operations do not inherit it.
+ ***/
+int set_attach_filter(set * group)
+{
+  if (group == NULL || (group->hash == NULL && !set_isinterned(group)))
+    return -1;
+  if (group->filter != NULL)
+    return 0;
+
+  return refilter(group, 2 * (unsigned long)set_size(group));
+}
+
+/******************************************************************************
+ * FUNCTION:	    set_detach_filter
+ *
+ * DESCRIPTION:	    Removes and frees the filter of a set, if it has one.
+ *
+ * ARGUMENTS:	    group: (set *) -- the set to be operated on.
+ *
+ * RETURN:	    void.
+ *
+ * NOTES:	    O(1)
+ ***/
+void set_detach_filter(set * group)
+{
+  if (group != NULL)
+    cuckoofilter_destroy(&group->filter);
+}
+
+/******************************************************************************
+ * FUNCTION:	    set_use_hugepages
+ *
+ * DESCRIPTION:	    Puts the hash table of a hashed set on huge pages, or back
+ *		    on normal ones, so that random lookups in a large set
+ *		    miss the TLB less. SET_PAGES_EXPLICIT asks for pages from
+ *		    the reserved pool (MAP_HUGETLB), SET_PAGES_TRANSPARENT for
+ *		    transparent huge pages (madvise(MADV_HUGEPAGE)); when they
+ *		    cannot be had, the set falls back to smaller pages.
+ *
+ * ARGUMENTS:	    group: (set *) -- the set to be operated on.
+ *		    pages: (set_pages) -- the kind of pages.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise. Falling back is not
+ *		    an error: set_memory_stats tells which pages the set got.
+ *
+ * NOTES:	    O(n), since the table is moved. It keeps the choice as it
+ *		    grows, but tables smaller than CONFIG_HASHTABLE_HUGE_MIN
+ *		    stay on normal pages. Sets produced by the set operations
+ *		    do not inherit it.
+ ***/
+int set_use_hugepages(set * group, set_pages pages)
+{
+  if (group == NULL || group->engine != &set_hashed_engine
+      || pages < SET_PAGES_NORMAL || pages > SET_PAGES_EXPLICIT)
+    return -1;
+
+  /* The kinds of pages are in the same order as hashtable_pages. */
+  group->pages = pages;
+  if (group->storage == NULL)
+    return 0;
+  return hashtable_setpages(group->storage, (hashtable_pages)pages);
+}
+
+/******************************************************************************
+ * FUNCTION:	    set_use_incremental
+ *
+ * DESCRIPTION:	    Makes the hash table of a hashed set grow incrementally,
+ *		    or all at once. When an incremental table must grow, it
+ *		    only allocates the new array, and each set_insert that
+ *		    follows moves the next CONFIG_HASHTABLE_MIGRATE slots of
+ *		    the old one, while lookups search both. This bounds the
+ *		    time of every insertion, instead of stalling the one that
+ *		    finds the table full while all of it is copied.
+ *
+ * ARGUMENTS:	    group: (set *) -- the set to be operated on.
+ *		    incremental: (int) -- nonzero to grow incrementally.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    O(1), or O(n) when turning it off finishes a resize that
+ *		    is under way. Sets produced by the set operations do not
+ *		    inherit it.
+ ***/
+int set_use_incremental(set * group, int incremental)
+{
+  if (group == NULL || group->engine != &set_hashed_engine)
+    return -1;
+
+  group->incremental = incremental != 0;
+  if (group->storage == NULL)
+    return 0;
+  return hashtable_setincremental(group->storage, group->incremental);
+}
+
+/******************************************************************************
+ * FUNCTION:	    set_memory_stats
+ *
+ * DESCRIPTION:	    Reports the pages behind the hash table of a hashed set.
+ *
+ * ARGUMENTS:	    group: (const set *) -- the set to be operated on.
+ *		    stats: (set_memstats *) -- will contain the statistics.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    May read /proc/self/smaps, to see whether the kernel has
+ *		    granted transparent huge pages.
+ ***/
+int set_memory_stats(const set * group, set_memstats * stats)
+{
+  if (group == NULL || stats == NULL || group->engine != &set_hashed_engine)
+    return -1;
+
+  const hashtable * table = group->storage;
+  stats->pages = group->pages;
+  stats->pagesize = hashtable_pagesize(table);
+  stats->bytes = table == NULL ? 0
+    : (unsigned long long)(table->capacity + table->oldcapacity)
+    * sizeof(bucket);
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    set_create_engine
+ *
+ * DESCRIPTION:	    Initializes a set that is held by the given engine.
+ *
+ * ARGUMENTS:	    engine: (const set_engine *) -- the storage engine.
+ *		    match, copy, destroy: as in set_create.
+ *		    hash: (unsigned long (*)(const void *)) -- as in
+ *			set_create_hashed. May be NULL if the engine does not
+ *			use it. If match is NULL too, the members are compared
+ *			by address (see set_isinterned in setengine.h).
+ *
+ * RETURN:	    (set *) -- pointer to the new set, or NULL.
+ *
+ * NOTES:	    O(1). Declared in setengine.h.
+ ***/
+set * set_create_engine(const set_engine * engine,
+			int (*match)(const void *, const void *),
+			unsigned long (*hash)(const void *),
+			void * (*copy)(const void *),
+			void (*destroy)(void *))
+{
+  if (engine == NULL)
+    return NULL;
   set * group = NULL;
   if ((group = malloc(sizeof(set))) == NULL)
     return NULL;
@@ -68,8 +372,14 @@ set * set_create(int (*match)(const void *, const void *),
     .match = match,
     .copy = copy,
     .destroy = destroy,
+    .hash = hash,
+    .engine = engine,
     .head = NULL,
-    .tail = NULL
+    .tail = NULL,
+    .storage = NULL,
+    .filter = NULL,
+    .pages = SET_PAGES_NORMAL,
+    .incremental = 0
   };
 
   return group;
@@ -87,21 +397,19 @@ set * set_create(int (*match)(const void *, const void *),
  * RETURN:	    int -- 1 if the member is in the set, 0 if it is not, -1 if
  *		    an error has occurred.
  *
- * NOTES:	    O(n)
+ * NOTES:	    O(n) for list sets, O(1) expected for hashed sets. If a
+ *		    filter is attached, most non-members are turned away by
+ *		    it, without reaching the engine.
  ***/
 int set_ismember(const set * group, const void * data)
 {
   if (group == NULL || data == NULL || set_isempty(group))
     return 0;
-
-  member * current = group->head;
-  while ((group->match(current->data, data) != 1) && set_next(current))
-    ;
-
-  if (current != NULL)
-    return group->match(current->data, data);
-  else
+  if (group->filter != NULL
+      && !cuckoofilter_contains(group->filter, set_hashof(group, data)))
     return 0;
+
+  return group->engine->ismember(group, data);
 }
 
 /******************************************************************************
@@ -116,35 +424,24 @@ int set_ismember(const set * group, const void * data)
  * RETURN:	    int -- 0 if successful, 1 if the data is already contained
  *		    in the set, -1 otherwise.
  *
- * NOTES:	    O(n)
+ * NOTES:	    O(n) for list sets, O(1) amortized for hashed sets. A disk
+ *		    set (diskset.h) stores a copy of the data, and destroys
+ *		    the data itself once it has been inserted.
  ***/
 int set_insert(set * group, void * data)
 {
   if (group == NULL || data == NULL)
     return -1;
 
-  if (set_ismember(group, data))
-    return 1;
-
-  member * new = (member *)malloc(sizeof(member));
-  new->data = data;
-
-  if (set_isempty(group)) {
-
-    group->head = new;
-    group->tail = new;
-    new->next = NULL;
-
-  } else {
-
-    group->tail->next = new;
-    group->tail = new;
-    new->next = NULL;
-
-  }  
-
-  group->size++;
-  return 0;
+  int ret = group->engine->insert(group, data);
+  if (ret == 0 && group->filter != NULL
+      && cuckoofilter_insert(group->filter, set_hashof(group, data))
+      && refilter(group, 2 * group->filter->buckets
+		  * CONFIG_CUCKOOFILTER_SLOTS))
+    set_detach_filter(group);
+  if (ret == 0 && group->engine->byvalue && group->destroy != NULL)
+    group->destroy(data);
+  return ret;
 }
 
 /******************************************************************************
@@ -158,59 +455,28 @@ int set_insert(set * group, void * data)
  *
  * RETURN:	    int -- 0 if successful, -1 otherwise.
  *
- * NOTES:	    O(n)
+ * NOTES:	    O(n) for list sets, O(1) expected for hashed sets.
  ***/
 int set_remove(set * group, const void ** data)
 {
   if (group == NULL || data == NULL || *data == NULL)
     return -1;
 
-  if (set_ismember(group, *data) != 1 && *data != NULL)
+  void * old = NULL;
+  if ((old = group->engine->remove(group, *data)) == NULL)
     return -1;
 
-  member * old;
-  if (*data == NULL) {
-    /* Remove the first element in the set. */
-    old = group->head;
-    group->head = group->head->next;
-
-    if (group->head == NULL)
-      group->tail = NULL;
-  } else {
-
-    member * current = group->head;
-    if (group->match(current->data, *data) != 1) {
-      while (group->match(current->next->data, *data) != 1) {
-	current = current->next;
-      }
-
-      old = current->next;
-      if (current->next == group->tail)
-	current->next = NULL;
-      else
-	current->next = current->next->next;
-
-    } else {
-
-      old = current;
-      group->head = group->head->next;
-      if (group->head == NULL)
-	group->tail = NULL;
-
-    }
-  }
-
-  if (group->destroy != NULL)
-    group->destroy(old->data);
-  free(old);
-  group->size--;
+  if (group->filter != NULL)
+    cuckoofilter_remove(group->filter, set_hashof(group, old));
+  if (group->destroy != NULL && !group->engine->byvalue)
+    group->destroy(old);
   return 0;
 }
 
 /******************************************************************************
  * FUNCTION:	    set_traverse
  *
- * DESCRIPTION:	    Traverses the set and calls func() on each member in the 
+ * DESCRIPTION:	    Traverses the set and calls func() on each member in the
  *		    set. Since the type member is unkown to the user, the
  *		    function takes a pointer to void.
  *
@@ -224,17 +490,61 @@ int set_remove(set * group, const void ** data)
  ***/
 int set_traverse(set * group, void (*func)(void *))
 {
-  member * current;
-
   if (group == NULL || set_isempty(group) || func == NULL)
     return -1;
 
-  for (current = group->head; current != NULL; set_next(current))
-    func(current->data);
+  set_iterator iterator;
+  for (void * data = set_begin(group, &iterator); data != NULL;
+       data = set_advance(group, &iterator))
+    func(data);
 
   return 0;
 }
 
+/******************************************************************************
+ * FUNCTION:	    set_begin
+ *
+ * DESCRIPTION:	    Starts an iteration over the members of the set.
+ *
+ * ARGUMENTS:	    group: (const set *) -- the set to be operated on.
+ *		    iterator: (set_iterator *) -- will contain the position of
+ *			the first member.
+ *
+ * RETURN:	    void * -- the data of the first member, or NULL if the set
+ *		    is empty.
+ *
+ * NOTES:	    O(1). The set must not be modified until the iteration is
+ *		    finished.
+ ***/
+void * set_begin(const set * group, set_iterator * iterator)
+{
+  if (group == NULL || iterator == NULL)
+    return NULL;
+
+  return group->engine->begin(group, iterator);
+}
+
+/******************************************************************************
+ * FUNCTION:	    set_advance
+ *
+ * DESCRIPTION:	    Continues an iteration over the members of the set.
+ *
+ * ARGUMENTS:	    group: (const set *) -- the set to be operated on.
+ *		    iterator: (set_iterator *) -- the position returned by
+ *			set_begin or a previous call to set_advance.
+ *
+ * RETURN:	    void * -- the data of the next member, or NULL at the end.
+ *
+ * NOTES:	    O(1) amortized.
+ ***/
+void * set_advance(const set * group, set_iterator * iterator)
+{
+  if (group == NULL || iterator == NULL)
+    return NULL;
+
+  return group->engine->advance(group, iterator);
+}
+
 /******************************************************************************
  * FUNCTION:	    set_destroy
  *
@@ -253,21 +563,8 @@ void set_destroy(set ** group)
   if (group == NULL || *group == NULL)
     return;
 
-  void * data;
-  member * old;
-  while (set_size(*group) > 0) {
-    data = (*group)->head->data;
-    old = (*group)->head;
-    (*group)->head = (*group)->head->next;
-    
-    (*group)->size--;
-    free(old);
-    
-    if ((*group)->destroy != NULL) {
-      (*group)->destroy(data);
-    }
-  }
-
+  (*group)->engine->clear(*group);
+  set_detach_filter(*group);
   free(*group);
   *group = NULL;
 }
@@ -289,42 +586,12 @@ void set_destroy(set ** group)
  *
  * RETURN:	    int -- 0 if computation was successful, -1 otherwise.
  *
- * NOTES:	    O(mn), where m is the number of sets unioned. Should always
- *		    be called by wrapper macro.
+ * NOTES:	    The union is the threshold operation with k = 1. Should
+ *		    always be called by wrapper macro.
  ***/
 int set_union_func(set ** setu,  set * sets[])
 {
-  if (sets[0] == NULL || setu == NULL)
-    return -1;
-  if ((*setu = set_create(sets[0]->match,
-			  sets[0]->copy,
-			  sets[0]->destroy)) == NULL)
-    return -1;
-
-  int i = 0;
-  for (set * set = sets[i]; set != NULL; set = sets[i++]) {
-    if (set->copy == NULL)
-      goto error_exception;
-    int ret = 0;
-    for (member * current = set->head; current != NULL; set_next(current)) {
-      void * new = NULL;
-      if ((new = (*setu)->copy(current->data)) == NULL)
-	goto error_exception;
-      if ((ret = set_insert(*setu, new))) {
-	if ((*setu)->destroy != NULL)
-	  (*setu)->destroy(new);
-	if (ret < 0)
-	  goto error_exception;
-      }
-    }
-  }
-
-  return 0;
-
- error_exception: {
-    set_destroy(setu);
-    return -1;
-  }
+  return set_threshold_func(setu, 1, sets);
 }
 
 /******************************************************************************
@@ -342,32 +609,77 @@ int set_union_func(set ** setu,  set * sets[])
  *
  * RETURN:	    int -- 0 if computation was successful, -1 otherwise.
  *
- * NOTES:	    O(mn), where m is the number of sets passed.
+ * NOTES:	    The intersection is the threshold operation with k = n,
+ *		    where n is the number of sets passed.
  ***/
 int set_intersection_func(set ** seti, set * sets[])
 {
-  if (sets[0] == NULL || seti == NULL || sets[0]->copy == NULL)
+  if (sets[0] == NULL)
     return -1;
-  int i = 0;
-  for (set * s = sets[i]; s != NULL; s = sets[++i])
+  int n = 0;
+  while (sets[n] != NULL)
+    n++;
+
+  return set_threshold_func(seti, n, sets);
+}
+
+/******************************************************************************
+ * FUNCTION:	    set_threshold_func
+ *
+ * DESCRIPTION:	    Places every element that is a member of at least k of the
+ *		    sets into setk. The result is computed with a single
+ *		    counting pass over the members of the input sets.
+ *
+ * ARGUMENTS:	    setk: (set **) -- will contain a pointer to the result at
+ *			the end of the call.
+ *		    k: (int) -- the minimum number of sets an element must be
+ *			a member of. Must be at least 1.
+ *		    sets: (set * []) -- An array of sets to operate on. If the
+ *			set_threshold() macro was used (as it should be), the
+ *			final set in the array will be NULL.
+ *
+ * RETURN:	    int -- 0 if computation was successful, -1 otherwise.
+ *
+ * NOTES:	    An element first seen in set i can only reach k if
+ *		    n - i >= k, so only the first n - k + 1 sets introduce
+ *		    candidates. For k = n this is the members of the first set
+ *		    only, for k = 1 it is every member. Hashed sets count in a
+ *		    hash table, in O(N) for N members in total; list sets, and
+ *		    inputs with few candidates, count in an array, in O(Nd)
+ *		    for d distinct candidates. An engine with a combine
+ *		    primitive (setengine.h) does the pass itself; sorted sets
+ *		    merge, in O(N), and radix sets walk their trees together.
+ *		    Should always be called by wrapper macro.
+ ***/
+int set_threshold_func(set ** setk, int k, set * sets[])
+{
+  if (sets[0] == NULL || setk == NULL || k < 1)
+    return -1;
+  int n = 0;
+  for (set * s = sets[n]; s != NULL; s = sets[++n])
     if (s->copy == NULL)
       return -1;
-  if ((*seti = set_create(sets[0]->match,
-			  sets[0]->copy,
-			  sets[0]->destroy)) == NULL)
+  if ((*setk = set_like(sets[0])) == NULL)
     return -1;
+  if (k > n)
+    return 0;
 
-  for (member * current = (*sets)->head; current != NULL; set_next(current)) {
-    int nonmember = 0, j = 1;
-    while (sets[j] != NULL && !nonmember)
-      nonmember = !set_ismember((const set *)sets[j++], current->data);
+  long candidates = 0;
+  for (int i = 0; i <= n - k; i++)
+    candidates += set_size(sets[i]);
 
-    if (nonmember)
-      continue;
-    set_insert(*seti, (*seti)->copy(current->data));
-  }
+  int ret = 0;
+  if (sets[0]->engine->combine != NULL)
+    ret = sets[0]->engine->combine(*setk, k, sets);
+  else if ((sets[0]->hash != NULL || set_isinterned(sets[0]))
+	   && candidates > TALLY_LOCAL)
+    ret = count_hashed(*setk, k, sets, candidates);
+  else
+    ret = count_linear(*setk, k, sets, candidates);
 
-  return 0;
+  if (ret)
+    set_destroy(setk);
+  return ret;
 }
 
 /******************************************************************************
@@ -383,23 +695,22 @@ int set_intersection_func(set ** seti, set * sets[])
  *
  * RETURN:	    int -- 0 if computation was successful, -1 otherwise.
  *
- * NOTES:	    O(mn)
+ * NOTES:	    O(mn) for list sets, O(m) for hashed sets.
  ***/
 int set_difference(set ** setd, const set * set1, const set * set2)
 {
   if (setd == NULL || set1 == NULL || set2 == NULL
       || set1->copy == NULL || set2->copy == NULL)
     return -1;
-  if ((*setd = set_create(set1->match,
-			  set1->copy,
-			  set1->destroy)) == NULL)
+  if ((*setd = set_like(set1)) == NULL)
     return -1;
 
-  member * current;
-  for (current = set1->head; current != NULL; set_next(current)) {
-    
-    if (!set_ismember(set2, current->data))
-      if (set_insert(*setd, (*setd)->copy(current->data)) != 0)
+  set_iterator iterator;
+  for (void * data = set_begin(set1, &iterator); data != NULL;
+       data = set_advance(set1, &iterator)) {
+
+    if (!set_ismember(set2, data))
+      if (add_copy(*setd, data))
 	goto error_exception;
 
   }
@@ -422,7 +733,7 @@ int set_difference(set ** setd, const set * set1, const set * set2)
  *
  * RETURN:	    int -- 1 if the set is a subset, 0 otherwise.
  *
- * NOTES:	    O(mn)
+ * NOTES:	    O(mn) for list sets, O(m) for hashed sets.
  ***/
 int set_issubset(const set * set1, const set * set2)
 {
@@ -432,10 +743,11 @@ int set_issubset(const set * set1, const set * set2)
   if (set_isempty(set1) && !set_isempty(set2))
     return 1;
 
-  member * current;
-  for (current = set1->head; current != NULL; set_next(current)) {
-    
-    if (!set_ismember(set2, current->data))
+  set_iterator iterator;
+  for (void * data = set_begin(set1, &iterator); data != NULL;
+       data = set_advance(set1, &iterator)) {
+
+    if (!set_ismember(set2, data))
       return 0;
 
   }
@@ -452,7 +764,7 @@ int set_issubset(const set * set1, const set * set2)
  *
  * RETURN:	    int -- 1 if the sets are equal, 0 otherwise.
  *
- * NOTES:	    O(mn)
+ * NOTES:	    O(mn) for list sets, O(m) for hashed sets.
  ***/
 int set_isequal_func(set * sets[])
 {
@@ -465,14 +777,15 @@ int set_isequal_func(set * sets[])
   if (i == 1)
     return 0;
 
-  member * current;
-  for (current = sets[0]->head; current != NULL; set_next(current)) {
+  set_iterator iterator;
+  for (void * data = set_begin(sets[0], &iterator); data != NULL;
+       data = set_advance(sets[0], &iterator)) {
     i = 0;
     for (set * s = sets[i]; s != NULL; s = sets[++i])
-      if (!set_ismember(s, current->data))
+      if (!set_ismember(s, data))
 	return 0;
   }
-  
+
   return 1;
 }
 
@@ -493,15 +806,18 @@ set * set_copy(const set * s)
   if (s == NULL)
     return NULL;
   if (set_size(s) == 0)
-    return set_create(s->match, s->copy, s->destroy);
+    return set_like(s);
+  if (s->copy == NULL)
+    return NULL;
 
   set * _new = NULL;
-  if ((_new = set_create(s->match, s->copy, s->destroy)) == NULL)
+  if ((_new = set_like(s)) == NULL)
     return NULL;
 
-  for (member * current = s->head; current != NULL;
-       current = current->next) {
-    if (set_insert(_new, _new->copy(current->data)) < 0) {
+  set_iterator iterator;
+  for (void * data = set_begin(s, &iterator); data != NULL;
+       data = set_advance(s, &iterator)) {
+    if (add_copy(_new, data)) {
       set_destroy(&_new);
       return NULL;
     }
@@ -510,4 +826,410 @@ set * set_copy(const set * s)
   return _new;
 }
 
+/******************************************************************************
+ * LOCAL FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:	    set_like
+ *
+ * DESCRIPTION:	    Creates an empty set with the same functions and engine as
+ *		    `model'.
+ *
+ * ARGUMENTS:	    model: (const set *) -- the set to imitate.
+ *
+ * RETURN:	    set * -- the new set, or NULL.
+ *
+ * NOTES:	    O(1)
+ ***/
+static set * set_like(const set * model)
+{
+  set * group = NULL;
+  if ((group = set_create_engine(model->engine, model->match, model->hash,
+				 model->copy, model->destroy)) == NULL)
+    return NULL;
+
+  if (model->engine->like != NULL && model->engine->like(group, model)) {
+    free(group);
+    return NULL;
+  }
+
+  return group;
+}
+
+/******************************************************************************
+ * FUNCTION:	    add_copy
+ *
+ * DESCRIPTION:	    Inserts a copy of `data' into the set, made with the copy
+ *		    function of the set.
+ *
+ * ARGUMENTS:	    group: (set *) -- the set to be operated on.
+ *		    data: (const void *) -- the data to copy.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    If the copy is already a member, it is destroyed.
+ ***/
+static int add_copy(set * group, const void * data)
+{
+  void * new = NULL;
+  if ((new = group->copy(data)) == NULL)
+    return -1;
+
+  int ret = set_insert(group, new);
+  if (ret && group->destroy != NULL)
+    group->destroy(new);
+  return ret < 0 ? -1 : 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    share
+ *
+ * DESCRIPTION:	    The copy function of interned sets. Handles are canonical,
+ *		    so a copy of one is the handle itself.
+ *
+ * ARGUMENTS:	    data: (const void *) -- the handle.
+ *
+ * RETURN:	    void * -- the same handle.
+ *
+ * NOTES:	    O(1)
+ ***/
+static void * share(const void * data)
+{
+  return (void *)data;
+}
+
+/******************************************************************************
+ * FUNCTION:	    refilter
+ *
+ * DESCRIPTION:	    Replaces the filter of a set with a new one, holding the
+ *		    hashes of all of its members.
+ *
+ * ARGUMENTS:	    group: (set *) -- a hashed or interned set.
+ *		    capacity: (unsigned long) -- the least capacity of the new
+ *			filter. It is doubled until every member fits.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise. On failure the old
+ *		    filter is kept.
+ *
+ * NOTES:	    O(n)
+ ***/
+static int refilter(set * group, unsigned long capacity)
+{
+  cuckoofilter * filter = NULL;
+  for (int full = 1; full; capacity *= 2) {
+    if ((filter = cuckoofilter_create(capacity)) == NULL)
+      return -1;
+
+    full = 0;
+    set_iterator iterator;
+    for (void * data = set_begin(group, &iterator); data != NULL && !full;
+	 data = set_advance(group, &iterator))
+      full = cuckoofilter_insert(filter, set_hashof(group, data));
+    if (full)
+      cuckoofilter_destroy(&filter);
+  }
+
+  cuckoofilter_destroy(&group->filter);
+  group->filter = filter;
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    count_linear
+ *
+ * DESCRIPTION:	    Counting pass of set_threshold_func, using an array of
+ *		    candidates that is searched linearly. When the sets are
+ *		    hashed, the hashes are compared before calling match.
+ *
+ * ARGUMENTS:	    setk: (set *) -- the empty result set.
+ *		    k: (int) -- the threshold.
+ *		    sets: (set * []) -- NULL terminated array of sets.
+ *		    candidates: (long) -- an upper bound on the number of
+ *			distinct candidates.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    O(Nd). Up to TALLY_LOCAL candidates are counted on the
+ *		    stack, so small sets are combined without allocating.
+ *		    The result is in the order the candidates were first seen.
+ *		    If any of the sets is byvalue, the candidates are copies.
+ ***/
+static int count_linear(set * setk, int k, set * sets[], long candidates)
+{
+  tally local[TALLY_LOCAL], * counts = local;
+  if (candidates > TALLY_LOCAL
+      && (counts = malloc(candidates * sizeof(tally))) == NULL)
+    return -1;
+
+  int n = 0, byvalue = 0;
+  while (sets[n] != NULL)
+    byvalue |= sets[n++]->engine->byvalue;
+
+  const set * model = sets[0];
+  long ncounts = 0;
+  int ret = 0;
+  for (int i = 0; i < n && ret == 0; i++) {
+    set_iterator iterator;
+    for (void * data = set_begin(sets[i], &iterator); data != NULL;
+	 data = set_advance(sets[i], &iterator)) {
+      unsigned long hash = model->hash != NULL || set_isinterned(model)
+	? set_hashof(model, data) : 0;
+      long j = 0;
+      while (j < ncounts && (counts[j].hash != hash
+			     || !set_matches(model, counts[j].data, data)))
+	j++;
+
+      if (j < ncounts) {
+	counts[j].count++;
+      } else if (i <= n - k) {
+	if (byvalue && (data = model->copy(data)) == NULL) {
+	  ret = -1;
+	  break;
+	}
+	counts[ncounts++] = (tally){.data = data, .hash = hash, .count = 1};
+      }
+    }
+  }
+
+  for (long j = 0; j < ncounts && ret == 0; j++)
+    if (counts[j].count >= k)
+      ret = add_copy(setk, counts[j].data);
+
+  if (byvalue && model->destroy != NULL)
+    for (long j = 0; j < ncounts; j++)
+      model->destroy(counts[j].data);
+  if (counts != local)
+    free(counts);
+  return ret;
+}
+
+/******************************************************************************
+ * FUNCTION:	    count_hashed
+ *
+ * DESCRIPTION:	    Counting pass of set_threshold_func, using a hash table
+ *		    keyed by the candidates. Requires a hash function.
+ *
+ * ARGUMENTS:	    setk: (set *) -- the empty result set.
+ *		    k: (int) -- the threshold.
+ *		    sets: (set * []) -- NULL terminated array of sets.
+ *		    candidates: (long) -- an upper bound on the number of
+ *			distinct candidates.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    O(N) expected. If any of the sets is byvalue, the
+ *		    candidates are copies.
+ ***/
+static int count_hashed(set * setk, int k, set * sets[], long candidates)
+{
+  hashtable counts;
+  if (hashtable_init(&counts, candidates + candidates / 3,
+		     sets[0]->hash, sets[0]->match))
+    return -1;
+
+  int n = 0, byvalue = 0;
+  while (sets[n] != NULL)
+    byvalue |= sets[n++]->engine->byvalue;
+
+  int ret = 0;
+  for (int i = 0; i < n && ret == 0; i++) {
+    set_iterator iterator;
+    for (void * data = set_begin(sets[i], &iterator); data != NULL;
+	 data = set_advance(sets[i], &iterator)) {
+      bucket * entry = i <= n - k && !byvalue
+	? hashtable_insert(&counts, data, NULL)
+	: hashtable_lookup(&counts, data);
+      if (entry == NULL && i <= n - k && byvalue) {
+	void * held = NULL;
+	if ((held = sets[0]->copy(data)) != NULL
+	    && (entry = hashtable_insert(&counts, held, NULL)) == NULL
+	    && sets[0]->destroy != NULL)
+	  sets[0]->destroy(held);
+      }
+
+      if (entry != NULL)
+	entry->count++;
+      else if (i <= n - k)
+	ret = -1;
+    }
+  }
+
+  for (bucket * entry = hashtable_next(&counts, NULL);
+       entry != NULL && ret == 0; entry = hashtable_next(&counts, entry))
+    if (entry->count >= k)
+      ret = add_copy(setk, entry->data);
+
+  hashtable_fini(&counts, byvalue ? sets[0]->destroy : NULL);
+  return ret;
+}
+
+/******************************************************************************
+ * FUNCTION:	    list_ismember
+ *
+ * DESCRIPTION:	    ismember primitive of the linked list engine.
+ *
+ * ARGUMENTS:	    group: (const set *) -- the set to be operated on.
+ *		    data: (const void *) -- data to check.
+ *
+ * RETURN:	    int -- 1 if the member is in the set, 0 if it is not.
+ *
+ * NOTES:	    O(n)
+ ***/
+static int list_ismember(const set * group, const void * data)
+{
+  for (member * current = group->head; current != NULL; set_next(current))
+    if (set_matches(group, current->data, data))
+      return 1;
+
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    list_insert
+ *
+ * DESCRIPTION:	    insert primitive of the linked list engine. New members
+ *		    are appended to the tail of the list.
+ *
+ * ARGUMENTS:	    group: (set *) -- the set to be operated on.
+ *		    data: (void *) -- data to insert.
+ *
+ * RETURN:	    int -- 0 if successful, 1 if the data is already contained
+ *		    in the set, -1 otherwise.
+ *
+ * NOTES:	    O(n)
+ ***/
+static int list_insert(set * group, void * data)
+{
+  if (list_ismember(group, data))
+    return 1;
+
+  member * new = NULL;
+  if ((new = (member *)malloc(sizeof(member))) == NULL)
+    return -1;
+  new->data = data;
+  new->next = NULL;
+
+  if (set_isempty(group)) {
+
+    group->head = new;
+    group->tail = new;
+
+  } else {
+
+    group->tail->next = new;
+    group->tail = new;
+
+  }
+
+  group->size++;
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    list_remove
+ *
+ * DESCRIPTION:	    remove primitive of the linked list engine.
+ *
+ * ARGUMENTS:	    group: (set *) -- the set to be operated on.
+ *		    data: (const void *) -- data to remove.
+ *
+ * RETURN:	    void * -- the data of the removed member, or NULL if there
+ *		    was no matching member.
+ *
+ * NOTES:	    O(n)
+ ***/
+static void * list_remove(set * group, const void * data)
+{
+  member * old = group->head, * previous = NULL;
+  while (old != NULL && !set_matches(group, old->data, data)) {
+    previous = old;
+    set_next(old);
+  }
+
+  if (old == NULL)
+    return NULL;
+
+  if (previous == NULL)
+    group->head = old->next;
+  else
+    previous->next = old->next;
+  if (group->tail == old)
+    group->tail = previous;
+
+  void * removed = old->data;
+  free(old);
+  group->size--;
+  return removed;
+}
+
+/******************************************************************************
+ * FUNCTION:	    list_begin
+ *
+ * DESCRIPTION:	    begin primitive of the linked list engine.
+ *
+ * ARGUMENTS:	    group: (const set *) -- the set to be operated on.
+ *		    iterator: (set_iterator *) -- will contain the position.
+ *
+ * RETURN:	    void * -- the data of the head, or NULL.
+ *
+ * NOTES:	    O(1)
+ ***/
+static void * list_begin(const set * group, set_iterator * iterator)
+{
+  iterator->node = group->head;
+  return group->head == NULL ? NULL : group->head->data;
+}
+
+/******************************************************************************
+ * FUNCTION:	    list_advance
+ *
+ * DESCRIPTION:	    advance primitive of the linked list engine.
+ *
+ * ARGUMENTS:	    group: (const set *) -- the set to be operated on.
+ *		    iterator: (set_iterator *) -- the current position.
+ *
+ * RETURN:	    void * -- the data of the next member, or NULL.
+ *
+ * NOTES:	    O(1)
+ ***/
+static void * list_advance(const set * group, set_iterator * iterator)
+{
+  member * current = iterator->node;
+  if (current == NULL || (iterator->node = current->next) == NULL)
+    return NULL;
+  return ((member *)iterator->node)->data;
+}
+
+/******************************************************************************
+ * FUNCTION:	    list_clear
+ *
+ * DESCRIPTION:	    clear primitive of the linked list engine.
+ *
+ * ARGUMENTS:	    group: (set *) -- the set to be operated on.
+ *
+ * RETURN:	    void.
+ *
+ * NOTES:	    O(n)
+ ***/
+static void list_clear(set * group)
+{
+  void * data;
+  member * old;
+  while (set_size(group) > 0) {
+    data = group->head->data;
+    old = group->head;
+    group->head = group->head->next;
+
+    group->size--;
+    free(old);
+
+    if (group->destroy != NULL) {
+      group->destroy(data);
+    }
+  }
+
+  group->tail = NULL;
+}
+
 /*****************************************************************************/
@@ -9,12 +9,22 @@
  *
  * CREATED:	    05/09/2017
  *
- * LAST EDITED:	    02/04/2018
+ * LAST EDITED:	    10/17/2026
  ***/
 
 #ifndef __ET_SET_H__
 #define __ET_SET_H__
 
+/******************************************************************************
+ * CONFIGURATION
+ ***/
+
+/* The number of members a hashed set holds inside the set object itself,
+ * before it moves them to a hash table. At most 64. */
+#ifndef CONFIG_SET_INLINE
+#   define CONFIG_SET_INLINE 8
+#endif
+
 /******************************************************************************
  * TYPE DEFINITIONS
  ***/
@@ -26,6 +36,20 @@ typedef struct _member_ {
 
 } member;
 
+/* The storage engine of a set. Defined in setengine.h */
+struct _set_engine_;
+/* An optional filter in front of a hashed set. Defined in cuckoofilter.h */
+struct _cuckoofilter_;
+
+/* The pages behind the hash table of a hashed set (set_use_hugepages). */
+typedef enum {
+
+  SET_PAGES_NORMAL,
+  SET_PAGES_TRANSPARENT,
+  SET_PAGES_EXPLICIT
+
+} set_pages;
+
 typedef struct {
 
   int size;
@@ -33,12 +57,43 @@ typedef struct {
   int (*match)(const void *, const void *);
   void * (*copy)(const void *);
   void (*destroy)(void *);
+  unsigned long (*hash)(const void *);
 
+  const struct _set_engine_ * engine;
+
+  /* List sets */
   member * head;
   member * tail;
 
+  /* Hashed sets */
+  void * storage;
+  unsigned long hashes[CONFIG_SET_INLINE];
+  void * inlined[CONFIG_SET_INLINE];
+  struct _cuckoofilter_ * filter;
+  set_pages pages;
+  int incremental;
+
 } set;
 
+/* The memory of a hashed set: the pages asked for, the size of the pages
+ * its hash table has, and the bytes of the table, with both of its arrays
+ * while it grows incrementally (set_use_incremental). */
+typedef struct {
+
+  set_pages pages;
+  unsigned long pagesize;
+  unsigned long long bytes;
+
+} set_memstats;
+
+/* A position in a set, for use with set_begin and set_advance. */
+typedef struct {
+
+  void * node;
+  long index;
+
+} set_iterator;
+
 /******************************************************************************
  * MACRO DEFINITIONS
  ***/
@@ -48,9 +103,10 @@ typedef struct {
 /* Mostly for use in for and while loops: */
 #define set_next(member) (member = (member)->next)
 
-/* Wrapper macros for set_union and set_intersection
+/* Wrapper macros for set_union, set_intersection and set_threshold
  * These macros safely terminate the list, and should ALWAYS be called
- * instead of set_union_func and set_intersection_func, respectively.
+ * instead of set_union_func, set_intersection_func and set_threshold_func,
+ * respectively.
  */
 #define set_union(Setu, ...)				\
   (set_union_func(Setu, (set * []){__VA_ARGS__, NULL}))
@@ -58,6 +114,10 @@ typedef struct {
 #define set_intersection(Seti, ...)				\
   (set_intersection_func(Seti, (set * []){__VA_ARGS__, NULL}))
 
+/* Elements that are members of at least k of the sets. */
+#define set_threshold(Setk, k, ...)				\
+  (set_threshold_func(Setk, k, (set * []){__VA_ARGS__, NULL}))
+
 #define set_isequal(...)				\
   (set_isequal_func((set * []){__VA_ARGS__, NULL}))
 
@@ -68,10 +128,26 @@ typedef struct {
 extern set * set_create(int (*match)(const void *, const void *),
 			void * (*copy)(const void *),
 			void (*destroy)(void *));
+extern set * set_create_hashed(int (*match)(const void *, const void *),
+			       unsigned long (*hash)(const void *),
+			       void * (*copy)(const void *),
+			       void (*destroy)(void *));
+extern set * set_create_compact(int (*match)(const void *, const void *),
+				unsigned long (*hash)(const void *),
+				void * (*copy)(const void *),
+				void (*destroy)(void *));
+extern set * set_create_interned(void);
+extern int set_attach_filter(set * set);
+extern void set_detach_filter(set * set);
+extern int set_use_hugepages(set * set, set_pages pages);
+extern int set_use_incremental(set * set, int incremental);
+extern int set_memory_stats(const set * set, set_memstats * stats);
 extern int set_ismember(const set * set, const void * data);
 extern int set_insert(set * set, void * data);
 extern int set_remove(set * set, const void ** data);
 extern int set_traverse(set * set, void (*func)(void *));
+extern void * set_begin(const set * set, set_iterator * iterator);
+extern void * set_advance(const set * set, set_iterator * iterator);
 extern void set_destroy(set ** set);
 extern int set_difference(set ** dest,
 			  const set * source1,
@@ -82,6 +158,7 @@ extern set * set_copy(const set * set);
 /* These functions: */
 extern int set_union_func(set **, set * []);
 extern int set_intersection_func(set **, set * []);
+extern int set_threshold_func(set **, int, set * []);
 extern int set_isequal_func(set * []);
 /* Should NEVER be called directly. Use the wrapper macros defined above. */
 
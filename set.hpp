@@ -0,0 +1,579 @@
+/******************************************************************************
+ * NAME:	    set.hpp
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    Header-only C++ counterpart of set.h. et::Set<T, Hash, Eq,
+ *		    Alloc> is a hashed set that stores its members by value, in
+ *		    an open-addressed table with linear probing, and calls the
+ *		    hash and equality functors directly, so they are inlined
+ *		    where the C API goes through function pointers and boxes
+ *		    every member on the heap. The set operations of set.h are
+ *		    provided as free functions in the namespace, named without
+ *		    the set_ prefix (and union as unite, since it is a
+ *		    keyword), which reuse the storage of an argument passed as
+ *		    an rvalue. Sets can be converted to and from C sets, for
+ *		    code that is moving from one API to the other.
+ *
+ * CREATED:	    10/17/2026
+ *
+ * LAST EDITED:	    10/17/2026
+ ***/
+
+#ifndef __ET_SET_HPP__
+#define __ET_SET_HPP__
+
+/******************************************************************************
+ * INCLUDES
+ ***/
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+extern "C" {
+#include "set.h"
+}
+
+namespace et {
+
+/******************************************************************************
+ * TYPE DEFINITIONS
+ ***/
+
+/* Every slot has a tag: 0 if it is empty, otherwise the mixed hash of its
+ * member with the high bit set, which is compared before calling Eq. The
+ * table is at most three quarters full, and removals shift the rest of their
+ * cluster back instead of leaving tombstones. */
+template <class T, class Hash = std::hash<T>, class Eq = std::equal_to<T>,
+	  class Alloc = std::allocator<T>>
+class Set {
+
+  using traits = std::allocator_traits<Alloc>;
+  using tag_allocator = typename traits::template rebind_alloc<std::size_t>;
+  using tag_traits = std::allocator_traits<tag_allocator>;
+
+public:
+
+  using value_type = T;
+  using size_type = std::size_t;
+  using hasher = Hash;
+  using key_equal = Eq;
+  using allocator_type = Alloc;
+
+  class const_iterator {
+
+  public:
+
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T *;
+    using reference = const T &;
+
+    const_iterator() = default;
+    reference operator*() const { return owner->slots[index]; }
+    pointer operator->() const { return &owner->slots[index]; }
+
+    const_iterator & operator++()
+    {
+      index = owner->next(index + 1);
+      return *this;
+    }
+
+    const_iterator operator++(int)
+    {
+      const_iterator old = *this;
+      ++*this;
+      return old;
+    }
+
+    bool operator==(const const_iterator & other) const
+    {
+      return index == other.index;
+    }
+
+    bool operator!=(const const_iterator & other) const
+    {
+      return index != other.index;
+    }
+
+  private:
+
+    friend class Set;
+    const_iterator(const Set * owner, size_type index)
+      : owner(owner), index(index) {}
+
+    const Set * owner = nullptr;
+    size_type index = 0;
+
+  };
+
+  using iterator = const_iterator;
+
+  explicit Set(size_type capacity = 0, const Hash & hash = Hash(),
+	       const Eq & eq = Eq(), const Alloc & alloc = Alloc())
+    : hash(hash), eq(eq), alloc(alloc), tag_alloc(alloc)
+  {
+    reserve(capacity);
+  }
+
+  Set(std::initializer_list<T> init, const Hash & hash = Hash(),
+      const Eq & eq = Eq(), const Alloc & alloc = Alloc())
+    : Set(init.size(), hash, eq, alloc)
+  {
+    for (const T & value : init)
+      insert(value);
+  }
+
+  Set(const Set & other)
+    : hash(other.hash), eq(other.eq),
+      alloc(traits::select_on_container_copy_construction(other.alloc)),
+      tag_alloc(alloc)
+  {
+    reserve(other.count);
+    for (const T & value : other)
+      insert(value);
+  }
+
+  Set(Set && other) noexcept
+    : hash(std::move(other.hash)), eq(std::move(other.eq)),
+      alloc(std::move(other.alloc)), tag_alloc(alloc)
+  {
+    steal(other);
+  }
+
+  Set & operator=(const Set & other)
+  {
+    if (this != &other) {
+      Set copy(other);
+      swap(copy);
+    }
+    return *this;
+  }
+
+  Set & operator=(Set && other) noexcept
+  {
+    if (this != &other) {
+      release();
+      hash = std::move(other.hash);
+      eq = std::move(other.eq);
+      alloc = std::move(other.alloc);
+      tag_alloc = tag_allocator(alloc);
+      steal(other);
+    }
+    return *this;
+  }
+
+  ~Set() { release(); }
+
+  size_type size() const { return count; }
+  bool empty() const { return count == 0; }
+  size_type capacity() const { return tags == nullptr ? 0 : mask + 1; }
+
+  const_iterator begin() const { return const_iterator(this, next(0)); }
+  const_iterator end() const { return const_iterator(this, capacity()); }
+
+  bool contains(const T & value) const
+  {
+    if (count == 0)
+      return false;
+    return tags[find(value, tag_of(value))] != 0;
+  }
+
+  bool insert(const T & value) { return put(value); }
+  bool insert(T && value) { return put(std::move(value)); }
+
+  /****************************************************************************
+   * FUNCTION:	    erase
+   *
+   * DESCRIPTION:   Removes the member equal to `value', if there is one.
+   *
+   * ARGUMENTS:	    value: (const T &) -- the value to remove.
+   *
+   * RETURN:	    bool -- true if a member was removed.
+   *
+   * NOTES:	    O(1) expected.
+   ***/
+  bool erase(const T & value)
+  {
+    if (count == 0)
+      return false;
+    size_type i = find(value, tag_of(value));
+    if (tags[i] == 0)
+      return false;
+
+    remove_at(i);
+    return true;
+  }
+
+  /****************************************************************************
+   * FUNCTION:	    erase_if
+   *
+   * DESCRIPTION:   Removes every member for which `predicate' is true.
+   *
+   * ARGUMENTS:	    predicate: (Predicate) -- called with each member.
+   *
+   * RETURN:	    size_type -- the number of members removed.
+   *
+   * NOTES:	    O(capacity). When a removal shifts a later member back
+   *		    into the current slot, the slot is looked at again.
+   ***/
+  template <class Predicate>
+  size_type erase_if(Predicate predicate)
+  {
+    size_type removed = 0;
+    for (size_type i = 0; i < capacity(); ) {
+      if (tags[i] != 0 && predicate(const_cast<const T &>(slots[i]))) {
+	remove_at(i);
+	removed++;
+      } else {
+	i++;
+      }
+    }
+    return removed;
+  }
+
+  void clear()
+  {
+    for (size_type i = 0; i < capacity(); i++)
+      if (tags[i] != 0) {
+	traits::destroy(alloc, slots + i);
+	tags[i] = 0;
+      }
+    count = 0;
+  }
+
+  /****************************************************************************
+   * FUNCTION:	    reserve
+   *
+   * DESCRIPTION:   Grows the table so that it holds `wanted' members without
+   *		    growing again.
+   *
+   * ARGUMENTS:	    wanted: (size_type) -- the number of members.
+   *
+   * RETURN:	    void.
+   *
+   * NOTES:	    O(n). The members are moved, not copied.
+   ***/
+  void reserve(size_type wanted)
+  {
+    size_type buckets = 8;
+    while (buckets * 3 < wanted * 4)
+      buckets <<= 1;
+    if (wanted == 0 || buckets <= capacity())
+      return;
+
+    std::size_t * old_tags = tags;
+    T * old_slots = slots;
+    size_type old_capacity = capacity();
+
+    tags = tag_traits::allocate(tag_alloc, buckets);
+    try {
+      slots = traits::allocate(alloc, buckets);
+    } catch (...) {
+      tag_traits::deallocate(tag_alloc, tags, buckets);
+      tags = old_tags;
+      throw;
+    }
+    std::fill(tags, tags + buckets, std::size_t(0));
+    mask = buckets - 1;
+
+    for (size_type i = 0; i < old_capacity; i++) {
+      if (old_tags[i] == 0)
+	continue;
+      size_type j = old_tags[i] & mask;
+      while (tags[j] != 0)
+	j = (j + 1) & mask;
+      traits::construct(alloc, slots + j, std::move(old_slots[i]));
+      traits::destroy(alloc, old_slots + i);
+      tags[j] = old_tags[i];
+    }
+
+    if (old_tags != nullptr) {
+      tag_traits::deallocate(tag_alloc, old_tags, old_capacity);
+      traits::deallocate(alloc, old_slots, old_capacity);
+    }
+  }
+
+  void swap(Set & other) noexcept
+  {
+    using std::swap;
+    swap(hash, other.hash);
+    swap(eq, other.eq);
+    swap(alloc, other.alloc);
+    swap(tag_alloc, other.tag_alloc);
+    swap(tags, other.tags);
+    swap(slots, other.slots);
+    swap(mask, other.mask);
+    swap(count, other.count);
+  }
+
+  const Hash & hash_function() const { return hash; }
+  const Eq & key_eq() const { return eq; }
+  Alloc get_allocator() const { return alloc; }
+
+  /****************************************************************************
+   * FUNCTION:	    from_c
+   *
+   * DESCRIPTION:   Copies the members of a C set, which must point to T.
+   *
+   * ARGUMENTS:	    source: (const set *) -- the C set.
+   *
+   * RETURN:	    Set -- the copy.
+   *
+   * NOTES:	    O(n). Works with any engine, since every member is copied
+   *		    as soon as it is returned.
+   ***/
+  static Set from_c(const set * source)
+  {
+    Set result(source == nullptr ? 0 : set_size(source));
+    if (source == nullptr)
+      return result;
+
+    set_iterator iterator;
+    for (void * data = set_begin(source, &iterator); data != nullptr;
+	 data = set_advance(source, &iterator))
+      result.insert(*static_cast<const T *>(data));
+    return result;
+  }
+
+  /****************************************************************************
+   * FUNCTION:	    to_c
+   *
+   * DESCRIPTION:   Copies the members into a new hashed C set, whose members
+   *		    are T allocated with new, and whose functions call a
+   *		    default-constructed Hash and Eq.
+   *
+   * ARGUMENTS:	    none.
+   *
+   * RETURN:	    (set *) -- the C set, which the caller destroys with
+   *		    set_destroy, or NULL.
+   *
+   * NOTES:	    O(n)
+   ***/
+  set * to_c() const
+  {
+    set * result = set_create_hashed(c_match, c_hash, c_copy, c_destroy);
+    if (result == nullptr)
+      return nullptr;
+
+    for (const T & value : *this) {
+      void * data = c_copy(&value);
+      if (data == nullptr || set_insert(result, data) < 0) {
+	c_destroy(data);
+	set_destroy(&result);
+	return nullptr;
+      }
+    }
+    return result;
+  }
+
+private:
+
+  static std::size_t tag_of(const Hash & hash, const T & value)
+  {
+    std::uint64_t h = static_cast<std::uint64_t>(hash(value));
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return static_cast<std::size_t>(h)
+      | std::size_t(1) << (sizeof(std::size_t) * 8 - 1);
+  }
+
+  std::size_t tag_of(const T & value) const { return tag_of(hash, value); }
+
+  size_type next(size_type i) const
+  {
+    while (i < capacity() && tags[i] == 0)
+      i++;
+    return i;
+  }
+
+  /* The slot holding the member equal to `value', or the empty slot that
+   * ends its probe sequence. */
+  size_type find(const T & value, std::size_t tag) const
+  {
+    size_type i = tag & mask;
+    while (tags[i] != 0 && (tags[i] != tag || !eq(slots[i], value)))
+      i = (i + 1) & mask;
+    return i;
+  }
+
+  template <class U>
+  bool put(U && value)
+  {
+    if ((count + 1) * 4 > capacity() * 3)
+      reserve(count + 1);
+    std::size_t tag = tag_of(value);
+    size_type i = find(value, tag);
+    if (tags[i] != 0)
+      return false;
+
+    traits::construct(alloc, slots + i, std::forward<U>(value));
+    tags[i] = tag;
+    count++;
+    return true;
+  }
+
+  void remove_at(size_type i)
+  {
+    traits::destroy(alloc, slots + i);
+    for (size_type j = (i + 1) & mask; tags[j] != 0; j = (j + 1) & mask) {
+      size_type home = tags[j] & mask;
+      if (((j - home) & mask) >= ((j - i) & mask)) {
+	traits::construct(alloc, slots + i, std::move(slots[j]));
+	traits::destroy(alloc, slots + j);
+	tags[i] = tags[j];
+	i = j;
+      }
+    }
+    tags[i] = 0;
+    count--;
+  }
+
+  void steal(Set & other)
+  {
+    tags = other.tags;
+    slots = other.slots;
+    mask = other.mask;
+    count = other.count;
+    other.tags = nullptr;
+    other.slots = nullptr;
+    other.mask = 0;
+    other.count = 0;
+  }
+
+  void release()
+  {
+    if (tags == nullptr)
+      return;
+    clear();
+    tag_traits::deallocate(tag_alloc, tags, mask + 1);
+    traits::deallocate(alloc, slots, mask + 1);
+    tags = nullptr;
+    slots = nullptr;
+    mask = 0;
+  }
+
+  static int c_match(const void * one, const void * two)
+  {
+    return Eq()(*static_cast<const T *>(one), *static_cast<const T *>(two));
+  }
+
+  static unsigned long c_hash(const void * data)
+  {
+    return static_cast<unsigned long>(Hash()(*static_cast<const T *>(data)));
+  }
+
+  static void * c_copy(const void * data)
+  {
+    try {
+      return new T(*static_cast<const T *>(data));
+    } catch (...) {
+      return nullptr;
+    }
+  }
+
+  static void c_destroy(void * data)
+  {
+    delete static_cast<T *>(data);
+  }
+
+  Hash hash;
+  Eq eq;
+  Alloc alloc;
+  tag_allocator tag_alloc;
+
+  std::size_t * tags = nullptr;
+  T * slots = nullptr;
+  size_type mask = 0;
+  size_type count = 0;
+
+};
+
+/******************************************************************************
+ * API FUNCTIONS
+ ***/
+
+/* The set operations take their first argument by value: pass it with
+ * std::move to build the result in its storage instead of a copy. They are
+ * not named as in set.h, whose names are macros. */
+
+template <class T, class H, class E, class A, class... Rest>
+Set<T, H, E, A> unite(Set<T, H, E, A> first, const Rest &... rest)
+{
+  first.reserve(first.size() + (rest.size() + ... + 0));
+  auto add = [&first](const Set<T, H, E, A> & other) {
+    for (const T & value : other)
+      first.insert(value);
+  };
+  (add(rest), ...);
+  return first;
+}
+
+template <class T, class H, class E, class A, class... Rest>
+Set<T, H, E, A> intersection(Set<T, H, E, A> first, const Rest &... rest)
+{
+  first.erase_if([&](const T & value) {
+    return !(rest.contains(value) && ...);
+  });
+  return first;
+}
+
+template <class T, class H, class E, class A>
+Set<T, H, E, A> difference(Set<T, H, E, A> first,
+			       const Set<T, H, E, A> & second)
+{
+  first.erase_if([&](const T & value) { return second.contains(value); });
+  return first;
+}
+
+template <class T, class H, class E, class A>
+bool issubset(const Set<T, H, E, A> & subset,
+		  const Set<T, H, E, A> & masterset)
+{
+  if (subset.size() > masterset.size())
+    return false;
+  for (const T & value : subset)
+    if (!masterset.contains(value))
+      return false;
+  return true;
+}
+
+template <class T, class H, class E, class A, class... Rest>
+bool isequal(const Set<T, H, E, A> & first, const Rest &... rest)
+{
+  return ((rest.size() == first.size() && issubset(first, rest)) && ...);
+}
+
+template <class T, class H, class E, class A>
+bool operator==(const Set<T, H, E, A> & one, const Set<T, H, E, A> & two)
+{
+  return isequal(one, two);
+}
+
+template <class T, class H, class E, class A>
+bool operator!=(const Set<T, H, E, A> & one, const Set<T, H, E, A> & two)
+{
+  return !isequal(one, two);
+}
+
+template <class T, class H, class E, class A>
+void swap(Set<T, H, E, A> & one, Set<T, H, E, A> & two) noexcept
+{
+  one.swap(two);
+}
+
+} /* namespace et */
+
+#endif /* __ET_SET_HPP__ */
+
+/*****************************************************************************/
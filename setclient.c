@@ -0,0 +1,430 @@
+/******************************************************************************
+ * NAME:	    setclient.c
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    Source file containing the client of the set server. A
+ *		    call sends its keys in requests of up to
+ *		    CONFIG_SETCLIENT_BATCH keys, and keeps up to
+ *		    CONFIG_SETCLIENT_WINDOW of them in flight, so that a large
+ *		    batch costs a few round trips instead of one per request.
+ *		    The calls block, and a client must not be used by two
+ *		    threads at once. This code follows the typedefs and
+ *		    prototypes in setserver.h.
+ *
+ * CREATED:	    10/17/2026
+ *
+ * LAST EDITED:	    10/17/2026
+ ***/
+
+/******************************************************************************
+ * INCLUDES
+ ***/
+
+/* For the socket interface. */
+#define _DEFAULT_SOURCE
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "setserver.h"
+
+/******************************************************************************
+ * LOCAL PROTOTYPES
+ ***/
+
+static int transact(setclient *, uint32_t, const char * [], int,
+		    const uint64_t *, size_t, unsigned char *, uint64_t *);
+static int send_all(int, const void *, size_t);
+static int receive_all(int, void *, size_t);
+
+/******************************************************************************
+ * API FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:	    setclient_connect
+ *
+ * DESCRIPTION:	    Connects to a set server.
+ *
+ * ARGUMENTS:	    path: (const char *) -- the path of its socket.
+ *
+ * RETURN:	    (setclient *) -- pointer to the client, or NULL if an error
+ *		    has occurred.
+ *
+ * NOTES:	    O(1)
+ ***/
+setclient * setclient_connect(const char * path)
+{
+  struct sockaddr_un address = {.sun_family = AF_UNIX};
+  if (path == NULL || strlen(path) >= sizeof(address.sun_path))
+    return NULL;
+  strcpy(address.sun_path, path);
+
+  int fd = -1;
+  setclient * client = NULL;
+  if ((fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0)) < 0)
+    return NULL;
+  if (connect(fd, (struct sockaddr *)&address, sizeof(address))
+      || (client = malloc(sizeof(setclient))) == NULL) {
+    close(fd);
+    return NULL;
+  }
+
+  *client = (setclient){.fd = fd, .next = 0};
+  return client;
+}
+
+/******************************************************************************
+ * FUNCTION:	    setclient_close
+ *
+ * DESCRIPTION:	    Closes the connection of a client, and frees it.
+ *
+ * ARGUMENTS:	    client: (setclient **) -- the client to be operated on.
+ *
+ * RETURN:	    void.
+ *
+ * NOTES:	    O(1)
+ ***/
+void setclient_close(setclient ** client)
+{
+  if (client == NULL || *client == NULL)
+    return;
+
+  close((*client)->fd);
+  free(*client);
+  *client = NULL;
+}
+
+/******************************************************************************
+ * FUNCTION:	    setclient_create
+ *
+ * DESCRIPTION:	    Creates an empty set on the server.
+ *
+ * ARGUMENTS:	    client: (setclient *) -- the client to be operated on.
+ *		    name: (const char *) -- the name of the set, of 1 to
+ *			SETSERVER_NAME_MAX bytes.
+ *
+ * RETURN:	    int -- 0 if successful, SETSERVER_EXISTS if the server has
+ *		    a set of that name, or another setserver_status. -1 if the
+ *		    arguments are bad, or the connection has failed.
+ *
+ * NOTES:	    One round trip. The other calls return the same way. A
+ *		    client whose connection has failed must be closed.
+ ***/
+int setclient_create(setclient * client, const char * name)
+{
+  const char * names[] = {name};
+  return transact(client, SETSERVER_CREATE, names, 1, NULL, 0, NULL, NULL);
+}
+
+/******************************************************************************
+ * FUNCTION:	    setclient_drop
+ *
+ * DESCRIPTION:	    Destroys a set on the server.
+ *
+ * ARGUMENTS:	    client: (setclient *) -- the client to be operated on.
+ *		    name: (const char *) -- the name of the set.
+ *
+ * RETURN:	    int -- 0 if successful, SETSERVER_NOSET if there is no set
+ *		    of that name.
+ *
+ * NOTES:	    One round trip.
+ ***/
+int setclient_drop(setclient * client, const char * name)
+{
+  const char * names[] = {name};
+  return transact(client, SETSERVER_DROP, names, 1, NULL, 0, NULL, NULL);
+}
+
+/******************************************************************************
+ * FUNCTION:	    setclient_insert
+ *
+ * DESCRIPTION:	    Inserts a batch of keys into a set on the server.
+ *
+ * ARGUMENTS:	    client: (setclient *) -- the client to be operated on.
+ *		    name: (const char *) -- the name of the set.
+ *		    keys: (const uint64_t *) -- the keys.
+ *		    count: (size_t) -- the number of keys.
+ *		    inserted: (uint64_t *) -- receives the number of keys that
+ *			were not members before, or NULL.
+ *
+ * RETURN:	    int -- 0 if successful, SETSERVER_NOSET if there is no set
+ *		    of that name.
+ *
+ * NOTES:	    O(count), in about count / CONFIG_SETCLIENT_BATCH /
+ *		    CONFIG_SETCLIENT_WINDOW round trips.
+ ***/
+int setclient_insert(setclient * client, const char * name,
+		     const uint64_t * keys, size_t count, uint64_t * inserted)
+{
+  const char * names[] = {name};
+  uint64_t value = 0;
+  int ret = transact(client, SETSERVER_INSERT, names, 1, keys, count, NULL,
+		     &value);
+  if (inserted != NULL)
+    *inserted = value;
+  return ret;
+}
+
+/******************************************************************************
+ * FUNCTION:	    setclient_remove
+ *
+ * DESCRIPTION:	    Removes a batch of keys from a set on the server.
+ *
+ * ARGUMENTS:	    client: (setclient *) -- the client to be operated on.
+ *		    name: (const char *) -- the name of the set.
+ *		    keys: (const uint64_t *) -- the keys.
+ *		    count: (size_t) -- the number of keys.
+ *		    removed: (uint64_t *) -- receives the number of keys that
+ *			were members, or NULL.
+ *
+ * RETURN:	    int -- 0 if successful, SETSERVER_NOSET if there is no set
+ *		    of that name.
+ *
+ * NOTES:	    As setclient_insert.
+ ***/
+int setclient_remove(setclient * client, const char * name,
+		     const uint64_t * keys, size_t count, uint64_t * removed)
+{
+  const char * names[] = {name};
+  uint64_t value = 0;
+  int ret = transact(client, SETSERVER_REMOVE, names, 1, keys, count, NULL,
+		     &value);
+  if (removed != NULL)
+    *removed = value;
+  return ret;
+}
+
+/******************************************************************************
+ * FUNCTION:	    setclient_ismember
+ *
+ * DESCRIPTION:	    Looks up a batch of keys in a set on the server.
+ *
+ * ARGUMENTS:	    client: (setclient *) -- the client to be operated on.
+ *		    name: (const char *) -- the name of the set.
+ *		    keys: (const uint64_t *) -- the keys.
+ *		    count: (size_t) -- the number of keys.
+ *		    members: (unsigned char *) -- receives 1 for each key that
+ *			is a member, and 0 for each that is not.
+ *
+ * RETURN:	    int -- 0 if successful, SETSERVER_NOSET if there is no set
+ *		    of that name.
+ *
+ * NOTES:	    As setclient_insert.
+ ***/
+int setclient_ismember(setclient * client, const char * name,
+		       const uint64_t * keys, size_t count,
+		       unsigned char * members)
+{
+  const char * names[] = {name};
+  if (members == NULL && count > 0)
+    return -1;
+  return transact(client, SETSERVER_ISMEMBER, names, 1, keys, count, members,
+		  NULL);
+}
+
+/******************************************************************************
+ * FUNCTION:	    setclient_size
+ *
+ * DESCRIPTION:	    Takes the size of a set on the server.
+ *
+ * ARGUMENTS:	    client: (setclient *) -- the client to be operated on.
+ *		    name: (const char *) -- the name of the set.
+ *		    size: (uint64_t *) -- receives the size.
+ *
+ * RETURN:	    int -- 0 if successful, SETSERVER_NOSET if there is no set
+ *		    of that name.
+ *
+ * NOTES:	    One round trip.
+ ***/
+int setclient_size(setclient * client, const char * name, uint64_t * size)
+{
+  const char * names[] = {name};
+  if (size == NULL)
+    return -1;
+  *size = 0;
+  return transact(client, SETSERVER_SIZE, names, 1, NULL, 0, NULL, size);
+}
+
+/******************************************************************************
+ * FUNCTION:	    setclient_union
+ *
+ * DESCRIPTION:	    Makes a set on the server the union of two others. The
+ *		    set is created, or replaced if it exists.
+ *
+ * ARGUMENTS:	    client: (setclient *) -- the client to be operated on.
+ *		    dest: (const char *) -- the name of the result.
+ *		    one, two: (const char *) -- the names of the operands,
+ *			which may be the same as `dest'.
+ *
+ * RETURN:	    int -- 0 if successful, SETSERVER_NOSET if an operand does
+ *		    not exist.
+ *
+ * NOTES:	    One round trip. The members do not leave the server.
+ *		    setclient_intersection and setclient_difference work the
+ *		    same way.
+ ***/
+int setclient_union(setclient * client, const char * dest,
+		    const char * one, const char * two)
+{
+  const char * names[] = {dest, one, two};
+  return transact(client, SETSERVER_UNION, names, 3, NULL, 0, NULL, NULL);
+}
+
+int setclient_intersection(setclient * client, const char * dest,
+			   const char * one, const char * two)
+{
+  const char * names[] = {dest, one, two};
+  return transact(client, SETSERVER_INTERSECTION, names, 3, NULL, 0, NULL,
+		  NULL);
+}
+
+int setclient_difference(setclient * client, const char * dest,
+			 const char * one, const char * two)
+{
+  const char * names[] = {dest, one, two};
+  return transact(client, SETSERVER_DIFFERENCE, names, 3, NULL, 0, NULL,
+		  NULL);
+}
+
+/******************************************************************************
+ * LOCAL FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:	    transact
+ *
+ * DESCRIPTION:	    Sends an operation on a batch of keys as a series of
+ *		    requests, and reads their responses as they come, with up
+ *		    to CONFIG_SETCLIENT_WINDOW requests in flight.
+ *
+ * ARGUMENTS:	    client: (setclient *) -- the client to be operated on.
+ *		    op: (uint32_t) -- the operation.
+ *		    names: (const char * []) -- the names of its sets.
+ *		    required: (int) -- the number of names.
+ *		    keys: (const uint64_t *) -- the keys, or NULL.
+ *		    count: (size_t) -- the number of keys.
+ *		    members: (unsigned char *) -- receives the bitmaps of
+ *			SETSERVER_ISMEMBER, a byte for each key, or NULL.
+ *		    value: (uint64_t *) -- receives the sum of the values of
+ *			the responses, or NULL.
+ *
+ * RETURN:	    int -- the first status that is not SETSERVER_OK, or 0. -1
+ *		    if the arguments are bad, or the connection has failed.
+ *
+ * NOTES:	    An operation with no keys is one request.
+ ***/
+static int transact(setclient * client, uint32_t op, const char * names[],
+		    int required, const uint64_t * keys, size_t count,
+		    unsigned char * members, uint64_t * value)
+{
+  size_t prefix = 0, frames = (count + CONFIG_SETCLIENT_BATCH - 1)
+    / CONFIG_SETCLIENT_BATCH;
+  if (client == NULL || (keys == NULL && count > 0))
+    return -1;
+  for (int i = 0; i < required; i++) {
+    size_t length = names[i] != NULL ? strlen(names[i]) : 0;
+    if (length == 0 || length > SETSERVER_NAME_MAX)
+      return -1;
+    prefix += 1 + length;
+  }
+
+  char * frame = NULL;
+  unsigned char bitmap[(CONFIG_SETCLIENT_BATCH + 7) / 8];
+  if ((frame = malloc(sizeof(setserver_request) + prefix
+		      + 8 * CONFIG_SETCLIENT_BATCH)) == NULL)
+    return -1;
+  char * body = frame + sizeof(setserver_request);
+  for (int i = 0; i < required; i++) {
+    size_t length = strlen(names[i]);
+    *body++ = (char)length;
+    memcpy(body, names[i], length);
+    body += length;
+  }
+
+  int status = SETSERVER_OK;
+  uint32_t first = client->next;
+  size_t sent = 0, received = 0;
+  frames = frames ? frames : 1;
+  while (received < frames && status >= 0) {
+    while (sent < frames && sent - received < CONFIG_SETCLIENT_WINDOW) {
+      size_t start = sent * CONFIG_SETCLIENT_BATCH;
+      size_t batch = count - start < CONFIG_SETCLIENT_BATCH
+	? count - start : CONFIG_SETCLIENT_BATCH;
+      setserver_request request = {.length = prefix + 8 * batch,
+				   .id = client->next++, .op = op,
+				   .count = batch};
+      memcpy(frame, &request, sizeof(request));
+      if (batch > 0)
+	memcpy(body, keys + start, 8 * batch);
+      if (send_all(client->fd, frame, sizeof(request) + request.length)) {
+	status = -1;
+	break;
+      }
+      sent++;
+    }
+    if (status < 0)
+      break;
+
+    setserver_response response;
+    size_t start = received * CONFIG_SETCLIENT_BATCH;
+    if (receive_all(client->fd, &response, sizeof(response))
+	|| response.id != first + (uint32_t)received
+	|| response.length > sizeof(bitmap)
+	|| receive_all(client->fd, bitmap, response.length)) {
+      status = -1;
+      break;
+    }
+
+    for (size_t i = 0; members != NULL && i < 8 * response.length
+	   && start + i < count; i++)
+      members[start + i] = (bitmap[i / 8] >> (i % 8)) & 1;
+    if (value != NULL)
+      *value += response.value;
+    if (status == SETSERVER_OK)
+      status = (int)response.status;
+    received++;
+  }
+
+  free(frame);
+  return status;
+}
+
+/* Writes all of a buffer to a socket. */
+static int send_all(int fd, const void * buffer, size_t length)
+{
+  const char * next = buffer;
+  while (length > 0) {
+    ssize_t count = send(fd, next, length, MSG_NOSIGNAL);
+    if (count < 0 && errno == EINTR)
+      continue;
+    if (count <= 0)
+      return -1;
+    next += count;
+    length -= count;
+  }
+  return 0;
+}
+
+/* Reads all of a buffer from a socket. */
+static int receive_all(int fd, void * buffer, size_t length)
+{
+  char * next = buffer;
+  while (length > 0) {
+    ssize_t count = recv(fd, next, length, 0);
+    if (count < 0 && errno == EINTR)
+      continue;
+    if (count <= 0)
+      return -1;
+    next += count;
+    length -= count;
+  }
+  return 0;
+}
+
+/*****************************************************************************/
@@ -0,0 +1,89 @@
+/******************************************************************************
+ * NAME:	    setd.c
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    The set server daemon. Hosts named sets on a Unix domain
+ *		    socket, for the clients of setserver.h, until it receives
+ *		    SIGINT or SIGTERM.
+ *
+ *		    Usage: setd [-t threads] socket
+ *
+ * CREATED:	    10/17/2026
+ *
+ * LAST EDITED:	    10/17/2026
+ ***/
+
+/******************************************************************************
+ * INCLUDES
+ ***/
+
+/* For sigaction and getopt. */
+#define _POSIX_C_SOURCE 200809L
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "setserver.h"
+
+/******************************************************************************
+ * LOCAL PROTOTYPES
+ ***/
+
+static void stop(int);
+
+/******************************************************************************
+ * STATIC VARIABLES
+ ***/
+
+static setserver * server = NULL;
+
+/******************************************************************************
+ * MAIN
+ ***/
+
+int main(int argc, char * argv[])
+{
+  int threads = 0, option = 0;
+  while ((option = getopt(argc, argv, "t:")) != -1) {
+    if (option != 't' || (threads = atoi(optarg)) <= 0) {
+      fprintf(stderr, "Usage: %s [-t threads] socket\n", argv[0]);
+      return 1;
+    }
+  }
+  if (optind != argc - 1) {
+    fprintf(stderr, "Usage: %s [-t threads] socket\n", argv[0]);
+    return 1;
+  }
+
+  if ((server = setserver_create(argv[optind], threads)) == NULL) {
+    fprintf(stderr, "%s: could not listen on %s\n", argv[0], argv[optind]);
+    return 1;
+  }
+
+  struct sigaction action;
+  memset(&action, 0, sizeof(action));
+  action.sa_handler = stop;
+  sigemptyset(&action.sa_mask);
+  sigaction(SIGINT, &action, NULL);
+  sigaction(SIGTERM, &action, NULL);
+
+  int status = setserver_run(server);
+  setserver_destroy(&server);
+  return status ? 1 : 0;
+}
+
+/******************************************************************************
+ * LOCAL FUNCTIONS
+ ***/
+
+/* Stops the server, from a signal handler. */
+static void stop(int signal)
+{
+  setserver_stop(server);
+}
+
+/*****************************************************************************/
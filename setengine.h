@@ -0,0 +1,114 @@
+/******************************************************************************
+ * NAME:	    setengine.h
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    The interface between the set API in set.c and the storage
+ *		    engines that hold the members of a set. Every set points
+ *		    to one engine, which implements the primitive operations;
+ *		    the set operations in set.c are written in terms of them.
+ *		    This header is internal to the library.
+ *
+ * CREATED:	    10/17/2026
+ *
+ * LAST EDITED:	    10/17/2026
+ ***/
+
+#ifndef __ET_SETENGINE_H__
+#define __ET_SETENGINE_H__
+
+#include <stdint.h>
+
+#include "set.h"
+
+/******************************************************************************
+ * TYPE DEFINITIONS
+ ***/
+
+/* The engine is responsible for keeping set->size up to date. None of the
+ * functions are called with a NULL set or NULL data.
+ *
+ *	ismember: returns 1 if a member matches the data, 0 otherwise.
+ *	insert: returns 0 if the data was inserted, 1 if a matching member
+ *		exists (and the data was not inserted), -1 on error.
+ *	remove: removes the matching member and returns its data, without
+ *		destroying it, or returns NULL if there is none.
+ *	begin, advance: iterate over the members, returning NULL at the end.
+ *		The set must not be modified during iteration.
+ *	clear: removes and destroys every member, and releases the storage.
+ *	like: optional. Prepares the storage of an empty set, made with the
+ *		same functions and engine as the model, for the set operations.
+ *		Returns 0 if successful, -1 otherwise.
+ *	combine: optional. Places in the empty set, made by like, every
+ *		member of at least k of the sets, the first of which is held
+ *		by this engine. Called by set_threshold_func (and so by
+ *		set_union and set_intersection) in place of its counting
+ *		pass. Returns 0 if successful, -1 otherwise.
+ *
+ * An engine that is byvalue stores a copy of the bytes of each member rather
+ * than the pointer it was given. set_insert destroys the data once it has
+ * been stored, set_remove does not destroy the data returned by remove, and
+ * the data returned by begin, advance and remove are only valid until the
+ * next call to the engine.
+ */
+typedef struct _set_engine_ {
+
+  const char * name;
+
+  int (*ismember)(const set *, const void *);
+  int (*insert)(set *, void *);
+  void * (*remove)(set *, const void *);
+  void * (*begin)(const set *, set_iterator *);
+  void * (*advance)(const set *, set_iterator *);
+  void (*clear)(set *);
+  int (*like)(set *, const set *);
+  int (*combine)(set *, int, set * []);
+
+  int byvalue;
+
+} set_engine;
+
+/******************************************************************************
+ * MACRO DEFINITIONS
+ ***/
+
+/* A set of interned handles (set_create_interned) has neither a match nor a
+ * hash function: its members are canonical pointers, so they are equal only
+ * if they are the same pointer, and the pointer is the hash. Engines compare
+ * and hash members with these macros instead of calling the functions. The
+ * sorted engine (sortedset.h) is the exception: its match is a three-way
+ * comparison, which only the engine calls. */
+#define set_isinterned(group) ((group)->match == NULL)
+#define set_matches(group, one, two)					\
+  (set_isinterned(group) ? (one) == (two) : (group)->match(one, two) == 1)
+#define set_hashof(group, data)						\
+  (set_isinterned(group) ? (unsigned long)(uintptr_t)(data)		\
+   : (group)->hash(data))
+
+/******************************************************************************
+ * ENGINES
+ ***/
+
+extern const set_engine set_list_engine;
+extern const set_engine set_hashed_engine;
+extern const set_engine set_disk_engine;
+extern const set_engine set_sorted_engine;
+extern const set_engine set_adaptive_engine;
+extern const set_engine set_radix_engine;
+extern const set_engine set_compact_engine;
+extern const set_engine set_robin_engine;
+extern const set_engine set_shared_engine;
+
+/******************************************************************************
+ * API FUNCTION PROTOTYPES
+ ***/
+
+extern set * set_create_engine(const set_engine * engine,
+			       int (*match)(const void *, const void *),
+			       unsigned long (*hash)(const void *),
+			       void * (*copy)(const void *),
+			       void (*destroy)(void *));
+
+#endif /* __ET_SETENGINE_H__ */
+
+/*****************************************************************************/
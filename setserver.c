@@ -0,0 +1,871 @@
+/******************************************************************************
+ * NAME:	    setserver.c
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    Source file containing the set server. Every socket of a
+ *		    server is registered with one epoll instance, which all of
+ *		    its threads wait on. Connections are registered one-shot,
+ *		    so a connection is served by one thread at a time, which
+ *		    reads what it can, answers every whole request in its
+ *		    buffer, writes what it can, and registers it again. The
+ *		    named sets are hashed sets of keys, kept in a hash table
+ *		    under a read-write lock; each set has a read-write lock of
+ *		    its own, so requests on different sets, and lookups on the
+ *		    same set, run in parallel. This code follows the typedefs
+ *		    and prototypes in setserver.h.
+ *
+ * CREATED:	    10/17/2026
+ *
+ * LAST EDITED:	    10/17/2026
+ ***/
+
+/******************************************************************************
+ * INCLUDES
+ ***/
+
+/* For the socket and epoll interfaces, and strdup. */
+#define _DEFAULT_SOURCE
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "set.h"
+#include "stringset.h"
+#include "setserver.h"
+
+/******************************************************************************
+ * TYPE DEFINITIONS
+ ***/
+
+/* A named set. The table of sets holds a pointer to each. */
+typedef struct {
+
+  char * name;
+  set * group;
+  pthread_rwlock_t lock;
+
+} serverset;
+
+/* A client connection: the requests read but not yet answered, and the
+ * responses not yet written, from `sent' on. */
+typedef struct _setserver_connection_ {
+
+  int fd;
+  int eof;
+
+  char * in;
+  size_t inlength;
+  size_t incapacity;
+
+  char * out;
+  size_t outlength;
+  size_t sent;
+  size_t outcapacity;
+
+  struct _setserver_connection_ * prev;
+  struct _setserver_connection_ * next;
+
+} connection;
+
+/******************************************************************************
+ * LOCAL PROTOTYPES
+ ***/
+
+static int match_key(const void *, const void *);
+static unsigned long hash_key(const void *);
+static void * copy_key(const void *);
+static int match_name(const void *, const void *);
+static unsigned long hash_name(const void *);
+static serverset * make_set(const char *, set *);
+static void free_set(void *);
+static serverset * lookup(const setserver *, const char *);
+static int open_listener(const char *);
+static int watch(int, int, void *, uint32_t);
+static void * work(void *);
+static void accept_all(setserver *);
+static int serve(setserver *, connection *);
+static void close_connection(setserver *, connection *);
+static int reserve(char **, size_t *, size_t);
+static int process(setserver *, connection *);
+static int execute(setserver *, connection *, const setserver_request *,
+		   const char *);
+static const char * parse_names(const char *, const char *, int,
+				char [][SETSERVER_NAME_MAX + 1]);
+static setserver_status change(setserver *, uint32_t, const char *,
+			       const char *, uint32_t, uint64_t *);
+static setserver_status check(setserver *, const char *, const char *,
+			      uint32_t, unsigned char *, uint64_t *);
+static setserver_status combine(setserver *, uint32_t,
+				char [][SETSERVER_NAME_MAX + 1], uint64_t *);
+
+/******************************************************************************
+ * API FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:	    setserver_create
+ *
+ * DESCRIPTION:	    Creates a server, listening on a Unix domain socket.
+ *
+ * ARGUMENTS:	    path: (const char *) -- the path of the socket. A socket
+ *			left there by a server that has exited is replaced.
+ *		    threads: (int) -- the threads that setserver_run serves
+ *			with, or 0 for CONFIG_SETSERVER_THREADS.
+ *
+ * RETURN:	    (setserver *) -- pointer to the server, or NULL if an error
+ *		    has occurred, as when another server listens on `path'.
+ *
+ * NOTES:	    O(1). The server has no sets until a client creates them.
+ ***/
+setserver * setserver_create(const char * path, int threads)
+{
+  if (path == NULL || threads < 0)
+    return NULL;
+
+  setserver * server = NULL;
+  if ((server = malloc(sizeof(setserver))) == NULL)
+    return NULL;
+  *server = (setserver){.path = NULL, .listener = -1, .epoll = -1,
+			.wakeup = -1,
+			.threads = threads ? threads : CONFIG_SETSERVER_THREADS};
+  if (hashtable_init(&server->sets, 0, hash_name, match_name)) {
+    free(server);
+    return NULL;
+  }
+  pthread_rwlock_init(&server->lock, NULL);
+  pthread_mutex_init(&server->guard, NULL);
+
+  if ((server->path = strdup(path)) == NULL
+      || (server->listener = open_listener(path)) < 0
+      || (server->epoll = epoll_create1(EPOLL_CLOEXEC)) < 0
+      || (server->wakeup = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)) < 0
+      || watch(server->epoll, server->listener, server, EPOLLIN)
+      || watch(server->epoll, server->wakeup, &server->wakeup, EPOLLIN)) {
+    setserver_destroy(&server);
+    return NULL;
+  }
+
+  return server;
+}
+
+/******************************************************************************
+ * FUNCTION:	    setserver_run
+ *
+ * DESCRIPTION:	    Serves clients on the threads of the server, until
+ *		    setserver_stop is called.
+ *
+ * ARGUMENTS:	    server: (setserver *) -- the server to be operated on.
+ *
+ * RETURN:	    int -- 0 once the server has stopped, -1 if it could not
+ *		    start.
+ *
+ * NOTES:	    The calling thread is one of the threads of the server.
+ *		    The connections still open when it stops are closed.
+ ***/
+int setserver_run(setserver * server)
+{
+  if (server == NULL)
+    return -1;
+
+  pthread_t * threads = NULL;
+  if ((threads = malloc(server->threads * sizeof(pthread_t))) == NULL)
+    return -1;
+  int started = 1;
+  for (; started < server->threads; started++)
+    if (pthread_create(&threads[started], NULL, work, server))
+      break;
+
+  work(server);
+  for (int i = 1; i < started; i++)
+    pthread_join(threads[i], NULL);
+  free(threads);
+
+  while (server->connections != NULL)
+    close_connection(server, server->connections);
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    setserver_stop
+ *
+ * DESCRIPTION:	    Stops a server: its threads return as soon as they are
+ *		    done with the requests at hand.
+ *
+ * ARGUMENTS:	    server: (setserver *) -- the server to be operated on.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    Safe to call from a signal handler.
+ ***/
+int setserver_stop(setserver * server)
+{
+  uint64_t one = 1;
+  if (server == NULL
+      || write(server->wakeup, &one, sizeof(one)) != sizeof(one))
+    return -1;
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    setserver_destroy
+ *
+ * DESCRIPTION:	    Destroys a server that is not running, with its sets, and
+ *		    removes its socket.
+ *
+ * ARGUMENTS:	    server: (setserver **) -- the server to be operated on.
+ *
+ * RETURN:	    void.
+ *
+ * NOTES:	    O(n)
+ ***/
+void setserver_destroy(setserver ** server)
+{
+  if (server == NULL || *server == NULL)
+    return;
+
+  setserver * doomed = *server;
+  if (doomed->listener >= 0) {
+    close(doomed->listener);
+    unlink(doomed->path);
+  }
+  if (doomed->epoll >= 0)
+    close(doomed->epoll);
+  if (doomed->wakeup >= 0)
+    close(doomed->wakeup);
+  hashtable_fini(&doomed->sets, free_set);
+  pthread_rwlock_destroy(&doomed->lock);
+  pthread_mutex_destroy(&doomed->guard);
+  free(doomed->path);
+  free(doomed);
+  *server = NULL;
+}
+
+/******************************************************************************
+ * LOCAL FUNCTIONS
+ ***/
+
+/* The members of the named sets are 64-bit keys. */
+static int match_key(const void * one, const void * two)
+{
+  return *((const uint64_t *)one) == *((const uint64_t *)two);
+}
+
+/* Mixes the key, since keys are often small or sequential integers. */
+static unsigned long hash_key(const void * key)
+{
+  uint64_t h = *((const uint64_t *)key);
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  return (unsigned long)h;
+}
+
+static void * copy_key(const void * key)
+{
+  uint64_t * copy = NULL;
+  if ((copy = malloc(sizeof(uint64_t))) == NULL)
+    return NULL;
+  *copy = *((const uint64_t *)key);
+  return copy;
+}
+
+/* The table of sets matches and hashes them by name. */
+static int match_name(const void * one, const void * two)
+{
+  return !strcmp(((const serverset *)one)->name,
+		 ((const serverset *)two)->name);
+}
+
+static unsigned long hash_name(const void * entry)
+{
+  const char * name = ((const serverset *)entry)->name;
+  return stringset_hash(name, strlen(name));
+}
+
+/* Makes a named set, holding `group', or a new empty set if it is NULL. */
+static serverset * make_set(const char * name, set * group)
+{
+  serverset * entry = NULL;
+  if ((entry = malloc(sizeof(serverset))) == NULL)
+    return NULL;
+  *entry = (serverset){.name = strdup(name), .group = group};
+  if (entry->group == NULL)
+    entry->group = set_create_hashed(match_key, hash_key, copy_key, free);
+  if (entry->name == NULL || entry->group == NULL) {
+    free(entry->name);
+    free(entry);
+    return NULL;
+  }
+
+  pthread_rwlock_init(&entry->lock, NULL);
+  return entry;
+}
+
+static void free_set(void * data)
+{
+  serverset * entry = data;
+  set_destroy(&entry->group);
+  pthread_rwlock_destroy(&entry->lock);
+  free(entry->name);
+  free(entry);
+}
+
+/* Finds a named set, with the lock on the table held. */
+static serverset * lookup(const setserver * server, const char * name)
+{
+  serverset probe = {.name = (char *)name};
+  bucket * entry = hashtable_lookup(&server->sets, &probe);
+  return entry != NULL ? entry->data : NULL;
+}
+
+/******************************************************************************
+ * FUNCTION:	    open_listener
+ *
+ * DESCRIPTION:	    Binds a listening, non-blocking socket to a path.
+ *
+ * ARGUMENTS:	    path: (const char *) -- the path of the socket.
+ *
+ * RETURN:	    int -- the socket, or -1 if an error has occurred.
+ *
+ * NOTES:	    If the path is taken, and nothing answers a connection to
+ *		    it, it is the socket of a server that has exited, and it
+ *		    is removed.
+ ***/
+static int open_listener(const char * path)
+{
+  struct sockaddr_un address = {.sun_family = AF_UNIX};
+  if (strlen(path) >= sizeof(address.sun_path))
+    return -1;
+  strcpy(address.sun_path, path);
+
+  int fd = -1;
+  if ((fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0))
+      < 0)
+    return -1;
+  if (bind(fd, (struct sockaddr *)&address, sizeof(address))
+      && errno == EADDRINUSE) {
+    int probe = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (probe >= 0
+	&& connect(probe, (struct sockaddr *)&address, sizeof(address))
+	&& errno == ECONNREFUSED)
+      unlink(path);
+    if (probe >= 0)
+      close(probe);
+    if (bind(fd, (struct sockaddr *)&address, sizeof(address))) {
+      close(fd);
+      return -1;
+    }
+  }
+
+  if (listen(fd, SOMAXCONN)) {
+    close(fd);
+    unlink(path);
+    return -1;
+  }
+  return fd;
+}
+
+/* Registers a descriptor with an epoll instance, or registers it again. */
+static int watch(int epoll, int fd, void * data, uint32_t events)
+{
+  struct epoll_event event = {.events = events, .data.ptr = data};
+  if (epoll_ctl(epoll, EPOLL_CTL_MOD, fd, &event)
+      && epoll_ctl(epoll, EPOLL_CTL_ADD, fd, &event))
+    return -1;
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    work
+ *
+ * DESCRIPTION:	    The loop of a thread of the server.
+ *
+ * ARGUMENTS:	    arg: (void *) -- the server.
+ *
+ * RETURN:	    void * -- NULL.
+ *
+ * NOTES:	    A thread takes one event per wait, so that the ready
+ *		    connections are spread over all of the threads. The
+ *		    listener and the eventfd are level-triggered: every
+ *		    thread sees the eventfd once it is written.
+ ***/
+static void * work(void * arg)
+{
+  setserver * server = arg;
+  struct epoll_event event;
+  for (;;) {
+    int ready = epoll_wait(server->epoll, &event, 1, -1);
+    if (ready < 0 && errno != EINTR)
+      break;
+    if (ready <= 0)
+      continue;
+
+    if (event.data.ptr == &server->wakeup)
+      break;
+    if (event.data.ptr == server) {
+      accept_all(server);
+      continue;
+    }
+
+    connection * client = event.data.ptr;
+    if (serve(server, client))
+      close_connection(server, client);
+  }
+
+  return NULL;
+}
+
+/* Accepts every pending connection. */
+static void accept_all(setserver * server)
+{
+  int fd = -1;
+  while ((fd = accept(server->listener, NULL, NULL)) >= 0) {
+    connection * client = NULL;
+    if (fcntl(fd, F_SETFL, O_NONBLOCK)
+	|| (client = calloc(1, sizeof(connection))) == NULL) {
+      close(fd);
+      continue;
+    }
+
+    client->fd = fd;
+    pthread_mutex_lock(&server->guard);
+    if ((client->next = server->connections) != NULL)
+      client->next->prev = client;
+    server->connections = client;
+    pthread_mutex_unlock(&server->guard);
+    if (watch(server->epoll, fd, client, EPOLLIN | EPOLLONESHOT))
+      close_connection(server, client);
+  }
+}
+
+/******************************************************************************
+ * FUNCTION:	    serve
+ *
+ * DESCRIPTION:	    Serves a connection that is ready: alternately answers the
+ *		    requests in its buffer, writes the responses and reads
+ *		    more requests, until it would block.
+ *
+ * ARGUMENTS:	    server: (setserver *) -- the server.
+ *		    client: (connection *) -- the connection.
+ *
+ * RETURN:	    int -- 0 if the connection has been registered again, -1
+ *		    if it should be closed.
+ *
+ * NOTES:	    Once the responses waiting to be written reach
+ *		    CONFIG_SETSERVER_BACKLOG, the server stops reading until
+ *		    the client has read some of them. A client that has shut
+ *		    its side down still gets the responses to its requests.
+ ***/
+static int serve(setserver * server, connection * client)
+{
+  for (;;) {
+    if (process(server, client))
+      return -1;
+
+    while (client->sent < client->outlength) {
+      ssize_t count = send(client->fd, client->out + client->sent,
+			   client->outlength - client->sent, MSG_NOSIGNAL);
+      if (count < 0 && errno == EINTR)
+	continue;
+      if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+	break;
+      if (count < 0)
+	return -1;
+      client->sent += count;
+    }
+    if (client->sent == client->outlength)
+      client->sent = client->outlength = 0;
+
+    if (client->eof || client->outlength - client->sent
+	>= CONFIG_SETSERVER_BACKLOG)
+      break;
+
+    if (reserve(&client->in, &client->incapacity, client->inlength + 65536))
+      return -1;
+    ssize_t count = recv(client->fd, client->in + client->inlength,
+			 client->incapacity - client->inlength, 0);
+    if (count < 0 && errno == EINTR)
+      continue;
+    if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+      break;
+    if (count < 0)
+      return -1;
+    if (count == 0)
+      client->eof = 1;
+    client->inlength += count;
+  }
+
+  int waiting = client->sent < client->outlength;
+  if (client->eof && !waiting)
+    return -1;
+  uint32_t events = EPOLLONESHOT | (waiting ? EPOLLOUT : 0);
+  if (!client->eof && client->outlength - client->sent
+      < CONFIG_SETSERVER_BACKLOG)
+    events |= EPOLLIN;
+  return watch(server->epoll, client->fd, client, events);
+}
+
+/* Closes a connection, and forgets it. */
+static void close_connection(setserver * server, connection * client)
+{
+  pthread_mutex_lock(&server->guard);
+  if (client->prev != NULL)
+    client->prev->next = client->next;
+  else
+    server->connections = client->next;
+  if (client->next != NULL)
+    client->next->prev = client->prev;
+  pthread_mutex_unlock(&server->guard);
+
+  close(client->fd);
+  free(client->in);
+  free(client->out);
+  free(client);
+}
+
+/* Makes room for `needed' bytes in a buffer, doubling it. */
+static int reserve(char ** buffer, size_t * capacity, size_t needed)
+{
+  if (needed <= *capacity)
+    return 0;
+
+  size_t length = *capacity ? *capacity : 4096;
+  while (length < needed)
+    length *= 2;
+  char * grown = NULL;
+  if ((grown = realloc(*buffer, length)) == NULL)
+    return -1;
+
+  *buffer = grown;
+  *capacity = length;
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    process
+ *
+ * DESCRIPTION:	    Answers the whole requests in the buffer of a connection,
+ *		    in order, and moves what is left of it to the front.
+ *
+ * ARGUMENTS:	    server: (setserver *) -- the server.
+ *		    client: (connection *) -- the connection.
+ *
+ * RETURN:	    int -- 0 if successful, -1 if the connection should be
+ *		    closed, as when a request is longer than
+ *		    CONFIG_SETSERVER_FRAME.
+ *
+ * NOTES:	    Stops early when the backlog of responses is full.
+ ***/
+static int process(setserver * server, connection * client)
+{
+  size_t offset = 0;
+  while (client->inlength - offset >= sizeof(setserver_request)
+	 && client->outlength - client->sent < CONFIG_SETSERVER_BACKLOG) {
+    setserver_request request;
+    memcpy(&request, client->in + offset, sizeof(request));
+    if (request.length > CONFIG_SETSERVER_FRAME)
+      return -1;
+    if (client->inlength - offset < sizeof(request) + request.length)
+      break;
+
+    if (execute(server, client, &request,
+		client->in + offset + sizeof(request)))
+      return -1;
+    offset += sizeof(request) + request.length;
+  }
+
+  if (offset > 0)
+    memmove(client->in, client->in + offset, client->inlength - offset);
+  client->inlength -= offset;
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    execute
+ *
+ * DESCRIPTION:	    Answers one request, appending the response to the
+ *		    output of the connection.
+ *
+ * ARGUMENTS:	    server: (setserver *) -- the server.
+ *		    client: (connection *) -- the connection.
+ *		    request: (const setserver_request *) -- the header.
+ *		    body: (const char *) -- the body, request->length bytes.
+ *
+ * RETURN:	    int -- 0 if successful, -1 if there is no memory for the
+ *		    response.
+ *
+ * NOTES:	    A request that is malformed is answered with
+ *		    SETSERVER_BADREQUEST.
+ ***/
+static int execute(setserver * server, connection * client,
+		   const setserver_request * request, const char * body)
+{
+  char names[3][SETSERVER_NAME_MAX + 1];
+  int required = request->op >= SETSERVER_UNION ? 3 : 1;
+  const char * end = body + request->length, * keys = NULL;
+  if (request->op < SETSERVER_CREATE || request->op > SETSERVER_DIFFERENCE
+      || (keys = parse_names(body, end, required, names)) == NULL
+      || (uint64_t)(end - keys) != (uint64_t)request->count * 8)
+    keys = NULL;
+
+  size_t bitmap = request->op == SETSERVER_ISMEMBER && keys != NULL
+    ? (request->count + 7) / 8 : 0;
+  size_t start = client->outlength;
+  if (reserve(&client->out, &client->outcapacity,
+	      start + sizeof(setserver_response) + bitmap))
+    return -1;
+  unsigned char * bits = (unsigned char *)client->out + start
+    + sizeof(setserver_response);
+  memset(bits, 0, bitmap);
+
+  setserver_response response = {.length = bitmap, .id = request->id,
+				 .status = SETSERVER_BADREQUEST};
+  serverset * entry = NULL;
+  if (keys != NULL) {
+    switch (request->op) {
+    case SETSERVER_CREATE:
+      pthread_rwlock_wrlock(&server->lock);
+      response.status = SETSERVER_EXISTS;
+      if (lookup(server, names[0]) == NULL) {
+	int inserted = 0;
+	response.status = (entry = make_set(names[0], NULL)) != NULL
+	  && hashtable_insert(&server->sets, entry, &inserted) != NULL
+	  ? SETSERVER_OK : SETSERVER_NOMEMORY;
+	if (response.status != SETSERVER_OK && entry != NULL)
+	  free_set(entry);
+      }
+      pthread_rwlock_unlock(&server->lock);
+      break;
+
+    case SETSERVER_DROP:
+      pthread_rwlock_wrlock(&server->lock);
+      serverset probe = {.name = names[0]};
+      response.status = SETSERVER_NOSET;
+      if ((entry = hashtable_remove(&server->sets, &probe)) != NULL) {
+	free_set(entry);
+	response.status = SETSERVER_OK;
+      }
+      pthread_rwlock_unlock(&server->lock);
+      break;
+
+    case SETSERVER_INSERT:
+    case SETSERVER_REMOVE:
+      response.status = change(server, request->op, names[0], keys,
+			       request->count, &response.value);
+      break;
+
+    case SETSERVER_ISMEMBER:
+    case SETSERVER_SIZE:
+      response.status = check(server, names[0], keys, request->count,
+			      request->op == SETSERVER_ISMEMBER ? bits : NULL,
+			      &response.value);
+      break;
+
+    default:
+      response.status = combine(server, request->op, names, &response.value);
+      break;
+    }
+  }
+
+  memcpy(client->out + start, &response, sizeof(response));
+  client->outlength = start + sizeof(response) + bitmap;
+  return 0;
+}
+
+/* Reads `count' names off the front of a body into `names'. Returns the
+ * rest of the body, or NULL if a name is empty or runs past the end. */
+static const char * parse_names(const char * body, const char * end,
+				int count, char names[][SETSERVER_NAME_MAX + 1])
+{
+  for (int i = 0; i < count; i++) {
+    size_t length = 0;
+    if (body >= end || (length = (unsigned char)*body++) == 0
+	|| (size_t)(end - body) < length)
+      return NULL;
+    memcpy(names[i], body, length);
+    names[i][length] = '\0';
+    body += length;
+  }
+
+  return body;
+}
+
+/******************************************************************************
+ * FUNCTION:	    change
+ *
+ * DESCRIPTION:	    Inserts or removes a batch of keys, under the lock on the
+ *		    set for writing.
+ *
+ * ARGUMENTS:	    server: (setserver *) -- the server.
+ *		    op: (uint32_t) -- SETSERVER_INSERT or SETSERVER_REMOVE.
+ *		    name: (const char *) -- the name of the set.
+ *		    keys: (const char *) -- the keys, unaligned.
+ *		    count: (uint32_t) -- the number of keys.
+ *		    value: (uint64_t *) -- receives the number of keys that
+ *			were inserted, or removed.
+ *
+ * RETURN:	    setserver_status -- the status of the response.
+ *
+ * NOTES:	    O(count) expected. The keys before a failed insertion stay
+ *		    in the set.
+ ***/
+static setserver_status change(setserver * server, uint32_t op,
+			       const char * name, const char * keys,
+			       uint32_t count, uint64_t * value)
+{
+  setserver_status status = SETSERVER_OK;
+  serverset * entry = NULL;
+  pthread_rwlock_rdlock(&server->lock);
+  if ((entry = lookup(server, name)) == NULL) {
+    pthread_rwlock_unlock(&server->lock);
+    return SETSERVER_NOSET;
+  }
+
+  pthread_rwlock_wrlock(&entry->lock);
+  for (uint32_t i = 0; i < count && status == SETSERVER_OK; i++) {
+    uint64_t key;
+    memcpy(&key, keys + 8 * i, sizeof(key));
+    if (op == SETSERVER_REMOVE) {
+      const void * data = &key;
+      *value += !set_remove(entry->group, &data);
+      continue;
+    }
+
+    uint64_t * copy = NULL;
+    int ret = -1;
+    if ((copy = copy_key(&key)) == NULL
+	|| (ret = set_insert(entry->group, copy)) != 0)
+      free(copy);
+    if (ret < 0)
+      status = SETSERVER_NOMEMORY;
+    *value += ret == 0;
+  }
+  pthread_rwlock_unlock(&entry->lock);
+  pthread_rwlock_unlock(&server->lock);
+  return status;
+}
+
+/******************************************************************************
+ * FUNCTION:	    check
+ *
+ * DESCRIPTION:	    Looks up a batch of keys, or takes the size of a set,
+ *		    under the lock on the set for reading.
+ *
+ * ARGUMENTS:	    server: (setserver *) -- the server.
+ *		    name: (const char *) -- the name of the set.
+ *		    keys: (const char *) -- the keys, unaligned.
+ *		    count: (uint32_t) -- the number of keys.
+ *		    bits: (unsigned char *) -- receives a bit for each key
+ *			that is a member, or NULL to take the size.
+ *		    value: (uint64_t *) -- receives the number of members
+ *			found, or the size.
+ *
+ * RETURN:	    setserver_status -- the status of the response.
+ *
+ * NOTES:	    O(count) expected.
+ ***/
+static setserver_status check(setserver * server, const char * name,
+			      const char * keys, uint32_t count,
+			      unsigned char * bits, uint64_t * value)
+{
+  serverset * entry = NULL;
+  pthread_rwlock_rdlock(&server->lock);
+  if ((entry = lookup(server, name)) == NULL) {
+    pthread_rwlock_unlock(&server->lock);
+    return SETSERVER_NOSET;
+  }
+
+  pthread_rwlock_rdlock(&entry->lock);
+  if (bits == NULL)
+    *value = set_size(entry->group);
+  for (uint32_t i = 0; bits != NULL && i < count; i++) {
+    uint64_t key;
+    memcpy(&key, keys + 8 * i, sizeof(key));
+    if (set_ismember(entry->group, &key) == 1) {
+      bits[i / 8] |= 1 << (i % 8);
+      (*value)++;
+    }
+  }
+  pthread_rwlock_unlock(&entry->lock);
+  pthread_rwlock_unlock(&server->lock);
+  return SETSERVER_OK;
+}
+
+/******************************************************************************
+ * FUNCTION:	    combine
+ *
+ * DESCRIPTION:	    Computes the union, intersection or difference of two
+ *		    named sets, and gives the result a name.
+ *
+ * ARGUMENTS:	    server: (setserver *) -- the server.
+ *		    op: (uint32_t) -- the set operation.
+ *		    names: (char [][]) -- the names of the result and of the
+ *			two operands.
+ *		    value: (uint64_t *) -- receives the size of the result.
+ *
+ * RETURN:	    setserver_status -- the status of the response.
+ *
+ * NOTES:	    O(n + m). The operands are read under their locks for
+ *		    reading; the lock on the table is only taken for writing
+ *		    to put the result in, replacing any set of its name.
+ ***/
+static setserver_status combine(setserver * server, uint32_t op,
+				char names[][SETSERVER_NAME_MAX + 1],
+				uint64_t * value)
+{
+  serverset * one = NULL, * two = NULL, * dest = NULL;
+  set * result = NULL;
+  int failed = 0;
+  pthread_rwlock_rdlock(&server->lock);
+  if ((one = lookup(server, names[1])) == NULL
+      || (two = lookup(server, names[2])) == NULL) {
+    pthread_rwlock_unlock(&server->lock);
+    return SETSERVER_NOSET;
+  }
+
+  pthread_rwlock_rdlock(&one->lock);
+  if (two != one)
+    pthread_rwlock_rdlock(&two->lock);
+  if (op == SETSERVER_UNION)
+    failed = set_union(&result, one->group, two->group);
+  else if (op == SETSERVER_INTERSECTION)
+    failed = set_intersection(&result, one->group, two->group);
+  else
+    failed = set_difference(&result, one->group, two->group);
+  if (two != one)
+    pthread_rwlock_unlock(&two->lock);
+  pthread_rwlock_unlock(&one->lock);
+  pthread_rwlock_unlock(&server->lock);
+  if (failed) {
+    set_destroy(&result);
+    return SETSERVER_NOMEMORY;
+  }
+
+  /* No request holds the lock on a set without the lock on the table. */
+  *value = set_size(result);
+  int inserted = 0;
+  pthread_rwlock_wrlock(&server->lock);
+  if ((dest = lookup(server, names[0])) != NULL) {
+    set_destroy(&dest->group);
+    dest->group = result;
+  } else if ((dest = make_set(names[0], result)) == NULL
+	     || hashtable_insert(&server->sets, dest, &inserted) == NULL) {
+    if (dest != NULL)
+      free_set(dest);
+    else
+      set_destroy(&result);
+    failed = 1;
+  }
+  pthread_rwlock_unlock(&server->lock);
+  return failed ? SETSERVER_NOMEMORY : SETSERVER_OK;
+}
+
+/*****************************************************************************/
@@ -0,0 +1,188 @@
+/******************************************************************************
+ * NAME:	    setserver.h
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    The header file for the set server, which hosts named sets
+ *		    of 64-bit keys for the processes of one host, and for its
+ *		    client. The server listens on a Unix domain socket and
+ *		    serves every connection from one epoll instance, on a
+ *		    fixed pool of threads. Requests and responses are binary
+ *		    frames: a fixed header, then a body. A request carries a
+ *		    batch of keys, and a client may send many requests before
+ *		    it reads the responses, which come back in order. Both
+ *		    ends are on the same host, so integers are in its native
+ *		    byte order.
+ *
+ * CREATED:	    10/17/2026
+ *
+ * LAST EDITED:	    10/17/2026
+ ***/
+
+#ifndef __ET_SETSERVER_H__
+#define __ET_SETSERVER_H__
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "hashtable.h"
+
+/******************************************************************************
+ * CONFIGURATION
+ ***/
+
+/* The threads of a server, if it is not given a number. */
+#ifndef CONFIG_SETSERVER_THREADS
+#   define CONFIG_SETSERVER_THREADS 4
+#endif
+
+/* The longest body of a request the server accepts, in bytes. A connection
+ * that sends a longer one is closed. */
+#ifndef CONFIG_SETSERVER_FRAME
+#   define CONFIG_SETSERVER_FRAME (1UL << 20)
+#endif
+
+/* The bytes of responses a connection may have waiting to be written
+ * before the server stops reading its requests. */
+#ifndef CONFIG_SETSERVER_BACKLOG
+#   define CONFIG_SETSERVER_BACKLOG (1UL << 20)
+#endif
+
+/* The most keys the client puts in one request, and the most requests it
+ * sends before it reads a response. */
+#ifndef CONFIG_SETCLIENT_BATCH
+#   define CONFIG_SETCLIENT_BATCH 4096
+#endif
+
+#ifndef CONFIG_SETCLIENT_WINDOW
+#   define CONFIG_SETCLIENT_WINDOW 16
+#endif
+
+/******************************************************************************
+ * MACRO DEFINITIONS
+ ***/
+
+/* The longest name of a set. */
+#define SETSERVER_NAME_MAX 255
+
+/******************************************************************************
+ * TYPE DEFINITIONS
+ ***/
+
+/* The operations of a request. The body of a request starts with the names
+ * of the sets it operates on, each a length byte followed by that many
+ * bytes: one name for most operations, and the destination and the two
+ * operands for the set operations, which create or replace the
+ * destination. The keys follow, 8 bytes each. */
+typedef enum {
+
+  SETSERVER_CREATE = 1,
+  SETSERVER_DROP,
+  SETSERVER_INSERT,
+  SETSERVER_REMOVE,
+  SETSERVER_ISMEMBER,
+  SETSERVER_SIZE,
+  SETSERVER_UNION,
+  SETSERVER_INTERSECTION,
+  SETSERVER_DIFFERENCE
+
+} setserver_op;
+
+typedef enum {
+
+  SETSERVER_OK = 0,
+  SETSERVER_NOSET,
+  SETSERVER_EXISTS,
+  SETSERVER_BADREQUEST,
+  SETSERVER_NOMEMORY
+
+} setserver_status;
+
+/* The header of a request: the bytes of its body, an identifier that is
+ * echoed in the response, the operation, and the number of keys. */
+typedef struct {
+
+  uint32_t length;
+  uint32_t id;
+  uint32_t op;
+  uint32_t count;
+
+} setserver_request;
+
+/* The header of a response. `value' is the number of keys inserted,
+ * removed or found, or the size of the set. The body of a response to
+ * SETSERVER_ISMEMBER is a bitmap, a bit for each key, in order from the
+ * lowest bit of the first byte; the other responses have none. */
+typedef struct {
+
+  uint32_t length;
+  uint32_t id;
+  uint32_t status;
+  uint32_t reserved;
+  uint64_t value;
+
+} setserver_response;
+
+typedef struct {
+
+  char * path;
+  int listener;
+  int epoll;
+  /* An eventfd that becomes readable when the server is stopped. */
+  int wakeup;
+  int threads;
+
+  /* The open connections, so that they can be closed when the server
+   * stops. */
+  pthread_mutex_t guard;
+  struct _setserver_connection_ * connections;
+
+  /* The named sets, and a lock on the table itself. Each set has a lock of
+   * its own. */
+  pthread_rwlock_t lock;
+  hashtable sets;
+
+} setserver;
+
+typedef struct {
+
+  int fd;
+  uint32_t next;
+
+} setclient;
+
+/******************************************************************************
+ * API FUNCTION PROTOTYPES
+ ***/
+
+extern setserver * setserver_create(const char * path, int threads);
+extern int setserver_run(setserver * server);
+extern int setserver_stop(setserver * server);
+extern void setserver_destroy(setserver ** server);
+
+extern setclient * setclient_connect(const char * path);
+extern void setclient_close(setclient ** client);
+extern int setclient_create(setclient * client, const char * name);
+extern int setclient_drop(setclient * client, const char * name);
+extern int setclient_insert(setclient * client, const char * name,
+			    const uint64_t * keys, size_t count,
+			    uint64_t * inserted);
+extern int setclient_remove(setclient * client, const char * name,
+			    const uint64_t * keys, size_t count,
+			    uint64_t * removed);
+extern int setclient_ismember(setclient * client, const char * name,
+			      const uint64_t * keys, size_t count,
+			      unsigned char * members);
+extern int setclient_size(setclient * client, const char * name,
+			  uint64_t * size);
+extern int setclient_union(setclient * client, const char * dest,
+			   const char * one, const char * two);
+extern int setclient_intersection(setclient * client, const char * dest,
+				  const char * one, const char * two);
+extern int setclient_difference(setclient * client, const char * dest,
+				const char * one, const char * two);
+
+#endif /* __ET_SETSERVER_H__ */
+
+/*****************************************************************************/
@@ -0,0 +1,769 @@
+/******************************************************************************
+ * NAME:	    shardset.c
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    Source file containing code for sharded sets. The NUMA
+ *		    nodes and their CPUs are read from sysfs; a machine that
+ *		    does not describe them is taken to be one node, whose
+ *		    threads are not bound. Shard i belongs to node i modulo
+ *		    the number of nodes. Memory is placed by the kernel's
+ *		    first-touch policy: the shards are created, filled in bulk
+ *		    and combined by threads bound to the CPUs of their nodes,
+ *		    and the allocator gives each thread memory of its own.
+ *		    Every member is routed to its shard by the high bits of its
+ *		    hash multiplied by a constant, which are independent of the
+ *		    bits used by the hash table of the shard. This code follows
+ *		    the typedefs and prototypes in shardset.h.
+ *
+ * CREATED:	    10/17/2026
+ *
+ * LAST EDITED:	    10/17/2026
+ ***/
+
+/******************************************************************************
+ * INCLUDES
+ ***/
+
+/* For cpu_set_t and pthread_attr_setaffinity_np. */
+#define _GNU_SOURCE
+
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "shardset.h"
+
+/******************************************************************************
+ * TYPE DEFINITIONS
+ ***/
+
+/* The threads of a shard are bound to `cpus', if `bound'. */
+typedef struct _shard_ {
+
+  set * group;
+  pthread_rwlock_t lock;
+
+  int node;
+  cpu_set_t cpus;
+  int bound;
+
+} shard;
+
+/* The work of one shard in a parallel operation. */
+typedef int (*shard_work)(shardset *, int, void *);
+
+typedef struct {
+
+  shardset * sharded;
+  int index;
+  shard_work work;
+  void * context;
+
+  int status;
+  pthread_t thread;
+  int started;
+
+} task;
+
+/* The arguments of the shard-wise set operations. */
+typedef enum {
+
+  COMBINE_UNION,
+  COMBINE_INTERSECTION,
+  COMBINE_DIFFERENCE
+
+} combine_mode;
+
+typedef struct {
+
+  combine_mode mode;
+  shardset ** sources;
+  int count;
+
+} combine_args;
+
+typedef struct {
+
+  void * const * data;
+  size_t count;
+
+} array_args;
+
+typedef struct {
+
+  void (*func)(void *, void *);
+  void * context;
+
+} traverse_args;
+
+/******************************************************************************
+ * LOCAL PROTOTYPES
+ ***/
+
+static int read_nodes(int *, cpu_set_t *, int);
+static void parse_cpulist(const char *, cpu_set_t *);
+static int owner(const shardset *, const void *);
+static int run(shardset *, shard_work, void *);
+static void * run_task(void *);
+static int create_shard(shardset *, int, void *);
+static int insert_shard(shardset *, int, void *);
+static int traverse_shard(shardset *, int, void *);
+static int combine_shard(shardset *, int, void *);
+static int combine(shardset **, shardset **, combine_mode);
+
+/******************************************************************************
+ * API FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:	    shardset_nodes
+ *
+ * DESCRIPTION:	    Counts the NUMA nodes of the machine.
+ *
+ * ARGUMENTS:	    none.
+ *
+ * RETURN:	    int -- the number of nodes, at least 1.
+ *
+ * NOTES:	    Reads CONFIG_SHARDSET_SYSFS.
+ ***/
+int shardset_nodes(void)
+{
+  int ids[CONFIG_SHARDSET_SHARDS];
+  cpu_set_t cpus[CONFIG_SHARDSET_SHARDS];
+  return read_nodes(ids, cpus, CONFIG_SHARDSET_SHARDS);
+}
+
+/******************************************************************************
+ * FUNCTION:	    shardset_create
+ *
+ * DESCRIPTION:	    Creates an empty sharded set.
+ *
+ * ARGUMENTS:	    match: (int (*)(const void *, const void *)) -- returns 1
+ *			if two members are equal.
+ *		    hash: (unsigned long (*)(const void *)) -- hashes a member.
+ *		    copy: (void * (*)(const void *)) -- copies a member.
+ *		    destroy: (void (*)(void *)) -- frees a member, or NULL.
+ *		    nshards: (int) -- the number of shards, or 0 for one shard
+ *			per node.
+ *
+ * RETURN:	    (shardset *) -- pointer to the new set, or NULL.
+ *
+ * NOTES:	    O(shards). Each shard is created on a thread of its node.
+ ***/
+shardset * shardset_create(int (*match)(const void *, const void *),
+			   unsigned long (*hash)(const void *),
+			   void * (*copy)(const void *),
+			   void (*destroy)(void *), int nshards)
+{
+  if (match == NULL || hash == NULL || nshards < 0
+      || nshards > CONFIG_SHARDSET_SHARDS)
+    return NULL;
+
+  int ids[CONFIG_SHARDSET_SHARDS];
+  cpu_set_t cpus[CONFIG_SHARDSET_SHARDS];
+  int nodes = read_nodes(ids, cpus, CONFIG_SHARDSET_SHARDS);
+  shardset * sharded = NULL;
+  if (nshards == 0)
+    nshards = nodes;
+  if ((sharded = malloc(sizeof(shardset))) == NULL)
+    return NULL;
+
+  *sharded = (shardset){
+    .nshards = 0,
+    .shards = NULL,
+    .match = match,
+    .hash = hash,
+    .copy = copy,
+    .destroy = destroy
+  };
+  if ((sharded->shards = malloc(nshards * sizeof(shard))) == NULL)
+    goto error_exception;
+  for (int i = 0; i < nshards; i++) {
+    shard * part = &sharded->shards[i];
+    if (pthread_rwlock_init(&part->lock, NULL))
+      goto error_exception;
+    part->group = NULL;
+    part->node = ids[i % nodes];
+    part->cpus = cpus[i % nodes];
+    part->bound = CPU_COUNT(&part->cpus) > 0;
+    sharded->nshards++;
+  }
+
+  if (run(sharded, create_shard, NULL))
+    goto error_exception;
+  return sharded;
+
+ error_exception: {
+    shardset_destroy(&sharded);
+    return NULL;
+  }
+}
+
+/******************************************************************************
+ * FUNCTION:	    shardset_destroy
+ *
+ * DESCRIPTION:	    Destroys every shard, and the sharded set.
+ *
+ * ARGUMENTS:	    sharded: (shardset **) -- the set to be operated on.
+ *
+ * RETURN:	    void.
+ *
+ * NOTES:	    O(n)
+ ***/
+void shardset_destroy(shardset ** sharded)
+{
+  if (sharded == NULL || *sharded == NULL)
+    return;
+
+  for (int i = 0; i < (*sharded)->nshards; i++) {
+    set_destroy(&(*sharded)->shards[i].group);
+    pthread_rwlock_destroy(&(*sharded)->shards[i].lock);
+  }
+  free((*sharded)->shards);
+  free(*sharded);
+  *sharded = NULL;
+}
+
+/******************************************************************************
+ * FUNCTION:	    shardset_insert
+ *
+ * DESCRIPTION:	    Inserts the data into the shard that owns it, as
+ *		    set_insert does.
+ *
+ * ARGUMENTS:	    sharded: (shardset *) -- the set to be operated on.
+ *		    data: (void *) -- data to insert.
+ *
+ * RETURN:	    int -- 0 if successful, 1 if the data is already contained
+ *		    in the set, -1 otherwise.
+ *
+ * NOTES:	    O(1) amortized. Runs on the calling thread, so memory the
+ *		    shard allocates here comes from the node of the caller;
+ *		    shardset_insert_array inserts on the nodes of the shards.
+ ***/
+int shardset_insert(shardset * sharded, void * data)
+{
+  if (sharded == NULL || data == NULL)
+    return -1;
+
+  shard * part = &sharded->shards[owner(sharded, data)];
+  pthread_rwlock_wrlock(&part->lock);
+  int ret = set_insert(part->group, data);
+  pthread_rwlock_unlock(&part->lock);
+  return ret;
+}
+
+/******************************************************************************
+ * FUNCTION:	    shardset_insert_array
+ *
+ * DESCRIPTION:	    Inserts copies of an array of members, on all shards in
+ *		    parallel.
+ *
+ * ARGUMENTS:	    sharded: (shardset *) -- the set to be operated on.
+ *		    data: (void * const *) -- the members, which are copied.
+ *		    count: (size_t) -- the number of members.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    O(n * shards / threads): the thread of each shard reads
+ *		    the whole array, and copies and inserts the members that
+ *		    it owns, so they are allocated on its node.
+ ***/
+int shardset_insert_array(shardset * sharded, void * const * data,
+			  size_t count)
+{
+  if (sharded == NULL || sharded->copy == NULL || (data == NULL && count > 0))
+    return -1;
+
+  array_args args = {.data = data, .count = count};
+  return run(sharded, insert_shard, &args);
+}
+
+/******************************************************************************
+ * FUNCTION:	    shardset_ismember
+ *
+ * DESCRIPTION:	    Looks the data up in the shard that owns it.
+ *
+ * ARGUMENTS:	    sharded: (shardset *) -- the set to be operated on.
+ *		    data: (const void *) -- data to check.
+ *
+ * RETURN:	    int -- 1 if the data is a member, 0 otherwise.
+ *
+ * NOTES:	    O(1) expected. Lookups in a shard run at the same time.
+ ***/
+int shardset_ismember(shardset * sharded, const void * data)
+{
+  if (sharded == NULL || data == NULL)
+    return 0;
+
+  shard * part = &sharded->shards[owner(sharded, data)];
+  pthread_rwlock_rdlock(&part->lock);
+  int ret = set_ismember(part->group, data);
+  pthread_rwlock_unlock(&part->lock);
+  return ret;
+}
+
+/******************************************************************************
+ * FUNCTION:	    shardset_remove
+ *
+ * DESCRIPTION:	    Removes the member from the shard that owns it, as
+ *		    set_remove does.
+ *
+ * ARGUMENTS:	    sharded: (shardset *) -- the set to be operated on.
+ *		    data: (const void **) -- data to remove.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    O(1) expected.
+ ***/
+int shardset_remove(shardset * sharded, const void ** data)
+{
+  if (sharded == NULL || data == NULL || *data == NULL)
+    return -1;
+
+  shard * part = &sharded->shards[owner(sharded, *data)];
+  pthread_rwlock_wrlock(&part->lock);
+  int ret = set_remove(part->group, data);
+  pthread_rwlock_unlock(&part->lock);
+  return ret;
+}
+
+/******************************************************************************
+ * FUNCTION:	    shardset_size
+ *
+ * DESCRIPTION:	    Counts the members of all shards.
+ *
+ * ARGUMENTS:	    sharded: (shardset *) -- the set to be operated on.
+ *
+ * RETURN:	    long -- the number of members.
+ *
+ * NOTES:	    O(shards)
+ ***/
+long shardset_size(shardset * sharded)
+{
+  if (sharded == NULL)
+    return 0;
+
+  long size = 0;
+  for (int i = 0; i < sharded->nshards; i++) {
+    pthread_rwlock_rdlock(&sharded->shards[i].lock);
+    size += set_size(sharded->shards[i].group);
+    pthread_rwlock_unlock(&sharded->shards[i].lock);
+  }
+  return size;
+}
+
+/******************************************************************************
+ * FUNCTION:	    shardset_shard
+ *
+ * DESCRIPTION:	    Gets the set that holds one shard.
+ *
+ * ARGUMENTS:	    sharded: (const shardset *) -- the set to be operated on.
+ *		    index: (int) -- the shard, from 0 to nshards - 1.
+ *
+ * RETURN:	    (const set *) -- the shard, or NULL.
+ *
+ * NOTES:	    O(1). The shard is not locked, so it may only be read while
+ *		    no other thread changes the sharded set.
+ ***/
+const set * shardset_shard(const shardset * sharded, int index)
+{
+  if (sharded == NULL || index < 0 || index >= sharded->nshards)
+    return NULL;
+  return sharded->shards[index].group;
+}
+
+/******************************************************************************
+ * FUNCTION:	    shardset_node
+ *
+ * DESCRIPTION:	    Gets the NUMA node that a shard belongs to.
+ *
+ * ARGUMENTS:	    sharded: (const shardset *) -- the set to be operated on.
+ *		    index: (int) -- the shard, from 0 to nshards - 1.
+ *
+ * RETURN:	    int -- the number of the node, or -1.
+ *
+ * NOTES:	    O(1)
+ ***/
+int shardset_node(const shardset * sharded, int index)
+{
+  if (sharded == NULL || index < 0 || index >= sharded->nshards)
+    return -1;
+  return sharded->shards[index].node;
+}
+
+/******************************************************************************
+ * FUNCTION:	    shardset_traverse
+ *
+ * DESCRIPTION:	    Calls a function on every member, on all shards in
+ *		    parallel.
+ *
+ * ARGUMENTS:	    sharded: (shardset *) -- the set to be operated on.
+ *		    func: (void (*)(void *, void *)) -- called with each member
+ *			and the context, from the thread of its shard.
+ *		    context: (void *) -- passed to func.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    O(n / threads). func is called by several threads at once.
+ ***/
+int shardset_traverse(shardset * sharded, void (*func)(void *, void *),
+		      void * context)
+{
+  if (sharded == NULL || func == NULL)
+    return -1;
+
+  traverse_args args = {.func = func, .context = context};
+  return run(sharded, traverse_shard, &args);
+}
+
+/******************************************************************************
+ * FUNCTION:	    shardset_difference
+ *
+ * DESCRIPTION:	    Computes the members of sharded1 that are not in sharded2,
+ *		    shard by shard, in parallel.
+ *
+ * ARGUMENTS:	    setd: (shardset **) -- will contain a pointer to the
+ *			result.
+ *		    sharded1: (shardset *) -- the first set.
+ *		    sharded2: (shardset *) -- the second set.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    The sets must have the same number of shards and the same
+ *		    hash function, so that a member has the same shard in all.
+ ***/
+int shardset_difference(shardset ** setd, shardset * sharded1,
+			shardset * sharded2)
+{
+  shardset * sources[] = {sharded1, sharded2, NULL};
+  if (sharded1 == NULL || sharded2 == NULL)
+    return -1;
+  return combine(setd, sources, COMBINE_DIFFERENCE);
+}
+
+/******************************************************************************
+ * FUNCTION:	    shardset_union_func
+ *
+ * DESCRIPTION:	    Computes the union of sharded sets, shard by shard, in
+ *		    parallel.
+ *
+ * ARGUMENTS:	    setu: (shardset **) -- will contain a pointer to the
+ *			result.
+ *		    sets: (shardset * []) -- the sets, ending with NULL.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    As shardset_difference. Should always be called by wrapper
+ *		    macro.
+ ***/
+int shardset_union_func(shardset ** setu, shardset * sets[])
+{
+  return combine(setu, sets, COMBINE_UNION);
+}
+
+/******************************************************************************
+ * FUNCTION:	    shardset_intersection_func
+ *
+ * DESCRIPTION:	    Computes the intersection of sharded sets, shard by shard,
+ *		    in parallel.
+ *
+ * ARGUMENTS:	    seti: (shardset **) -- will contain a pointer to the
+ *			result.
+ *		    sets: (shardset * []) -- the sets, ending with NULL.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    As shardset_difference. Should always be called by wrapper
+ *		    macro.
+ ***/
+int shardset_intersection_func(shardset ** seti, shardset * sets[])
+{
+  return combine(seti, sets, COMBINE_INTERSECTION);
+}
+
+/******************************************************************************
+ * LOCAL FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:	    read_nodes
+ *
+ * DESCRIPTION:	    Reads the NUMA nodes of the machine, and their CPUs.
+ *
+ * ARGUMENTS:	    ids: (int *) -- will contain the numbers of the nodes.
+ *		    cpus: (cpu_set_t *) -- will contain the CPUs of each
+ *			node.
+ *		    max: (int) -- the most nodes to read.
+ *
+ * RETURN:	    int -- the number of nodes, at least 1. If there are none
+ *		    to read, node 0 is returned, with no CPUs.
+ *
+ * NOTES:	    The nodes are in the order of the directory.
+ ***/
+static int read_nodes(int * ids, cpu_set_t * cpus, int max)
+{
+  int nodes = 0;
+  DIR * directory = opendir(CONFIG_SHARDSET_SYSFS);
+  struct dirent * entry = NULL;
+  while (directory != NULL && nodes < max
+	 && (entry = readdir(directory)) != NULL) {
+    int id = 0;
+    char rest = 0;
+    if (sscanf(entry->d_name, "node%d%c", &id, &rest) != 1)
+      continue;
+
+    char path[sizeof(CONFIG_SHARDSET_SYSFS) + 64], list[4096];
+    snprintf(path, sizeof(path), CONFIG_SHARDSET_SYSFS "/node%d/cpulist", id);
+    FILE * file = fopen(path, "r");
+    CPU_ZERO(&cpus[nodes]);
+    if (file != NULL) {
+      if (fgets(list, sizeof(list), file) != NULL)
+	parse_cpulist(list, &cpus[nodes]);
+      fclose(file);
+    }
+    ids[nodes++] = id;
+  }
+  if (directory != NULL)
+    closedir(directory);
+
+  if (nodes == 0) {
+    ids[0] = 0;
+    CPU_ZERO(&cpus[0]);
+    nodes = 1;
+  }
+  return nodes;
+}
+
+/* Adds the CPUs in a list such as "0-3,8-11" to a set. */
+static void parse_cpulist(const char * list, cpu_set_t * cpus)
+{
+  while (*list != '\0') {
+    char * end = NULL;
+    long first = strtol(list, &end, 10), last = first;
+    if (end == list)
+      return;
+    if (*end == '-')
+      last = strtol(end + 1, &end, 10);
+    for (long cpu = first < 0 ? 0 : first; cpu <= last && cpu < CPU_SETSIZE;
+	 cpu++)
+      CPU_SET(cpu, cpus);
+    if (*end != ',')
+      return;
+    list = end + 1;
+  }
+}
+
+/* The shard that owns a member. */
+static int owner(const shardset * sharded, const void * data)
+{
+  uint64_t hash = (uint64_t)sharded->hash(data) * 0x9e3779b97f4a7c15ULL;
+  return (int)(((hash >> 32) * (uint64_t)sharded->nshards) >> 32);
+}
+
+/******************************************************************************
+ * FUNCTION:	    run
+ *
+ * DESCRIPTION:	    Does some work on every shard, in parallel, each on a
+ *		    thread bound to the CPUs of the node of its shard.
+ *
+ * ARGUMENTS:	    sharded: (shardset *) -- the set to be operated on.
+ *		    work: (shard_work) -- called with the set, the index of a
+ *			shard and the context; returns 0 if successful.
+ *		    context: (void *) -- passed to work.
+ *
+ * RETURN:	    int -- 0 if the work on every shard succeeded, -1
+ *		    otherwise.
+ *
+ * NOTES:	    The work on a shard whose thread cannot be started is done
+ *		    on the calling thread, after the others have started.
+ ***/
+static int run(shardset * sharded, shard_work work, void * context)
+{
+  task tasks[CONFIG_SHARDSET_SHARDS];
+  for (int i = 0; i < sharded->nshards; i++) {
+    tasks[i] = (task){
+      .sharded = sharded,
+      .index = i,
+      .work = work,
+      .context = context,
+      .status = -1,
+      .started = 0
+    };
+
+    const shard * part = &sharded->shards[i];
+    pthread_attr_t attributes;
+    if (pthread_attr_init(&attributes))
+      continue;
+    if (part->bound)
+      pthread_attr_setaffinity_np(&attributes, sizeof(cpu_set_t),
+				  &part->cpus);
+    tasks[i].started = !pthread_create(&tasks[i].thread, &attributes,
+				       run_task, &tasks[i]);
+    pthread_attr_destroy(&attributes);
+  }
+
+  int status = 0;
+  for (int i = 0; i < sharded->nshards; i++) {
+    if (tasks[i].started)
+      pthread_join(tasks[i].thread, NULL);
+    else
+      run_task(&tasks[i]);
+    status |= tasks[i].status;
+  }
+  return status ? -1 : 0;
+}
+
+static void * run_task(void * arg)
+{
+  task * work = arg;
+  work->status = work->work(work->sharded, work->index, work->context) ? -1
+    : 0;
+  return NULL;
+}
+
+static int create_shard(shardset * sharded, int index, void * context)
+{
+  (void)context;
+  sharded->shards[index].group = set_create_hashed(sharded->match,
+						   sharded->hash,
+						   sharded->copy,
+						   sharded->destroy);
+  return sharded->shards[index].group == NULL ? -1 : 0;
+}
+
+/* Copies and inserts the members of an array that this shard owns. */
+static int insert_shard(shardset * sharded, int index, void * context)
+{
+  const array_args * args = context;
+  shard * part = &sharded->shards[index];
+  int status = 0;
+
+  pthread_rwlock_wrlock(&part->lock);
+  for (size_t i = 0; i < args->count && status == 0; i++) {
+    if (owner(sharded, args->data[i]) != index)
+      continue;
+
+    void * data = NULL;
+    if ((data = sharded->copy(args->data[i])) == NULL) {
+      status = -1;
+      break;
+    }
+    int ret = set_insert(part->group, data);
+    if (ret != 0 && sharded->destroy != NULL)
+      sharded->destroy(data);
+    status = ret < 0 ? -1 : 0;
+  }
+  pthread_rwlock_unlock(&part->lock);
+  return status;
+}
+
+static int traverse_shard(shardset * sharded, int index, void * context)
+{
+  const traverse_args * args = context;
+  shard * part = &sharded->shards[index];
+  set_iterator iterator;
+
+  pthread_rwlock_rdlock(&part->lock);
+  for (void * data = set_begin(part->group, &iterator); data != NULL;
+       data = set_advance(part->group, &iterator))
+    args->func(data, args->context);
+  pthread_rwlock_unlock(&part->lock);
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    combine_shard
+ *
+ * DESCRIPTION:	    Computes one shard of a union, intersection or difference
+ *		    from the same shard of every source.
+ *
+ * ARGUMENTS:	    sharded: (shardset *) -- the result.
+ *		    index: (int) -- the shard.
+ *		    context: (void *) -- the combine_args.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    The sources are read-locked for the whole operation.
+ ***/
+static int combine_shard(shardset * sharded, int index, void * context)
+{
+  const combine_args * args = context;
+  set ** parts = NULL, * result = NULL;
+  int n = 0, ret = -1;
+
+  if ((parts = calloc(args->count + 1, sizeof(set *))) == NULL)
+    return -1;
+  for (n = 0; n < args->count; n++) {
+    pthread_rwlock_rdlock(&args->sources[n]->shards[index].lock);
+    parts[n] = args->sources[n]->shards[index].group;
+  }
+  parts[n] = NULL;
+
+  switch (args->mode) {
+  case COMBINE_UNION:
+    ret = set_union_func(&result, parts);
+    break;
+  case COMBINE_INTERSECTION:
+    ret = set_intersection_func(&result, parts);
+    break;
+  case COMBINE_DIFFERENCE:
+    ret = set_difference(&result, parts[0], parts[1]);
+    break;
+  }
+
+  for (int i = 0; i < n; i++)
+    pthread_rwlock_unlock(&args->sources[i]->shards[index].lock);
+  free(parts);
+  if (ret != 0) {
+    set_destroy(&result);
+    return -1;
+  }
+
+  set_destroy(&sharded->shards[index].group);
+  sharded->shards[index].group = result;
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    combine
+ *
+ * DESCRIPTION:	    Creates a sharded set like the sources, and computes each
+ *		    of its shards from the sources in parallel.
+ *
+ * ARGUMENTS:	    dest: (shardset **) -- will contain the result.
+ *		    sources: (shardset **) -- the sources, ending with NULL.
+ *		    mode: (combine_mode) -- the operation.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    Fails if the sources are not sharded alike.
+ ***/
+static int combine(shardset ** dest, shardset ** sources, combine_mode mode)
+{
+  if (dest == NULL || sources == NULL || sources[0] == NULL)
+    return -1;
+  int n = 0;
+  for (n = 0; sources[n] != NULL; n++)
+    if (sources[n]->nshards != sources[0]->nshards
+	|| sources[n]->hash != sources[0]->hash
+	|| sources[n]->match != sources[0]->match)
+      return -1;
+
+  const shardset * model = sources[0];
+  shardset * result = shardset_create(model->match, model->hash, model->copy,
+				      model->destroy, model->nshards);
+  combine_args args = {.mode = mode, .sources = sources, .count = n};
+  if (result == NULL || run(result, combine_shard, &args)) {
+    shardset_destroy(&result);
+    return -1;
+  }
+
+  *dest = result;
+  return 0;
+}
+
+/*****************************************************************************/
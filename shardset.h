@@ -0,0 +1,105 @@
+/******************************************************************************
+ * NAME:	    shardset.h
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    The header file for sharded sets, for machines with more
+ *		    than one NUMA node. A shardset divides its members by hash
+ *		    among shards, each of which is a hashed set (set.h) that
+ *		    belongs to one node. The work on a shard that allocates in
+ *		    bulk, or that touches all of it, runs on threads bound to
+ *		    the CPUs of its node, so its memory is placed on that node
+ *		    and read from there; single insertions, removals and
+ *		    lookups are routed to the owning shard and run on the
+ *		    calling thread. Union, intersection, difference and
+ *		    traversal run on all shards in parallel.
+ *
+ * CREATED:	    10/17/2026
+ *
+ * LAST EDITED:	    10/17/2026
+ ***/
+
+#ifndef __ET_SHARDSET_H__
+#define __ET_SHARDSET_H__
+
+#include <stddef.h>
+
+#include "set.h"
+
+/******************************************************************************
+ * CONFIGURATION
+ ***/
+
+/* The most shards, and the most nodes that are looked for. */
+#ifndef CONFIG_SHARDSET_SHARDS
+#   define CONFIG_SHARDSET_SHARDS 64
+#endif
+
+/* Where the kernel describes the NUMA nodes. */
+#ifndef CONFIG_SHARDSET_SYSFS
+#   define CONFIG_SHARDSET_SYSFS "/sys/devices/system/node"
+#endif
+
+/******************************************************************************
+ * TYPE DEFINITIONS
+ ***/
+
+/* A shard, its lock, and the node it belongs to. Defined in shardset.c */
+struct _shard_;
+
+typedef struct {
+
+  int nshards;
+  struct _shard_ * shards;
+
+  int (*match)(const void *, const void *);
+  unsigned long (*hash)(const void *);
+  void * (*copy)(const void *);
+  void (*destroy)(void *);
+
+} shardset;
+
+/******************************************************************************
+ * MACRO DEFINITIONS
+ ***/
+
+/* Wrapper macros for the variadic operations. As with set.h, these should
+ * ALWAYS be called instead of the corresponding _func functions.
+ */
+#define shardset_union(Setu, ...)					\
+  (shardset_union_func(Setu, (shardset * []){__VA_ARGS__, NULL}))
+
+#define shardset_intersection(Seti, ...)				\
+  (shardset_intersection_func(Seti, (shardset * []){__VA_ARGS__, NULL}))
+
+/******************************************************************************
+ * API FUNCTION PROTOTYPES
+ ***/
+
+extern int shardset_nodes(void);
+extern shardset * shardset_create(int (*match)(const void *, const void *),
+				  unsigned long (*hash)(const void *),
+				  void * (*copy)(const void *),
+				  void (*destroy)(void *), int nshards);
+extern void shardset_destroy(shardset ** sharded);
+extern int shardset_insert(shardset * sharded, void * data);
+extern int shardset_insert_array(shardset * sharded, void * const * data,
+				 size_t count);
+extern int shardset_ismember(shardset * sharded, const void * data);
+extern int shardset_remove(shardset * sharded, const void ** data);
+extern long shardset_size(shardset * sharded);
+extern const set * shardset_shard(const shardset * sharded, int index);
+extern int shardset_node(const shardset * sharded, int index);
+extern int shardset_traverse(shardset * sharded,
+			     void (*func)(void *, void *), void * context);
+extern int shardset_difference(shardset ** setd, shardset * sharded1,
+			       shardset * sharded2);
+
+/* These functions: */
+extern int shardset_union_func(shardset **, shardset * []);
+extern int shardset_intersection_func(shardset **, shardset * []);
+/* Should NEVER be called directly. Use the wrapper macros defined above. */
+
+#endif /* __ET_SHARDSET_H__ */
+
+/*****************************************************************************/
@@ -0,0 +1,764 @@
+/******************************************************************************
+ * NAME:	    shmset.c
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    Source file containing the shared set engine. A segment
+ *		    starts with a header, which holds a process-shared
+ *		    read-write lock, then an array of buckets, then a pool of
+ *		    entries. Each entry holds a link to the next entry of its
+ *		    bucket, the mixed hash of its record, whether it is live,
+ *		    and the record itself. Links are offsets from the start of
+ *		    the segment, and 0, the offset of the header, is the end
+ *		    of a chain. Removed entries are kept on a free list, also
+ *		    linked by offsets, and reused by later inserts. The pool
+ *		    does not grow: the segment is sized for the capacity when
+ *		    it is created, and its pages are only backed as they are
+ *		    used. This code follows the typedefs and prototypes in
+ *		    shmset.h.
+ *
+ * CREATED:	    10/17/2026
+ *
+ * LAST EDITED:	    10/17/2026
+ ***/
+
+/******************************************************************************
+ * INCLUDES
+ ***/
+
+/* For shm_open, ftruncate and MAP_ANONYMOUS. */
+#define _DEFAULT_SOURCE
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "set.h"
+#include "setengine.h"
+#include "shmset.h"
+
+/******************************************************************************
+ * MACRO DEFINITIONS
+ ***/
+
+#define SHMSET_MAGIC "SETSHM01"
+/* The end of a chain. No entry can be at offset 0, since the header is. */
+#define SHMSET_NONE ((uint64_t)0)
+
+#define head_of(store) ((shmhead *)(store)->base)
+#define at(store, offset) ((shmentry *)((store)->base + (offset)))
+#define buckets_of(store)					\
+  ((uint64_t *)((store)->base + head_of(store)->buckets))
+#define offset_of(store, i)						\
+  (head_of(store)->entries + (uint64_t)(i) * head_of(store)->stride)
+#define record_of(entry) ((char *)(entry) + sizeof(shmentry))
+
+/******************************************************************************
+ * TYPE DEFINITIONS
+ ***/
+
+/* The start of a segment. `fresh' counts the entries of the pool that have
+ * ever been used, and `free' is the first of the free list. `buckets' and
+ * `entries' are the offsets of the arrays. */
+typedef struct {
+
+  char magic[8];
+  uint64_t width;
+  uint64_t stride;
+  uint64_t capacity;
+  uint64_t mask;
+  uint64_t size;
+  uint64_t fresh;
+  uint64_t free;
+  uint64_t buckets;
+  uint64_t entries;
+  uint64_t length;
+  pthread_rwlock_t lock;
+
+} shmhead;
+
+/* An entry of the pool. The record follows it. */
+typedef struct {
+
+  uint64_t next;
+  uint64_t hash;
+  uint64_t live;
+
+} shmentry;
+
+/* The storage of a shared set in one process: its mapping of the segment,
+ * whether the segment has a name (the sets made by the set operations are
+ * private to a process), and the member returned by the last call to begin,
+ * advance or remove. */
+typedef struct {
+
+  char * base;
+  size_t length;
+  int named;
+  char * scratch;
+
+} shmstore;
+
+/******************************************************************************
+ * LOCAL PROTOTYPES
+ ***/
+
+static unsigned long mix(unsigned long);
+static size_t layout(size_t, size_t, shmhead *);
+static shmstore * map_store(int, size_t, int);
+static shmstore * open_private(size_t, size_t);
+static void close_store(shmstore *);
+static int format(shmstore *, const shmhead *);
+static uint64_t find(const set *, const void *, unsigned long, uint64_t *);
+static uint64_t add_entry(shmstore *, unsigned long, const void *);
+static int grow(set *);
+
+static int shared_ismember(const set *, const void *);
+static int shared_insert(set *, void *);
+static void * shared_remove(set *, const void *);
+static void * shared_begin(const set *, set_iterator *);
+static void * shared_advance(const set *, set_iterator *);
+static void shared_clear(set *);
+static int shared_like(set *, const set *);
+
+/******************************************************************************
+ * ENGINES
+ ***/
+
+const set_engine set_shared_engine = {
+  .name = "shared",
+  .ismember = shared_ismember,
+  .insert = shared_insert,
+  .remove = shared_remove,
+  .begin = shared_begin,
+  .advance = shared_advance,
+  .clear = shared_clear,
+  .like = shared_like,
+  .byvalue = 1
+};
+
+/******************************************************************************
+ * API FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:	    set_create_shared
+ *
+ * DESCRIPTION:	    Creates a shared memory segment, and a shared set in it.
+ *
+ * ARGUMENTS:	    match, copy, destroy: as in set_create (set.h). They are
+ *			called on records of `width' bytes.
+ *		    hash: (unsigned long (*)(const void *)) -- as in
+ *			set_create_hashed.
+ *		    width: (size_t) -- the size of a member, in bytes.
+ *		    name: (const char *) -- the name of the segment, as for
+ *			shm_open: a slash followed by up to 255 characters
+ *			that are not slashes.
+ *		    capacity: (size_t) -- the most members the set can hold.
+ *
+ * RETURN:	    (set *) -- pointer to the set, or NULL if an argument is
+ *		    bad, or a segment of that name exists.
+ *
+ * NOTES:	    O(1). Records are copied into the segment, so they must
+ *		    not hold pointers that other processes would follow.
+ *		    set_insert fails once the set is full. set_destroy unmaps
+ *		    the segment and leaves the members in it, for other
+ *		    processes and for later attaches, until the name is
+ *		    removed with set_shared_unlink. The sets made by the set
+ *		    operations are shared sets in memory private to this
+ *		    process, which grow as needed.
+ ***/
+set * set_create_shared(int (*match)(const void *, const void *),
+			unsigned long (*hash)(const void *),
+			void * (*copy)(const void *),
+			void (*destroy)(void *),
+			size_t width, const char * name, size_t capacity)
+{
+  shmhead head;
+  size_t length = 0;
+  if (match == NULL || hash == NULL || name == NULL
+      || (length = layout(width, capacity, &head)) == 0)
+    return NULL;
+
+  int fd = -1;
+  set * group = NULL;
+  shmstore * store = NULL;
+  if ((fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600)) < 0)
+    return NULL;
+  if (ftruncate(fd, (off_t)length)
+      || (store = map_store(fd, length, 1)) == NULL
+      || format(store, &head)
+      || (group = set_create_engine(&set_shared_engine, match, hash, copy,
+				    destroy)) == NULL)
+    goto error_exception;
+
+  close(fd);
+  group->storage = store;
+  return group;
+
+ error_exception: {
+    if (store != NULL)
+      close_store(store);
+    close(fd);
+    shm_unlink(name);
+    return NULL;
+  }
+}
+
+/******************************************************************************
+ * FUNCTION:	    set_attach_shared
+ *
+ * DESCRIPTION:	    Attaches to a shared set made by set_create_shared, in
+ *		    this or another process.
+ *
+ * ARGUMENTS:	    match, hash, copy, destroy: as in set_create_shared.
+ *		    name: (const char *) -- the name of the segment.
+ *
+ * RETURN:	    (set *) -- pointer to the set, or NULL if there is no
+ *		    segment of that name, or it does not hold a shared set.
+ *
+ * NOTES:	    O(1). The width of the records is that of the segment.
+ *		    Lookups compare the records in the segment, without
+ *		    copying them.
+ ***/
+set * set_attach_shared(int (*match)(const void *, const void *),
+			unsigned long (*hash)(const void *),
+			void * (*copy)(const void *),
+			void (*destroy)(void *),
+			const char * name)
+{
+  if (match == NULL || hash == NULL || name == NULL)
+    return NULL;
+
+  int fd = -1;
+  struct stat info;
+  set * group = NULL;
+  shmstore * store = NULL;
+  if ((fd = shm_open(name, O_RDWR, 0)) < 0)
+    return NULL;
+  if (fstat(fd, &info) || (size_t)info.st_size < sizeof(shmhead)
+      || (store = map_store(fd, (size_t)info.st_size, 1)) == NULL)
+    goto error_exception;
+
+  /* The creator writes the magic last, so a segment that has it is ready. */
+  const shmhead * head = head_of(store);
+  if (memcmp(head->magic, SHMSET_MAGIC, sizeof(head->magic)))
+    goto error_exception;
+  __sync_synchronize();
+  if (head->length != store->length
+      || (store->scratch = malloc(head->width)) == NULL
+      || (group = set_create_engine(&set_shared_engine, match, hash, copy,
+				    destroy)) == NULL)
+    goto error_exception;
+
+  close(fd);
+  group->storage = store;
+  set_shared_refresh(group);
+  return group;
+
+ error_exception: {
+    if (store != NULL)
+      close_store(store);
+    close(fd);
+    return NULL;
+  }
+}
+
+/******************************************************************************
+ * FUNCTION:	    set_shared_refresh
+ *
+ * DESCRIPTION:	    Brings the size of a shared set (set_size) up to date
+ *		    with the inserts and removes of other processes.
+ *
+ * ARGUMENTS:	    group: (set *) -- the set to be operated on.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    O(1). set_insert and set_remove also bring it up to date.
+ ***/
+int set_shared_refresh(set * group)
+{
+  if (group == NULL || group->engine != &set_shared_engine)
+    return -1;
+
+  shmhead * head = head_of((shmstore *)group->storage);
+  pthread_rwlock_rdlock(&head->lock);
+  group->size = (int)head->size;
+  pthread_rwlock_unlock(&head->lock);
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    set_shared_unlink
+ *
+ * DESCRIPTION:	    Removes the name of a shared set's segment.
+ *
+ * ARGUMENTS:	    name: (const char *) -- the name of the segment.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    The sets attached to it keep working, and the memory is
+ *		    freed when the last of them is destroyed.
+ ***/
+int set_shared_unlink(const char * name)
+{
+  if (name == NULL || shm_unlink(name))
+    return -1;
+  return 0;
+}
+
+/******************************************************************************
+ * LOCAL FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:	    mix
+ *
+ * DESCRIPTION:	    Scrambles the bits of a user hash, so that functions like
+ *		    the identity on small integers still spread evenly over a
+ *		    power-of-two array of buckets.
+ *
+ * ARGUMENTS:	    hash: (unsigned long) -- the user hash.
+ *
+ * RETURN:	    unsigned long -- the mixed hash.
+ *
+ * NOTES:	    This is the finalizer of MurmurHash3, as in hashtable.c.
+ ***/
+static unsigned long mix(unsigned long hash)
+{
+  unsigned long long h = hash;
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return (unsigned long)h;
+}
+
+/******************************************************************************
+ * FUNCTION:	    layout
+ *
+ * DESCRIPTION:	    Lays out a segment: a bucket for each member, rounded up
+ *		    to a power of two, then the pool, each entry padded to
+ *		    keep the next aligned.
+ *
+ * ARGUMENTS:	    width: (size_t) -- the size of a member.
+ *		    capacity: (size_t) -- the most members.
+ *		    head: (shmhead *) -- receives the layout, and is otherwise
+ *			cleared.
+ *
+ * RETURN:	    size_t -- the length of the segment, or 0 if the arguments
+ *		    are bad.
+ *
+ * NOTES:	    none.
+ ***/
+static size_t layout(size_t width, size_t capacity, shmhead * head)
+{
+  uint64_t stride = sizeof(shmentry) + (width + 7) / 8 * 8, buckets = 1;
+  if (width == 0 || capacity == 0
+      || capacity > (SIZE_MAX / 2 - sizeof(shmhead)) / (stride + 16))
+    return 0;
+  while (buckets < capacity)
+    buckets <<= 1;
+
+  memset(head, 0, sizeof(shmhead));
+  head->width = width;
+  head->stride = stride;
+  head->capacity = capacity;
+  head->mask = buckets - 1;
+  head->buckets = (sizeof(shmhead) + 63) / 64 * 64;
+  head->entries = head->buckets + buckets * sizeof(uint64_t);
+  head->length = head->entries + capacity * stride;
+  return head->length;
+}
+
+/* Maps a segment of `length' bytes, shared with other processes. */
+static shmstore * map_store(int fd, size_t length, int named)
+{
+  shmstore * store = NULL;
+  if ((store = malloc(sizeof(shmstore))) == NULL)
+    return NULL;
+
+  *store = (shmstore){.base = NULL, .length = length, .named = named,
+		      .scratch = NULL};
+  void * base = mmap(NULL, length, PROT_READ | PROT_WRITE,
+		     fd < 0 ? MAP_PRIVATE | MAP_ANONYMOUS : MAP_SHARED, fd, 0);
+  if (base == MAP_FAILED) {
+    free(store);
+    return NULL;
+  }
+
+  store->base = base;
+  return store;
+}
+
+/* Makes the storage of a set private to this process, in anonymous memory,
+ * with the same layout as a segment. */
+static shmstore * open_private(size_t width, size_t capacity)
+{
+  shmhead head;
+  size_t length = 0;
+  shmstore * store = NULL;
+  if ((length = layout(width, capacity, &head)) == 0
+      || (store = map_store(-1, length, 0)) == NULL)
+    return NULL;
+
+  if (format(store, &head)) {
+    close_store(store);
+    return NULL;
+  }
+  return store;
+}
+
+/* Unmaps a segment. The segment itself is left alone. */
+static void close_store(shmstore * store)
+{
+  munmap(store->base, store->length);
+  free(store->scratch);
+  free(store);
+}
+
+/******************************************************************************
+ * FUNCTION:	    format
+ *
+ * DESCRIPTION:	    Writes the header of an empty set into a new segment,
+ *		    which must be zeroed, and gives the store its scratch
+ *		    record.
+ *
+ * ARGUMENTS:	    store: (shmstore *) -- the mapping of the segment.
+ *		    layout: (const shmhead *) -- the layout, from layout().
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    The lock is made process-shared. The magic is written
+ *		    last, after a barrier, since set_attach_shared takes it to
+ *		    mean that the rest of the header is ready.
+ ***/
+static int format(shmstore * store, const shmhead * layout)
+{
+  shmhead * head = head_of(store);
+  if ((store->scratch = malloc(layout->width)) == NULL)
+    return -1;
+  *head = *layout;
+  head->size = 0;
+  head->fresh = 0;
+  head->free = SHMSET_NONE;
+
+  pthread_rwlockattr_t attributes;
+  if (pthread_rwlockattr_init(&attributes))
+    return -1;
+  int failed = pthread_rwlockattr_setpshared(&attributes,
+					     PTHREAD_PROCESS_SHARED)
+    || pthread_rwlock_init(&head->lock, &attributes);
+  pthread_rwlockattr_destroy(&attributes);
+  if (failed)
+    return -1;
+
+  __sync_synchronize();
+  memcpy(head->magic, SHMSET_MAGIC, sizeof(head->magic));
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    find
+ *
+ * DESCRIPTION:	    Finds the entry of a member, in the chain of its bucket.
+ *
+ * ARGUMENTS:	    group: (const set *) -- the set, with its lock held.
+ *		    data: (const void *) -- the record to look for.
+ *		    hash: (unsigned long) -- its mixed hash.
+ *		    prev: (uint64_t *) -- receives the offset of the entry
+ *			before it in the chain, or SHMSET_NONE.
+ *
+ * RETURN:	    uint64_t -- the offset of the entry, or SHMSET_NONE.
+ *
+ * NOTES:	    O(1) expected. match is called on the record in the
+ *		    segment, and only for entries with the same hash.
+ ***/
+static uint64_t find(const set * group, const void * data, unsigned long hash,
+		     uint64_t * prev)
+{
+  const shmstore * store = group->storage;
+  *prev = SHMSET_NONE;
+  for (uint64_t offset = buckets_of(store)[hash & head_of(store)->mask];
+       offset != SHMSET_NONE; offset = at(store, offset)->next) {
+    const shmentry * entry = at(store, offset);
+    if (entry->hash == hash && set_matches(group, record_of(entry), data))
+      return offset;
+    *prev = offset;
+  }
+
+  return SHMSET_NONE;
+}
+
+/******************************************************************************
+ * FUNCTION:	    add_entry
+ *
+ * DESCRIPTION:	    Copies a record that is not in the set into an entry,
+ *		    from the free list or else from the unused part of the
+ *		    pool, and puts it at the head of its chain.
+ *
+ * ARGUMENTS:	    store: (shmstore *) -- the store, with its lock held for
+ *			writing.
+ *		    hash: (unsigned long) -- the mixed hash of the record.
+ *		    data: (const void *) -- the record.
+ *
+ * RETURN:	    uint64_t -- the offset of the entry, or SHMSET_NONE if the
+ *		    pool is full.
+ *
+ * NOTES:	    O(1)
+ ***/
+static uint64_t add_entry(shmstore * store, unsigned long hash,
+			  const void * data)
+{
+  shmhead * head = head_of(store);
+  uint64_t offset = head->free;
+  if (offset != SHMSET_NONE)
+    head->free = at(store, offset)->next;
+  else if (head->fresh < head->capacity)
+    offset = offset_of(store, head->fresh++);
+  else
+    return SHMSET_NONE;
+
+  uint64_t * bucket = &buckets_of(store)[hash & head->mask];
+  shmentry * entry = at(store, offset);
+  *entry = (shmentry){.next = *bucket, .hash = hash, .live = 1};
+  memcpy(record_of(entry), data, head->width);
+  *bucket = offset;
+  head->size++;
+  return offset;
+}
+
+/******************************************************************************
+ * FUNCTION:	    grow
+ *
+ * DESCRIPTION:	    Moves the members of a full private set into a store of
+ *		    twice the capacity.
+ *
+ * ARGUMENTS:	    group: (set *) -- a set made by the set operations.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise. On failure the set is
+ *		    left unchanged.
+ *
+ * NOTES:	    O(n). A segment with a name cannot grow, since the other
+ *		    processes would have to map it again.
+ ***/
+static int grow(set * group)
+{
+  shmstore * old = group->storage, * store = NULL;
+  const shmhead * head = head_of(old);
+  if ((store = open_private(head->width, 2 * head->capacity)) == NULL)
+    return -1;
+
+  for (uint64_t i = 0; i < head->fresh; i++) {
+    const shmentry * entry = at(old, offset_of(old, i));
+    if (entry->live)
+      add_entry(store, entry->hash, record_of(entry));
+  }
+
+  close_store(old);
+  group->storage = store;
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    shared_ismember
+ *
+ * DESCRIPTION:	    ismember primitive of the shared engine.
+ *
+ * ARGUMENTS:	    group: (const set *) -- the set to be operated on.
+ *		    data: (const void *) -- the record to check.
+ *
+ * RETURN:	    int -- 1 if the member is in the set, 0 if it is not.
+ *
+ * NOTES:	    O(1) expected, under the lock for reading.
+ ***/
+static int shared_ismember(const set * group, const void * data)
+{
+  shmhead * head = head_of((const shmstore *)group->storage);
+  unsigned long hash = mix(set_hashof(group, data));
+  uint64_t prev = SHMSET_NONE;
+  pthread_rwlock_rdlock(&head->lock);
+  int found = find(group, data, hash, &prev) != SHMSET_NONE;
+  pthread_rwlock_unlock(&head->lock);
+  return found;
+}
+
+/******************************************************************************
+ * FUNCTION:	    shared_insert
+ *
+ * DESCRIPTION:	    insert primitive of the shared engine.
+ *
+ * ARGUMENTS:	    group: (set *) -- the set to be operated on.
+ *		    data: (void *) -- the record to insert.
+ *
+ * RETURN:	    int -- 0 if successful, 1 if the data is already contained
+ *		    in the set, -1 otherwise, as when a segment is full.
+ *
+ * NOTES:	    O(1) expected, under the lock for writing.
+ ***/
+static int shared_insert(set * group, void * data)
+{
+  shmstore * store = group->storage;
+  const shmhead * layout = head_of(store);
+  if (!store->named && layout->free == SHMSET_NONE
+      && layout->fresh == layout->capacity) {
+    if (shared_ismember(group, data))
+      return 1;
+    if (grow(group))
+      return -1;
+    store = group->storage;
+  }
+
+  shmhead * head = head_of(store);
+  unsigned long hash = mix(set_hashof(group, data));
+  uint64_t prev = SHMSET_NONE;
+  int ret = 0;
+  pthread_rwlock_wrlock(&head->lock);
+  if (find(group, data, hash, &prev) != SHMSET_NONE)
+    ret = 1;
+  else if (add_entry(store, hash, data) == SHMSET_NONE)
+    ret = -1;
+  group->size = (int)head->size;
+  pthread_rwlock_unlock(&head->lock);
+  return ret;
+}
+
+/******************************************************************************
+ * FUNCTION:	    shared_remove
+ *
+ * DESCRIPTION:	    remove primitive of the shared engine. The entry is taken
+ *		    out of its chain and put on the free list.
+ *
+ * ARGUMENTS:	    group: (set *) -- the set to be operated on.
+ *		    data: (const void *) -- the record to remove.
+ *
+ * RETURN:	    void * -- a copy of the removed record, valid until the
+ *		    next call on the set, or NULL.
+ *
+ * NOTES:	    O(1) expected, under the lock for writing.
+ ***/
+static void * shared_remove(set * group, const void * data)
+{
+  shmstore * store = group->storage;
+  shmhead * head = head_of(store);
+  unsigned long hash = mix(set_hashof(group, data));
+  uint64_t prev = SHMSET_NONE, offset = SHMSET_NONE;
+  pthread_rwlock_wrlock(&head->lock);
+  if ((offset = find(group, data, hash, &prev)) != SHMSET_NONE) {
+    shmentry * entry = at(store, offset);
+    if (prev == SHMSET_NONE)
+      buckets_of(store)[hash & head->mask] = entry->next;
+    else
+      at(store, prev)->next = entry->next;
+
+    memcpy(store->scratch, record_of(entry), head->width);
+    entry->live = 0;
+    entry->next = head->free;
+    head->free = offset;
+    head->size--;
+  }
+  group->size = (int)head->size;
+  pthread_rwlock_unlock(&head->lock);
+  return offset != SHMSET_NONE ? store->scratch : NULL;
+}
+
+/******************************************************************************
+ * FUNCTION:	    shared_begin
+ *
+ * DESCRIPTION:	    begin primitive of the shared engine.
+ *
+ * ARGUMENTS:	    group: (const set *) -- the set to be operated on.
+ *		    iterator: (set_iterator *) -- will contain the position.
+ *
+ * RETURN:	    void * -- a copy of the first member, or NULL.
+ *
+ * NOTES:	    O(1) amortized.
+ ***/
+static void * shared_begin(const set * group, set_iterator * iterator)
+{
+  iterator->node = NULL;
+  iterator->index = -1;
+  return shared_advance(group, iterator);
+}
+
+/******************************************************************************
+ * FUNCTION:	    shared_advance
+ *
+ * DESCRIPTION:	    advance primitive of the shared engine. The pool is read
+ *		    in order, skipping the entries that are not live.
+ *
+ * ARGUMENTS:	    group: (const set *) -- the set to be operated on.
+ *		    iterator: (set_iterator *) -- the current position.
+ *
+ * RETURN:	    void * -- a copy of the next member, valid until the next
+ *		    call on the set, or NULL.
+ *
+ * NOTES:	    O(1) amortized, under the lock for reading. The lock is
+ *		    not held between calls: if another process changes the
+ *		    set meanwhile, members may be missed or repeated, but
+ *		    every record returned was a member when it was read.
+ ***/
+static void * shared_advance(const set * group, set_iterator * iterator)
+{
+  shmstore * store = group->storage;
+  shmhead * head = head_of(store);
+  void * data = NULL;
+  pthread_rwlock_rdlock(&head->lock);
+  while (data == NULL && (uint64_t)++iterator->index < head->fresh) {
+    const shmentry * entry = at(store, offset_of(store, iterator->index));
+    if (entry->live)
+      data = memcpy(store->scratch, record_of(entry), head->width);
+  }
+  pthread_rwlock_unlock(&head->lock);
+  return data;
+}
+
+/******************************************************************************
+ * FUNCTION:	    shared_clear
+ *
+ * DESCRIPTION:	    clear primitive of the shared engine. Unmaps the segment
+ *		    from this process; its members stay in it.
+ *
+ * ARGUMENTS:	    group: (set *) -- the set to be operated on.
+ *
+ * RETURN:	    void.
+ *
+ * NOTES:	    O(1)
+ ***/
+static void shared_clear(set * group)
+{
+  if (group->storage != NULL)
+    close_store(group->storage);
+  group->storage = NULL;
+  group->size = 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    shared_like
+ *
+ * DESCRIPTION:	    like primitive of the shared engine. Gives the set private
+ *		    storage, for records of the same width, with room for as
+ *		    many members as the model.
+ *
+ * ARGUMENTS:	    group: (set *) -- the new, empty set.
+ *		    model: (const set *) -- the set to imitate.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    O(1)
+ ***/
+static int shared_like(set * group, const set * model)
+{
+  const shmhead * head = head_of((const shmstore *)model->storage);
+  if ((group->storage = open_private(head->width, head->capacity)) == NULL)
+    return -1;
+  return 0;
+}
+
+/*****************************************************************************/
@@ -0,0 +1,49 @@
+/******************************************************************************
+ * NAME:	    shmset.h
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    The header file for the shared set engine, which keeps the
+ *		    members of a set in a POSIX shared memory segment, so that
+ *		    several processes on a host can use one copy of it. A
+ *		    shared set is an ordinary set (set.h) of fixed-size
+ *		    records, stored by value. One process creates the segment
+ *		    and fills it; the others attach to it by name and query
+ *		    it in place, without copying. Links inside the segment
+ *		    are offsets from its start, so it may be mapped at any
+ *		    address, and a process-shared lock in the segment lets
+ *		    any of them insert and remove as well.
+ *
+ * CREATED:	    10/17/2026
+ *
+ * LAST EDITED:	    10/17/2026
+ ***/
+
+#ifndef __ET_SHMSET_H__
+#define __ET_SHMSET_H__
+
+#include <stddef.h>
+
+#include "set.h"
+
+/******************************************************************************
+ * API FUNCTION PROTOTYPES
+ ***/
+
+extern set * set_create_shared(int (*match)(const void *, const void *),
+			       unsigned long (*hash)(const void *),
+			       void * (*copy)(const void *),
+			       void (*destroy)(void *),
+			       size_t width, const char * name,
+			       size_t capacity);
+extern set * set_attach_shared(int (*match)(const void *, const void *),
+			       unsigned long (*hash)(const void *),
+			       void * (*copy)(const void *),
+			       void (*destroy)(void *),
+			       const char * name);
+extern int set_shared_refresh(set * set);
+extern int set_shared_unlink(const char * name);
+
+#endif /* __ET_SHMSET_H__ */
+
+/*****************************************************************************/
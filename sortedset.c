@@ -0,0 +1,1149 @@
+/******************************************************************************
+ * NAME:	    sortedset.c
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    Source file containing the sorted set engine. Members are
+ *		    records of a fixed width, kept by value in the leaves of a
+ *		    B+ tree. Every node is a few cache lines, aligned to a
+ *		    line, and holds its records (or, in an inner node, its
+ *		    separators) in one contiguous sorted array, so a lookup
+ *		    costs a binary search in one small array per level and
+ *		    the tree stays shallow. The leaves are linked in order,
+ *		    for iteration and for the merges of combine, which build
+ *		    their result leaf by leaf and put the index over it last.
+ *
+ * CREATED:	    10/17/2026
+ *
+ * LAST EDITED:	    10/17/2026
+ ***/
+
+/******************************************************************************
+ * INCLUDES
+ ***/
+
+/* For posix_memalign. */
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "set.h"
+#include "setengine.h"
+#include "sortedset.h"
+
+/******************************************************************************
+ * MACRO DEFINITIONS
+ ***/
+
+/* The most levels of inner nodes. */
+#define SORTEDSET_DEPTH 32
+/* Every node has room for at least this many records, or children. */
+#define SORTEDSET_MIN 4
+/* The number of sets a merge follows without allocating. */
+#define SORTEDSET_LOCAL 16
+
+#define NODE_HEAD (sizeof(sortednode))
+#define NODE_BYTES (CONFIG_SORTEDSET_LINE * CONFIG_SORTEDSET_LINES)
+
+#define record_of(store, node, i)				\
+  ((node)->data + (size_t)(i) * (store)->width)
+#define children_of(node) ((sortednode **)(node)->data)
+#define key_of(store, node, i)					\
+  ((node)->data + (store)->fanout * sizeof(sortednode *)	\
+   + (size_t)(i) * (store)->width)
+/* The smallest record under a node, as far as its parent knows. */
+#define least_of(store, node)					\
+  ((node)->leaf ? record_of(store, node, 0) : key_of(store, node, 0))
+
+/******************************************************************************
+ * TYPE DEFINITIONS
+ ***/
+
+/* A node of the tree. A leaf holds `count' records in order. An inner node
+ * holds `count' children, then room for as many separators: key i is no
+ * greater than any record under child i, and greater than every record under
+ * child i - 1. Key 0 is only a lower bound for the node as a whole, and is
+ * not kept up to date. Leaves are linked in order by prev and next; inner
+ * nodes use next only while an index is built. */
+typedef struct _sortednode_ {
+
+  int leaf;
+  int count;
+  struct _sortednode_ * prev;
+  struct _sortednode_ * next;
+  unsigned char data[];
+
+} sortednode;
+
+/* The storage of a sorted set. `scratch' holds the member returned by the
+ * last call to remove. */
+typedef struct {
+
+  size_t width;
+  int capacity;
+  int fanout;
+  size_t leafbytes;
+  size_t innerbytes;
+
+  int depth;
+  sortednode * root;
+  sortednode * first;
+  sortednode * last;
+  long leaves;
+  long inners;
+
+  unsigned char * scratch;
+
+} sortedstore;
+
+/******************************************************************************
+ * LOCAL PROTOTYPES
+ ***/
+
+static sortedstore * open_store(size_t);
+static void close_store(sortedstore *);
+static sortednode * new_node(sortedstore *, int);
+static int reserve(sortedstore *, sortednode * [], int);
+static int lower_bound(const set *, const sortednode *, const void *, int *);
+static int child_of(const set *, const sortednode *, const void *);
+static sortednode * descend(const set *, const void *, sortednode * [],
+			    int []);
+static void put(sortedstore *, sortednode *, int, const void *,
+		sortednode *);
+static void split(sortedstore *, sortednode *, int, sortednode *);
+static void promote(sortedstore *, sortednode * [], int [], int,
+		    const void *, sortednode *, sortednode * []);
+static void unlink_leaf(sortedstore *, sortednode *);
+static void drop(sortedstore *, sortednode * [], int [], int);
+static int append(sortedstore *, const void *);
+static int build_index(sortedstore *);
+static int merge(set *, int, set * [], int);
+static int gather(set *, int, set * [], int);
+
+static int sorted_ismember(const set *, const void *);
+static int sorted_insert(set *, void *);
+static void * sorted_remove(set *, const void *);
+static void * sorted_begin(const set *, set_iterator *);
+static void * sorted_advance(const set *, set_iterator *);
+static void sorted_clear(set *);
+static int sorted_like(set *, const set *);
+static int sorted_combine(set *, int, set * []);
+
+/******************************************************************************
+ * ENGINES
+ ***/
+
+const set_engine set_sorted_engine = {
+  .name = "sorted",
+  .ismember = sorted_ismember,
+  .insert = sorted_insert,
+  .remove = sorted_remove,
+  .begin = sorted_begin,
+  .advance = sorted_advance,
+  .clear = sorted_clear,
+  .like = sorted_like,
+  .combine = sorted_combine,
+  .byvalue = 1
+};
+
+/******************************************************************************
+ * API FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:	    set_create_sorted
+ *
+ * DESCRIPTION:	    Creates an empty sorted set.
+ *
+ * ARGUMENTS:	    compare: (int (*)(const void *, const void *)) -- orders
+ *			two records, returning a negative number, zero or a
+ *			positive number if the first is less than, equal to or
+ *			greater than the second.
+ *		    copy, destroy: as in set_create (set.h). They are called
+ *			on records of `width' bytes.
+ *		    width: (size_t) -- the size of a member, in bytes.
+ *
+ * RETURN:	    (set *) -- pointer to the set, or NULL.
+ *
+ * NOTES:	    O(1). As with a disk set (diskset.h), set_insert stores a
+ *		    copy of the record and destroys the one it was given, and
+ *		    the data returned by set_remove are only valid until the
+ *		    next call on the set. The iterators return members in
+ *		    order. The compare function is kept in the match field of
+ *		    the set.
+ ***/
+set * set_create_sorted(int (*compare)(const void *, const void *),
+			void * (*copy)(const void *),
+			void (*destroy)(void *), size_t width)
+{
+  if (compare == NULL || width == 0)
+    return NULL;
+
+  set * group = NULL;
+  if ((group = set_create_engine(&set_sorted_engine, compare, NULL, copy,
+				 destroy)) == NULL)
+    return NULL;
+
+  if ((group->storage = open_store(width)) == NULL) {
+    free(group);
+    return NULL;
+  }
+
+  return group;
+}
+
+/******************************************************************************
+ * FUNCTION:	    set_sorted_stats
+ *
+ * DESCRIPTION:	    Reports the shape of a sorted set.
+ *
+ * ARGUMENTS:	    group: (const set *) -- the set to be operated on.
+ *		    stats: (sortedset_stats *) -- will contain the statistics.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    O(1)
+ ***/
+int set_sorted_stats(const set * group, sortedset_stats * stats)
+{
+  if (group == NULL || stats == NULL || group->engine != &set_sorted_engine)
+    return -1;
+
+  const sortedstore * store = group->storage;
+  *stats = (sortedset_stats){
+    .depth = store->depth,
+    .leaves = store->leaves,
+    .inners = store->inners,
+    .capacity = store->capacity,
+    .bytes = (unsigned long long)store->leaves * store->leafbytes
+    + (unsigned long long)store->inners * store->innerbytes
+  };
+  return 0;
+}
+
+/******************************************************************************
+ * LOCAL FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:	    open_store
+ *
+ * DESCRIPTION:	    Creates the storage of an empty sorted set, sizing its
+ *		    nodes to whole cache lines.
+ *
+ * ARGUMENTS:	    width: (size_t) -- the size of a record.
+ *
+ * RETURN:	    sortedstore * -- the storage, or NULL.
+ *
+ * NOTES:	    O(1). The tree itself is made by the first insert.
+ ***/
+static sortedstore * open_store(size_t width)
+{
+  sortedstore * store = NULL;
+  if ((store = malloc(sizeof(sortedstore) + width)) == NULL)
+    return NULL;
+
+  size_t capacity = (NODE_BYTES - NODE_HEAD) / width;
+  size_t fanout = (NODE_BYTES - NODE_HEAD) / (width + sizeof(sortednode *));
+  if (capacity < SORTEDSET_MIN)
+    capacity = SORTEDSET_MIN;
+  if (fanout < SORTEDSET_MIN)
+    fanout = SORTEDSET_MIN;
+
+  size_t line = CONFIG_SORTEDSET_LINE;
+  *store = (sortedstore){
+    .width = width,
+    .capacity = (int)capacity,
+    .fanout = (int)fanout,
+    .leafbytes = (NODE_HEAD + capacity * width + line - 1) / line * line,
+    .innerbytes = (NODE_HEAD + fanout * (width + sizeof(sortednode *))
+		   + line - 1) / line * line,
+    .depth = 0,
+    .root = NULL,
+    .first = NULL,
+    .last = NULL,
+    .leaves = 0,
+    .inners = 0,
+    .scratch = (unsigned char *)(store + 1)
+  };
+
+  return store;
+}
+
+/******************************************************************************
+ * FUNCTION:	    close_store
+ *
+ * DESCRIPTION:	    Frees every node of a sorted set, and its storage.
+ *
+ * ARGUMENTS:	    store: (sortedstore *) -- the storage.
+ *
+ * RETURN:	    void.
+ *
+ * NOTES:	    O(n / capacity). The inner nodes are freed a level at a
+ *		    time, from the root down; the leaves along their links.
+ ***/
+static void close_store(sortedstore * store)
+{
+  sortednode * row[2] = {NULL, NULL};
+  if (store->root != NULL && !store->root->leaf) {
+    row[0] = store->root;
+    row[0]->next = NULL;
+  }
+
+  while (row[0] != NULL) {
+    row[1] = NULL;
+    for (sortednode * node = row[0], * next = NULL; node != NULL;
+	 node = next) {
+      next = node->next;
+      for (int i = 0; i < node->count; i++) {
+	sortednode * child = children_of(node)[i];
+	if (!child->leaf) {
+	  child->next = row[1];
+	  row[1] = child;
+	}
+      }
+      free(node);
+    }
+    row[0] = row[1];
+  }
+
+  for (sortednode * leaf = store->first, * next = NULL; leaf != NULL;
+       leaf = next) {
+    next = leaf->next;
+    free(leaf);
+  }
+  free(store);
+}
+
+/******************************************************************************
+ * FUNCTION:	    new_node
+ *
+ * DESCRIPTION:	    Allocates an empty node, aligned to a cache line.
+ *
+ * ARGUMENTS:	    store: (sortedstore *) -- the storage.
+ *		    leaf: (int) -- 1 for a leaf, 0 for an inner node.
+ *
+ * RETURN:	    sortednode * -- the node, or NULL.
+ *
+ * NOTES:	    The node is not counted, or linked, until it is used.
+ ***/
+static sortednode * new_node(sortedstore * store, int leaf)
+{
+  void * node = NULL;
+  if (posix_memalign(&node, CONFIG_SORTEDSET_LINE,
+		     leaf ? store->leafbytes : store->innerbytes))
+    return NULL;
+
+  *(sortednode *)node = (sortednode){
+    .leaf = leaf,
+    .count = 0,
+    .prev = NULL,
+    .next = NULL
+  };
+  return node;
+}
+
+/******************************************************************************
+ * FUNCTION:	    reserve
+ *
+ * DESCRIPTION:	    Allocates the nodes an insert into a full leaf needs
+ *		    before changing anything, so that it cannot fail halfway.
+ *
+ * ARGUMENTS:	    store: (sortedstore *) -- the storage.
+ *		    spare: (sortednode * []) -- will contain a leaf, then
+ *			inner nodes.
+ *		    count: (int) -- the number of nodes.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise, having freed any
+ *		    nodes it allocated.
+ *
+ * NOTES:	    O(count)
+ ***/
+static int reserve(sortedstore * store, sortednode * spare[], int count)
+{
+  for (int i = 0; i < count; i++) {
+    if ((spare[i] = new_node(store, i == 0)) == NULL) {
+      while (i-- > 0)
+	free(spare[i]);
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    lower_bound
+ *
+ * DESCRIPTION:	    Binary search of a leaf for the first record that is not
+ *		    less than `data'.
+ *
+ * ARGUMENTS:	    group: (const set *) -- the set.
+ *		    leaf: (const sortednode *) -- the leaf.
+ *		    data: (const void *) -- the record to look for.
+ *		    found: (int *) -- will contain 1 if the record at the
+ *			position is equal to `data', 0 otherwise.
+ *
+ * RETURN:	    int -- the position, between 0 and the count of the leaf.
+ *
+ * NOTES:	    O(log capacity). The records are contiguous, so the
+ *		    search touches the few lines of one node.
+ ***/
+static int lower_bound(const set * group, const sortednode * leaf,
+		       const void * data, int * found)
+{
+  const sortedstore * store = group->storage;
+  int low = 0, high = leaf->count;
+  while (low < high) {
+    int middle = low + (high - low) / 2;
+    if (group->match(record_of(store, leaf, middle), data) < 0)
+      low = middle + 1;
+    else
+      high = middle;
+  }
+
+  *found = low < leaf->count
+    && group->match(record_of(store, leaf, low), data) == 0;
+  return low;
+}
+
+/******************************************************************************
+ * FUNCTION:	    child_of
+ *
+ * DESCRIPTION:	    Binary search of the separators of an inner node for the
+ *		    child that would hold `data'.
+ *
+ * ARGUMENTS:	    group: (const set *) -- the set.
+ *		    node: (const sortednode *) -- an inner node.
+ *		    data: (const void *) -- the record to look for.
+ *
+ * RETURN:	    int -- the position of the child.
+ *
+ * NOTES:	    O(log fanout)
+ ***/
+static int child_of(const set * group, const sortednode * node,
+		    const void * data)
+{
+  const sortedstore * store = group->storage;
+  int low = 1, high = node->count;
+  while (low < high) {
+    int middle = low + (high - low) / 2;
+    if (group->match(key_of(store, node, middle), data) <= 0)
+      low = middle + 1;
+    else
+      high = middle;
+  }
+
+  return low - 1;
+}
+
+/******************************************************************************
+ * FUNCTION:	    descend
+ *
+ * DESCRIPTION:	    Finds the leaf that holds, or would hold, `data'.
+ *
+ * ARGUMENTS:	    group: (const set *) -- a set with a tree.
+ *		    data: (const void *) -- the record to look for.
+ *		    path: (sortednode * []) -- will contain the inner nodes
+ *			passed, from the root down. May be NULL.
+ *		    slots: (int []) -- will contain the child taken in each.
+ *
+ * RETURN:	    sortednode * -- the leaf.
+ *
+ * NOTES:	    O(depth log fanout)
+ ***/
+static sortednode * descend(const set * group, const void * data,
+			    sortednode * path[], int slots[])
+{
+  const sortedstore * store = group->storage;
+  sortednode * node = store->root;
+  for (int level = 0; !node->leaf; level++) {
+    int slot = child_of(group, node, data);
+    if (path != NULL) {
+      path[level] = node;
+      slots[level] = slot;
+    }
+    node = children_of(node)[slot];
+  }
+
+  return node;
+}
+
+/******************************************************************************
+ * FUNCTION:	    put
+ *
+ * DESCRIPTION:	    Inserts a record into a leaf, or a separator and a child
+ *		    into an inner node, that has room for it.
+ *
+ * ARGUMENTS:	    store: (sortedstore *) -- the storage.
+ *		    node: (sortednode *) -- the node.
+ *		    pos: (int) -- the position.
+ *		    key: (const void *) -- the record, or the separator.
+ *		    child: (sortednode *) -- the child, for an inner node.
+ *
+ * RETURN:	    void.
+ *
+ * NOTES:	    O(capacity)
+ ***/
+static void put(sortedstore * store, sortednode * node, int pos,
+		const void * key, sortednode * child)
+{
+  size_t after = (size_t)(node->count - pos);
+  if (node->leaf) {
+    memmove(record_of(store, node, pos + 1), record_of(store, node, pos),
+	    after * store->width);
+    memcpy(record_of(store, node, pos), key, store->width);
+  } else {
+    memmove(children_of(node) + pos + 1, children_of(node) + pos,
+	    after * sizeof(sortednode *));
+    memmove(key_of(store, node, pos + 1), key_of(store, node, pos),
+	    after * store->width);
+    children_of(node)[pos] = child;
+    memcpy(key_of(store, node, pos), key, store->width);
+  }
+
+  node->count++;
+}
+
+/******************************************************************************
+ * FUNCTION:	    split
+ *
+ * DESCRIPTION:	    Moves the upper entries of a full node into an empty one,
+ *		    which follows it.
+ *
+ * ARGUMENTS:	    store: (sortedstore *) -- the storage.
+ *		    node: (sortednode *) -- the full node.
+ *		    pos: (int) -- the position of the entry about to be put.
+ *		    right: (sortednode *) -- the new node, from reserve.
+ *
+ * RETURN:	    void.
+ *
+ * NOTES:	    O(capacity). A node is split in half, unless the new entry
+ *		    goes at its end: then the new node gets only that entry,
+ *		    so that members inserted in order fill their leaves.
+ ***/
+static void split(sortedstore * store, sortednode * node, int pos,
+		  sortednode * right)
+{
+  int half = pos == node->count ? node->count : node->count / 2;
+  right->leaf = node->leaf;
+  right->count = node->count - half;
+
+  if (node->leaf) {
+    memcpy(right->data, record_of(store, node, half),
+	   (size_t)right->count * store->width);
+    right->prev = node;
+    right->next = node->next;
+    if (node->next != NULL)
+      node->next->prev = right;
+    else
+      store->last = right;
+    node->next = right;
+    store->leaves++;
+  } else {
+    memcpy(children_of(right), children_of(node) + half,
+	   (size_t)right->count * sizeof(sortednode *));
+    memcpy(key_of(store, right, 0), key_of(store, node, half),
+	   (size_t)right->count * store->width);
+    store->inners++;
+  }
+
+  node->count = half;
+}
+
+/******************************************************************************
+ * FUNCTION:	    promote
+ *
+ * DESCRIPTION:	    Inserts a new node into its parent, after the child that
+ *		    was split to make it, splitting full parents on the way
+ *		    up and growing a new root if the old one was full.
+ *
+ * ARGUMENTS:	    store: (sortedstore *) -- the storage.
+ *		    path, slots: (sortednode * [], int []) -- from descend.
+ *		    level: (int) -- the level of the parent, or -1.
+ *		    key: (const void *) -- the separator of the new node.
+ *		    child: (sortednode *) -- the new node.
+ *		    spare: (sortednode * []) -- enough inner nodes, from
+ *			reserve.
+ *
+ * RETURN:	    void.
+ *
+ * NOTES:	    O(depth fanout)
+ ***/
+static void promote(sortedstore * store, sortednode * path[], int slots[],
+		    int level, const void * key, sortednode * child,
+		    sortednode * spare[])
+{
+  for (; level >= 0; level--) {
+    sortednode * node = path[level];
+    int pos = slots[level] + 1;
+    if (node->count < store->fanout) {
+      put(store, node, pos, key, child);
+      return;
+    }
+
+    sortednode * right = *spare++;
+    split(store, node, pos, right);
+    if (pos >= node->count)
+      put(store, right, pos - node->count, key, child);
+    else
+      put(store, node, pos, key, child);
+    key = key_of(store, right, 0);
+    child = right;
+  }
+
+  sortednode * root = *spare;
+  root->leaf = 0;
+  root->count = 2;
+  children_of(root)[0] = store->root;
+  children_of(root)[1] = child;
+  memcpy(key_of(store, root, 0), least_of(store, store->root), store->width);
+  memcpy(key_of(store, root, 1), key, store->width);
+  store->root = root;
+  store->depth++;
+  store->inners++;
+}
+
+/******************************************************************************
+ * FUNCTION:	    unlink_leaf
+ *
+ * DESCRIPTION:	    Takes a leaf out of the list of leaves, and frees it.
+ *
+ * ARGUMENTS:	    store: (sortedstore *) -- the storage.
+ *		    leaf: (sortednode *) -- a leaf that is not the only one.
+ *
+ * RETURN:	    void.
+ *
+ * NOTES:	    O(1). Its parent still points to it: see drop.
+ ***/
+static void unlink_leaf(sortedstore * store, sortednode * leaf)
+{
+  if (leaf->prev != NULL)
+    leaf->prev->next = leaf->next;
+  else
+    store->first = leaf->next;
+  if (leaf->next != NULL)
+    leaf->next->prev = leaf->prev;
+  else
+    store->last = leaf->prev;
+
+  free(leaf);
+  store->leaves--;
+}
+
+/******************************************************************************
+ * FUNCTION:	    drop
+ *
+ * DESCRIPTION:	    Removes a child from its parent, which is freed in turn if
+ *		    it is left empty, and then shortens the tree while the
+ *		    root has one child.
+ *
+ * ARGUMENTS:	    store: (sortedstore *) -- the storage.
+ *		    path, slots: (sortednode * [], int []) -- from descend,
+ *			with slots[level] the child to remove.
+ *		    level: (int) -- the level of the parent.
+ *
+ * RETURN:	    void.
+ *
+ * NOTES:	    O(depth fanout)
+ ***/
+static void drop(sortedstore * store, sortednode * path[], int slots[],
+		 int level)
+{
+  for (; level >= 0; level--) {
+    sortednode * node = path[level];
+    int slot = slots[level];
+    size_t after = (size_t)(node->count - slot - 1);
+    memmove(children_of(node) + slot, children_of(node) + slot + 1,
+	    after * sizeof(sortednode *));
+    memmove(key_of(store, node, slot), key_of(store, node, slot + 1),
+	    after * store->width);
+    if (--node->count > 0)
+      break;
+
+    free(node);
+    store->inners--;
+  }
+
+  while (!store->root->leaf && store->root->count == 1) {
+    sortednode * root = store->root;
+    store->root = children_of(root)[0];
+    free(root);
+    store->inners--;
+    store->depth--;
+  }
+}
+
+/******************************************************************************
+ * FUNCTION:	    append
+ *
+ * DESCRIPTION:	    Adds a record after every other in the leaves, without
+ *		    touching the index.
+ *
+ * ARGUMENTS:	    store: (sortedstore *) -- storage without an index.
+ *		    data: (const void *) -- a record greater than every other.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    O(1). The leaves are filled, and build_index must be
+ *		    called once the last record is appended.
+ ***/
+static int append(sortedstore * store, const void * data)
+{
+  sortednode * leaf = store->last;
+  if (leaf == NULL || leaf->count == store->capacity) {
+    if ((leaf = new_node(store, 1)) == NULL)
+      return -1;
+    leaf->prev = store->last;
+    if (store->last != NULL)
+      store->last->next = leaf;
+    else
+      store->first = leaf;
+    store->last = leaf;
+    store->leaves++;
+  }
+
+  memcpy(record_of(store, leaf, leaf->count++), data, store->width);
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    build_index
+ *
+ * DESCRIPTION:	    Puts an index over the leaves of a set that has none, a
+ *		    level at a time, filling each inner node.
+ *
+ * ARGUMENTS:	    store: (sortedstore *) -- storage without an index.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise, having freed the
+ *		    inner nodes it made.
+ *
+ * NOTES:	    O(n / capacity)
+ ***/
+static int build_index(sortedstore * store)
+{
+  if (store->first == NULL)
+    return 0;
+
+  sortednode * rows[SORTEDSET_DEPTH + 1] = {NULL};
+  sortednode * row = store->first;
+  long count = store->leaves;
+  int depth = 0;
+  while (count > 1) {
+    if (depth == SORTEDSET_DEPTH)
+      goto error_exception;
+
+    sortednode * tail = NULL;
+    count = 0;
+    for (sortednode * child = row; child != NULL; count++) {
+      sortednode * node = NULL;
+      if ((node = new_node(store, 0)) == NULL)
+	goto error_exception;
+      if (tail != NULL)
+	tail->next = node;
+      else
+	rows[depth] = node;
+      tail = node;
+
+      for (; child != NULL && node->count < store->fanout;
+	   child = child->next) {
+	children_of(node)[node->count] = child;
+	memcpy(key_of(store, node, node->count), least_of(store, child),
+	       store->width);
+	node->count++;
+      }
+    }
+
+    store->inners += count;
+    row = rows[depth++];
+  }
+
+  store->root = row;
+  store->depth = depth;
+  return 0;
+
+ error_exception: {
+    for (int i = 0; i <= depth; i++) {
+      for (sortednode * node = rows[i], * next = NULL; node != NULL;
+	   node = next) {
+	next = node->next;
+	free(node);
+      }
+    }
+    store->inners = 0;
+    return -1;
+  }
+}
+
+/******************************************************************************
+ * FUNCTION:	    merge
+ *
+ * DESCRIPTION:	    combine of sorted sets that share a compare function and
+ *		    a width. Walks the leaves of every set at once, in order,
+ *		    and appends each record held by at least k of them.
+ *
+ * ARGUMENTS:	    setk: (set *) -- the empty result.
+ *		    k: (int) -- the threshold.
+ *		    sets: (set * []) -- the sets.
+ *		    n: (int) -- the number of sets.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    O(Nn) comparisons for N members in total, with every leaf
+ *		    read once, front to back. The result is built without
+ *		    an index, which is added at the end.
+ ***/
+static int merge(set * setk, int k, set * sets[], int n)
+{
+  set_iterator local[SORTEDSET_LOCAL], * iterators = local;
+  const void * heads[SORTEDSET_LOCAL], ** current = heads;
+  if (n > SORTEDSET_LOCAL
+      && ((iterators = malloc(n * sizeof(set_iterator))) == NULL
+	  || (current = malloc(n * sizeof(void *))) == NULL)) {
+    if (iterators != local)
+      free(iterators);
+    return -1;
+  }
+
+  for (int i = 0; i < n; i++)
+    current[i] = sorted_begin(sets[i], &iterators[i]);
+
+  int ret = 0;
+  for (;;) {
+    const void * least = NULL;
+    for (int i = 0; i < n; i++)
+      if (current[i] != NULL
+	  && (least == NULL || setk->match(current[i], least) < 0))
+	least = current[i];
+    if (least == NULL)
+      break;
+
+    /* Advancing a set does not move its records, so `least' stays good. */
+    int count = 0;
+    for (int i = 0; i < n; i++) {
+      if (current[i] != NULL && setk->match(current[i], least) == 0) {
+	current[i] = sorted_advance(sets[i], &iterators[i]);
+	count++;
+      }
+    }
+
+    if (count >= k) {
+      if ((ret = append(setk->storage, least)) != 0)
+	break;
+      setk->size++;
+    }
+  }
+
+  if (ret == 0)
+    ret = build_index(setk->storage);
+  if (iterators != local) {
+    free(iterators);
+    free(current);
+  }
+  return ret;
+}
+
+/******************************************************************************
+ * FUNCTION:	    gather
+ *
+ * DESCRIPTION:	    combine of a sorted set with sets of other engines, or of
+ *		    other orders. Each candidate is looked up in the other
+ *		    sets, and inserted if it is found in enough of them.
+ *
+ * ARGUMENTS:	    setk: (set *) -- the empty result.
+ *		    k: (int) -- the threshold.
+ *		    sets: (set * []) -- the sets.
+ *		    n: (int) -- the number of sets.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    O(Nn) lookups. A candidate from set i that is in an earlier
+ *		    set has been counted already.
+ ***/
+static int gather(set * setk, int k, set * sets[], int n)
+{
+  for (int i = 0; i <= n - k; i++) {
+    set_iterator iterator;
+    for (void * data = set_begin(sets[i], &iterator); data != NULL;
+	 data = set_advance(sets[i], &iterator)) {
+      int count = 1, seen = 0;
+      for (int j = 0; j < n && !seen; j++) {
+	if (j != i && set_ismember(sets[j], data)) {
+	  seen = j < i;
+	  count++;
+	}
+      }
+      if (seen || count < k)
+	continue;
+      if (sorted_insert(setk, data) < 0)
+	return -1;
+    }
+  }
+
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    sorted_ismember
+ *
+ * DESCRIPTION:	    ismember primitive of the sorted engine.
+ *
+ * ARGUMENTS:	    group: (const set *) -- the set to be operated on.
+ *		    data: (const void *) -- the record to check.
+ *
+ * RETURN:	    int -- 1 if the member is in the set, 0 if it is not.
+ *
+ * NOTES:	    O(log n), one node per level.
+ ***/
+static int sorted_ismember(const set * group, const void * data)
+{
+  const sortedstore * store = group->storage;
+  if (store->root == NULL)
+    return 0;
+
+  int found = 0;
+  lower_bound(group, descend(group, data, NULL, NULL), data, &found);
+  return found;
+}
+
+/******************************************************************************
+ * FUNCTION:	    sorted_insert
+ *
+ * DESCRIPTION:	    insert primitive of the sorted engine. Copies the record
+ *		    into its leaf, splitting the leaf if it is full.
+ *
+ * ARGUMENTS:	    group: (set *) -- the set to be operated on.
+ *		    data: (void *) -- the record to insert.
+ *
+ * RETURN:	    int -- 0 if the record was inserted, 1 if it is already a
+ *		    member, -1 otherwise.
+ *
+ * NOTES:	    O(log n + capacity). The nodes a split needs are allocated
+ *		    first, so on failure the set is unchanged.
+ ***/
+static int sorted_insert(set * group, void * data)
+{
+  sortedstore * store = group->storage;
+  if (store->root == NULL) {
+    if ((store->root = new_node(store, 1)) == NULL)
+      return -1;
+    store->first = store->last = store->root;
+    store->leaves = 1;
+  }
+
+  sortednode * path[SORTEDSET_DEPTH];
+  int slots[SORTEDSET_DEPTH];
+  sortednode * leaf = descend(group, data, path, slots);
+  int found = 0;
+  int pos = lower_bound(group, leaf, data, &found);
+  if (found)
+    return 1;
+
+  if (leaf->count < store->capacity) {
+    put(store, leaf, pos, data, NULL);
+    group->size++;
+    return 0;
+  }
+
+  int needed = 1, level = store->depth - 1;
+  for (; level >= 0 && path[level]->count == store->fanout; level--)
+    needed++;
+  if (level < 0 && store->depth == SORTEDSET_DEPTH)
+    return -1;
+  if (level < 0)
+    needed++;
+
+  sortednode * spare[SORTEDSET_DEPTH + 2];
+  if (reserve(store, spare, needed))
+    return -1;
+
+  sortednode * right = spare[0];
+  split(store, leaf, pos, right);
+  if (pos >= leaf->count)
+    put(store, right, pos - leaf->count, data, NULL);
+  else
+    put(store, leaf, pos, data, NULL);
+  promote(store, path, slots, store->depth - 1, record_of(store, right, 0),
+	  right, spare + 1);
+
+  group->size++;
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    sorted_remove
+ *
+ * DESCRIPTION:	    remove primitive of the sorted engine. A leaf that is
+ *		    emptied is freed, and one that is left less than half
+ *		    full together with the next leaf under the same parent
+ *		    takes in the records of that leaf.
+ *
+ * ARGUMENTS:	    group: (set *) -- the set to be operated on.
+ *		    data: (const void *) -- the record to remove.
+ *
+ * RETURN:	    void * -- a copy of the member, valid until the next call
+ *		    on the set, or NULL.
+ *
+ * NOTES:	    O(log n + capacity)
+ ***/
+static void * sorted_remove(set * group, const void * data)
+{
+  sortedstore * store = group->storage;
+  if (store->root == NULL)
+    return NULL;
+
+  sortednode * path[SORTEDSET_DEPTH];
+  int slots[SORTEDSET_DEPTH];
+  sortednode * leaf = descend(group, data, path, slots);
+  int found = 0;
+  int pos = lower_bound(group, leaf, data, &found);
+  if (!found)
+    return NULL;
+
+  memcpy(store->scratch, record_of(store, leaf, pos), store->width);
+  memmove(record_of(store, leaf, pos), record_of(store, leaf, pos + 1),
+	  (size_t)(leaf->count - pos - 1) * store->width);
+  leaf->count--;
+  group->size--;
+
+  int level = store->depth - 1;
+  if (level < 0)
+    return store->scratch;
+
+  sortednode * right = leaf->next;
+  if (leaf->count == 0) {
+    unlink_leaf(store, leaf);
+    drop(store, path, slots, level);
+  } else if (slots[level] + 1 < path[level]->count
+	     && leaf->count + right->count <= store->capacity / 2) {
+    memcpy(record_of(store, leaf, leaf->count), right->data,
+	   (size_t)right->count * store->width);
+    leaf->count += right->count;
+    unlink_leaf(store, right);
+    slots[level]++;
+    drop(store, path, slots, level);
+  }
+
+  return store->scratch;
+}
+
+/******************************************************************************
+ * FUNCTION:	    sorted_begin
+ *
+ * DESCRIPTION:	    begin primitive of the sorted engine.
+ *
+ * ARGUMENTS:	    group: (const set *) -- the set to be operated on.
+ *		    iterator: (set_iterator *) -- will contain the position.
+ *
+ * RETURN:	    void * -- the least member, or NULL.
+ *
+ * NOTES:	    O(1). The iterator holds the current leaf, and the
+ *		    position in it.
+ ***/
+static void * sorted_begin(const set * group, set_iterator * iterator)
+{
+  const sortedstore * store = group->storage;
+  iterator->node = store->first;
+  iterator->index = -1;
+  return sorted_advance(group, iterator);
+}
+
+/******************************************************************************
+ * FUNCTION:	    sorted_advance
+ *
+ * DESCRIPTION:	    advance primitive of the sorted engine. The leaves are
+ *		    visited from left to right, so members come in order.
+ *
+ * ARGUMENTS:	    group: (const set *) -- the set to be operated on.
+ *		    iterator: (set_iterator *) -- the position.
+ *
+ * RETURN:	    void * -- the next member, in its leaf, or NULL at the end.
+ *
+ * NOTES:	    O(1)
+ ***/
+static void * sorted_advance(const set * group, set_iterator * iterator)
+{
+  const sortedstore * store = group->storage;
+  sortednode * leaf = iterator->node;
+  iterator->index++;
+  while (leaf != NULL && iterator->index >= leaf->count) {
+    leaf = leaf->next;
+    iterator->index = 0;
+  }
+
+  iterator->node = leaf;
+  return leaf == NULL ? NULL : record_of(store, leaf, iterator->index);
+}
+
+/******************************************************************************
+ * FUNCTION:	    sorted_clear
+ *
+ * DESCRIPTION:	    clear primitive of the sorted engine.
+ *
+ * ARGUMENTS:	    group: (set *) -- the set to be operated on.
+ *
+ * RETURN:	    void.
+ *
+ * NOTES:	    O(n / capacity). The records belong to the set, so destroy
+ *		    is not called on them.
+ ***/
+static void sorted_clear(set * group)
+{
+  if (group->storage == NULL)
+    return;
+
+  close_store(group->storage);
+  group->storage = NULL;
+  group->size = 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    sorted_like
+ *
+ * DESCRIPTION:	    like primitive of the sorted engine. Gives the set records
+ *		    of the same width as the model.
+ *
+ * ARGUMENTS:	    group: (set *) -- the empty set.
+ *		    model: (const set *) -- a sorted set.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    O(1)
+ ***/
+static int sorted_like(set * group, const set * model)
+{
+  const sortedstore * store = model->storage;
+  if ((group->storage = open_store(store->width)) == NULL)
+    return -1;
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    sorted_combine
+ *
+ * DESCRIPTION:	    combine primitive of the sorted engine. Sorted sets with
+ *		    the same order and width are merged; otherwise the other
+ *		    sets are searched.
+ *
+ * ARGUMENTS:	    setk: (set *) -- the empty result, like sets[0].
+ *		    k: (int) -- the threshold.
+ *		    sets: (set * []) -- NULL terminated array of sets.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    See merge and gather.
+ ***/
+static int sorted_combine(set * setk, int k, set * sets[])
+{
+  const sortedstore * store = setk->storage;
+  int n = 0, sorted = 1;
+  for (; sets[n] != NULL; n++)
+    sorted &= sets[n]->engine == &set_sorted_engine
+      && sets[n]->match == setk->match
+      && ((const sortedstore *)sets[n]->storage)->width == store->width;
+
+  return sorted ? merge(setk, k, sets, n) : gather(setk, k, sets, n);
+}
+
+/*****************************************************************************/
@@ -0,0 +1,72 @@
+/******************************************************************************
+ * NAME:	    sortedset.h
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    The header file for the sorted set engine, which keeps the
+ *		    members of a set in order, in memory laid out for the
+ *		    cache. A sorted set is an ordinary set (set.h): its
+ *		    members are fixed-size records, stored by value in sorted
+ *		    arrays of a few cache lines each (the leaves), under a
+ *		    shallow B+ tree index whose nodes are also arrays of
+ *		    records. A lookup reads one node per level, iteration
+ *		    walks the leaves from left to right, and set_union,
+ *		    set_intersection and set_threshold of sorted sets merge
+ *		    their leaves in a single streaming pass.
+ *
+ * CREATED:	    10/17/2026
+ *
+ * LAST EDITED:	    10/17/2026
+ ***/
+
+#ifndef __ET_SORTEDSET_H__
+#define __ET_SORTEDSET_H__
+
+#include <stddef.h>
+
+#include "set.h"
+
+/******************************************************************************
+ * CONFIGURATION
+ ***/
+
+/* The size of a cache line. Nodes are aligned to it. */
+#ifndef CONFIG_SORTEDSET_LINE
+#   define CONFIG_SORTEDSET_LINE 64
+#endif
+
+/* The size of a node, leaf or inner, in cache lines. Nodes are made larger
+ * only when a few records of the width asked for do not fit. */
+#ifndef CONFIG_SORTEDSET_LINES
+#   define CONFIG_SORTEDSET_LINES 4
+#endif
+
+/******************************************************************************
+ * TYPE DEFINITIONS
+ ***/
+
+/* The shape of a sorted set: the levels of inner nodes above the leaves, the
+ * number of each kind of node, the records a leaf holds, and the bytes of
+ * all of the nodes. */
+typedef struct {
+
+  int depth;
+  long leaves;
+  long inners;
+  int capacity;
+  unsigned long long bytes;
+
+} sortedset_stats;
+
+/******************************************************************************
+ * API FUNCTION PROTOTYPES
+ ***/
+
+extern set * set_create_sorted(int (*compare)(const void *, const void *),
+			       void * (*copy)(const void *),
+			       void (*destroy)(void *), size_t width);
+extern int set_sorted_stats(const set * set, sortedset_stats * stats);
+
+#endif /* __ET_SORTEDSET_H__ */
+
+/*****************************************************************************/
@@ -0,0 +1,679 @@
+/******************************************************************************
+ * NAME:	    stringset.c
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    Source file containing code for implementing a set of
+ *		    strings. Every distinct string is copied once into an
+ *		    arena, a single growing buffer, and the hash table holds
+ *		    its hash, length and offset in the arena. A lookup only
+ *		    touches the bytes of a string when both the hash and the
+ *		    length are equal. The table uses linear probing, and
+ *		    removal shifts the following entries back instead of
+ *		    leaving tombstones. This code follows the typedefs and
+ *		    prototypes in stringset.h.
+ *
+ * CREATED:	    10/17/2026
+ *
+ * LAST EDITED:	    10/17/2026
+ ***/
+
+/******************************************************************************
+ * INCLUDES
+ ***/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "stringset.h"
+
+/******************************************************************************
+ * MACRO DEFINITIONS
+ ***/
+
+#define STRINGSET_MIN_CAPACITY 16
+#define STRINGSET_MIN_ARENA 256
+
+#define slot_isempty(slot) ((slot)->offset == STRINGSET_EMPTY)
+
+/******************************************************************************
+ * LOCAL PROTOTYPES
+ ***/
+
+static stringentry * probe(const stringset *, unsigned long,
+			   const char *, size_t);
+static int place(stringset *, unsigned long, const char *, size_t);
+static int resize(stringset *, unsigned long);
+static int compact(stringset *);
+static unsigned long long load(const char *);
+
+/******************************************************************************
+ * API FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:	    stringset_create
+ *
+ * DESCRIPTION:	    Creates an empty string set.
+ *
+ * ARGUMENTS:	    none.
+ *
+ * RETURN:	    (stringset *) -- pointer to the new set, or NULL.
+ *
+ * NOTES:	    O(1)
+ ***/
+stringset * stringset_create(void)
+{
+  stringset * group = NULL;
+  if ((group = malloc(sizeof(stringset))) == NULL)
+    return NULL;
+
+  *group = (stringset){
+    .size = 0,
+    .capacity = 0,
+    .slots = NULL,
+    .arena = NULL,
+    .used = 0,
+    .dead = 0,
+    .reserved = 0
+  };
+
+  if (resize(group, STRINGSET_MIN_CAPACITY)) {
+    free(group);
+    return NULL;
+  }
+
+  return group;
+}
+
+/******************************************************************************
+ * FUNCTION:	    stringset_destroy
+ *
+ * DESCRIPTION:	    Frees the set, along with its copies of the strings.
+ *
+ * ARGUMENTS:	    group: (stringset **) -- the set to be operated on.
+ *
+ * RETURN:	    void.
+ *
+ * NOTES:	    O(1)
+ ***/
+void stringset_destroy(stringset ** group)
+{
+  if (group == NULL || *group == NULL)
+    return;
+
+  free((*group)->slots);
+  free((*group)->arena);
+  free(*group);
+  *group = NULL;
+}
+
+/******************************************************************************
+ * FUNCTION:	    stringset_ismember
+ *
+ * DESCRIPTION:	    Determines if `string' is a member of the set.
+ *
+ * ARGUMENTS:	    group: (const stringset *) -- the set to be operated on.
+ *		    string: (const char *) -- the string to check.
+ *
+ * RETURN:	    int -- 1 if the string is in the set, 0 if it is not.
+ *
+ * NOTES:	    O(1) expected.
+ ***/
+int stringset_ismember(const stringset * group, const char * string)
+{
+  if (group == NULL || string == NULL)
+    return 0;
+
+  size_t length = strlen(string);
+  return !slot_isempty(probe(group, stringset_hash(string, length),
+			     string, length));
+}
+
+/******************************************************************************
+ * FUNCTION:	    stringset_insert
+ *
+ * DESCRIPTION:	    Inserts a copy of `string' into the set if it is not
+ *		    already a member.
+ *
+ * ARGUMENTS:	    group: (stringset *) -- the set to be operated on.
+ *		    string: (const char *) -- the string to insert. The caller
+ *			keeps ownership of it.
+ *
+ * RETURN:	    int -- 0 if successful, 1 if the string is already in the
+ *		    set, -1 otherwise.
+ *
+ * NOTES:	    O(1) amortized. The arena may move, so pointers passed to
+ *		    stringset_traverse are only valid until the next insert.
+ ***/
+int stringset_insert(stringset * group, const char * string)
+{
+  if (group == NULL || string == NULL)
+    return -1;
+
+  size_t length = strlen(string);
+  return place(group, stringset_hash(string, length), string, length);
+}
+
+/******************************************************************************
+ * FUNCTION:	    stringset_remove
+ *
+ * DESCRIPTION:	    Removes `string' from the set.
+ *
+ * ARGUMENTS:	    group: (stringset *) -- the set to be operated on.
+ *		    string: (const char *) -- the string to remove.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    O(1) expected. The bytes of removed strings are reclaimed
+ *		    once they make up half of the arena.
+ ***/
+int stringset_remove(stringset * group, const char * string)
+{
+  if (group == NULL || string == NULL)
+    return -1;
+
+  size_t length = strlen(string);
+  stringentry * slot = probe(group, stringset_hash(string, length),
+			     string, length);
+  if (slot_isempty(slot))
+    return -1;
+
+  group->dead += slot->length + 1;
+  group->size--;
+
+  /* Shift back every following entry that would be unreachable past the
+   * new hole. */
+  unsigned long mask = group->capacity - 1;
+  unsigned long hole = slot - group->slots;
+  for (unsigned long i = (hole + 1) & mask;
+       !slot_isempty(&group->slots[i]); i = (i + 1) & mask) {
+    unsigned long home = group->slots[i].hash & mask;
+    if (((i - home) & mask) >= ((i - hole) & mask)) {
+      group->slots[hole] = group->slots[i];
+      hole = i;
+    }
+  }
+  group->slots[hole].offset = STRINGSET_EMPTY;
+
+  if (group->dead > STRINGSET_MIN_ARENA && 2 * group->dead > group->used)
+    compact(group);
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    stringset_traverse
+ *
+ * DESCRIPTION:	    Calls func() on each member of the set.
+ *
+ * ARGUMENTS:	    group: (stringset *) -- the set to be operated on.
+ *		    func: (void (*)(const char *)) -- the function to be called
+ *			on each string. It must not modify the set.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    O(n). The order is unspecified.
+ ***/
+int stringset_traverse(stringset * group, void (*func)(const char *))
+{
+  if (group == NULL || stringset_isempty(group) || func == NULL)
+    return -1;
+
+  for (unsigned long i = 0; i < group->capacity; i++)
+    if (!slot_isempty(&group->slots[i]))
+      func(group->arena + group->slots[i].offset);
+
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    stringset_union_func
+ *
+ * DESCRIPTION:	    Performs the union set operation and places the result in
+ *		    setu.
+ *
+ * ARGUMENTS:	    setu: (stringset **) -- will contain a pointer to the union
+ *			of all sets at the end of the call.
+ *		    sets: (stringset * []) -- NULL terminated array of sets.
+ *
+ * RETURN:	    int -- 0 if computation was successful, -1 otherwise.
+ *
+ * NOTES:	    O(N). The stored hashes are reused, so no string is hashed
+ *		    again. Should always be called by wrapper macro.
+ ***/
+int stringset_union_func(stringset ** setu, stringset * sets[])
+{
+  if (setu == NULL || sets[0] == NULL)
+    return -1;
+  if ((*setu = stringset_create()) == NULL)
+    return -1;
+
+  for (int i = 0; sets[i] != NULL; i++) {
+    for (unsigned long j = 0; j < sets[i]->capacity; j++) {
+      stringentry * slot = &sets[i]->slots[j];
+      if (!slot_isempty(slot)
+	  && place(*setu, slot->hash, sets[i]->arena + slot->offset,
+		   slot->length) < 0)
+	goto error_exception;
+    }
+  }
+
+  return 0;
+
+ error_exception: {
+    stringset_destroy(setu);
+    return -1;
+  }
+}
+
+/******************************************************************************
+ * FUNCTION:	    stringset_intersection_func
+ *
+ * DESCRIPTION:	    Performs the intersection set operation and places the
+ *		    result in seti.
+ *
+ * ARGUMENTS:	    seti: (stringset **) -- will contain a pointer to the
+ *			intersection of all sets at the end of the call.
+ *		    sets: (stringset * []) -- NULL terminated array of sets.
+ *
+ * RETURN:	    int -- 0 if computation was successful, -1 otherwise.
+ *
+ * NOTES:	    O(nm), where n is the size of the smallest set, which is
+ *		    the one that is scanned. Should always be called by
+ *		    wrapper macro.
+ ***/
+int stringset_intersection_func(stringset ** seti, stringset * sets[])
+{
+  if (seti == NULL || sets[0] == NULL)
+    return -1;
+  const stringset * smallest = sets[0];
+  for (int i = 1; sets[i] != NULL; i++)
+    if (sets[i]->size < smallest->size)
+      smallest = sets[i];
+  if ((*seti = stringset_create()) == NULL)
+    return -1;
+
+  for (unsigned long j = 0; j < smallest->capacity; j++) {
+    stringentry * slot = &smallest->slots[j];
+    if (slot_isempty(slot))
+      continue;
+
+    const char * string = smallest->arena + slot->offset;
+    int everywhere = 1;
+    for (int i = 0; sets[i] != NULL && everywhere; i++)
+      everywhere = sets[i] == smallest
+	|| !slot_isempty(probe(sets[i], slot->hash, string, slot->length));
+
+    if (everywhere && place(*seti, slot->hash, string, slot->length) < 0) {
+      stringset_destroy(seti);
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    stringset_difference
+ *
+ * DESCRIPTION:	    Performs the set difference operation and places the
+ *		    result in setd.
+ *
+ * ARGUMENTS:	    setd: (stringset **) -- will contain a pointer to the
+ *			difference at the end of the call.
+ *		    set1: (const stringset *) -- the minuend.
+ *		    set2: (const stringset *) -- the subtrahend.
+ *
+ * RETURN:	    int -- 0 if computation was successful, -1 otherwise.
+ *
+ * NOTES:	    O(n), where n is the size of set1.
+ ***/
+int stringset_difference(stringset ** setd, const stringset * set1,
+			 const stringset * set2)
+{
+  if (setd == NULL || set1 == NULL || set2 == NULL)
+    return -1;
+  if ((*setd = stringset_create()) == NULL)
+    return -1;
+
+  for (unsigned long j = 0; j < set1->capacity; j++) {
+    stringentry * slot = &set1->slots[j];
+    if (slot_isempty(slot))
+      continue;
+
+    const char * string = set1->arena + slot->offset;
+    if (slot_isempty(probe(set2, slot->hash, string, slot->length))
+	&& place(*setd, slot->hash, string, slot->length) < 0) {
+      stringset_destroy(setd);
+      return -1;
+    }
+  }
+
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    stringset_issubset
+ *
+ * DESCRIPTION:	    Determines if set1 is a subset of set2.
+ *
+ * ARGUMENTS:	    set1: (const stringset *) -- the set in question.
+ *		    set2: (const stringset *) -- the reference set.
+ *
+ * RETURN:	    int -- 1 if the set is a subset, 0 otherwise.
+ *
+ * NOTES:	    O(n), where n is the size of set1.
+ ***/
+int stringset_issubset(const stringset * set1, const stringset * set2)
+{
+  if (set1 == NULL || set2 == NULL || set1->size > set2->size)
+    return 0;
+
+  for (unsigned long j = 0; j < set1->capacity; j++) {
+    stringentry * slot = &set1->slots[j];
+    if (!slot_isempty(slot)
+	&& slot_isempty(probe(set2, slot->hash, set1->arena + slot->offset,
+			      slot->length)))
+      return 0;
+  }
+
+  return 1;
+}
+
+/******************************************************************************
+ * FUNCTION:	    stringset_isequal_func
+ *
+ * DESCRIPTION:	    Determines if the sets are all equal.
+ *
+ * ARGUMENTS:	    sets: (stringset * []) -- the sets to check equality of.
+ *
+ * RETURN:	    int -- 1 if the sets are equal, 0 otherwise.
+ *
+ * NOTES:	    O(nm). As with set_isequal, fewer than two sets are never
+ *		    equal. Should always be called by wrapper macro.
+ ***/
+int stringset_isequal_func(stringset * sets[])
+{
+  if (sets[0] == NULL || sets[1] == NULL)
+    return 0;
+
+  for (int i = 1; sets[i] != NULL; i++)
+    if (sets[i]->size != sets[0]->size || !stringset_issubset(sets[0], sets[i]))
+      return 0;
+
+  return 1;
+}
+
+/******************************************************************************
+ * FUNCTION:	    stringset_copy
+ *
+ * DESCRIPTION:	    Produces a copy of the set `s'.
+ *
+ * ARGUMENTS:	    s: (const stringset *) -- the set to create a copy of.
+ *
+ * RETURN:	    stringset * -- a copy of the set `s', or NULL if an error
+ *		    has occurred.
+ *
+ * NOTES:	    O(n). The table and the arena are copied as they are.
+ ***/
+stringset * stringset_copy(const stringset * s)
+{
+  if (s == NULL)
+    return NULL;
+
+  stringset * _new = NULL;
+  if ((_new = malloc(sizeof(stringset))) == NULL)
+    return NULL;
+
+  *_new = *s;
+  _new->slots = malloc(s->capacity * sizeof(stringentry));
+  _new->arena = s->reserved > 0 ? malloc(s->reserved) : NULL;
+  if (_new->slots == NULL || (s->reserved > 0 && _new->arena == NULL)) {
+    stringset_destroy(&_new);
+    return NULL;
+  }
+
+  memcpy(_new->slots, s->slots, s->capacity * sizeof(stringentry));
+  if (s->used > 0)
+    memcpy(_new->arena, s->arena, s->used);
+  return _new;
+}
+
+/******************************************************************************
+ * FUNCTION:	    stringset_hash
+ *
+ * DESCRIPTION:	    Hashes a string of the given length.
+ *
+ * ARGUMENTS:	    string: (const char *) -- the bytes to hash.
+ *		    length: (size_t) -- the number of bytes.
+ *
+ * RETURN:	    unsigned long -- the hash.
+ *
+ * NOTES:	    O(length). The string is read eight bytes at a time into
+ *		    two independent lanes of 64-bit multiply-xorshift, so that
+ *		    each iteration consumes sixteen bytes without a dependency
+ *		    between the lanes. The lanes are folded together with the
+ *		    MurmurHash3 finalizer.
+ ***/
+unsigned long stringset_hash(const char * string, size_t length)
+{
+  const unsigned long long k1 = 0x9e3779b97f4a7c15ULL;
+  const unsigned long long k2 = 0xc2b2ae3d27d4eb4fULL;
+  unsigned long long a = length * k1, b = length ^ k2;
+
+  size_t i = 0;
+  for (; i + 16 <= length; i += 16) {
+    a = (a ^ load(string + i)) * k1;
+    b = (b ^ load(string + i + 8)) * k2;
+    a ^= a >> 29;
+    b ^= b >> 32;
+  }
+
+  if (i < length) {
+    char tail[16] = {0};
+    memcpy(tail, string + i, length - i);
+    a = (a ^ load(tail)) * k1;
+    b = (b ^ load(tail + 8)) * k2;
+    a ^= a >> 29;
+    b ^= b >> 32;
+  }
+
+  unsigned long long h = a ^ ((b << 31) | (b >> 33));
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return (unsigned long)h;
+}
+
+/******************************************************************************
+ * LOCAL FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:	    probe
+ *
+ * DESCRIPTION:	    Finds the slot holding a string, or the empty slot where it
+ *		    would be placed.
+ *
+ * ARGUMENTS:	    group: (const stringset *) -- the set to search.
+ *		    hash: (unsigned long) -- the hash of the string.
+ *		    string: (const char *) -- the string.
+ *		    length: (size_t) -- the length of the string.
+ *
+ * RETURN:	    stringentry * -- the slot.
+ *
+ * NOTES:	    O(1) expected. The bytes are compared only if both the
+ *		    hash and the length are equal.
+ ***/
+static stringentry * probe(const stringset * group, unsigned long hash,
+			   const char * string, size_t length)
+{
+  unsigned long mask = group->capacity - 1;
+  for (unsigned long i = hash & mask;; i = (i + 1) & mask) {
+    stringentry * slot = &group->slots[i];
+    if (slot_isempty(slot)
+	|| (slot->hash == hash && slot->length == length
+	    && memcmp(group->arena + slot->offset, string, length) == 0))
+      return slot;
+  }
+}
+
+/******************************************************************************
+ * FUNCTION:	    place
+ *
+ * DESCRIPTION:	    Copies a string into the arena and adds it to the table, if
+ *		    it is not already a member.
+ *
+ * ARGUMENTS:	    group: (stringset *) -- the set to be operated on.
+ *		    hash: (unsigned long) -- the hash of the string.
+ *		    string: (const char *) -- the string. May point into the
+ *			arena of another set.
+ *		    length: (size_t) -- the length of the string.
+ *
+ * RETURN:	    int -- 0 if the string was added, 1 if it is already a
+ *		    member, -1 otherwise.
+ *
+ * NOTES:	    O(1) amortized.
+ ***/
+static int place(stringset * group, unsigned long hash, const char * string,
+		 size_t length)
+{
+  stringentry * slot = probe(group, hash, string, length);
+  if (!slot_isempty(slot))
+    return 1;
+
+  if ((group->size + 1) * 4 > group->capacity * 3) {
+    if (resize(group, group->capacity * 2))
+      return -1;
+    slot = probe(group, hash, string, length);
+  }
+
+  if (group->used + length + 1 > group->reserved) {
+    size_t reserved = group->reserved > 0 ? group->reserved
+      : STRINGSET_MIN_ARENA;
+    while (group->used + length + 1 > reserved)
+      reserved *= 2;
+
+    char * arena = NULL;
+    if ((arena = realloc(group->arena, reserved)) == NULL)
+      return -1;
+    group->arena = arena;
+    group->reserved = reserved;
+  }
+
+  memcpy(group->arena + group->used, string, length);
+  group->arena[group->used + length] = '\0';
+  *slot = (stringentry){
+    .hash = hash,
+    .offset = group->used,
+    .length = length
+  };
+
+  group->used += length + 1;
+  group->size++;
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    resize
+ *
+ * DESCRIPTION:	    Moves the entries of the table into a new table of
+ *		    `capacity' slots.
+ *
+ * ARGUMENTS:	    group: (stringset *) -- the set to be operated on.
+ *		    capacity: (unsigned long) -- a power of two larger than
+ *			the number of members.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    O(capacity). The arena is untouched, since the stored
+ *		    hashes are enough to place the entries.
+ ***/
+static int resize(stringset * group, unsigned long capacity)
+{
+  stringentry * slots = NULL;
+  if ((slots = malloc(capacity * sizeof(stringentry))) == NULL)
+    return -1;
+  for (unsigned long i = 0; i < capacity; i++)
+    slots[i].offset = STRINGSET_EMPTY;
+
+  unsigned long mask = capacity - 1;
+  for (unsigned long i = 0; i < group->capacity; i++) {
+    if (slot_isempty(&group->slots[i]))
+      continue;
+
+    unsigned long j = group->slots[i].hash & mask;
+    while (!slot_isempty(&slots[j]))
+      j = (j + 1) & mask;
+    slots[j] = group->slots[i];
+  }
+
+  free(group->slots);
+  group->slots = slots;
+  group->capacity = capacity;
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    compact
+ *
+ * DESCRIPTION:	    Copies the live strings into a new arena, dropping the
+ *		    bytes of removed strings.
+ *
+ * ARGUMENTS:	    group: (stringset *) -- the set to be operated on.
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise. On failure the old
+ *		    arena is kept.
+ *
+ * NOTES:	    O(n + used)
+ ***/
+static int compact(stringset * group)
+{
+  size_t reserved = STRINGSET_MIN_ARENA;
+  while (reserved < 2 * (group->used - group->dead))
+    reserved *= 2;
+
+  char * arena = NULL;
+  if ((arena = malloc(reserved)) == NULL)
+    return -1;
+
+  size_t used = 0;
+  for (unsigned long i = 0; i < group->capacity; i++) {
+    stringentry * slot = &group->slots[i];
+    if (slot_isempty(slot))
+      continue;
+
+    memcpy(arena + used, group->arena + slot->offset, slot->length + 1);
+    slot->offset = used;
+    used += slot->length + 1;
+  }
+
+  free(group->arena);
+  group->arena = arena;
+  group->used = used;
+  group->dead = 0;
+  group->reserved = reserved;
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    load
+ *
+ * DESCRIPTION:	    Reads eight bytes, which need not be aligned.
+ *
+ * ARGUMENTS:	    bytes: (const char *) -- the bytes to read.
+ *
+ * RETURN:	    unsigned long long -- the bytes, in native order.
+ *
+ * NOTES:	    Compilers turn the memcpy into a single load.
+ ***/
+static unsigned long long load(const char * bytes)
+{
+  unsigned long long word;
+  memcpy(&word, bytes, sizeof(word));
+  return word;
+}
+
+/*****************************************************************************/
@@ -0,0 +1,97 @@
+/******************************************************************************
+ * NAME:	    stringset.h
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    The header file for the implementation of a set of
+ *		    strings. Unlike the generic set, a string set makes its
+ *		    own copy of every string in one contiguous arena, and
+ *		    records the hash and length of each, so that most
+ *		    comparisons between strings are comparisons of integers.
+ *
+ * CREATED:	    10/17/2026
+ *
+ * LAST EDITED:	    10/17/2026
+ ***/
+
+#ifndef __ET_STRINGSET_H__
+#define __ET_STRINGSET_H__
+
+#include <stddef.h>
+
+/******************************************************************************
+ * TYPE DEFINITIONS
+ ***/
+
+/* A slot of the hash table. The string is at arena + offset, and is followed
+ * by a NUL. Empty slots have an offset of STRINGSET_EMPTY. */
+typedef struct {
+
+  unsigned long hash;
+  size_t offset;
+  size_t length;
+
+} stringentry;
+
+typedef struct {
+
+  int size;
+
+  unsigned long capacity;
+  stringentry * slots;
+
+  char * arena;
+  size_t used;
+  size_t dead;
+  size_t reserved;
+
+} stringset;
+
+/******************************************************************************
+ * MACRO DEFINITIONS
+ ***/
+
+#define STRINGSET_EMPTY ((size_t)-1)
+
+#define stringset_size(set) ((set)->size)
+#define stringset_isempty(set) (stringset_size(set) == 0 ? 1 : 0)
+
+/* Wrapper macros for the variadic string set operations. As with set.h,
+ * these should ALWAYS be called instead of the corresponding _func functions.
+ */
+#define stringset_union(Setu, ...)					\
+  (stringset_union_func(Setu, (stringset * []){__VA_ARGS__, NULL}))
+
+#define stringset_intersection(Seti, ...)				\
+  (stringset_intersection_func(Seti, (stringset * []){__VA_ARGS__, NULL}))
+
+#define stringset_isequal(...)						\
+  (stringset_isequal_func((stringset * []){__VA_ARGS__, NULL}))
+
+/******************************************************************************
+ * API FUNCTION PROTOTYPES
+ ***/
+
+extern stringset * stringset_create(void);
+extern void stringset_destroy(stringset ** set);
+extern int stringset_ismember(const stringset * set, const char * string);
+extern int stringset_insert(stringset * set, const char * string);
+extern int stringset_remove(stringset * set, const char * string);
+extern int stringset_traverse(stringset * set, void (*func)(const char *));
+extern int stringset_difference(stringset ** dest,
+				const stringset * source1,
+				const stringset * source2);
+extern int stringset_issubset(const stringset * subset,
+			      const stringset * masterset);
+extern stringset * stringset_copy(const stringset * set);
+extern unsigned long stringset_hash(const char * string, size_t length);
+
+/* These functions: */
+extern int stringset_union_func(stringset **, stringset * []);
+extern int stringset_intersection_func(stringset **, stringset * []);
+extern int stringset_isequal_func(stringset * []);
+/* Should NEVER be called directly. Use the wrapper macros defined above. */
+
+#endif /* __ET_STRINGSET_H__ */
+
+/*****************************************************************************/
@@ -7,7 +7,7 @@
  *
  * CREATED:	    01/18/2018
  *
- * LAST EDITED:	    02/12/2018
+ * LAST EDITED:	    10/17/2026
  ***/
 
 /******************************************************************************
@@ -15,6 +15,9 @@
  ***/
 
 #ifdef CONFIG_DEBUG_SET
+/* For fork and waitpid. */
+#define _POSIX_C_SOURCE 200809L
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
@@ -22,8 +25,28 @@
 #include <string.h>
 #include <errno.h>
 #include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
 
 #include "set.h"
+#include "hashtable.h"
+#include "multiset.h"
+#include "orderedset.h"
+#include "stringset.h"
+#include "intern.h"
+#include "frozenset.h"
+#include "cuckoofilter.h"
+#include "extset.h"
+#include "diskset.h"
+#include "asyncset.h"
+#include "shardset.h"
+#include "sortedset.h"
+#include "adaptiveset.h"
+#include "radixset.h"
+#include "disjointset.h"
+#include "robinset.h"
+#include "shmset.h"
+#include "setserver.h"
 #endif /* CONFIG_DEBUG_SET */
 
 /******************************************************************************
@@ -87,6 +110,11 @@ static FILE * logfile = NULL;
 
 static int failures = 0;
 
+#ifdef CONFIG_DEBUG_SET
+/* The members visited by fold_member, folded in order. */
+static unsigned long folded = 0;
+#endif
+
 /******************************************************************************
  * LOCAL PROTOTYPES
  ***/
@@ -94,8 +122,22 @@ static int failures = 0;
 #ifdef CONFIG_DEBUG_SET
 int match(const void *, const void *);
 void * copy(const void *);
+unsigned long hash(const void *);
+int compare(const void *, const void *);
 void printset(void *);
+void ignore(void *);
+static int compare_ids(const void *, const void *);
+static int count_ids(const void *, size_t, void *);
+static int load_range(set *, int, int, void *);
+static void note_done(asyncset_job *, int, void *);
+static void add_member(void *, void *);
+static int match_strings(const void *, const void *);
+static void * copy_string(const void *);
+static void fold_member(void *);
+static void * run_server(void *);
+static void * query_server(void *);
 static set * prep_set();
+static set * prep_set_array(const int *, int);
 
 static int test_create();
 static int test_destroy();
@@ -106,6 +148,28 @@ static int test_union();
 static int test_intersection();
 static int test_difference();
 static int test_copy();
+static int test_threshold();
+static int test_multiset();
+static int test_orderedset();
+static int test_hashed();
+static int test_stringset();
+static int test_interned();
+static int test_frozenset();
+static int test_cuckoofilter();
+static int test_extset();
+static int test_diskset();
+static int test_asyncset();
+static int test_shardset();
+static int test_hugepages();
+static int test_sortedset();
+static int test_adaptiveset();
+static int test_radixset();
+static int test_disjointset();
+static int test_compact();
+static int test_incremental();
+static int test_robinset();
+static int test_shmset();
+static int test_setserver();
 #endif /* CONFIG_DEBUG_SET */
 
 /******************************************************************************
@@ -135,24 +199,68 @@ int main(int argc, char * argv[])
 
   printf("Test create (set_create):\t\t%s\n"
 	 "Test destroy (set_destroy):\t\t%s\n"
-  	 "Test remove (set_remove):\t\t%s\n"
-  	 "Test insert (set_insert):\t\t%s\n"
-  	 "Test isequal (set_isequal):\t\t%s\n"
-  	 "Test union (set_union):\t\t\t%s\n"
-  	 "Test intersection (set_intersection):\t%s\n"
-  	 "Test difference (set_difference):\t%s\n"
-	 "Test copy (set_copy):\t\t\t%s\n",
-
-  	 test_create()		? PASS"PASS"NC : FAIL"FAIL"NC,
+	 "Test remove (set_remove):\t\t%s\n"
+	 "Test insert (set_insert):\t\t%s\n"
+	 "Test isequal (set_isequal):\t\t%s\n"
+	 "Test union (set_union):\t\t\t%s\n"
+	 "Test intersection (set_intersection):\t%s\n"
+	 "Test difference (set_difference):\t%s\n"
+	 "Test copy (set_copy):\t\t\t%s\n"
+	 "Test threshold (set_threshold):\t\t%s\n"
+	 "Test multiset (multiset_*):\t\t%s\n"
+	 "Test ordered set (orderedset_*):\t%s\n"
+	 "Test hashed set (set_create_hashed):\t%s\n"
+	 "Test string set (stringset_*):\t\t%s\n"
+	 "Test interned set (intern_*):\t\t%s\n"
+	 "Test frozen set (frozenset_*):\t\t%s\n"
+	 "Test cuckoo filter (cuckoofilter_*):\t%s\n"
+	 "Test external set (extset_*):\t\t%s\n"
+	 "Test disk set (set_create_disk):\t%s\n"
+	 "Test async set (asyncset_*):\t\t%s\n"
+	 "Test sharded set (shardset_*):\t\t%s\n"
+	 "Test huge pages (set_use_hugepages):\t%s\n"
+	 "Test sorted set (set_create_sorted):\t%s\n"
+	 "Test adaptive set (set_create_adaptive):%s\n"
+	 "Test radix set (set_create_radix):\t%s\n"
+	 "Test disjoint sets (disjointset_*):\t%s\n"
+	 "Test compact set (set_create_compact):\t%s\n"
+	 "Test incremental (set_use_incremental):\t%s\n"
+	 "Test robin set (set_create_robin):\t%s\n"
+	 "Test shared set (set_create_shared):\t%s\n"
+	 "Test set server (setserver_*):\t\t%s\n",
+
+	 test_create()		? PASS"PASS"NC : FAIL"FAIL"NC,
 	 test_destroy()		? PASS"PASS"NC : FAIL"FAIL"NC,
-  	 test_remove()		? PASS"PASS"NC : FAIL"FAIL"NC,
-  	 test_insert()		? PASS"PASS"NC : FAIL"FAIL"NC,
-  	 test_isequal()		? PASS"PASS"NC : FAIL"FAIL"NC,
-  	 test_union()		? PASS"PASS"NC : FAIL"FAIL"NC,
-  	 test_intersection()	? PASS"PASS"NC : FAIL"FAIL"NC,
-  	 test_difference()	? PASS"PASS"NC : FAIL"FAIL"NC,
-	 test_copy()		? PASS"PASS"NC : FAIL"FAIL"NC
-  	 );
+	 test_remove()		? PASS"PASS"NC : FAIL"FAIL"NC,
+	 test_insert()		? PASS"PASS"NC : FAIL"FAIL"NC,
+	 test_isequal()		? PASS"PASS"NC : FAIL"FAIL"NC,
+	 test_union()		? PASS"PASS"NC : FAIL"FAIL"NC,
+	 test_intersection()	? PASS"PASS"NC : FAIL"FAIL"NC,
+	 test_difference()	? PASS"PASS"NC : FAIL"FAIL"NC,
+	 test_copy()		? PASS"PASS"NC : FAIL"FAIL"NC,
+	 test_threshold()	? PASS"PASS"NC : FAIL"FAIL"NC,
+	 test_multiset()	? PASS"PASS"NC : FAIL"FAIL"NC,
+	 test_orderedset()	? PASS"PASS"NC : FAIL"FAIL"NC,
+	 test_hashed()		? PASS"PASS"NC : FAIL"FAIL"NC,
+	 test_stringset()	? PASS"PASS"NC : FAIL"FAIL"NC,
+	 test_interned()	? PASS"PASS"NC : FAIL"FAIL"NC,
+	 test_frozenset()	? PASS"PASS"NC : FAIL"FAIL"NC,
+	 test_cuckoofilter()	? PASS"PASS"NC : FAIL"FAIL"NC,
+	 test_extset()		? PASS"PASS"NC : FAIL"FAIL"NC,
+	 test_diskset()		? PASS"PASS"NC : FAIL"FAIL"NC,
+	 test_asyncset()	? PASS"PASS"NC : FAIL"FAIL"NC,
+	 test_shardset()	? PASS"PASS"NC : FAIL"FAIL"NC,
+	 test_hugepages()	? PASS"PASS"NC : FAIL"FAIL"NC,
+	 test_sortedset()	? PASS"PASS"NC : FAIL"FAIL"NC,
+	 test_adaptiveset()	? PASS"PASS"NC : FAIL"FAIL"NC,
+	 test_radixset()	? PASS"PASS"NC : FAIL"FAIL"NC,
+	 test_disjointset()	? PASS"PASS"NC : FAIL"FAIL"NC,
+	 test_compact()		? PASS"PASS"NC : FAIL"FAIL"NC,
+	 test_incremental()	? PASS"PASS"NC : FAIL"FAIL"NC,
+	 test_robinset()	? PASS"PASS"NC : FAIL"FAIL"NC,
+	 test_shmset()		? PASS"PASS"NC : FAIL"FAIL"NC,
+	 test_setserver()	? PASS"PASS"NC : FAIL"FAIL"NC
+	 );
 
 
 #ifdef CONFIG_TEST_LOG
@@ -219,6 +327,44 @@ void * copy(const void * data)
   return new;
 }
 
+/******************************************************************************
+ * FUNCTION:	    hash
+ *
+ * DESCRIPTION:	    Used by the hashed containers. Integers that match have
+ *		    the same hash.
+ *
+ * ARGUMENTS:	    data: (const void *) -- the data to hash.
+ *
+ * RETURN:	    unsigned long -- the hash of `data'.
+ *
+ * NOTES:	    none.
+ ***/
+unsigned long hash(const void * data)
+{
+  return (unsigned long)*((int *)data);
+}
+
+/******************************************************************************
+ * FUNCTION:	    compare
+ *
+ * DESCRIPTION:	    Used by the ordered containers. Orders integers.
+ *
+ * ARGUMENTS:	    one: (const void *) -- the first datum.
+ *		    two: (const void *) -- the second datum.
+ *
+ * RETURN:	    int -- negative, zero or positive if one is less than,
+ *		    equal to or greater than two.
+ *
+ * NOTES:	    none.
+ ***/
+int compare(const void * one, const void * two)
+{
+  int a = *((int *)one);
+  int b = *((int *)two);
+
+  return (a > b) - (a < b);
+}
+
 /******************************************************************************
  * FUNCTION:	    printset
  *
@@ -240,6 +386,23 @@ void printset(void * data)
 #endif
 }
 
+/******************************************************************************
+ * FUNCTION:	    ignore
+ *
+ * DESCRIPTION:	    Used by the traversal functions, when only the number of
+ *		    members visited matters.
+ *
+ * ARGUMENTS:	    data: (void *) -- the data in each member of the set.
+ *
+ * RETURN:	    void.
+ *
+ * NOTES:	    none.
+ ***/
+void ignore(void * data)
+{
+  (void)data;
+}
+
 /******************************************************************************
  * FUNCTION:	    prep_set
  *
@@ -284,6 +447,214 @@ static set * prep_set()
   }
 }
 
+/******************************************************************************
+ * FUNCTION:	    prep_set_array
+ *
+ * DESCRIPTION:	    Prepares a set containing copies of the integers in `arr'.
+ *
+ * ARGUMENTS:	    arr: (const int *) -- the elements of the new set.
+ *		    size: (int) -- the number of elements in `arr'.
+ *
+ * RETURN:	    set * -- a pointer to a new set, or NULL if an error has
+ *		    occurred.
+ *
+ * NOTES:	    none.
+ ***/
+static set * prep_set_array(const int * arr, int size)
+{
+  set * group = NULL;
+  if ((group = set_create(match, copy, free)) == NULL) {
+    log("prep_set_array: set_create() -> NULL");
+    return NULL;
+  }
+
+  for (int i = 0; i < size; i++) {
+    int * pNum = NULL;
+    if ((pNum = copy(&arr[i])) == NULL) {
+      log("prep_set_array: copy() -> NULL");
+      goto error_except;
+    }
+    if (set_insert(group, pNum)) {
+      log("prep_set_array: set_insert() !-> 0");
+      free(pNum);
+      goto error_except;
+    }
+  }
+
+  return group;
+
+ error_except: {
+    set_destroy(&group);
+    return NULL;
+  }
+}
+
+/******************************************************************************
+ * FUNCTION:	    compare_ids
+ *
+ * DESCRIPTION:	    Compares two records of the external set tests.
+ *
+ * ARGUMENTS:	    one: (const void *) -- the first (long long) record.
+ *		    two: (const void *) -- the second (long long) record.
+ *
+ * RETURN:	    (int) -- less than, equal to or greater than zero, as one is
+ *		    less than, equal to or greater than two.
+ *
+ * NOTES:	    none.
+ ***/
+static int compare_ids(const void * one, const void * two)
+{
+  long long a = *((const long long *)one), b = *((const long long *)two);
+  return (a > b) - (a < b);
+}
+
+/******************************************************************************
+ * FUNCTION:	    count_ids
+ *
+ * DESCRIPTION:	    A sink for the external set tests, which counts and sums
+ *		    the records it receives, and checks that they are in order.
+ *
+ * ARGUMENTS:	    record: (const void *) -- the (long long) record.
+ *		    width: (size_t) -- ignored.
+ *		    context: (void *) -- array of three long longs: the count,
+ *			the sum, and the last record, which starts at -1.
+ *
+ * RETURN:	    (int) -- 0, or -1 if the records are out of order.
+ *
+ * NOTES:	    none.
+ ***/
+static int count_ids(const void * record, size_t width, void * context)
+{
+  long long * totals = context, id = *((const long long *)record);
+  if (id <= totals[2])
+    return -1;
+
+  totals[0]++;
+  totals[1] += id;
+  totals[2] = id;
+  return 0;
+}
+
+/******************************************************************************
+ * FUNCTION:	    load_range
+ *
+ * DESCRIPTION:	    Loader for asyncset_build. Loads part of the integers from
+ *		    *context to *context + 29999, and fails for the part -1.
+ *
+ * ARGUMENTS:	    group: (set *) -- the set to load into.
+ *		    part: (int) -- which part to load.
+ *		    parts: (int) -- the number of parts.
+ *		    context: (void *) -- the first integer, and the part that
+ *			fails, as an int[2].
+ *
+ * RETURN:	    int -- 0 if successful, -1 otherwise.
+ *
+ * NOTES:	    none.
+ ***/
+static int load_range(set * group, int part, int parts, void * context)
+{
+  const int * range = (const int *)context;
+  if (part == range[1])
+    return -1;
+
+  for (int i = part; i < 30000; i += parts) {
+    int num = range[0] + i;
+    int * pNum = copy(&num);
+    if (set_insert(group, pNum))
+      free(pNum);
+  }
+  return 0;
+}
+
+/* Done callback for asyncset_build. Records the status in *context. */
+static void note_done(asyncset_job * job, int status, void * context)
+{
+  *((int *)context) = job != NULL ? status : -2;
+}
+
+/* Traversal function for shardset_traverse. Adds the member to the sum in
+ * *context, a struct { pthread_mutex_t; long sum; long count; }. */
+static void add_member(void * data, void * context)
+{
+  struct { pthread_mutex_t lock; long sum; long count; } * total = context;
+  pthread_mutex_lock(&total->lock);
+  total->sum += *((int *)data);
+  total->count++;
+  pthread_mutex_unlock(&total->lock);
+}
+
+/* Match function for sets of C strings. */
+static int match_strings(const void * one, const void * two)
+{
+  return !strcmp((const char *)one, (const char *)two);
+}
+
+/* Copy function for sets of C strings. */
+static void * copy_string(const void * data)
+{
+  size_t length = strlen(data) + 1;
+  char * string = NULL;
+  if ((string = malloc(length)) != NULL)
+    memcpy(string, data, length);
+  return string;
+}
+
+/* Traversal function for set_traverse. Folds the member into `folded', so
+ * that the same members in a different order give a different result. */
+static void fold_member(void * data)
+{
+  folded = folded * 31 + (unsigned long)*((int *)data);
+}
+
+/* Thread function that runs the set server in *context. */
+static void * run_server(void * context)
+{
+  setserver_run(context);
+  return NULL;
+}
+
+/******************************************************************************
+ * FUNCTION:	    query_server
+ *
+ * DESCRIPTION:	    Thread function for test_setserver. Connects to the server
+ *		    on its own, inserts a range of keys into the set "shared"
+ *		    and looks them up with their neighbours.
+ *
+ * ARGUMENTS:	    context: (void *) -- the path of the socket and the part
+ *			of the keys, as a struct { const char * path; int
+ *			part; int status; }. The status is set to 0 if the
+ *			keys are all found, and no others.
+ *
+ * RETURN:	    void * -- NULL.
+ *
+ * NOTES:	    none.
+ ***/
+static void * query_server(void * context)
+{
+  struct { const char * path; int part; int status; } * query = context;
+  setclient * client = NULL;
+  uint64_t keys[20000], inserted = 0;
+  unsigned char members[20000];
+  if ((client = setclient_connect(query->path)) == NULL)
+    return NULL;
+
+  for (int i = 0; i < 10000; i++)
+    keys[i] = 10000 * query->part + i;
+  for (int i = 0; i < 10000; i++)
+    keys[10000 + i] = 10000 * (query->part + 100) + i;
+  if (setclient_insert(client, "shared", keys, 10000, &inserted) == 0
+      && inserted == 10000
+      && setclient_ismember(client, "shared", keys, 20000, members) == 0) {
+    query->status = 0;
+    for (int i = 0; i < 20000; i++)
+      if (members[i] != (i < 10000))
+	query->status = -1;
+  }
+
+  setclient_close(&client);
+  return NULL;
+}
+
 /******************************************************************************
  * FUNCTION:	    test_create
  *
@@ -971,6 +1342,2271 @@ static int test_copy()
 
   return 1;
 }
+
+/******************************************************************************
+ * FUNCTION:	    test_threshold
+ *
+ * DESCRIPTION:	    Tests the set_threshold function.
+ *
+ * ARGUMENTS:	    none.
+ *
+ * RETURN:	    int -- 1 if the tests pass, 0 otherwise.
+ *
+ * NOTES:	    Test cases:
+ *			1 - NULL, k, set1, set2
+ *			2 - setk, 0, set1
+ *			3 - setk, 1, set1, set2, set3 (union)
+ *			4 - setk, 2, set1, set2, set3
+ *			5 - setk, 3, set1, set2, set3 (intersection)
+ *			6 - setk, 4, set1, set2, set3 (null result)
+ ***/
+static int test_threshold()
+{
+  set *setk = NULL, *set1 = NULL, *set2 = NULL, *set3 = NULL, *expect = NULL;
+  int arr1[] = {1, 2, 3}, arr2[] = {2, 3, 4}, arr3[] = {3, 4, 5},
+    arru[] = {1, 2, 3, 4, 5}, arr2k[] = {2, 3, 4}, arri[] = {3};
+  if ((set1 = prep_set_array(arr1, 3)) == NULL
+      || (set2 = prep_set_array(arr2, 3)) == NULL
+      || (set3 = prep_set_array(arr3, 3)) == NULL)
+    log_fail("test_threshold: 1 failed--prep_set_array() -> NULL\n");
+
+  /* NULL, k, set1, set2 */
+  if (!set_threshold(NULL, 1, set1, set2))
+    log_fail("test_threshold: 1 failed--set_threshold() -> 0\n");
+
+  /* setk, 0, set1 */
+  if (!set_threshold(&setk, 0, set1))
+    log_fail("test_threshold: 2 failed--set_threshold() -> 0\n");
+
+  /* setk, 1, set1, set2, set3 (union) */
+  if (set_threshold(&setk, 1, set1, set2, set3))
+    log_fail("test_threshold: 3 failed--set_threshold() !-> 0\n");
+  if ((expect = prep_set_array(arru, 5)) == NULL)
+    log_fail("test_threshold: 3 failed--prep_set_array() -> NULL\n");
+  if (!set_isequal(setk, expect))
+    log_fail("test_threshold: 3 failed--setk and expect are not equal\n");
+  set_destroy(&setk);
+  set_destroy(&expect);
+
+  /* setk, 2, set1, set2, set3 */
+  if (set_threshold(&setk, 2, set1, set2, set3))
+    log_fail("test_threshold: 4 failed--set_threshold() !-> 0\n");
+  if ((expect = prep_set_array(arr2k, 3)) == NULL)
+    log_fail("test_threshold: 4 failed--prep_set_array() -> NULL\n");
+  if (!set_isequal(setk, expect))
+    log_fail("test_threshold: 4 failed--setk and expect are not equal\n");
+  set_destroy(&setk);
+  set_destroy(&expect);
+
+  /* setk, 3, set1, set2, set3 (intersection) */
+  if (set_threshold(&setk, 3, set1, set2, set3))
+    log_fail("test_threshold: 5 failed--set_threshold() !-> 0\n");
+  if ((expect = prep_set_array(arri, 1)) == NULL)
+    log_fail("test_threshold: 5 failed--prep_set_array() -> NULL\n");
+  if (!set_isequal(setk, expect))
+    log_fail("test_threshold: 5 failed--setk and expect are not equal\n");
+  set_destroy(&setk);
+  set_destroy(&expect);
+
+  /* setk, 4, set1, set2, set3 (null result) */
+  if (set_threshold(&setk, 4, set1, set2, set3))
+    log_fail("test_threshold: 6 failed--set_threshold() !-> 0\n");
+  if (set_size(setk) != 0)
+    log_fail("test_threshold: 6 failed--setk is not empty\n");
+  set_destroy(&setk);
+
+  set_destroy(&set1);
+  set_destroy(&set2);
+  set_destroy(&set3);
+  return 1;
+}
+
+/******************************************************************************
+ * FUNCTION:	    test_multiset
+ *
+ * DESCRIPTION:	    Tests the multiset functions.
+ *
+ * ARGUMENTS:	    none.
+ *
+ * RETURN:	    int -- 1 if the tests pass, 0 otherwise.
+ *
+ * NOTES:	    Test cases:
+ *			1 - multiset_create(NULL, hash, copy, free)
+ *			2 - insert and count
+ *			3 - remove
+ *			4 - union, sum, intersection (deterministic)
+ *			5 - difference (deterministic)
+ *			6 - topk
+ ***/
+static int test_multiset()
+{
+  multiset *bag1 = NULL, *bag2 = NULL, *bagr = NULL;
+  if ((bag1 = multiset_create(NULL, hash, copy, free)) != NULL)
+    log_fail("test_multiset: 1 failed--multiset_create() !-> NULL\n");
+
+  /* insert and count: bag1 = {1:3, 2:1, 3:2}, bag2 = {2:4, 3:1, 4:1} */
+  int entries[][3] = {{1, 3, 1}, {2, 1, 1}, {3, 2, 1},
+		      {2, 4, 2}, {3, 1, 2}, {4, 1, 2}};
+  if ((bag1 = multiset_create(match, hash, copy, free)) == NULL
+      || (bag2 = multiset_create(match, hash, copy, free)) == NULL)
+    log_fail("test_multiset: 2 failed--multiset_create() -> NULL\n");
+  for (int i = 0; i < 6; i++) {
+    multiset * bag = entries[i][2] == 1 ? bag1 : bag2;
+    for (int j = 0; j < entries[i][1]; j++) {
+      int * pNum = NULL, ret = 0;
+      if ((pNum = copy(&entries[i][0])) == NULL)
+	log_fail("test_multiset: 2 failed--copy() -> NULL\n");
+      if ((ret = multiset_insert(bag, pNum, 1)) != (j == 0 ? 0 : 1))
+	log_fail("test_multiset: 2 failed--multiset_insert() -> %d\n", ret);
+      if (ret == 1)
+	free(pNum);
+    }
+  }
+  if (multiset_size(bag1) != 3 || multiset_total(bag1) != 6
+      || multiset_count(bag1, &entries[0][0]) != 3
+      || multiset_count(bag1, &entries[5][0]) != 0)
+    log_fail("test_multiset: 2 failed--wrong counts in bag1\n");
+
+  /* remove */
+  int two = 2;
+  if (multiset_remove(bag1, &entries[5][0], 1) != -1)
+    log_fail("test_multiset: 3 failed--multiset_remove() !-> -1\n");
+  if (multiset_remove(bag1, &two, 1) || multiset_count(bag1, &two) != 0
+      || multiset_size(bag1) != 2 || multiset_total(bag1) != 5)
+    log_fail("test_multiset: 3 failed--2 was not removed from bag1\n");
+  if ((multiset_insert(bag1, copy(&two), 1)))
+    log_fail("test_multiset: 3 failed--multiset_insert() !-> 0\n");
+
+  /* union, sum, intersection (deterministic) */
+  int one = 1, three = 3, four = 4;
+  if (multiset_union(&bagr, bag1, bag2))
+    log_fail("test_multiset: 4 failed--multiset_union() !-> 0\n");
+  if (multiset_count(bagr, &one) != 3 || multiset_count(bagr, &two) != 4
+      || multiset_count(bagr, &three) != 2 || multiset_count(bagr, &four) != 1
+      || multiset_total(bagr) != 10)
+    log_fail("test_multiset: 4 failed--wrong counts in the union\n");
+  multiset_destroy(&bagr);
+  if (multiset_sum(&bagr, bag1, bag2))
+    log_fail("test_multiset: 4 failed--multiset_sum() !-> 0\n");
+  if (multiset_count(bagr, &two) != 5 || multiset_total(bagr) != 12)
+    log_fail("test_multiset: 4 failed--wrong counts in the sum\n");
+  multiset_destroy(&bagr);
+  if (multiset_intersection(&bagr, bag1, bag2))
+    log_fail("test_multiset: 4 failed--multiset_intersection() !-> 0\n");
+  if (multiset_size(bagr) != 2 || multiset_count(bagr, &two) != 1
+      || multiset_count(bagr, &three) != 1 || multiset_total(bagr) != 2)
+    log_fail("test_multiset: 4 failed--wrong counts in the intersection\n");
+  multiset_destroy(&bagr);
+
+  /* difference (deterministic) */
+  if (multiset_difference(&bagr, bag1, bag2))
+    log_fail("test_multiset: 5 failed--multiset_difference() !-> 0\n");
+  if (multiset_size(bagr) != 2 || multiset_count(bagr, &one) != 3
+      || multiset_count(bagr, &three) != 1)
+    log_fail("test_multiset: 5 failed--wrong counts in the difference\n");
+  multiset_destroy(&bagr);
+
+  /* topk */
+  void * data[3] = {NULL};
+  long counts[3] = {0};
+  if (multiset_sum(&bagr, bag1, bag2))
+    log_fail("test_multiset: 6 failed--multiset_sum() !-> 0\n");
+  if (multiset_topk(bagr, 2, data, counts) != 2
+      || *((int *)data[0]) != 2 || counts[0] != 5
+      || *((int *)data[1]) != 1 || counts[1] != 3)
+    log_fail("test_multiset: 6 failed--wrong top two elements\n");
+  if (multiset_topk(bagr, 3, data, counts) != 3 || counts[2] != 3)
+    log_fail("test_multiset: 6 failed--wrong top three elements\n");
+  multiset_destroy(&bagr);
+
+  multiset_destroy(&bag1);
+  multiset_destroy(&bag2);
+  return 1;
+}
+
+/******************************************************************************
+ * FUNCTION:	    test_orderedset
+ *
+ * DESCRIPTION:	    Tests the orderedset functions.
+ *
+ * ARGUMENTS:	    none.
+ *
+ * RETURN:	    int -- 1 if the tests pass, 0 otherwise.
+ *
+ * NOTES:	    Test cases:
+ *			1 - orderedset_create(NULL, copy, free)
+ *			2 - insert (shuffled)
+ *			3 - select and rank
+ *			4 - floor, ceiling and range
+ *			5 - remove
+ *			6 - union, intersection, difference (deterministic)
+ *			7 - issubset, isequal and copy
+ ***/
+static int test_orderedset()
+{
+  orderedset *set1 = NULL, *set2 = NULL, *setr = NULL;
+  if ((set1 = orderedset_create(NULL, copy, free)) != NULL)
+    log_fail("test_orderedset: 1 failed--orderedset_create() !-> NULL\n");
+
+  /* insert (shuffled): the even numbers in [0, 1000) */
+  int arr[500];
+  for (int i = 0; i < 500; i++)
+    arr[i] = 2 * i;
+  for (int i = 499; i > 0; i--) {
+    int j = rand() % (i + 1), temp = arr[i];
+    arr[i] = arr[j];
+    arr[j] = temp;
+  }
+  if ((set1 = orderedset_create(compare, copy, free)) == NULL)
+    log_fail("test_orderedset: 2 failed--orderedset_create() -> NULL\n");
+  for (int i = 0; i < 500; i++)
+    if (orderedset_insert(set1, copy(&arr[i])))
+      log_fail("test_orderedset: 2 failed--orderedset_insert() !-> 0\n");
+  if (orderedset_insert(set1, &arr[0]) != 1 || orderedset_size(set1) != 500)
+    log_fail("test_orderedset: 2 failed--duplicate was inserted\n");
+
+  /* select and rank */
+  for (int i = 0; i < 500; i++) {
+    int even = 2 * i, odd = 2 * i + 1;
+    if (*((int *)orderedset_select(set1, i)) != even
+	|| orderedset_rank(set1, &even) != i
+	|| orderedset_rank(set1, &odd) != i + 1)
+      log_fail("test_orderedset: 3 failed--wrong rank of %d\n", even);
+  }
+  if (orderedset_select(set1, 500) != NULL
+      || *((int *)orderedset_min(set1)) != 0
+      || *((int *)orderedset_max(set1)) != 998)
+    log_fail("test_orderedset: 3 failed--wrong select, min or max\n");
+
+  /* floor, ceiling and range */
+  int lo = 101, hi = 201, below = -1, above = 999;
+  if (*((int *)orderedset_floor(set1, &lo)) != 100
+      || *((int *)orderedset_ceiling(set1, &lo)) != 102
+      || orderedset_floor(set1, &below) != NULL
+      || orderedset_ceiling(set1, &above) != NULL)
+    log_fail("test_orderedset: 4 failed--wrong floor or ceiling\n");
+  if (orderedset_range(set1, &lo, &hi, ignore) != 50
+      || orderedset_range(set1, NULL, &lo, ignore) != 51
+      || orderedset_range(set1, &hi, NULL, ignore) != 399)
+    log_fail("test_orderedset: 4 failed--wrong number of members in range\n");
+
+  /* remove: the multiples of four */
+  for (int i = 0; i < 1000; i += 4)
+    if (orderedset_remove(set1, &i))
+      log_fail("test_orderedset: 5 failed--orderedset_remove() !-> 0\n");
+  if (orderedset_remove(set1, &lo) != -1 || orderedset_size(set1) != 250
+      || orderedset_ismember(set1, &arr[0]) != (arr[0] % 4 != 0)
+      || *((int *)orderedset_select(set1, 0)) != 2)
+    log_fail("test_orderedset: 5 failed--wrong members after removal\n");
+  orderedset_destroy(&set1);
+
+  /* union, intersection, difference (deterministic) */
+  int ent1[] = {1, 2, 3, 4}, ent2[] = {3, 4, 5}, entu[] = {1, 2, 3, 4, 5};
+  if ((set1 = orderedset_create(compare, copy, free)) == NULL
+      || (set2 = orderedset_create(compare, copy, free)) == NULL)
+    log_fail("test_orderedset: 6 failed--orderedset_create() -> NULL\n");
+  for (int i = 0; i < 4; i++)
+    orderedset_insert(set1, copy(&ent1[i]));
+  for (int i = 0; i < 3; i++)
+    orderedset_insert(set2, copy(&ent2[i]));
+  if (orderedset_union(&setr, set1, set2) || orderedset_size(setr) != 5)
+    log_fail("test_orderedset: 6 failed--wrong union\n");
+  for (int i = 0; i < 5; i++)
+    if (*((int *)orderedset_select(setr, i)) != entu[i])
+      log_fail("test_orderedset: 6 failed--union is out of order\n");
+  orderedset_destroy(&setr);
+  if (orderedset_intersection(&setr, set1, set2) || orderedset_size(setr) != 2
+      || *((int *)orderedset_min(setr)) != 3)
+    log_fail("test_orderedset: 6 failed--wrong intersection\n");
+  orderedset_destroy(&setr);
+  if (orderedset_difference(&setr, set1, set2) || orderedset_size(setr) != 2
+      || *((int *)orderedset_max(setr)) != 2)
+    log_fail("test_orderedset: 6 failed--wrong difference\n");
+
+  /* issubset, isequal and copy */
+  if (!orderedset_issubset(setr, set1) || orderedset_issubset(set1, setr)
+      || orderedset_isequal(set1, set2))
+    log_fail("test_orderedset: 7 failed--wrong subset or equality\n");
+  orderedset_destroy(&setr);
+  if ((setr = orderedset_copy(set1)) == NULL || !orderedset_isequal(setr, set1))
+    log_fail("test_orderedset: 7 failed--copy is not equal\n");
+
+  orderedset_destroy(&setr);
+  orderedset_destroy(&set1);
+  orderedset_destroy(&set2);
+  return 1;
+}
+
+/******************************************************************************
+ * FUNCTION:	    test_hashed
+ *
+ * DESCRIPTION:	    Tests the hashed set engine, and the set operations on
+ *		    hashed sets.
+ *
+ * ARGUMENTS:	    none.
+ *
+ * RETURN:	    int -- 1 if the tests pass, 0 otherwise.
+ *
+ * NOTES:	    Test cases:
+ *			1 - set_create_hashed(match, NULL, copy, free)
+ *			2 - insert and remove while small
+ *			3 - union and intersection of small sets
+ *			4 - grow past CONFIG_SET_INLINE
+ *			5 - iterate, remove, threshold and difference
+ ***/
+static int test_hashed()
+{
+  set *set1 = NULL, *set2 = NULL, *setr = NULL;
+  if ((set1 = set_create_hashed(match, NULL, copy, free)) != NULL)
+    log_fail("test_hashed: 1 failed--set_create_hashed() !-> NULL\n");
+
+  /* insert and remove while small */
+  int one = 1, ent1[] = {1, 2, 3, 4}, ent2[] = {3, 4, 5};
+  if ((set1 = set_create_hashed(match, hash, copy, free)) == NULL
+      || (set2 = set_create_hashed(match, hash, copy, free)) == NULL)
+    log_fail("test_hashed: 2 failed--set_create_hashed() -> NULL\n");
+  for (int i = 0; i < 4; i++)
+    if (set_insert(set1, copy(&ent1[i])))
+      log_fail("test_hashed: 2 failed--set_insert() !-> 0\n");
+  for (int i = 0; i < 3; i++)
+    if (set_insert(set2, copy(&ent2[i])))
+      log_fail("test_hashed: 2 failed--set_insert() !-> 0\n");
+  if (set_insert(set1, &one) != 1 || !set_ismember(set1, &one)
+      || set_ismember(set2, &one) || set1->storage != NULL)
+    log_fail("test_hashed: 2 failed--wrong members of small set\n");
+  const void * pOne = &one;
+  if (set_remove(set1, &pOne) || set_ismember(set1, &one)
+      || set_size(set1) != 3 || set_insert(set1, copy(&one)))
+    log_fail("test_hashed: 2 failed--1 was not removed from set1\n");
+
+  /* union and intersection of small sets */
+  if (set_union(&setr, set1, set2) || set_size(setr) != 5
+      || setr->storage != NULL)
+    log_fail("test_hashed: 3 failed--wrong union\n");
+  set_destroy(&setr);
+  if (set_intersection(&setr, set1, set2) || set_size(setr) != 2
+      || !set_ismember(setr, &ent2[0]) || !set_ismember(setr, &ent2[1]))
+    log_fail("test_hashed: 3 failed--wrong intersection\n");
+  set_destroy(&setr);
+
+  /* grow past CONFIG_SET_INLINE */
+  for (int i = 0; i < 1000; i++) {
+    int * pNum = copy(&i);
+    if (set_insert(set1, pNum) == 1)
+      free(pNum);
+  }
+  if (set_size(set1) != 1000 || set1->storage == NULL)
+    log_fail("test_hashed: 4 failed--set1 did not grow\n");
+  for (int i = 0; i < 1000; i++)
+    if (!set_ismember(set1, &i))
+      log_fail("test_hashed: 4 failed--%d is not a member\n", i);
+
+  /* iterate, remove, threshold and difference */
+  set_iterator iterator;
+  long sum = 0, count = 0;
+  for (void * data = set_begin(set1, &iterator); data != NULL;
+       data = set_advance(set1, &iterator), count++)
+    sum += *((int *)data);
+  if (count != 1000 || sum != 999 * 1000 / 2)
+    log_fail("test_hashed: 5 failed--iteration is incomplete\n");
+  for (int i = 0; i < 1000; i += 2) {
+    const void * pNum = &i;
+    if (set_remove(set1, &pNum))
+      log_fail("test_hashed: 5 failed--set_remove() !-> 0\n");
+  }
+  if (set_threshold(&setr, 2, set1, set2) || set_size(setr) != 2)
+    log_fail("test_hashed: 5 failed--wrong threshold\n");
+  set_destroy(&setr);
+  if (set_difference(&setr, set1, set2) || set_size(setr) != 498
+      || !set_issubset(setr, set1))
+    log_fail("test_hashed: 5 failed--wrong difference\n");
+
+  set_destroy(&setr);
+  set_destroy(&set1);
+  set_destroy(&set2);
+  return 1;
+}
+
+/******************************************************************************
+ * FUNCTION:	    test_stringset
+ *
+ * DESCRIPTION:	    Tests the string set.
+ *
+ * ARGUMENTS:	    none.
+ *
+ * RETURN:	    int -- 1 if the tests pass, 0 otherwise.
+ *
+ * NOTES:	    Test cases:
+ *			1 - insert, remove and ismember
+ *			2 - union, intersection, difference and isequal
+ *			3 - copy
+ *			4 - grow the table, and compact the arena
+ ***/
+static int test_stringset()
+{
+  stringset *set1 = NULL, *set2 = NULL, *setr = NULL, *setc = NULL;
+  if ((set1 = stringset_create()) == NULL
+      || (set2 = stringset_create()) == NULL)
+    log_fail("test_stringset: 1 failed--stringset_create() -> NULL\n");
+
+  /* insert, remove and ismember */
+  const char * ent1[] = {"alpha", "beta", "gamma", "", "a longer string, "
+			 "which is hashed sixteen bytes at a time"};
+  const char * ent2[] = {"beta", "gamma", "delta"};
+  char buffer[64];
+  for (int i = 0; i < 5; i++)
+    if (stringset_insert(set1, ent1[i]))
+      log_fail("test_stringset: 1 failed--stringset_insert() !-> 0\n");
+  for (int i = 0; i < 3; i++)
+    if (stringset_insert(set2, ent2[i]))
+      log_fail("test_stringset: 1 failed--stringset_insert() !-> 0\n");
+  strcpy(buffer, "alpha");
+  if (stringset_insert(set1, buffer) != 1 || stringset_size(set1) != 5
+      || !stringset_ismember(set1, "") || stringset_ismember(set1, "alph")
+      || !stringset_ismember(set1, ent1[4]))
+    log_fail("test_stringset: 1 failed--wrong members of set1\n");
+  if (stringset_remove(set1, "alpha") || stringset_ismember(set1, "alpha")
+      || !stringset_remove(set1, "alpha") || stringset_insert(set1, "alpha"))
+    log_fail("test_stringset: 1 failed--alpha was not removed\n");
+
+  /* union, intersection, difference and isequal */
+  if (stringset_union(&setr, set1, set2) || stringset_size(setr) != 6
+      || !stringset_ismember(setr, "delta"))
+    log_fail("test_stringset: 2 failed--wrong union\n");
+  stringset_destroy(&setr);
+  if (stringset_intersection(&setr, set1, set2) || stringset_size(setr) != 2
+      || !stringset_ismember(setr, "beta") || !stringset_issubset(setr, set2))
+    log_fail("test_stringset: 2 failed--wrong intersection\n");
+  stringset_destroy(&setr);
+  if (stringset_difference(&setr, set1, set2) || stringset_size(setr) != 3
+      || stringset_ismember(setr, "gamma"))
+    log_fail("test_stringset: 2 failed--wrong difference\n");
+  if (stringset_isequal(set1, set2) || stringset_isequal(set1))
+    log_fail("test_stringset: 2 failed--stringset_isequal() !-> 0\n");
+  stringset_destroy(&setr);
+
+  /* copy */
+  if ((setc = stringset_copy(set1)) == NULL || !stringset_isequal(set1, setc))
+    log_fail("test_stringset: 3 failed--wrong copy\n");
+
+  /* grow the table, and compact the arena */
+  for (int i = 0; i < 2000; i++) {
+    sprintf(buffer, "string number %d", i);
+    if (stringset_insert(set1, buffer))
+      log_fail("test_stringset: 4 failed--stringset_insert() !-> 0\n");
+  }
+  for (int i = 0; i < 2000; i++) {
+    if (i % 4 == 0)
+      continue;
+    sprintf(buffer, "string number %d", i);
+    if (stringset_remove(set1, buffer))
+      log_fail("test_stringset: 4 failed--stringset_remove() !-> 0\n");
+  }
+  for (int i = 0; i < 2000; i++) {
+    sprintf(buffer, "string number %d", i);
+    if (stringset_ismember(set1, buffer) != (i % 4 == 0))
+      log_fail("test_stringset: 4 failed--wrong member %d\n", i);
+  }
+  if (stringset_size(set1) != 505 || !stringset_issubset(setc, set1)
+      || 2 * set1->dead > set1->used)
+    log_fail("test_stringset: 4 failed--wrong members of set1\n");
+
+  stringset_destroy(&setc);
+  stringset_destroy(&set1);
+  stringset_destroy(&set2);
+  return 1;
+}
+
+/******************************************************************************
+ * FUNCTION:	    test_interned
+ *
+ * DESCRIPTION:	    Tests the interning pools, and sets of interned handles.
+ *
+ * ARGUMENTS:	    none.
+ *
+ * RETURN:	    int -- 1 if the tests pass, 0 otherwise.
+ *
+ * NOTES:	    Test cases:
+ *			1 - intern(), intern_find() and intern_release()
+ *			2 - intern_string() of equal strings
+ *			3 - set_create_interned(), small and large
+ *			4 - union, intersection and isequal of handles
+ *			5 - release every string
+ ***/
+static int test_interned()
+{
+  /* intern(), intern_find() and intern_release() */
+  internpool * pool = NULL;
+  int one = 1, two = 2, another = 1;
+  if ((pool = intern_create(match, hash, copy, free)) == NULL)
+    log_fail("test_interned: 1 failed--intern_create() -> NULL\n");
+  const void * pOne = intern(pool, &one), * pTwo = intern(pool, &two);
+  if (pOne == NULL || pOne == &one || intern(pool, &another) != pOne
+      || intern_find(pool, &one) != pOne || intern_size(pool) != 2)
+    log_fail("test_interned: 1 failed--wrong handles\n");
+  if (intern_release(pool, pOne) || intern_release(pool, pTwo)
+      || intern_release(pool, &one) != -1 || intern_size(pool) != 1
+      || intern_release(pool, pOne) || intern_find(pool, &one) != NULL)
+    log_fail("test_interned: 1 failed--wrong reference counts\n");
+  intern_destroy(&pool);
+
+  /* intern_string() of equal strings */
+  char buffer[32];
+  const char * strings[100];
+  strcpy(buffer, "string 0");
+  if ((strings[0] = intern_string("string 0")) == NULL
+      || intern_string(buffer) != strings[0]
+      || intern_string_release(strings[0]))
+    log_fail("test_interned: 2 failed--intern_string() !-> strings[0]\n");
+  for (int i = 1; i < 100; i++) {
+    sprintf(buffer, "string %d", i);
+    if ((strings[i] = intern_string(buffer)) == NULL)
+      log_fail("test_interned: 2 failed--intern_string() -> NULL\n");
+  }
+
+  /* set_create_interned(), small and large */
+  set *set1 = NULL, *set2 = NULL, *setr = NULL;
+  if ((set1 = set_create_interned()) == NULL
+      || (set2 = set_create_interned()) == NULL)
+    log_fail("test_interned: 3 failed--set_create_interned() -> NULL\n");
+  for (int i = 0; i < 4; i++)
+    if (set_insert(set1, (void *)strings[i]))
+      log_fail("test_interned: 3 failed--set_insert() !-> 0\n");
+  if (set_insert(set1, (void *)intern_string("string 2")) != 1
+      || intern_string_release(strings[2])
+      || !set_ismember(set1, strings[3]) || set_ismember(set1, "string 3"))
+    log_fail("test_interned: 3 failed--wrong members of small set\n");
+  for (int i = 0; i < 100; i++)
+    if (set_insert(i < 50 ? set1 : set2, (void *)strings[i]) != (i < 4))
+      log_fail("test_interned: 3 failed--set_insert() !-> %d\n", i < 4);
+  if (set_size(set1) != 50 || set1->storage == NULL
+      || !set_ismember(set2, strings[99]))
+    log_fail("test_interned: 3 failed--wrong members of large set\n");
+
+  /* union, intersection and isequal of handles */
+  if (set_union(&setr, set1, set2) || set_size(setr) != 100
+      || !set_issubset(set1, setr))
+    log_fail("test_interned: 4 failed--wrong union\n");
+  set_destroy(&setr);
+  if (set_intersection(&setr, set1, set2) || set_size(setr) != 0)
+    log_fail("test_interned: 4 failed--wrong intersection\n");
+  set_destroy(&setr);
+  if ((setr = set_copy(set1)) == NULL || !set_isequal(setr, set1)
+      || set_isequal(set1, set2))
+    log_fail("test_interned: 4 failed--wrong copy\n");
+  set_destroy(&setr);
+  set_destroy(&set1);
+  set_destroy(&set2);
+
+  /* release every string */
+  for (int i = 0; i < 100; i++)
+    if (intern_string_release(strings[i]))
+      log_fail("test_interned: 5 failed--intern_string_release() !-> 0\n");
+  if (intern_string_release(strings[0]) != -1)
+    log_fail("test_interned: 5 failed--intern_string_release() !-> -1\n");
+
+  return 1;
+}
+
+/******************************************************************************
+ * FUNCTION:	    test_frozenset
+ *
+ * DESCRIPTION:	    Tests the frozen set.
+ *
+ * ARGUMENTS:	    none.
+ *
+ * RETURN:	    int -- 1 if the tests pass, 0 otherwise.
+ *
+ * NOTES:	    Test cases:
+ *			1 - frozenset_build(NULL), and from a list set
+ *			2 - frozenset_build() from an empty set
+ *			3 - frozenset_build() from a large set
+ *			4 - frozenset_build() from an interned set
+ *			5 - frozenset_build() from a set that keeps records
+ ***/
+static int test_frozenset()
+{
+  /* frozenset_build(NULL), and from a list set */
+  set * source = NULL;
+  frozenset * frozen = NULL;
+  if (frozenset_build(NULL) != NULL)
+    log_fail("test_frozenset: 1 failed--frozenset_build() !-> NULL\n");
+  if ((source = prep_set()) == NULL || frozenset_build(source) != NULL)
+    log_fail("test_frozenset: 1 failed--frozenset_build() !-> NULL\n");
+  set_destroy(&source);
+
+  /* frozenset_build() from an empty set */
+  int zero = 0;
+  if ((source = set_create_hashed(match, hash, copy, free)) == NULL
+      || (frozen = frozenset_build(source)) == NULL
+      || frozenset_size(frozen) != 0 || frozenset_ismember(frozen, &zero))
+    log_fail("test_frozenset: 2 failed--wrong empty frozen set\n");
+  frozenset_destroy(&frozen);
+
+  /* frozenset_build() from a large set */
+  for (int i = 0; i < 20000; i += 2)
+    if (set_insert(source, copy(&i)))
+      log_fail("test_frozenset: 3 failed--set_insert() !-> 0\n");
+  if ((frozen = frozenset_build(source)) == NULL
+      || frozenset_size(frozen) != 10000)
+    log_fail("test_frozenset: 3 failed--frozenset_build() -> NULL\n");
+  for (int i = 0; i < 20000; i++)
+    if (frozenset_ismember(frozen, &i) != (i % 2 == 0))
+      log_fail("test_frozenset: 3 failed--wrong member %d\n", i);
+  long sum = 0;
+  for (int i = 0; i < frozenset_size(frozen); i++)
+    sum += *((int *)frozen->keys[i]);
+  if (sum != 9999L * 10000)
+    log_fail("test_frozenset: 3 failed--wrong keys\n");
+  frozenset_destroy(&frozen);
+  set_destroy(&source);
+
+  /* frozenset_build() from an interned set */
+  const char * one = intern_string("one"), * two = intern_string("two");
+  if ((source = set_create_interned()) == NULL
+      || set_insert(source, (void *)one)
+      || (frozen = frozenset_build(source)) == NULL
+      || !frozenset_ismember(frozen, one) || frozenset_ismember(frozen, two))
+    log_fail("test_frozenset: 4 failed--wrong interned frozen set\n");
+  frozenset_destroy(&frozen);
+  set_destroy(&source);
+  intern_string_release(one);
+  intern_string_release(two);
+
+  /* frozenset_build() from a set that keeps records */
+  adaptiveset_stats stats;
+  if ((source = set_create_adaptive(match, hash, compare, copy, free,
+				    sizeof(int), 1)) == NULL)
+    log_fail("test_frozenset: 5 failed--set_create_adaptive() -> NULL\n");
+  for (int i = 0; i < 100; i++)
+    set_insert(source, copy(&i));
+  if (set_adaptive_stats(source, &stats) || stats.repr != ADAPTIVESET_BITSET
+      || (frozen = frozenset_build(source)) == NULL
+      || frozenset_size(frozen) != 100)
+    log_fail("test_frozenset: 5 failed--frozenset_build() -> NULL\n");
+  for (int i = -10; i < 110; i++)
+    if (frozenset_ismember(frozen, &i) != (i >= 0 && i < 100))
+      log_fail("test_frozenset: 5 failed--wrong member %d\n", i);
+  frozenset_destroy(&frozen);
+  set_destroy(&source);
+
+  return 1;
+}
+
+/******************************************************************************
+ * FUNCTION:	    test_cuckoofilter
+ *
+ * DESCRIPTION:	    Tests the cuckoo filter, on its own and attached to a set.
+ *
+ * ARGUMENTS:	    none.
+ *
+ * RETURN:	    int -- 1 if the tests pass, 0 otherwise.
+ *
+ * NOTES:	    Test cases:
+ *			1 - insert, contains and remove
+ *			2 - false positive rate
+ *			3 - fill a filter until it is full
+ *			4 - set_attach_filter() on a list set, and a hashed set
+ *			5 - insert and remove with an attached filter
+ ***/
+static int test_cuckoofilter()
+{
+  /* insert, contains and remove */
+  cuckoofilter * filter = NULL;
+  if ((filter = cuckoofilter_create(1000)) == NULL)
+    log_fail("test_cuckoofilter: 1 failed--cuckoofilter_create() -> NULL\n");
+  for (unsigned long i = 0; i < 1000; i++)
+    if (cuckoofilter_insert(filter, i))
+      log_fail("test_cuckoofilter: 1 failed--cuckoofilter_insert() !-> 0\n");
+  for (unsigned long i = 0; i < 1000; i += 2)
+    if (cuckoofilter_remove(filter, i))
+      log_fail("test_cuckoofilter: 1 failed--cuckoofilter_remove() !-> 0\n");
+  for (unsigned long i = 1; i < 1000; i += 2)
+    if (!cuckoofilter_contains(filter, i))
+      log_fail("test_cuckoofilter: 1 failed--%lu is missing\n", i);
+  if (cuckoofilter_count(filter) != 500)
+    log_fail("test_cuckoofilter: 1 failed--wrong count\n");
+
+  /* false positive rate */
+  int positives = 0;
+  for (unsigned long i = 1000; i < 101000; i++)
+    positives += cuckoofilter_contains(filter, i);
+  if (positives > 100)
+    log_fail("test_cuckoofilter: 2 failed--%d false positives\n", positives);
+  cuckoofilter_destroy(&filter);
+
+  /* fill a filter until it is full */
+  unsigned long n = 0;
+  if ((filter = cuckoofilter_create(64)) == NULL)
+    log_fail("test_cuckoofilter: 3 failed--cuckoofilter_create() -> NULL\n");
+  while (cuckoofilter_insert(filter, n) == 0)
+    n++;
+  if (n < 64)
+    log_fail("test_cuckoofilter: 3 failed--full after %lu\n", n);
+  for (unsigned long i = 0; i < n; i++)
+    if (!cuckoofilter_contains(filter, i))
+      log_fail("test_cuckoofilter: 3 failed--%lu is missing\n", i);
+  if (cuckoofilter_remove(filter, 0) || cuckoofilter_insert(filter, n))
+    log_fail("test_cuckoofilter: 3 failed--no room after removal\n");
+  cuckoofilter_destroy(&filter);
+
+  /* set_attach_filter() on a list set, and a hashed set */
+  set * group = NULL;
+  if ((group = prep_set()) == NULL || set_attach_filter(group) != -1)
+    log_fail("test_cuckoofilter: 4 failed--set_attach_filter() !-> -1\n");
+  set_destroy(&group);
+  if ((group = set_create_hashed(match, hash, copy, free)) == NULL)
+    log_fail("test_cuckoofilter: 4 failed--set_create_hashed() -> NULL\n");
+  for (int i = 0; i < 100; i++)
+    if (set_insert(group, copy(&i)))
+      log_fail("test_cuckoofilter: 4 failed--set_insert() !-> 0\n");
+  if (set_attach_filter(group) || group->filter == NULL)
+    log_fail("test_cuckoofilter: 4 failed--set_attach_filter() !-> 0\n");
+
+  /* insert and remove with an attached filter */
+  for (int i = 100; i < 5000; i++)
+    if (set_insert(group, copy(&i)))
+      log_fail("test_cuckoofilter: 5 failed--set_insert() !-> 0\n");
+  for (int i = 0; i < 5000; i += 2) {
+    const void * pNum = &i;
+    if (set_remove(group, &pNum))
+      log_fail("test_cuckoofilter: 5 failed--set_remove() !-> 0\n");
+  }
+  for (int i = 0; i < 10000; i++)
+    if (set_ismember(group, &i) != (i < 5000 && i % 2 == 1))
+      log_fail("test_cuckoofilter: 5 failed--wrong member %d\n", i);
+  if (group->filter == NULL || cuckoofilter_count(group->filter) != 2500)
+    log_fail("test_cuckoofilter: 5 failed--filter is out of sync\n");
+  set_destroy(&group);
+
+  return 1;
+}
+
+/******************************************************************************
+ * FUNCTION:	    test_extset
+ *
+ * DESCRIPTION:	    Tests the external-memory set.
+ *
+ * ARGUMENTS:	    none.
+ *
+ * RETURN:	    int -- 1 if the tests pass, 0 otherwise.
+ *
+ * NOTES:	    Test cases:
+ *			1 - extset_create() with bad arguments
+ *			2 - insert enough records to merge runs
+ *			3 - union, intersection and difference
+ *			4 - issubset
+ *			5 - extset_tofile()
+ *			6 - the same set given more than once
+ ***/
+static int test_extset()
+{
+  /* extset_create() with bad arguments */
+  extset *set2 = NULL, *set3 = NULL, *set6 = NULL;
+  if (extset_create(0, compare_ids, 1024, NULL) != NULL
+      || extset_create(sizeof(long long), NULL, 1024, NULL) != NULL)
+    log_fail("test_extset: 1 failed--extset_create() !-> NULL\n");
+
+  /* insert enough records to merge runs */
+  if ((set2 = extset_create(sizeof(long long), compare_ids, 512, NULL)) == NULL
+      || (set3 = extset_create(sizeof(long long), compare_ids, 512, "."))
+      == NULL
+      || (set6 = extset_create(sizeof(long long), compare_ids, 512, NULL))
+      == NULL)
+    log_fail("test_extset: 2 failed--extset_create() -> NULL\n");
+  for (long long i = 0; i < 2 * 12000; i++) {
+    long long id = (i * 7919) % 12000;
+    if ((id % 2 == 0 && extset_insert(set2, &id))
+	|| (id % 3 == 0 && extset_insert(set3, &id))
+	|| (id % 6 == 0 && extset_insert(set6, &id)))
+      log_fail("test_extset: 2 failed--extset_insert() !-> 0\n");
+  }
+  if (set2->nruns < 2 || set2->nruns > CONFIG_EXTSET_FANIN)
+    log_fail("test_extset: 2 failed--wrong number of runs\n");
+  for (int level = 0, runs = 0; level < 8; level++, runs = 0) {
+    for (int i = 0; i < set2->nruns; i++)
+      runs += set2->runs[i].level == level;
+    if (runs >= CONFIG_EXTSET_TIER || (level == 0 && runs == set2->nruns))
+      log_fail("test_extset: 2 failed--%d runs of level %d\n", runs, level);
+  }
+
+  /* union, intersection and difference */
+  long long totals[3] = {0, 0, -1};
+  if (extset_union(count_ids, totals, set2, set3) || totals[0] != 8000
+      || totals[1] != 6000LL * 11998 / 2 + 4000LL * 11997 / 2
+      - 2000LL * 11994 / 2)
+    log_fail("test_extset: 3 failed--wrong union\n");
+  totals[0] = totals[1] = 0, totals[2] = -1;
+  if (extset_intersection(count_ids, totals, set2, set3, set6)
+      || totals[0] != 2000 || totals[1] != 2000LL * 11994 / 2)
+    log_fail("test_extset: 3 failed--wrong intersection\n");
+  totals[0] = totals[1] = 0, totals[2] = -1;
+  if (extset_difference(count_ids, totals, set2, set3) || totals[0] != 4000)
+    log_fail("test_extset: 3 failed--wrong difference\n");
+
+  /* issubset */
+  if (extset_issubset(set6, set2) != 1 || extset_issubset(set6, set3) != 1
+      || extset_issubset(set2, set6) != 0)
+    log_fail("test_extset: 4 failed--wrong extset_issubset()\n");
+
+  /* extset_tofile() */
+  FILE * file = NULL;
+  if ((file = tmpfile()) == NULL
+      || extset_intersection(extset_tofile, file, set2, set3)
+      || ftell(file) != 2000 * (long)sizeof(long long))
+    log_fail("test_extset: 5 failed--wrong file\n");
+  fclose(file);
+
+  /* the same set given more than once */
+  totals[0] = totals[1] = 0, totals[2] = -1;
+  if (extset_union(count_ids, totals, set2, set2) || totals[0] != 6000)
+    log_fail("test_extset: 6 failed--wrong union\n");
+  totals[0] = totals[1] = 0, totals[2] = -1;
+  if (extset_intersection(count_ids, totals, set2, set3, set2)
+      || totals[0] != 2000 || totals[1] != 2000LL * 11994 / 2)
+    log_fail("test_extset: 6 failed--wrong intersection\n");
+  totals[0] = totals[1] = 0, totals[2] = -1;
+  if (extset_difference(count_ids, totals, set2, set2) || totals[0] != 0
+      || extset_issubset(set3, set3) != 1)
+    log_fail("test_extset: 6 failed--wrong difference\n");
+
+  extset_destroy(&set2);
+  extset_destroy(&set3);
+  extset_destroy(&set6);
+  return 1;
+}
+
+/******************************************************************************
+ * FUNCTION:	    test_diskset
+ *
+ * DESCRIPTION:	    Tests the disk set engine.
+ *
+ * ARGUMENTS:	    none.
+ *
+ * RETURN:	    int -- 1 if the tests pass, 0 otherwise.
+ *
+ * NOTES:	    Test cases:
+ *			1 - set_create_disk() with bad arguments
+ *			2 - insert many more members than the buffer pool holds
+ *			3 - remove and iterate
+ *			4 - union and difference with a hashed set, and copy
+ *			5 - reopen the file
+ ***/
+static int test_diskset()
+{
+  const char * path = "./diskset.test";
+  remove(path);
+
+  /* set_create_disk() with bad arguments */
+  set *group = NULL, *other = NULL, *setr = NULL, *setc = NULL;
+  if (set_create_disk(match, NULL, copy, free, sizeof(int), NULL, 0) != NULL
+      || set_create_disk(match, hash, copy, free, 0, NULL, 0) != NULL
+      || set_create_disk(match, hash, copy, free, 4096, NULL, 0) != NULL)
+    log_fail("test_diskset: 1 failed--set_create_disk() !-> NULL\n");
+
+  /* insert many more members than the buffer pool holds */
+  if ((group = set_create_disk(match, hash, copy, free, sizeof(int), path,
+			       0)) == NULL)
+    log_fail("test_diskset: 2 failed--set_create_disk() -> NULL\n");
+  for (int i = 0; i < 2 * 20000; i++) {
+    int num = (int)((i * 7919L) % 20000);
+    int * pNum = copy(&num);
+    int ret = set_insert(group, pNum);
+    if (ret == 1)
+      free(pNum);
+    if (ret != (i >= 20000))
+      log_fail("test_diskset: 2 failed--set_insert() -> %d\n", ret);
+  }
+  diskset_stats stats;
+  if (set_size(group) != 20000 || set_disk_stats(group, &stats)
+      || stats.frames != 8 || stats.evictions == 0 || stats.pages < 60)
+    log_fail("test_diskset: 2 failed--wrong size or statistics\n");
+  for (int i = -10; i < 20010; i++)
+    if (set_ismember(group, &i) != (i >= 0 && i < 20000))
+      log_fail("test_diskset: 2 failed--wrong member %d\n", i);
+
+  /* remove and iterate */
+  for (int i = 0; i < 20000; i += 2) {
+    const void * pNum = &i;
+    if (set_remove(group, &pNum))
+      log_fail("test_diskset: 3 failed--set_remove() !-> 0\n");
+  }
+  set_iterator iterator;
+  long sum = 0, count = 0;
+  for (void * data = set_begin(group, &iterator); data != NULL;
+       data = set_advance(group, &iterator), count++)
+    sum += *((int *)data);
+  if (set_size(group) != 10000 || count != 10000 || sum != 10000L * 10000)
+    log_fail("test_diskset: 3 failed--iteration is incomplete\n");
+
+  /* union and difference with a hashed set, and copy */
+  if ((other = set_create_hashed(match, hash, copy, free)) == NULL)
+    log_fail("test_diskset: 4 failed--set_create_hashed() -> NULL\n");
+  for (int i = 19000; i < 21000; i++)
+    set_insert(other, copy(&i));
+  if (set_union(&setr, group, other) || set_size(setr) != 11500
+      || setr->engine != group->engine || !set_issubset(other, setr))
+    log_fail("test_diskset: 4 failed--wrong union\n");
+  set_destroy(&setr);
+  if (set_difference(&setr, group, other) || set_size(setr) != 9500
+      || !set_issubset(setr, group))
+    log_fail("test_diskset: 4 failed--wrong difference\n");
+  if ((setc = set_copy(group)) == NULL || !set_isequal(setc, group))
+    log_fail("test_diskset: 4 failed--wrong copy\n");
+  set_destroy(&setc);
+  set_destroy(&setr);
+  set_destroy(&other);
+
+  /* reopen the file */
+  if (set_disk_sync(group))
+    log_fail("test_diskset: 5 failed--set_disk_sync() !-> 0\n");
+  set_destroy(&group);
+  if (set_create_disk(match, hash, copy, free, sizeof(long long), path, 0)
+      != NULL
+      || (group = set_create_disk(match, hash, copy, free, sizeof(int), path,
+				  64 * 4096)) == NULL
+      || set_size(group) != 10000)
+    log_fail("test_diskset: 5 failed--set_create_disk() did not reopen\n");
+  for (int pass = 0; pass < 2; pass++)
+    for (int i = 0; i < 20000; i++)
+      if (set_ismember(group, &i) != (i % 2 == 1))
+	log_fail("test_diskset: 5 failed--wrong member %d\n", i);
+  if (set_disk_stats(group, &stats) || diskset_hitratio(&stats) < 0.9)
+    log_fail("test_diskset: 5 failed--wrong hit ratio\n");
+
+  set_destroy(&group);
+  remove(path);
+  return 1;
+}
+
+/******************************************************************************
+ * FUNCTION:	    test_asyncset
+ *
+ * DESCRIPTION:	    Tests sets that are rebuilt in the background.
+ *
+ * ARGUMENTS:	    none.
+ *
+ * RETURN:	    int -- 1 if the tests pass, 0 otherwise.
+ *
+ * NOTES:	    Test cases:
+ *			1 - asyncset_build() with bad arguments
+ *			2 - build from an array on several threads
+ *			3 - a reader keeps the old version across a swap
+ *			4 - a failed build leaves the current version
+ ***/
+static int test_asyncset()
+{
+  /* asyncset_build() with bad arguments */
+  asyncset * handle = NULL;
+  asyncset_job * job = NULL;
+  int range[2] = {1000000, -1}, status = 1;
+  if ((handle = asyncset_create(match, hash, NULL, free)) == NULL)
+    log_fail("test_asyncset: 1 failed--asyncset_create() -> NULL\n");
+  if (asyncset_build(handle, load_range, range, 0, NULL, NULL) != NULL
+      || asyncset_build(handle, NULL, range, 1, NULL, NULL) != NULL
+      || asyncset_build_array(handle, NULL, 0, 1, NULL, NULL) != NULL
+      || asyncset_wait(&job) != -1)
+    log_fail("test_asyncset: 1 failed--asyncset_build() !-> NULL\n");
+  asyncset_destroy(&handle);
+
+  /* build from an array on several threads */
+  int * nums = NULL;
+  void ** members = NULL;
+  if ((handle = asyncset_create(match, hash, copy, free)) == NULL
+      || (nums = malloc(100000 * sizeof(int))) == NULL
+      || (members = malloc(100000 * sizeof(void *))) == NULL)
+    log_fail("test_asyncset: 2 failed--out of memory\n");
+  for (int i = 0; i < 100000; i++) {
+    nums[i] = (int)((i * 7919L) % 50000);
+    members[i] = &nums[i];
+  }
+  if ((job = asyncset_build_array(handle, members, 100000, 4, note_done,
+				  &status)) == NULL
+      || asyncset_wait(&job) || job != NULL || status != 0)
+    log_fail("test_asyncset: 2 failed--asyncset_wait() !-> 0\n");
+  free(members);
+  free(nums);
+  const set * old = asyncset_acquire(handle);
+  if (set_size(old) != 50000)
+    log_fail("test_asyncset: 2 failed--size is %d\n", set_size(old));
+  for (int i = -10; i < 50010; i++)
+    if (set_ismember(old, &i) != (i >= 0 && i < 50000))
+      log_fail("test_asyncset: 2 failed--wrong member %d\n", i);
+
+  /* a reader keeps the old version across a swap */
+  status = 1;
+  if ((job = asyncset_build(handle, load_range, range, 3, note_done,
+			    &status)) == NULL)
+    log_fail("test_asyncset: 3 failed--asyncset_build() -> NULL\n");
+  long hits = 0;
+  for (int i = 0; i < 50000; i++)
+    hits += set_ismember(old, &i);
+  if (asyncset_wait(&job) || status != 0 || hits != 50000)
+    log_fail("test_asyncset: 3 failed--wrong build\n");
+  const set * current = asyncset_acquire(handle);
+  int first = range[0], middle = 40000;
+  if (current == old || set_size(current) != 30000
+      || !set_ismember(current, &first) || set_ismember(current, &middle)
+      || set_size(old) != 50000 || !set_ismember(old, &middle))
+    log_fail("test_asyncset: 3 failed--wrong versions\n");
+  asyncset_release(handle, old);
+
+  /* a failed build leaves the current version */
+  range[1] = 2;
+  if ((job = asyncset_build(handle, load_range, range, 3, note_done,
+			    &status)) == NULL
+      || asyncset_wait(&job) != -1 || status != -1)
+    log_fail("test_asyncset: 4 failed--asyncset_wait() !-> -1\n");
+  old = asyncset_acquire(handle);
+  if (old != current)
+    log_fail("test_asyncset: 4 failed--the version changed\n");
+  asyncset_release(handle, old);
+  asyncset_release(handle, current);
+
+  asyncset_destroy(&handle);
+  return 1;
+}
+
+/******************************************************************************
+ * FUNCTION:	    test_shardset
+ *
+ * DESCRIPTION:	    Tests sharded sets.
+ *
+ * ARGUMENTS:	    none.
+ *
+ * RETURN:	    int -- 1 if the tests pass, 0 otherwise.
+ *
+ * NOTES:	    Test cases:
+ *			1 - shardset_create() with bad arguments
+ *			2 - insert, one at a time and from an array
+ *			3 - remove, and traverse in parallel
+ *			4 - union, intersection and difference
+ *			5 - union and intersection of more sets than shards
+ ***/
+static int test_shardset()
+{
+  /* shardset_create() with bad arguments */
+  shardset *group = NULL, *other = NULL, *setr = NULL;
+  if (shardset_create(match, NULL, copy, free, 4) != NULL
+      || shardset_create(match, hash, copy, free, -1) != NULL
+      || shardset_create(match, hash, copy, free,
+			 CONFIG_SHARDSET_SHARDS + 1) != NULL)
+    log_fail("test_shardset: 1 failed--shardset_create() !-> NULL\n");
+  if ((group = shardset_create(match, hash, copy, free, 0)) == NULL
+      || group->nshards != shardset_nodes() || group->nshards < 1
+      || shardset_node(group, 0) < 0 || shardset_shard(group, -1) != NULL)
+    log_fail("test_shardset: 1 failed--one shard per node\n");
+  shardset_destroy(&group);
+
+  /* insert, one at a time and from an array */
+  int nums[20000];
+  void * members[20000];
+  if ((group = shardset_create(match, hash, copy, free, 4)) == NULL)
+    log_fail("test_shardset: 2 failed--shardset_create() -> NULL\n");
+  for (int i = 0; i < 10000; i++) {
+    int * pNum = copy(&i);
+    if (shardset_insert(group, pNum))
+      log_fail("test_shardset: 2 failed--shardset_insert() !-> 0\n");
+  }
+  for (int i = 0; i < 20000; i++) {
+    nums[i] = i / 2 + 5000;
+    members[i] = &nums[i];
+  }
+  if (shardset_insert_array(group, members, 20000)
+      || shardset_size(group) != 15000)
+    log_fail("test_shardset: 2 failed--size is %ld\n", shardset_size(group));
+  for (int i = 0; i < 4; i++)
+    if (set_size(shardset_shard(group, i)) < 3000)
+      log_fail("test_shardset: 2 failed--shard %d is small\n", i);
+  for (int i = -10; i < 15010; i++)
+    if (shardset_ismember(group, &i) != (i >= 0 && i < 15000))
+      log_fail("test_shardset: 2 failed--wrong member %d\n", i);
+
+  /* remove, and traverse in parallel */
+  for (int i = 0; i < 15000; i += 3) {
+    const void * pNum = &i;
+    if (shardset_remove(group, &pNum))
+      log_fail("test_shardset: 3 failed--shardset_remove() !-> 0\n");
+  }
+  struct { pthread_mutex_t lock; long sum; long count; } total = {
+    PTHREAD_MUTEX_INITIALIZER, 0, 0
+  };
+  if (shardset_traverse(group, add_member, &total) || total.count != 10000
+      || total.sum != 14999L * 15000 / 2 - 3L * 4999 * 5000 / 2)
+    log_fail("test_shardset: 3 failed--wrong traversal\n");
+
+  /* union, intersection and difference */
+  if ((other = shardset_create(match, hash, copy, free, 4)) == NULL)
+    log_fail("test_shardset: 4 failed--shardset_create() -> NULL\n");
+  for (int i = 10000; i < 20000; i++)
+    shardset_insert(other, copy(&i));
+  if (shardset_union(&setr, group, other) || shardset_size(setr) != 16666
+      || !shardset_ismember(setr, &nums[19999]))
+    log_fail("test_shardset: 4 failed--wrong union\n");
+  shardset_destroy(&setr);
+  if (shardset_intersection(&setr, group, other)
+      || shardset_size(setr) != 3334)
+    log_fail("test_shardset: 4 failed--wrong intersection\n");
+  shardset_destroy(&setr);
+  if (shardset_difference(&setr, group, other)
+      || shardset_size(setr) != 6666)
+    log_fail("test_shardset: 4 failed--wrong difference\n");
+  shardset_destroy(&setr);
+  shardset_destroy(&other);
+  if ((other = shardset_create(match, hash, copy, free, 3)) == NULL
+      || shardset_union(&setr, group, other) != -1 || setr != NULL)
+    log_fail("test_shardset: 4 failed--shards do not match\n");
+  shardset_destroy(&other);
+  shardset_destroy(&group);
+
+  /* union and intersection of more sets than shards */
+  enum { MANY = CONFIG_SHARDSET_SHARDS + 36 };
+  shardset * many[MANY + 1] = {NULL};
+  int common = -1;
+  for (int i = 0; i < MANY; i++) {
+    if ((many[i] = shardset_create(match, hash, copy, free, 2)) == NULL
+	|| shardset_insert(many[i], copy(&i))
+	|| shardset_insert(many[i], copy(&common)))
+      log_fail("test_shardset: 5 failed--could not create the sets\n");
+  }
+  if (shardset_union_func(&setr, many) || shardset_size(setr) != MANY + 1)
+    log_fail("test_shardset: 5 failed--wrong union\n");
+  shardset_destroy(&setr);
+  if (shardset_intersection_func(&setr, many) || shardset_size(setr) != 1
+      || !shardset_ismember(setr, &common))
+    log_fail("test_shardset: 5 failed--wrong intersection\n");
+  shardset_destroy(&setr);
+  for (int i = 0; i < MANY; i++)
+    shardset_destroy(&many[i]);
+
+  return 1;
+}
+
+/******************************************************************************
+ * FUNCTION:	    test_hugepages
+ *
+ * DESCRIPTION:	    Tests hashed sets on huge pages.
+ *
+ * ARGUMENTS:	    none.
+ *
+ * RETURN:	    int -- 1 if the tests pass, 0 otherwise.
+ *
+ * NOTES:	    Test cases:
+ *			1 - set_use_hugepages() with bad arguments
+ *			2 - grow a set on transparent huge pages
+ *			3 - move it to explicit huge pages, and back
+ *
+ *		    Whether the system grants huge pages is up to it, so the
+ *		    page size is only checked to be one of those it may give.
+ ***/
+static int test_hugepages()
+{
+  /* set_use_hugepages() with bad arguments */
+  set *group = NULL, *list = NULL;
+  set_memstats stats;
+  if ((list = set_create(match, copy, free)) == NULL
+      || (group = set_create_hashed(match, hash, copy, free)) == NULL)
+    log_fail("test_hugepages: 1 failed--could not create the sets\n");
+  if (set_use_hugepages(list, SET_PAGES_TRANSPARENT) != -1
+      || set_use_hugepages(group, (set_pages)7) != -1
+      || set_memory_stats(list, &stats) != -1)
+    log_fail("test_hugepages: 1 failed--set_use_hugepages() !-> -1\n");
+  set_destroy(&list);
+
+  /* grow a set on transparent huge pages */
+  unsigned long base = 0;
+  if (set_use_hugepages(group, SET_PAGES_TRANSPARENT)
+      || set_memory_stats(group, &stats) || stats.bytes != 0
+      || stats.pages != SET_PAGES_TRANSPARENT)
+    log_fail("test_hugepages: 2 failed--wrong statistics\n");
+  base = stats.pagesize;
+  for (int i = 0; i < 200000; i++)
+    set_insert(group, copy(&i));
+  if (set_memory_stats(group, &stats) || stats.bytes < 4 * 1024 * 1024
+      || (stats.pagesize != base && stats.pagesize < 1024 * 1024))
+    log_fail("test_hugepages: 2 failed--page size %lu\n", stats.pagesize);
+  for (int i = -10; i < 200010; i++)
+    if (set_ismember(group, &i) != (i >= 0 && i < 200000))
+      log_fail("test_hugepages: 2 failed--wrong member %d\n", i);
+
+  /* move it to explicit huge pages, and back */
+  if (set_use_hugepages(group, SET_PAGES_EXPLICIT)
+      || set_memory_stats(group, &stats)
+      || stats.pages != SET_PAGES_EXPLICIT
+      || (stats.pagesize != base && stats.pagesize < 1024 * 1024))
+    log_fail("test_hugepages: 3 failed--page size %lu\n", stats.pagesize);
+  for (int i = 0; i < 200000; i += 2) {
+    const void * pNum = &i;
+    set_remove(group, &pNum);
+  }
+  if (set_use_hugepages(group, SET_PAGES_NORMAL)
+      || set_memory_stats(group, &stats) || stats.pagesize != base
+      || set_size(group) != 100000)
+    log_fail("test_hugepages: 3 failed--did not move back\n");
+  for (int i = 0; i < 200000; i++)
+    if (set_ismember(group, &i) != (i % 2 == 1))
+      log_fail("test_hugepages: 3 failed--wrong member %d\n", i);
+
+  set_destroy(&group);
+  return 1;
+}
+
+/******************************************************************************
+ * FUNCTION:	    test_sortedset
+ *
+ * DESCRIPTION:	    Tests the sorted set engine.
+ *
+ * ARGUMENTS:	    none.
+ *
+ * RETURN:	    int -- 1 if the tests pass, 0 otherwise.
+ *
+ * NOTES:	    Test cases:
+ *			1 - set_create_sorted() with bad arguments
+ *			2 - insert out of order
+ *			3 - iterate in order, and remove
+ *			4 - merge sorted sets
+ *			5 - combine with a hashed set, and difference
+ ***/
+static int test_sortedset()
+{
+  /* set_create_sorted() with bad arguments */
+  set *group = NULL, *other = NULL, *setr = NULL;
+  if (set_create_sorted(NULL, copy, free, sizeof(int)) != NULL
+      || set_create_sorted(compare, copy, free, 0) != NULL)
+    log_fail("test_sortedset: 1 failed--set_create_sorted() !-> NULL\n");
+
+  /* insert out of order */
+  if ((group = set_create_sorted(compare, copy, free, sizeof(int))) == NULL)
+    log_fail("test_sortedset: 2 failed--set_create_sorted() -> NULL\n");
+  for (int i = 0; i < 2 * 100000; i++) {
+    int num = (int)((i * 7919L) % 100000);
+    int * pNum = copy(&num);
+    int ret = set_insert(group, pNum);
+    if (ret == 1)
+      free(pNum);
+    if (ret != (i >= 100000))
+      log_fail("test_sortedset: 2 failed--set_insert() -> %d\n", ret);
+  }
+  sortedset_stats stats;
+  if (set_size(group) != 100000 || set_sorted_stats(group, &stats)
+      || stats.depth > 4 || stats.leaves * stats.capacity < 100000
+      || stats.leaves * stats.capacity > 2 * 100000)
+    log_fail("test_sortedset: 2 failed--wrong size or shape\n");
+  for (int i = -10; i < 100010; i++)
+    if (set_ismember(group, &i) != (i >= 0 && i < 100000))
+      log_fail("test_sortedset: 2 failed--wrong member %d\n", i);
+
+  /* iterate in order, and remove */
+  for (int i = 0; i < 100000; i++) {
+    const void * pNum = &i;
+    if (i % 4 != 1 && set_remove(group, &pNum))
+      log_fail("test_sortedset: 3 failed--set_remove() !-> 0\n");
+  }
+  set_iterator iterator;
+  int last = -1, count = 0;
+  for (int * data = set_begin(group, &iterator); data != NULL;
+       data = set_advance(group, &iterator), count++) {
+    if (*data != last + 2 + (last >= 0 ? 2 : 0))
+      log_fail("test_sortedset: 3 failed--%d after %d\n", *data, last);
+    last = *data;
+  }
+  if (set_size(group) != 25000 || count != 25000
+      || set_sorted_stats(group, &stats) || stats.leaves > 25000 / 4)
+    log_fail("test_sortedset: 3 failed--iteration is incomplete\n");
+
+  /* merge sorted sets */
+  if ((other = set_create_sorted(compare, copy, free, sizeof(int))) == NULL)
+    log_fail("test_sortedset: 4 failed--set_create_sorted() -> NULL\n");
+  for (int i = 0; i < 100000; i += 3)
+    set_insert(other, copy(&i));
+  if (set_union(&setr, group, other) || set_size(setr) != 25000 + 33334 - 8333
+      || setr->engine != group->engine || !set_issubset(other, setr)
+      || !set_issubset(group, setr))
+    log_fail("test_sortedset: 4 failed--wrong union\n");
+  last = -1;
+  for (int * data = set_begin(setr, &iterator); data != NULL;
+       last = *data, data = set_advance(setr, &iterator))
+    if (*data <= last)
+      log_fail("test_sortedset: 4 failed--union is out of order\n");
+  set_destroy(&setr);
+  if (set_intersection(&setr, group, other) || set_size(setr) != 8333)
+    log_fail("test_sortedset: 4 failed--wrong intersection\n");
+  for (int i = -10; i < 100010; i++)
+    if (set_ismember(setr, &i) != (i >= 0 && i % 12 == 9 && i < 100000))
+      log_fail("test_sortedset: 4 failed--wrong member %d\n", i);
+  set_destroy(&setr);
+  set_destroy(&other);
+
+  /* combine with a hashed set */
+  if ((other = set_create_hashed(match, hash, copy, free)) == NULL)
+    log_fail("test_sortedset: 5 failed--set_create_hashed() -> NULL\n");
+  for (int i = 99000; i < 101000; i++)
+    set_insert(other, copy(&i));
+  if (set_union(&setr, group, other) || set_size(setr) != 24750 + 2000
+      || setr->engine != group->engine || !set_issubset(other, setr))
+    log_fail("test_sortedset: 5 failed--wrong union\n");
+  set_destroy(&setr);
+  if (set_intersection(&setr, group, other) || set_size(setr) != 250)
+    log_fail("test_sortedset: 5 failed--wrong intersection\n");
+  set_destroy(&other);
+  if (set_difference(&other, group, setr) || set_size(other) != 24750)
+    log_fail("test_sortedset: 5 failed--wrong difference\n");
+
+  set_destroy(&setr);
+  set_destroy(&other);
+  set_destroy(&group);
+  return 1;
+}
+
+/******************************************************************************
+ * FUNCTION:	    test_adaptiveset
+ *
+ * DESCRIPTION:	    Tests the adaptive set engine, and its switches.
+ *
+ * ARGUMENTS:	    none.
+ *
+ * RETURN:	    int -- 1 if the tests pass, 0 otherwise.
+ *
+ * NOTES:	    Test cases:
+ *			1 - set_create_adaptive() with bad arguments
+ *			2 - a growing set moves from inline to hashed
+ *			3 - a frozen set is sorted, and hashed again on change
+ *			4 - dense integers become a bitset
+ *			5 - a bitset that grows sparse is hashed
+ *			6 - set operations
+ ***/
+static int test_adaptiveset()
+{
+  /* set_create_adaptive() with bad arguments */
+  set *group = NULL, *other = NULL, *setr = NULL;
+  if (set_create_adaptive(match, NULL, compare, copy, free, sizeof(int), 0)
+      != NULL
+      || set_create_adaptive(match, hash, compare, copy, free, 3, 1) != NULL)
+    log_fail("test_adaptiveset: 1 failed--set_create_adaptive() !-> NULL\n");
+
+  /* a growing set moves from inline to hashed */
+  adaptiveset_stats stats;
+  if ((group = set_create_adaptive(match, hash, compare, copy, free,
+				   sizeof(int), 1)) == NULL
+      || set_adaptive_stats(group, &stats)
+      || stats.repr != ADAPTIVESET_INLINE || stats.switches != 0)
+    log_fail("test_adaptiveset: 2 failed--set_create_adaptive() -> NULL\n");
+  for (int i = 0; i < 100; i++) {
+    int num = i * 1000;
+    set_insert(group, copy(&num));
+  }
+  if (set_adaptive_stats(group, &stats) || stats.repr != ADAPTIVESET_HASHED
+      || stats.switches != 1 || stats.events[0].from != ADAPTIVESET_INLINE
+      || stats.events[0].size != CONFIG_SET_INLINE + 1)
+    log_fail("test_adaptiveset: 2 failed--wrong representation\n");
+
+  /* a frozen set is sorted, and hashed again on change */
+  for (int i = 0; i < 2 * CONFIG_ADAPTIVESET_QUIET; i++)
+    if (set_ismember(group, &i) != (i % 1000 == 0 && i < 100000))
+      log_fail("test_adaptiveset: 3 failed--wrong member %d\n", i);
+  set_iterator iterator, inner;
+  int last = -1000, count = 0;
+  for (int * data = set_begin(group, &iterator); data != NULL;
+       data = set_advance(group, &iterator)) {
+    for (int i = 0; i < 40; i++)
+      set_ismember(group, data);
+    for (int * member = set_begin(group, &inner); member != NULL;
+	 member = set_advance(group, &inner))
+      count++;
+  }
+  if (count != 100 * 100 || set_adaptive_stats(group, &stats)
+      || stats.repr != ADAPTIVESET_HASHED)
+    log_fail("test_adaptiveset: 3 failed--iteration switched the set\n");
+  if (set_adaptive_settle(group))
+    log_fail("test_adaptiveset: 3 failed--set_adaptive_settle() !-> 0\n");
+  count = 0;
+  for (int * data = set_begin(group, &iterator); data != NULL;
+       data = set_advance(group, &iterator), count++) {
+    if (*data != last + 1000)
+      log_fail("test_adaptiveset: 3 failed--%d after %d\n", *data, last);
+    last = *data;
+  }
+  if (count != 100 || set_adaptive_stats(group, &stats)
+      || stats.repr != ADAPTIVESET_SORTED
+      || stats.events[1].from != ADAPTIVESET_HASHED)
+    log_fail("test_adaptiveset: 3 failed--set was not sorted\n");
+  for (int i = 100; i < 100 + CONFIG_ADAPTIVESET_QUIET; i++) {
+    int num = i * 1000;
+    set_insert(group, copy(&num));
+  }
+  if (set_adaptive_stats(group, &stats) || stats.repr != ADAPTIVESET_HASHED
+      || stats.switches != 3 || set_size(group) != 100 + 1024)
+    log_fail("test_adaptiveset: 3 failed--set was not hashed again\n");
+  for (int i = 0; i < 2; i++)
+    for (void * data = set_begin(group, &iterator); data != NULL;
+	 data = set_advance(group, &iterator))
+      continue;
+  if (set_adaptive_settle(group) || set_adaptive_stats(group, &stats)
+      || stats.repr != ADAPTIVESET_SORTED || stats.switches != 4)
+    log_fail("test_adaptiveset: 3 failed--scans did not freeze the set\n");
+  set_destroy(&group);
+
+  /* dense integers become a bitset */
+  if ((group = set_create_adaptive(match, hash, compare, copy, free,
+				   sizeof(int), 1)) == NULL)
+    log_fail("test_adaptiveset: 4 failed--set_create_adaptive() -> NULL\n");
+  for (int i = 0; i < 2 * 10000; i++) {
+    int num = (int)((i * 7919L) % 10000);
+    int * pNum = copy(&num);
+    int ret = set_insert(group, pNum);
+    if (ret == 1)
+      free(pNum);
+    if (ret != (i >= 10000))
+      log_fail("test_adaptiveset: 4 failed--set_insert() -> %d\n", ret);
+  }
+  if (set_adaptive_stats(group, &stats) || stats.repr != ADAPTIVESET_BITSET
+      || stats.events[stats.nevents - 1].from != ADAPTIVESET_HASHED
+      || stats.inserts != 20000)
+    log_fail("test_adaptiveset: 4 failed--set is not a bitset\n");
+  last = -1;
+  count = 0;
+  for (int * data = set_begin(group, &iterator); data != NULL;
+       data = set_advance(group, &iterator), count++) {
+    if (*data != last + 1)
+      log_fail("test_adaptiveset: 4 failed--%d after %d\n", *data, last);
+    last = *data;
+  }
+  for (int i = -100; i < 10100; i++)
+    if (set_ismember(group, &i) != (i >= 0 && i < 10000))
+      log_fail("test_adaptiveset: 4 failed--wrong member %d\n", i);
+  if (count != 10000 || set_size(group) != 10000)
+    log_fail("test_adaptiveset: 4 failed--iteration is incomplete\n");
+
+  /* a bitset that grows sparse is hashed */
+  for (int i = -1000; i < 0; i++)
+    set_insert(group, copy(&i));
+  for (int i = -1000; i < 10000; i++) {
+    const void * pNum = &i;
+    if (i % 100 != 0 && set_remove(group, &pNum))
+      log_fail("test_adaptiveset: 5 failed--set_remove() !-> 0\n");
+  }
+  if (set_adaptive_stats(group, &stats) || stats.repr != ADAPTIVESET_HASHED
+      || set_size(group) != 110)
+    log_fail("test_adaptiveset: 5 failed--set is still a bitset\n");
+  for (int i = -1000; i < 10000; i++)
+    if (set_ismember(group, &i) != (i % 100 == 0))
+      log_fail("test_adaptiveset: 5 failed--wrong member %d\n", i);
+
+  /* set operations */
+  if ((other = set_create_hashed(match, hash, copy, free)) == NULL)
+    log_fail("test_adaptiveset: 6 failed--set_create_hashed() -> NULL\n");
+  for (int i = 0; i < 20000; i += 50)
+    set_insert(other, copy(&i));
+  if (set_union(&setr, group, other) || set_size(setr) != 10 + 400
+      || setr->engine != group->engine || !set_issubset(group, setr))
+    log_fail("test_adaptiveset: 6 failed--wrong union\n");
+  set_destroy(&setr);
+  if (set_intersection(&setr, group, other) || set_size(setr) != 100)
+    log_fail("test_adaptiveset: 6 failed--wrong intersection\n");
+
+  set_destroy(&setr);
+  set_destroy(&other);
+  set_destroy(&group);
+  return 1;
+}
+
+/******************************************************************************
+ * FUNCTION:	    test_radixset
+ *
+ * DESCRIPTION:	    Tests the radix set engine.
+ *
+ * ARGUMENTS:	    none.
+ *
+ * RETURN:	    int -- 1 if the tests pass, 0 otherwise.
+ *
+ * NOTES:	    Test cases:
+ *			1 - set_create_radix() with bad arguments
+ *			2 - integer keys, in order, and node growth
+ *			3 - remove, and node shrinking
+ *			4 - string keys with shared prefixes
+ *			5 - prefix iteration
+ *			6 - set operations, with radix and hashed sets
+ ***/
+static int test_radixset()
+{
+  /* set_create_radix() with bad arguments */
+  set *group = NULL, *other = NULL, *setr = NULL;
+  if (set_create_radix(NULL, radixset_int_key, copy, free) != NULL
+      || set_create_radix(match, NULL, copy, free) != NULL)
+    log_fail("test_radixset: 1 failed--set_create_radix() !-> NULL\n");
+
+  /* integer keys, in order, and node growth */
+  if ((group = set_create_radix(match, radixset_int_key, copy, free)) == NULL)
+    log_fail("test_radixset: 2 failed--set_create_radix() -> NULL\n");
+  for (int i = 0; i < 2 * 60000; i++) {
+    int num = (int)((i * 7919L) % 60000) - 10000;
+    int * pNum = copy(&num);
+    int ret = set_insert(group, pNum);
+    if (ret == 1)
+      free(pNum);
+    if (ret != (i >= 60000))
+      log_fail("test_radixset: 2 failed--set_insert() -> %d\n", ret);
+  }
+  radixset_stats stats;
+  if (set_size(group) != 60000 || set_radix_stats(group, &stats)
+      || stats.leaves != 60000 || stats.nodes256 == 0)
+    log_fail("test_radixset: 2 failed--wrong size or shape\n");
+  for (int i = -10010; i < 50010; i++)
+    if (set_ismember(group, &i) != (i >= -10000 && i < 50000))
+      log_fail("test_radixset: 2 failed--wrong member %d\n", i);
+  set_iterator iterator;
+  int last = -10001, count = 0;
+  for (int * data = set_begin(group, &iterator); data != NULL;
+       last = *data, data = set_advance(group, &iterator), count++)
+    if (*data != last + 1)
+      log_fail("test_radixset: 2 failed--%d after %d\n", *data, last);
+  if (count != 60000)
+    log_fail("test_radixset: 2 failed--iteration is incomplete\n");
+
+  /* remove, and node shrinking */
+  for (int i = -10000; i < 50000; i++) {
+    const void * pNum = &i;
+    if (i % 64 != 0 && set_remove(group, &pNum))
+      log_fail("test_radixset: 3 failed--set_remove() !-> 0\n");
+  }
+  if (set_size(group) != 938 || set_radix_stats(group, &stats)
+      || stats.leaves != 938 || stats.nodes256 > 1)
+    log_fail("test_radixset: 3 failed--wrong size or shape\n");
+  last = -10048;
+  for (int * data = set_begin(group, &iterator); data != NULL;
+       last = *data, data = set_advance(group, &iterator))
+    if (*data != last + 64)
+      log_fail("test_radixset: 3 failed--%d after %d\n", *data, last);
+  for (int i = -9984; i < 50000; i += 64) {
+    const void * pNum = &i;
+    if (set_remove(group, &pNum))
+      log_fail("test_radixset: 3 failed--set_remove() !-> 0\n");
+  }
+  if (set_size(group) != 0 || set_radix_stats(group, &stats)
+      || stats.bytes != 0 || set_begin(group, &iterator) != NULL)
+    log_fail("test_radixset: 3 failed--set is not empty\n");
+  set_destroy(&group);
+
+  /* string keys with shared prefixes */
+  if ((group = set_create_radix(match_strings, radixset_string_key,
+				copy_string, free)) == NULL)
+    log_fail("test_radixset: 4 failed--set_create_radix() -> NULL\n");
+  char path[64];
+  const char * names[] = {"/", "/usr", "/usr/lib", "/usr/share/doc", ""};
+  for (int i = 0; i < 5; i++)
+    set_insert(group, copy_string(names[i]));
+  for (int i = 0; i < 1000; i++) {
+    sprintf(path, "/usr/lib/lib%d.so", i);
+    set_insert(group, copy_string(path));
+    sprintf(path, "/usr/share/doc/package-%d/README", i);
+    set_insert(group, copy_string(path));
+  }
+  if (set_size(group) != 2005)
+    log_fail("test_radixset: 4 failed--wrong size\n");
+  for (int i = 0; i < 5; i++)
+    if (!set_ismember(group, names[i]))
+      log_fail("test_radixset: 4 failed--%s is not a member\n", names[i]);
+  if (set_ismember(group, "/usr/li") || set_ismember(group, "/usr/lib/")
+      || set_ismember(group, "/usr/share/doc/package-1/READ")
+      || set_ismember(group, "/usr/share/doc/package-1000/README"))
+    log_fail("test_radixset: 4 failed--wrong member\n");
+  char * before = NULL;
+  count = 0;
+  for (char * data = set_begin(group, &iterator); data != NULL;
+       before = data, data = set_advance(group, &iterator), count++)
+    if (before != NULL && strcmp(before, data) >= 0)
+      log_fail("test_radixset: 4 failed--%s after %s\n", data, before);
+  if (count != 2005)
+    log_fail("test_radixset: 4 failed--iteration is incomplete\n");
+
+  /* prefix iteration */
+  const char * prefixes[] = {"/usr/lib", "/usr/lib/", "/usr/lib/lib1",
+			     "/usr/share/doc/package-99", "/usr/x", "", "/"};
+  const int counts[] = {1001, 1000, 111, 11, 0, 2005, 2004};
+  for (int i = 0; i < 7; i++) {
+    count = 0;
+    for (char * data = set_radix_prefix(group, prefixes[i],
+					strlen(prefixes[i]), &iterator);
+	 data != NULL; data = set_advance(group, &iterator), count++)
+      if (strncmp(data, prefixes[i], strlen(prefixes[i])))
+	log_fail("test_radixset: 5 failed--%s is not under %s\n", data,
+		 prefixes[i]);
+    if (count != counts[i])
+      log_fail("test_radixset: 5 failed--%d under %s\n", count, prefixes[i]);
+  }
+  for (int i = 0; i < 1000; i += 2) {
+    sprintf(path, "/usr/lib/lib%d.so", i);
+    const void * pPath = path;
+    if (set_remove(group, &pPath))
+      log_fail("test_radixset: 5 failed--set_remove() !-> 0\n");
+  }
+  count = 0;
+  for (char * data = set_radix_prefix(group, "/usr/lib/lib1", 13, &iterator);
+       data != NULL; data = set_advance(group, &iterator))
+    count++;
+  if (count != 56 || set_size(group) != 1505)
+    log_fail("test_radixset: 5 failed--%d under /usr/lib/lib1\n", count);
+  set_destroy(&group);
+
+  /* set operations, with radix and hashed sets */
+  group = set_create_radix(match, radixset_int_key, copy, free);
+  other = set_create_radix(match, radixset_int_key, copy, free);
+  if (group == NULL || other == NULL)
+    log_fail("test_radixset: 6 failed--set_create_radix() -> NULL\n");
+  for (int i = 0; i < 100000; i += 4)
+    set_insert(group, copy(&i));
+  for (int i = 0; i < 100000; i += 3)
+    set_insert(other, copy(&i));
+  if (set_union(&setr, group, other) || set_size(setr) != 25000 + 33334 - 8334
+      || setr->engine != group->engine || !set_issubset(other, setr)
+      || !set_issubset(group, setr))
+    log_fail("test_radixset: 6 failed--wrong union\n");
+  set_destroy(&setr);
+  if (set_intersection(&setr, group, other) || set_size(setr) != 8334)
+    log_fail("test_radixset: 6 failed--wrong intersection\n");
+  for (int i = -10; i < 100010; i++)
+    if (set_ismember(setr, &i) != (i >= 0 && i % 12 == 0 && i < 100000))
+      log_fail("test_radixset: 6 failed--wrong member %d\n", i);
+  set_destroy(&setr);
+  set_destroy(&other);
+  if ((other = set_create_hashed(match, hash, copy, free)) == NULL)
+    log_fail("test_radixset: 6 failed--set_create_hashed() -> NULL\n");
+  for (int i = 99000; i < 101000; i++)
+    set_insert(other, copy(&i));
+  if (set_union(&setr, group, other) || set_size(setr) != 24750 + 2000
+      || setr->engine != group->engine || !set_issubset(other, setr))
+    log_fail("test_radixset: 6 failed--wrong union with a hashed set\n");
+  set_destroy(&setr);
+  if (set_intersection(&setr, group, other) || set_size(setr) != 250)
+    log_fail("test_radixset: 6 failed--wrong intersection\n");
+
+  set_destroy(&setr);
+  set_destroy(&other);
+  set_destroy(&group);
+  return 1;
+}
+
+/******************************************************************************
+ * FUNCTION:	    test_disjointset
+ *
+ * DESCRIPTION:	    Tests the disjoint-set forest.
+ *
+ * ARGUMENTS:	    none.
+ *
+ * RETURN:	    int -- 1 if the tests pass, 0 otherwise.
+ *
+ * NOTES:	    Test cases:
+ *			1 - disjointset_create() with bad arguments
+ *			2 - disjointset_add(), and singleton classes
+ *			3 - disjointset_union() and disjointset_find()
+ *			4 - disjointset_class() and disjointset_export()
+ ***/
+static int test_disjointset()
+{
+  /* disjointset_create() with bad arguments */
+  disjointset * forest = NULL;
+  if (disjointset_create(NULL, hash, copy, free) != NULL
+      || disjointset_create(match, NULL, copy, free) != NULL)
+    log_fail("test_disjointset: 1 failed--disjointset_create() !-> NULL\n");
+
+  /* disjointset_add(), and singleton classes */
+  if ((forest = disjointset_create(match, hash, copy, free)) == NULL)
+    log_fail("test_disjointset: 2 failed--disjointset_create() -> NULL\n");
+  for (int i = 0; i < 2 * 10000; i++) {
+    int num = i % 10000;
+    int * pNum = copy(&num);
+    int ret = disjointset_add(forest, pNum);
+    if (ret == 1)
+      free(pNum);
+    if (ret != (i >= 10000))
+      log_fail("test_disjointset: 2 failed--disjointset_add() -> %d\n", ret);
+  }
+  int one = 1, two = 2, absent = 10000;
+  if (disjointset_size(forest) != 10000
+      || disjointset_classes(forest) != 10000
+      || *((const int *)disjointset_find(forest, &one)) != 1
+      || disjointset_find(forest, &absent) != NULL
+      || disjointset_count(forest, &two) != 1)
+    log_fail("test_disjointset: 2 failed--classes are not singletons\n");
+
+  /* disjointset_union() and disjointset_find() */
+  for (int i = 0; i + 3 < 10000; i++) {
+    int next = i + 3;
+    if (disjointset_union(forest, &next, &i))
+      log_fail("test_disjointset: 3 failed--disjointset_union() !-> 0\n");
+  }
+  int last = 9997;
+  if (disjointset_classes(forest) != 3
+      || disjointset_union(forest, &one, &last) != 1
+      || disjointset_union(forest, &one, &absent) != -1
+      || !disjointset_same(forest, &one, &last)
+      || disjointset_same(forest, &one, &two)
+      || disjointset_same(forest, &one, &absent)
+      || disjointset_count(forest, &one) != 3333)
+    log_fail("test_disjointset: 3 failed--wrong classes\n");
+  for (int i = 0; i < 10000; i++)
+    if (*((const int *)disjointset_find(forest, &i)) % 3 != i % 3)
+      log_fail("test_disjointset: 3 failed--wrong class of %d\n", i);
+
+  /* disjointset_class() and disjointset_export() */
+  set * group = NULL, ** classes = NULL;
+  int member = 9998;
+  if ((group = disjointset_class(forest, &two)) == NULL
+      || set_size(group) != 3333 || !set_ismember(group, &member)
+      || set_ismember(group, &last))
+    log_fail("test_disjointset: 4 failed--wrong class\n");
+  set_destroy(&group);
+  if (disjointset_export(forest, &classes) != 3)
+    log_fail("test_disjointset: 4 failed--disjointset_export() !-> 3\n");
+  for (int c = 0; c < 3; c++) {
+    set_iterator iterator;
+    if (set_size(classes[c]) != 3333 + (c == 0))
+      log_fail("test_disjointset: 4 failed--class %d has %d members\n", c,
+	       set_size(classes[c]));
+    for (int * data = set_begin(classes[c], &iterator); data != NULL;
+	 data = set_advance(classes[c], &iterator))
+      if (*data % 3 != c)
+	log_fail("test_disjointset: 4 failed--%d is in class %d\n", *data, c);
+    set_destroy(&classes[c]);
+  }
+  free(classes);
+
+  disjointset_destroy(&forest);
+  return 1;
+}
+
+/******************************************************************************
+ * FUNCTION:	    test_compact
+ *
+ * DESCRIPTION:	    Tests the compact set.
+ *
+ * ARGUMENTS:	    none.
+ *
+ * RETURN:	    int -- 1 if the tests pass, 0 otherwise.
+ *
+ * NOTES:	    Test cases:
+ *			1 - set_create_compact(match, NULL, copy, free)
+ *			2 - iterate in the order of insertion
+ *			3 - remove, reinsert, and set_traverse
+ *			4 - shrink, and grow again
+ *			5 - union and intersection keep the order
+ *			6 - insert and remove in turn
+ ***/
+static int test_compact()
+{
+  set *set1 = NULL, *set2 = NULL, *setr = NULL;
+  if ((set1 = set_create_compact(match, NULL, copy, free)) != NULL)
+    log_fail("test_compact: 1 failed--set_create_compact() !-> NULL\n");
+
+  /* iterate in the order of insertion */
+  if ((set1 = set_create_compact(match, hash, copy, free)) == NULL
+      || (set2 = set_create_compact(match, hash, copy, free)) == NULL)
+    log_fail("test_compact: 2 failed--set_create_compact() -> NULL\n");
+  for (int i = 0; i < 10000; i++) {
+    int num = i * 7919 % 10000;
+    if (set_insert(set1, copy(&num)))
+      log_fail("test_compact: 2 failed--set_insert() !-> 0\n");
+  }
+  int one = 1;
+  if (set_insert(set1, &one) != 1 || set_size(set1) != 10000)
+    log_fail("test_compact: 2 failed--1 was inserted twice\n");
+  set_iterator iterator;
+  int count = 0;
+  for (int * data = set_begin(set1, &iterator); data != NULL;
+       data = set_advance(set1, &iterator), count++)
+    if (*data != count * 7919 % 10000)
+      log_fail("test_compact: 2 failed--%d is out of order\n", *data);
+  if (count != 10000)
+    log_fail("test_compact: 2 failed--iteration is incomplete\n");
+
+  /* remove, reinsert, and set_traverse */
+  for (int i = 0; i < 10000; i += 3) {
+    const void * pNum = &i;
+    if (set_remove(set1, &pNum))
+      log_fail("test_compact: 3 failed--set_remove() !-> 0\n");
+  }
+  for (int i = 0; i < 30; i += 3)
+    if (set_ismember(set1, &i) || set_insert(set1, copy(&i)))
+      log_fail("test_compact: 3 failed--%d was not removed\n", i);
+  unsigned long expected = 0;
+  for (int i = 0; i < 10000; i++)
+    if ((i * 7919 % 10000) % 3)
+      expected = expected * 31 + (unsigned long)(i * 7919 % 10000);
+  for (int i = 0; i < 30; i += 3)
+    expected = expected * 31 + (unsigned long)i;
+  folded = 0;
+  if (set_size(set1) != 6666 + 10 || set_traverse(set1, fold_member)
+      || folded != expected)
+    log_fail("test_compact: 3 failed--wrong order after removal\n");
+
+  /* shrink, and grow again */
+  for (int i = 0; i < 10000; i++) {
+    const void * pNum = &i;
+    if (i != one)
+      set_remove(set1, &pNum);
+  }
+  if (set_size(set1) != 1 || !set_ismember(set1, &one)
+      || *((int *)set_begin(set1, &iterator)) != one)
+    log_fail("test_compact: 4 failed--wrong members after shrinking\n");
+  for (int i = 0; i < 1000; i++) {
+    int * pNum = copy(&i);
+    if (set_insert(set1, pNum) == 1)
+      free(pNum);
+  }
+  count = 0;
+  for (int * data = set_begin(set1, &iterator); data != NULL;
+       data = set_advance(set1, &iterator), count++)
+    if (*data != (count == 0 ? one : count - (count <= one)))
+      log_fail("test_compact: 4 failed--%d is out of order\n", *data);
+  if (count != 1000)
+    log_fail("test_compact: 4 failed--iteration is incomplete\n");
+
+  /* union and intersection keep the order */
+  for (int i = 1999; i >= 500; i--)
+    if (set_insert(set2, copy(&i)))
+      log_fail("test_compact: 5 failed--set_insert() !-> 0\n");
+  if (set_union(&setr, set1, set2) || set_size(setr) != 2000
+      || setr->engine != set1->engine)
+    log_fail("test_compact: 5 failed--wrong union\n");
+  count = 0;
+  for (int * data = set_begin(setr, &iterator); data != NULL;
+       data = set_advance(setr, &iterator), count++)
+    if (count >= 1000 && *data != 1999 - (count - 1000))
+      log_fail("test_compact: 5 failed--%d is out of order\n", *data);
+  set_destroy(&setr);
+  if (set_intersection(&setr, set2, set1) || set_size(setr) != 500
+      || *((int *)set_begin(setr, &iterator)) != 999)
+    log_fail("test_compact: 5 failed--wrong intersection\n");
+  set_destroy(&setr);
+  set_destroy(&set1);
+
+  /* insert and remove in turn */
+  if ((set1 = set_create_compact(match, hash, copy, free)) == NULL)
+    log_fail("test_compact: 6 failed--set_create_compact() -> NULL\n");
+  for (int i = 0; i < 100000; i++) {
+    const void * pNum = &i;
+    if (set_insert(set1, copy(&i)) || set_remove(set1, &pNum)
+	|| set_size(set1) != 0)
+      log_fail("test_compact: 6 failed--%d was not removed\n", i);
+  }
+
+  set_destroy(&set1);
+  set_destroy(&set2);
+  return 1;
+}
+
+/******************************************************************************
+ * FUNCTION:	    test_incremental
+ *
+ * DESCRIPTION:	    Tests hashed sets that grow incrementally.
+ *
+ * ARGUMENTS:	    none.
+ *
+ * RETURN:	    int -- 1 if the tests pass, 0 otherwise.
+ *
+ * NOTES:	    Test cases:
+ *			1 - set_use_incremental() with bad arguments
+ *			2 - insert while the table is being moved
+ *			3 - remove and iterate while it is being moved
+ *			4 - turn it off in the middle of a move
+ ***/
+static int test_incremental()
+{
+  /* set_use_incremental() with bad arguments */
+  set *group = NULL, *list = NULL;
+  if ((list = set_create(match, copy, free)) == NULL
+      || (group = set_create_hashed(match, hash, copy, free)) == NULL)
+    log_fail("test_incremental: 1 failed--could not create the sets\n");
+  if (set_use_incremental(NULL, 1) != -1 || set_use_incremental(list, 1) != -1)
+    log_fail("test_incremental: 1 failed--set_use_incremental() !-> -1\n");
+  set_destroy(&list);
+
+  /* insert while the table is being moved */
+  int moves = 0;
+  if (set_use_incremental(group, 1))
+    log_fail("test_incremental: 2 failed--set_use_incremental() !-> 0\n");
+  for (int i = 0; i < 100000; i++) {
+    if (set_insert(group, copy(&i)))
+      log_fail("test_incremental: 2 failed--set_insert() !-> 0\n");
+    const hashtable * table = group->storage;
+    if (table == NULL || table->old == NULL)
+      continue;
+    moves++;
+    int half = i / 2;
+    if (!set_ismember(group, &i) || !set_ismember(group, &half)
+	|| set_insert(group, &half) != 1)
+      log_fail("test_incremental: 2 failed--lost %d\n", half);
+  }
+  if (moves == 0 || set_size(group) != 100000)
+    log_fail("test_incremental: 2 failed--the table was not moved\n");
+
+  /* remove and iterate while it is being moved */
+  while (((const hashtable *)group->storage)->old == NULL) {
+    int num = set_size(group);
+    set_insert(group, copy(&num));
+  }
+  int size = set_size(group);
+  for (int i = 0; i < size; i += 2) {
+    const void * pNum = &i;
+    if (set_remove(group, &pNum))
+      log_fail("test_incremental: 3 failed--could not remove %d\n", i);
+  }
+  set_iterator iterator;
+  long sum = 0, count = 0, expected = 0;
+  for (int i = 1; i < size; i += 2)
+    expected += i;
+  for (void * data = set_begin(group, &iterator); data != NULL;
+       data = set_advance(group, &iterator), count++)
+    sum += *((int *)data);
+  if (count != size / 2 || sum != expected
+      || ((const hashtable *)group->storage)->old == NULL)
+    log_fail("test_incremental: 3 failed--iteration is incomplete\n");
+
+  /* turn it off in the middle of a move */
+  if (set_use_incremental(group, 0)
+      || ((const hashtable *)group->storage)->old != NULL
+      || set_size(group) != size / 2)
+    log_fail("test_incremental: 4 failed--the move was not finished\n");
+  for (int i = 0; i < size; i++)
+    if (set_ismember(group, &i) != (i % 2 == 1))
+      log_fail("test_incremental: 4 failed--wrong member %d\n", i);
+
+  set_destroy(&group);
+  return 1;
+}
+
+/******************************************************************************
+ * FUNCTION:	    test_robinset
+ *
+ * DESCRIPTION:	    Tests the Robin Hood set engine.
+ *
+ * ARGUMENTS:	    none.
+ *
+ * RETURN:	    int -- 1 if the tests pass, 0 otherwise.
+ *
+ * NOTES:	    Test cases:
+ *			1 - set_create_robin(match, NULL, copy, free)
+ *			2 - insert and ismember
+ *			3 - churn a window of members
+ *			4 - union and intersection with a hashed set
+ *			5 - remove every member, and shrink
+ ***/
+static int test_robinset()
+{
+  set *group = NULL, *other = NULL, *setr = NULL;
+  robinset_stats stats, before;
+  if ((group = set_create_robin(match, NULL, copy, free)) != NULL)
+    log_fail("test_robinset: 1 failed--set_create_robin() !-> NULL\n");
+
+  /* insert and ismember */
+  if ((group = set_create_robin(match, hash, copy, free)) == NULL
+      || (other = set_create_hashed(match, hash, copy, free)) == NULL)
+    log_fail("test_robinset: 2 failed--could not create the sets\n");
+  if (set_robin_stats(other, &stats) != -1 || set_robin_stats(group, &stats)
+      || stats.capacity != 0)
+    log_fail("test_robinset: 2 failed--wrong statistics\n");
+  for (int i = 0; i < 2 * 10000; i++) {
+    int num = i % 10000;
+    int * pNum = copy(&num);
+    int ret = set_insert(group, pNum);
+    if (ret == 1)
+      free(pNum);
+    if (ret != (i >= 10000))
+      log_fail("test_robinset: 2 failed--set_insert() -> %d\n", ret);
+  }
+  for (int i = -10; i < 10010; i++)
+    if (set_ismember(group, &i) != (i >= 0 && i < 10000))
+      log_fail("test_robinset: 2 failed--wrong member %d\n", i);
+
+  /* churn a window of members */
+  if (set_robin_stats(group, &before))
+    log_fail("test_robinset: 3 failed--set_robin_stats() !-> 0\n");
+  for (int i = 0; i < 100000; i++) {
+    int next = i + 10000;
+    const void * pNum = &i;
+    if (set_insert(group, copy(&next)) || set_remove(group, &pNum))
+      log_fail("test_robinset: 3 failed--could not churn %d\n", i);
+  }
+  if (set_robin_stats(group, &stats) || set_size(group) != 10000
+      || stats.capacity != before.capacity || stats.mean > 3
+      || stats.longest > 64)
+    log_fail("test_robinset: 3 failed--mean probe %f, longest %lu\n",
+	     stats.mean, stats.longest);
+  for (int i = 90000; i < 120000; i++)
+    if (set_ismember(group, &i) != (i >= 100000 && i < 110000))
+      log_fail("test_robinset: 3 failed--wrong member %d\n", i);
+
+  /* union and intersection with a hashed set */
+  for (int i = 105000; i < 115000; i++)
+    set_insert(other, copy(&i));
+  if (set_union(&setr, group, other) || set_size(setr) != 15000
+      || setr->engine != group->engine)
+    log_fail("test_robinset: 4 failed--wrong union\n");
+  set_destroy(&setr);
+  if (set_intersection(&setr, group, other) || set_size(setr) != 5000)
+    log_fail("test_robinset: 4 failed--wrong intersection\n");
+  set_destroy(&setr);
+
+  /* remove every member, and shrink */
+  set_iterator iterator;
+  for (int i = 100000; i < 110000; i++) {
+    const void * pNum = &i;
+    if (set_remove(group, &pNum))
+      log_fail("test_robinset: 5 failed--could not remove %d\n", i);
+  }
+  if (set_robin_stats(group, &stats) || set_size(group) != 0
+      || stats.capacity > 32 || set_begin(group, &iterator) != NULL)
+    log_fail("test_robinset: 5 failed--the table did not shrink\n");
+
+  set_destroy(&other);
+  set_destroy(&group);
+  return 1;
+}
+
+/******************************************************************************
+ * FUNCTION:	    test_shmset
+ *
+ * DESCRIPTION:	    Tests the shared set engine.
+ *
+ * ARGUMENTS:	    none.
+ *
+ * RETURN:	    int -- 1 if the tests pass, 0 otherwise.
+ *
+ * NOTES:	    Test cases:
+ *			1 - set_create_shared() and set_attach_shared() with
+ *			    bad arguments
+ *			2 - fill the set, and create it twice
+ *			3 - attach from another process, and change the set
+ *			4 - union and difference with a hashed set, and copy
+ *			5 - attach again, and unlink
+ ***/
+static int test_shmset()
+{
+  char name[64];
+  snprintf(name, sizeof(name), "/settest.%ld", (long)getpid());
+  set_shared_unlink(name);
+
+  /* set_create_shared() and set_attach_shared() with bad arguments */
+  set *group = NULL, *other = NULL, *setr = NULL, *setc = NULL;
+  if (set_create_shared(match, NULL, copy, free, sizeof(int), name, 1000)
+      != NULL
+      || set_create_shared(match, hash, copy, free, 0, name, 1000) != NULL
+      || set_create_shared(match, hash, copy, free, sizeof(int), name, 0)
+      != NULL
+      || set_create_shared(match, hash, copy, free, sizeof(int), NULL, 1000)
+      != NULL
+      || set_attach_shared(match, hash, copy, free, name) != NULL)
+    log_fail("test_shmset: 1 failed--bad arguments !-> NULL\n");
+
+  /* fill the set, and create it twice */
+  if ((group = set_create_shared(match, hash, copy, free, sizeof(int), name,
+				 1000)) == NULL)
+    log_fail("test_shmset: 2 failed--set_create_shared() -> NULL\n");
+  for (int i = 0; i < 1001; i++) {
+    int * pNum = copy(&i);
+    int ret = set_insert(group, pNum);
+    if (ret)
+      free(pNum);
+    if (ret != (i < 1000 ? 0 : -1))
+      log_fail("test_shmset: 2 failed--set_insert() -> %d\n", ret);
+  }
+  int zero = 0;
+  if (set_insert(group, &zero) != 1 || set_size(group) != 1000
+      || set_create_shared(match, hash, copy, free, sizeof(int), name, 1000)
+      != NULL)
+    log_fail("test_shmset: 2 failed--the set is not full\n");
+
+  /* attach from another process, and change the set */
+  pid_t child = fork();
+  if (child < 0)
+    log_fail("test_shmset: 3 failed--fork() -> %d\n", (int)child);
+  if (child == 0) {
+    int status = (group = set_attach_shared(match, hash, copy, free, name))
+      == NULL || set_size(group) != 1000;
+    for (int i = -10; i < 1010 && !status; i++)
+      status = set_ismember(group, &i) != (i >= 0 && i < 1000);
+    for (int i = 0; i < 1000 && !status; i += 2) {
+      const void * pNum = &i;
+      status = set_remove(group, &pNum);
+    }
+    for (int i = 2000; i < 2250 && !status; i++)
+      status = set_insert(group, copy(&i));
+    set_destroy(&group);
+    _exit(status);
+  }
+  int status = -1;
+  if (waitpid(child, &status, 0) != child || !WIFEXITED(status)
+      || WEXITSTATUS(status) != 0)
+    log_fail("test_shmset: 3 failed--the child failed\n");
+  if (set_shared_refresh(group) || set_size(group) != 750)
+    log_fail("test_shmset: 3 failed--set_size() -> %d\n", set_size(group));
+  for (int i = 0; i < 2500; i++)
+    if (set_ismember(group, &i) != ((i < 1000 && i % 2 == 1)
+				    || (i >= 2000 && i < 2250)))
+      log_fail("test_shmset: 3 failed--wrong member %d\n", i);
+  set_iterator iterator;
+  long sum = 0, count = 0;
+  for (void * data = set_begin(group, &iterator); data != NULL;
+       data = set_advance(group, &iterator), count++)
+    sum += *((int *)data);
+  if (count != 750 || sum != 500L * 500 + 250L * 2000 + 250L * 249 / 2)
+    log_fail("test_shmset: 3 failed--iteration is incomplete\n");
+
+  /* union and difference with a hashed set, and copy */
+  if ((other = set_create_hashed(match, hash, copy, free)) == NULL)
+    log_fail("test_shmset: 4 failed--set_create_hashed() -> NULL\n");
+  for (int i = 2200; i < 3200; i++)
+    set_insert(other, copy(&i));
+  if (set_union(&setr, group, other) || set_size(setr) != 1700
+      || setr->engine != group->engine || !set_issubset(other, setr))
+    log_fail("test_shmset: 4 failed--wrong union\n");
+  set_destroy(&setr);
+  if (set_difference(&setr, group, other) || set_size(setr) != 700
+      || !set_issubset(setr, group))
+    log_fail("test_shmset: 4 failed--wrong difference\n");
+  if ((setc = set_copy(group)) == NULL || !set_isequal(setc, group))
+    log_fail("test_shmset: 4 failed--wrong copy\n");
+  set_destroy(&setc);
+  set_destroy(&setr);
+  set_destroy(&other);
+
+  /* attach again, and unlink */
+  set_destroy(&group);
+  if ((group = set_attach_shared(match, hash, copy, free, name)) == NULL
+      || set_size(group) != 750 || set_shared_unlink(name)
+      || set_shared_unlink(name) != -1
+      || set_attach_shared(match, hash, copy, free, name) != NULL)
+    log_fail("test_shmset: 5 failed--could not attach and unlink\n");
+  int odd = 999;
+  if (!set_ismember(group, &odd))
+    log_fail("test_shmset: 5 failed--the set is gone\n");
+
+  set_destroy(&group);
+  return 1;
+}
+
+/******************************************************************************
+ * FUNCTION:	    test_setserver
+ *
+ * DESCRIPTION:	    Tests the set server and its client, over a socket in the
+ *		    current directory.
+ *
+ * ARGUMENTS:	    none.
+ *
+ * RETURN:	    int -- 1 if the tests pass, 0 otherwise.
+ *
+ * NOTES:	    Test cases:
+ *			1 - setserver_create() and setclient_connect() with
+ *			    bad arguments
+ *			2 - create and drop sets, and sets that do not exist
+ *			3 - insert and look up batches of many requests
+ *			4 - query from many clients at once
+ *			5 - union, intersection and difference by name
+ *			6 - malformed requests
+ ***/
+static int test_setserver()
+{
+  const char * path = "./setserver.test";
+  remove(path);
+
+  /* setserver_create() and setclient_connect() with bad arguments */
+  setserver * server = NULL;
+  setclient * client = NULL;
+  if (setserver_create(NULL, 0) != NULL || setserver_create(path, -1) != NULL
+      || setclient_connect(path) != NULL)
+    log_fail("test_setserver: 1 failed--bad arguments !-> NULL\n");
+
+  /* create and drop sets, and sets that do not exist */
+  pthread_t thread;
+  if ((server = setserver_create(path, 4)) == NULL
+      || setserver_create(path, 4) != NULL
+      || pthread_create(&thread, NULL, run_server, server)
+      || (client = setclient_connect(path)) == NULL)
+    log_fail("test_setserver: 2 failed--could not start the server\n");
+  uint64_t value = 0;
+  if (setclient_create(client, "one") || setclient_create(client, "two")
+      || setclient_create(client, "shared")
+      || setclient_create(client, "one") != SETSERVER_EXISTS
+      || setclient_create(client, "") != -1
+      || setclient_size(client, "none", &value) != SETSERVER_NOSET
+      || setclient_drop(client, "none") != SETSERVER_NOSET
+      || setclient_create(client, "gone") || setclient_drop(client, "gone")
+      || setclient_size(client, "gone", &value) != SETSERVER_NOSET)
+    log_fail("test_setserver: 2 failed--could not create and drop sets\n");
+
+  /* insert and look up batches of many requests */
+  static uint64_t keys[100000];
+  static unsigned char members[100000];
+  for (int i = 0; i < 100000; i++)
+    keys[i] = i;
+  if (setclient_insert(client, "one", keys, 60000, &value) || value != 60000
+      || setclient_insert(client, "one", keys, 60000, &value) || value != 0
+      || setclient_insert(client, "two", keys + 40000, 60000, &value)
+      || setclient_size(client, "one", &value) || value != 60000)
+    log_fail("test_setserver: 3 failed--could not insert\n");
+  if (setclient_ismember(client, "one", keys, 100000, members))
+    log_fail("test_setserver: 3 failed--setclient_ismember() !-> 0\n");
+  for (int i = 0; i < 100000; i++)
+    if (members[i] != (i < 60000))
+      log_fail("test_setserver: 3 failed--wrong member %d\n", i);
+
+  /* query from many clients at once */
+  struct { const char * path; int part; int status; } queries[8];
+  pthread_t clients[8];
+  for (int i = 0; i < 8; i++) {
+    queries[i].path = path;
+    queries[i].part = i;
+    queries[i].status = -1;
+    pthread_create(&clients[i], NULL, query_server, &queries[i]);
+  }
+  for (int i = 0; i < 8; i++) {
+    pthread_join(clients[i], NULL);
+    if (queries[i].status)
+      log_fail("test_setserver: 4 failed--client %d\n", i);
+  }
+  if (setclient_size(client, "shared", &value) || value != 80000)
+    log_fail("test_setserver: 4 failed--the set has %d members\n",
+	     (int)value);
+
+  /* union, intersection and difference by name */
+  uint64_t sizes[3];
+  if (setclient_union(client, "u", "one", "two")
+      || setclient_intersection(client, "i", "one", "two")
+      || setclient_difference(client, "one", "one", "two")
+      || setclient_size(client, "u", &sizes[0])
+      || setclient_size(client, "i", &sizes[1])
+      || setclient_size(client, "one", &sizes[2])
+      || sizes[0] != 100000 || sizes[1] != 20000 || sizes[2] != 40000
+      || setclient_union(client, "u", "one", "none") != SETSERVER_NOSET)
+    log_fail("test_setserver: 5 failed--wrong set operation\n");
+  if (setclient_remove(client, "u", keys, 50000, &value) || value != 50000
+      || setclient_ismember(client, "u", keys + 49990, 20, members))
+    log_fail("test_setserver: 5 failed--could not remove\n");
+  for (int i = 0; i < 20; i++)
+    if (members[i] != (i >= 10))
+      log_fail("test_setserver: 5 failed--wrong member %d\n", 49990 + i);
+
+  /* malformed requests */
+  setserver_request request = {.length = 0, .id = client->next, .op = 99};
+  setserver_response response;
+  if (write(client->fd, &request, sizeof(request)) != sizeof(request)
+      || read(client->fd, &response, sizeof(response)) != sizeof(response)
+      || response.status != SETSERVER_BADREQUEST || response.length != 0)
+    log_fail("test_setserver: 6 failed--the request was not refused\n");
+  request = (setserver_request){.length = CONFIG_SETSERVER_FRAME + 1,
+				.op = SETSERVER_SIZE};
+  if (write(client->fd, &request, sizeof(request)) != sizeof(request)
+      || read(client->fd, &response, sizeof(response)) != 0)
+    log_fail("test_setserver: 6 failed--the connection was not closed\n");
+
+  setclient_close(&client);
+  setserver_stop(server);
+  pthread_join(thread, NULL);
+  setserver_destroy(&server);
+  if (access(path, F_OK) == 0)
+    log_fail("test_setserver: 6 failed--the socket was not removed\n");
+  return 1;
+}
 #endif /* CONFIG_DEBUG_SET */
 
 /*****************************************************************************/
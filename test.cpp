@@ -0,0 +1,534 @@
+/******************************************************************************
+ * NAME:	    test.cpp
+ *
+ * AUTHOR:	    Ethan D. Twardy
+ *
+ * DESCRIPTION:	    The source file containing the tests for the C++ API in
+ *		    set.hpp. Compile this by 'make debug.'
+ *
+ * CREATED:	    10/17/2026
+ *
+ * LAST EDITED:	    10/17/2026
+ ***/
+
+/******************************************************************************
+ * INCLUDES
+ ***/
+
+#ifdef CONFIG_DEBUG_SET
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "constset.hpp"
+#include "lazyset.hpp"
+#include "set.hpp"
+#endif /* CONFIG_DEBUG_SET */
+
+/******************************************************************************
+ * MACRO DEFINITIONS
+ ***/
+
+#ifdef CONFIG_DEBUG_SET
+#define FAIL "\033[1;31m"
+
+#ifdef __APPLE__
+#   define PASS "\033[1;32m"
+#else
+#   define PASS "\033[1;39m"
+#endif
+
+#define NC	"\033[0m"
+
+#ifdef CONFIG_TEST_LOG
+#   define log_fail(...) {			\
+    fprintf(stderr, __VA_ARGS__);		\
+    failures++;					\
+    return 0;					\
+  }
+#else
+#   define log_fail(...) { return 0; }
+#endif /* CONFIG_TEST_LOG */
+#endif /* CONFIG_DEBUG_SET */
+
+/******************************************************************************
+ * STATIC VARIABLES
+ ***/
+
+#ifdef CONFIG_DEBUG_SET
+static int failures = 0;
+static long allocated = 0;
+static long matches = 0;
+#endif /* CONFIG_DEBUG_SET */
+
+/******************************************************************************
+ * TYPE DEFINITIONS
+ ***/
+
+#ifdef CONFIG_DEBUG_SET
+/* Hashes and compares strings without regard to case. */
+struct fold_hash {
+  std::size_t operator()(const std::string & key) const
+  {
+    std::size_t h = 14695981039346656037ULL;
+    for (unsigned char c : key)
+      h = (h ^ (std::size_t)std::tolower(c)) * 1099511628211ULL;
+    return h;
+  }
+};
+
+struct fold_equal {
+  bool operator()(const std::string & one, const std::string & two) const
+  {
+    if (one.size() != two.size())
+      return false;
+    for (std::size_t i = 0; i < one.size(); i++)
+      if (std::tolower((unsigned char)one[i])
+	  != std::tolower((unsigned char)two[i]))
+	return false;
+    return true;
+  }
+};
+
+/* Counts the bytes it has handed out and not taken back. */
+template <class T>
+struct counting_allocator {
+  using value_type = T;
+
+  counting_allocator() = default;
+  template <class U>
+  counting_allocator(const counting_allocator<U> &) {}
+
+  T * allocate(std::size_t n)
+  {
+    allocated += (long)(n * sizeof(T));
+    return static_cast<T *>(std::malloc(n * sizeof(T)));
+  }
+
+  void deallocate(T * p, std::size_t n)
+  {
+    allocated -= (long)(n * sizeof(T));
+    std::free(p);
+  }
+
+  template <class U>
+  bool operator==(const counting_allocator<U> &) const { return true; }
+  template <class U>
+  bool operator!=(const counting_allocator<U> &) const { return false; }
+};
+#endif /* CONFIG_DEBUG_SET */
+
+/******************************************************************************
+ * LOCAL PROTOTYPES
+ ***/
+
+#ifdef CONFIG_DEBUG_SET
+static int test_members();
+static int test_operations();
+static int test_functors();
+static int test_interop();
+static int test_constset();
+static int test_lazy();
+static int match_long(const void *, const void *);
+static unsigned long hash_long(const void *);
+static void * copy_long(const void *);
+#endif /* CONFIG_DEBUG_SET */
+
+/******************************************************************************
+ * MAIN
+ ***/
+
+#ifdef CONFIG_DEBUG_SET
+int main()
+{
+  printf("Test members (et::Set):\t\t\t%s\n"
+	 "Test operations (et::unite, ...):\t%s\n"
+	 "Test functors (Hash, Eq, Alloc):\t%s\n"
+	 "Test interop (from_c, to_c):\t\t%s\n"
+	 "Test constant set (et::ConstSet):\t%s\n"
+	 "Test lazy operations (et::lazy):\t%s\n",
+
+	 test_members()		? PASS "PASS" NC : FAIL "FAIL" NC,
+	 test_operations()	? PASS "PASS" NC : FAIL "FAIL" NC,
+	 test_functors()	? PASS "PASS" NC : FAIL "FAIL" NC,
+	 test_interop()		? PASS "PASS" NC : FAIL "FAIL" NC,
+	 test_constset()	? PASS "PASS" NC : FAIL "FAIL" NC,
+	 test_lazy()		? PASS "PASS" NC : FAIL "FAIL" NC
+	 );
+
+  return failures;
+}
+
+/******************************************************************************
+ * LOCAL FUNCTIONS
+ ***/
+
+/******************************************************************************
+ * FUNCTION:	    test_members
+ *
+ * DESCRIPTION:	    Tests insert, contains, erase and iteration.
+ *
+ * ARGUMENTS:	    none.
+ *
+ * RETURN:	    int -- 1 if the tests pass, 0 otherwise.
+ *
+ * NOTES:	    Test cases:
+ *			1 - insert, duplicates and contains
+ *			2 - grow, and iterate
+ *			3 - erase, and erase_if
+ *			4 - copy and move
+ ***/
+static int test_members()
+{
+  /* insert, duplicates and contains */
+  et::Set<int> group;
+  if (!group.empty() || group.contains(1) || !group.insert(1)
+      || group.insert(1) || !group.contains(1) || group.size() != 1)
+    log_fail("test_members: 1 failed--wrong members\n");
+
+  /* grow, and iterate */
+  for (int i = 0; i < 10000; i++)
+    group.insert(i * 1024);
+  long sum = 0, count = 0;
+  for (int value : group)
+    sum += value, count++;
+  if (group.size() != 10001 || count != 10001
+      || sum != 1024L * 9999 * 10000 / 2 + 1
+      || group.capacity() * 3 < group.size() * 4)
+    log_fail("test_members: 2 failed--wrong iteration\n");
+
+  /* erase, and erase_if */
+  if (!group.erase(1) || group.erase(1) || group.contains(1))
+    log_fail("test_members: 3 failed--erase() did not remove 1\n");
+  if (group.erase_if([](int value) { return value % 2048 == 0; }) != 5000
+      || group.size() != 5000)
+    log_fail("test_members: 3 failed--erase_if() removed too many\n");
+  for (int i = 0; i < 10000; i++)
+    if (group.contains(i * 1024) != (i % 2 == 1))
+      log_fail("test_members: 3 failed--wrong member %d\n", i * 1024);
+
+  /* copy and move */
+  et::Set<int> copy(group), moved(std::move(group));
+  if (copy != moved || !group.empty() || group.contains(1024)
+      || !group.insert(7) || group.size() != 1)
+    log_fail("test_members: 4 failed--wrong copy or move\n");
+  copy = group;
+  moved = std::move(group);
+  if (copy != moved || copy.size() != 1 || !moved.contains(7))
+    log_fail("test_members: 4 failed--wrong assignment\n");
+
+  return 1;
+}
+
+/******************************************************************************
+ * FUNCTION:	    test_operations
+ *
+ * DESCRIPTION:	    Tests the set operations.
+ *
+ * ARGUMENTS:	    none.
+ *
+ * RETURN:	    int -- 1 if the tests pass, 0 otherwise.
+ *
+ * NOTES:	    Test cases:
+ *			1 - unite
+ *			2 - intersection
+ *			3 - difference, issubset and isequal
+ *			4 - results built in the storage of an rvalue
+ ***/
+static int test_operations()
+{
+  et::Set<int> set1 = {1, 2, 3, 4}, set2 = {3, 4, 5}, set3 = {4, 5, 6};
+
+  /* unite */
+  et::Set<int> setu = et::unite(set1, set2, set3);
+  if (setu != et::Set<int>{1, 2, 3, 4, 5, 6} || set1.size() != 4)
+    log_fail("test_operations: 1 failed--wrong union\n");
+
+  /* intersection */
+  if (et::intersection(set1, set2) != et::Set<int>{3, 4}
+      || et::intersection(set1, set2, set3) != et::Set<int>{4}
+      || !et::intersection(set1, et::Set<int>{}).empty())
+    log_fail("test_operations: 2 failed--wrong intersection\n");
+
+  /* difference, issubset and isequal */
+  if (et::difference(set1, set2) != et::Set<int>{1, 2}
+      || !et::issubset(set1, setu) || et::issubset(setu, set1)
+      || !et::isequal(set1, et::Set<int>{4, 3, 2, 1},
+		      et::Set<int>{1, 2, 3, 4})
+      || et::isequal(set1, set2))
+    log_fail("test_operations: 3 failed--wrong difference\n");
+
+  /* results built in the storage of an rvalue */
+  using counted = et::Set<int, std::hash<int>, std::equal_to<int>,
+			  counting_allocator<int>>;
+  counted big, small = {1, 2, 3};
+  for (int i = 0; i < 1000; i++)
+    big.insert(i);
+  long before = allocated;
+  counted setd = et::difference(std::move(big), small);
+  if (allocated != before || setd.size() != 997 || setd.contains(2)
+      || !big.empty())
+    log_fail("test_operations: 4 failed--result was copied\n");
+  setd = et::unite(std::move(setd), small);
+  if (allocated != before || setd.size() != 1000)
+    log_fail("test_operations: 4 failed--result was copied\n");
+
+  return 1;
+}
+
+/******************************************************************************
+ * FUNCTION:	    test_functors
+ *
+ * DESCRIPTION:	    Tests a set with its own Hash, Eq and Alloc.
+ *
+ * ARGUMENTS:	    none.
+ *
+ * RETURN:	    int -- 1 if the tests pass, 0 otherwise.
+ *
+ * NOTES:	    Test cases:
+ *			1 - members equal under Eq are one member
+ *			2 - every allocation goes through Alloc
+ ***/
+static int test_functors()
+{
+  {
+    /* members equal under Eq are one member */
+    et::Set<std::string, fold_hash, fold_equal,
+	    counting_allocator<std::string>> words;
+    std::string hello = "Hello";
+    if (!words.insert(hello) || words.insert("HELLO")
+	|| !words.insert(std::string("world")) || !words.contains("hello")
+	|| words.contains("hello!") || hello != "Hello")
+      log_fail("test_functors: 1 failed--wrong members\n");
+
+    /* every allocation goes through Alloc */
+    for (int i = 0; i < 1000; i++)
+      words.insert("word" + std::to_string(i));
+    if (allocated < (long)(words.capacity() * sizeof(std::string)))
+      log_fail("test_functors: 2 failed--storage was not counted\n");
+  }
+
+  if (allocated != 0)
+    log_fail("test_functors: 2 failed--%ld bytes leaked\n", allocated);
+  return 1;
+}
+
+/******************************************************************************
+ * FUNCTION:	    test_interop
+ *
+ * DESCRIPTION:	    Tests conversion to and from C sets.
+ *
+ * ARGUMENTS:	    none.
+ *
+ * RETURN:	    int -- 1 if the tests pass, 0 otherwise.
+ *
+ * NOTES:	    Test cases:
+ *			1 - to_c()
+ *			2 - from_c()
+ ***/
+static int test_interop()
+{
+  /* to_c() */
+  et::Set<long> group;
+  for (long i = 0; i < 500; i++)
+    group.insert(i * i);
+  set * c_group = group.to_c();
+  long square = 49 * 49, other = 50;
+  if (c_group == nullptr || set_size(c_group) != 500
+      || !set_ismember(c_group, &square) || set_ismember(c_group, &other))
+    log_fail("test_interop: 1 failed--wrong C set\n");
+
+  /* from_c() */
+  const void * pSquare = &square;
+  set_remove(c_group, &pSquare);
+  et::Set<long> back = et::Set<long>::from_c(c_group);
+  set_destroy(&c_group);
+  if (back.size() != 499 || back.contains(square)
+      || !et::issubset(back, group))
+    log_fail("test_interop: 2 failed--wrong copy of the C set\n");
+
+  return 1;
+}
+
+/******************************************************************************
+ * FUNCTION:	    test_constset
+ *
+ * DESCRIPTION:	    Tests sets built at compile time.
+ *
+ * ARGUMENTS:	    none.
+ *
+ * RETURN:	    int -- 1 if the tests pass, 0 otherwise.
+ *
+ * NOTES:	    Test cases:
+ *			1 - a table of keywords, checked by the compiler
+ *			2 - every key, and keys that are not members
+ *			3 - a table of integers
+ *			4 - a large table, built at run time
+ ***/
+static int test_constset()
+{
+  /* a table of keywords, checked by the compiler */
+  static constexpr std::string_view words[] = {
+    "auto", "break", "case", "char", "const", "continue", "default", "do",
+    "double", "else", "enum", "extern", "float", "for", "goto", "if",
+    "inline", "int", "long", "register", "restrict", "return", "short",
+    "signed", "sizeof", "static", "struct", "switch", "typedef", "union",
+    "unsigned", "void", "volatile", "while"
+  };
+  static constexpr auto keywords = et::ConstSet<std::string_view, 34>(words);
+  static_assert(keywords.contains("while") && !keywords.contains("whilst"),
+		"test_constset: 1 failed--wrong members");
+  static_assert(keywords.index_of("if") == 15 && keywords.index_of("") == -1,
+		"test_constset: 1 failed--wrong index");
+  static_assert(std::is_trivially_destructible_v<decltype(keywords)>,
+		"test_constset: 1 failed--needs a destructor");
+
+  /* every key, and keys that are not members */
+  for (std::size_t i = 0; i < keywords.size(); i++)
+    if (keywords.index_of(words[i]) != (long)i)
+      log_fail("test_constset: 2 failed--wrong index of %s\n",
+	       std::string(words[i]).c_str());
+  std::string misses[] = {"Auto", "whi", "while ", "integer", "x"};
+  for (const std::string & miss : misses)
+    if (keywords.contains(miss))
+      log_fail("test_constset: 2 failed--%s is a member\n", miss.c_str());
+
+  /* a table of integers */
+  static constexpr auto opcodes = et::make_const_set<unsigned>({
+      0x00, 0x01, 0x10, 0x11, 0x20, 0x40, 0x80, 0xff, 0x100, 0xdead
+    });
+  static_assert(opcodes.contains(0x80) && !opcodes.contains(0x81)
+		&& opcodes.index_of(0xdead) == 9,
+		"test_constset: 3 failed--wrong members");
+  for (unsigned op = 0; op < 0x10000; op++)
+    if (opcodes.contains(op) != (op == 0x00 || op == 0x01 || op == 0x10
+				 || op == 0x11 || op == 0x20 || op == 0x40
+				 || op == 0x80 || op == 0xff || op == 0x100
+				 || op == 0xdead))
+      log_fail("test_constset: 3 failed--wrong member %u\n", op);
+
+  /* a large table, built at run time */
+  static std::array<long, 1000> squares;
+  for (long i = 0; i < 1000; i++)
+    squares[i] = i * i;
+  static const et::ConstSet<long, 1000> large(squares);
+  for (long i = 0; i < 1000; i++)
+    if (large.index_of(i * i) != i || (i > 0 && large.contains(i * i + 1)))
+      log_fail("test_constset: 4 failed--wrong index of %ld\n", i * i);
+
+  return 1;
+}
+
+/******************************************************************************
+ * FUNCTION:	    test_lazy
+ *
+ * DESCRIPTION:	    Tests the lazy set operations.
+ *
+ * ARGUMENTS:	    none.
+ *
+ * RETURN:	    int -- 1 if the tests pass, 0 otherwise.
+ *
+ * NOTES:	    Test cases:
+ *			1 - members, union, intersection and difference of C
+ *			    sets
+ *			2 - take stops the operation early
+ *			3 - operations on et::Set
+ ***/
+static int test_lazy()
+{
+  /* members, union, intersection and difference of C sets */
+  set * one = set_create_hashed(match_long, hash_long, copy_long, free);
+  set * two = set_create_hashed(match_long, hash_long, copy_long, free);
+  for (long i = 0; i < 1000; i++) {
+    set_insert(one, copy_long(&i));
+    long multiple = i * 3;
+    set_insert(two, copy_long(&multiple));
+  }
+
+  long count = 0, sum = 0;
+  for (const void * data : et::lazy::members(one))
+    count++, sum += *static_cast<const long *>(data);
+  if (count != 1000 || sum != 999 * 1000 / 2)
+    log_fail("test_lazy: 1 failed--wrong members\n");
+  count = 0;
+  for (const void * data : et::lazy::unite(one, two))
+    count += data != nullptr;
+  if (count != 1000 + 666)
+    log_fail("test_lazy: 1 failed--wrong union\n");
+  count = 0;
+  for (const void * data : et::lazy::intersection(one, two)) {
+    if (*static_cast<const long *>(data) % 3 != 0)
+      log_fail("test_lazy: 1 failed--wrong intersection\n");
+    count++;
+  }
+  if (count != 334)
+    log_fail("test_lazy: 1 failed--wrong intersection\n");
+  count = 0;
+  for (const void * data : et::lazy::difference(two, one))
+    if (*static_cast<const long *>(data) >= 1000)
+      count++;
+  if (count != 666)
+    log_fail("test_lazy: 1 failed--wrong difference\n");
+
+  /* take stops the operation early */
+  matches = 0;
+  count = 0;
+  for (const void * data : et::lazy::take(et::lazy::intersection(one, two),
+					  10))
+    count += set_ismember(two, data);
+  if (count != 10 || matches > 100)
+    log_fail("test_lazy: 2 failed--%ld comparisons\n", matches);
+  set_destroy(&one);
+  set_destroy(&two);
+
+  /* operations on et::Set */
+  et::Set<std::string> set1, set2;
+  for (int i = 0; i < 100; i++) {
+    set1.insert(std::to_string(i));
+    set2.insert(std::to_string(i * 2));
+  }
+  et::Set<std::string> setu, seti, setd;
+  for (const std::string & value : et::lazy::unite(set1, set2))
+    setu.insert(value);
+  for (const std::string & value : et::lazy::intersection(set1, set2))
+    seti.insert(value);
+  for (const std::string & value : et::lazy::difference(set1, set2))
+    setd.insert(value);
+  if (setu != et::unite(set1, set2) || seti != et::intersection(set1, set2)
+      || setd != et::difference(set1, set2))
+    log_fail("test_lazy: 3 failed--wrong results\n");
+  count = 0;
+  for (const std::string & value : et::lazy::take(et::lazy::unite(set1, set2),
+						  0))
+    count += (long)value.size();
+  if (count != 0)
+    log_fail("test_lazy: 3 failed--take(0) yielded\n");
+
+  return 1;
+}
+
+static int match_long(const void * one, const void * two)
+{
+  matches++;
+  return *static_cast<const long *>(one) == *static_cast<const long *>(two);
+}
+
+static unsigned long hash_long(const void * data)
+{
+  return static_cast<unsigned long>(*static_cast<const long *>(data));
+}
+
+static void * copy_long(const void * data)
+{
+  long * copy = static_cast<long *>(malloc(sizeof(long)));
+  if (copy != nullptr)
+    *copy = *static_cast<const long *>(data);
+  return copy;
+}
+#endif /* CONFIG_DEBUG_SET */
+
+/*****************************************************************************/